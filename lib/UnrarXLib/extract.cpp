@@ -646,7 +646,7 @@ bool CmdExtract::ExtractCurrentFile(CommandData *Cmd,Archive &Arc,int HeaderSize
         {
           bool UserReject;
 
-          if (GetDataIO().UnpackToMemorySize == -1) 
+          if (GetDataIO().UnpackToMemorySize == -1 && GetDataIO().UnpackToSink == NULL)
           {
             if (!FileCreate(Cmd,&CurFile,DestFileName,DestNameW,Cmd->Overwrite,&UserReject,Arc.NewLhd.UnpSize,Arc.NewLhd.FileTime))
             {
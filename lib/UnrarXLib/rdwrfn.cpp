@@ -36,6 +36,7 @@ void ComprDataIO::Init()
   ProcessedArcSize=TotalArcSize=0;
   bQuit = false;
   m_pDlgProgress = NULL;
+  UnpackToSink = NULL;
  }
 
 int ComprDataIO::UnpRead(byte *Addr,uint Count)
@@ -225,6 +226,11 @@ void ComprDataIO::UnpWrite(byte *Addr,uint Count)
     else
       return;
   }
+  else if (UnpackToSink!=NULL)
+  {
+    if (!UnpackToSink->Write(Addr,Count))
+      bQuit = true;
+  }
   else
     if (!TestMode)
       DestFile->Write(Addr,Count);
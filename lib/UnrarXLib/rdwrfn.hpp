@@ -9,6 +9,15 @@ class Unpack;
 
 class CGUIDialogProgress;
 
+// receives the unpacked data in place of a file, see XFILE::CFileRar
+class ComprDataSink
+{
+  public:
+    virtual ~ComprDataSink() {}
+    // false stops the extraction
+    virtual bool Write(const byte *Addr,uint Count)=0;
+};
+
 class ComprDataIO
 {
   private:
@@ -95,6 +104,7 @@ class ComprDataIO
     Int64 m_iSeekTo;
     Int64 m_iStartOfBuffer;
     Int64 CurUnpStart;
+    ComprDataSink* UnpackToSink;
 };
 
 #endif
@@ -1098,6 +1098,34 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor(cp_context_t *ctx, const c
  */
 CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_memory(cp_context_t *context, const char *buffer, unsigned int buffer_len, cp_status_t *error) CP_GCC_NONNULL(1, 2);
 
+/**
+ * Serializes the information of a loaded plug-in descriptor into a compact
+ * form that ::cp_load_plugin_descriptor_from_serialized can turn back into
+ * plug-in information without parsing XML. This lets a main program cache
+ * the descriptors of plug-ins that have not changed. The serialized form
+ * contains no NUL characters and is not NUL terminated.
+ * 
+ * @param plugin the plug-in information to serialize
+ * @param buffer the buffer to write to, or NULL to only get the size
+ * @param buffer_len in: the size of the buffer, out: the size needed
+ * @return ::CP_OK if the serialized form fit the buffer or ::CP_ERR_RESOURCE
+ */
+CP_C_API cp_status_t cp_serialize_plugin_descriptor(const cp_plugin_info_t *plugin, char *buffer, unsigned int *buffer_len) CP_GCC_NONNULL(1, 3);
+
+/**
+ * Loads plug-in information serialized by ::cp_serialize_plugin_descriptor.
+ * The plug-in descriptor is not validated again. Otherwise this works like
+ * ::cp_load_plugin_descriptor and the returned information must be released
+ * the same way.
+ * 
+ * @param ctx the plug-in context
+ * @param buffer the buffer containing the serialized plug-in descriptor
+ * @param buffer_len the length of the buffer
+ * @param status a pointer to the location where status code is to be stored, or NULL
+ * @return pointer to the information structure or NULL if error occurs
+ */
+CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_serialized(cp_context_t *ctx, const char *buffer, unsigned int buffer_len, cp_status_t *status) CP_GCC_NONNULL(1, 2);
+
 /**
  * Installs the plug-in described by the specified plug-in information
  * structure to the specified plug-in context. The plug-in information
@@ -1363,3 +1363,379 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_memory(cp_context_t *
 
 	return plugin;
 }
+
+
+/* ------------------------------------------------------------------------
+ * Serialized plug-in descriptors
+ * ----------------------------------------------------------------------*/
+
+/*
+ * The serialized form is a sequence of unsigned numbers written as decimal
+ * digits followed by ';' and strings written as their length in decimal
+ * digits followed by ':' and the characters, or just '-' for NULL. It starts
+ * with a format marker so that stale caches are rejected.
+ */
+
+/// Serialized descriptor format marker
+#define CP_SERIALIZED_MARKER "cpsd1;"
+
+/// Serialization output
+typedef struct serial_writer_t {
+	char *buffer;
+	unsigned int size;
+	unsigned int len;
+} serial_writer_t;
+
+/// Serialization input
+typedef struct serial_reader_t {
+	const char *pos;
+	const char *end;
+	int error;
+} serial_reader_t;
+
+static void write_data(serial_writer_t *w, const char *data, unsigned int len) {
+	if (w->buffer != NULL && w->len + len <= w->size) {
+		memcpy(w->buffer + w->len, data, len);
+	}
+	w->len += len;
+}
+
+static void write_uint(serial_writer_t *w, unsigned int value) {
+	char num[16];
+	
+	sprintf(num, "%u;", value);
+	write_data(w, num, strlen(num));
+}
+
+static void write_str(serial_writer_t *w, const char *str) {
+	char num[16];
+	unsigned int len;
+	
+	if (str == NULL) {
+		write_data(w, "-", 1);
+		return;
+	}
+	len = strlen(str);
+	sprintf(num, "%u:", len);
+	write_data(w, num, strlen(num));
+	write_data(w, str, len);
+}
+
+static void write_cfg_element(serial_writer_t *w, const cp_cfg_element_t *ce) {
+	unsigned int i;
+	
+	write_str(w, ce->name);
+	write_uint(w, ce->num_atts);
+	for (i = 0; i < 2 * ce->num_atts; i++) {
+		write_str(w, ce->atts[i]);
+	}
+	write_str(w, ce->value);
+	write_uint(w, ce->num_children);
+	for (i = 0; i < ce->num_children; i++) {
+		write_cfg_element(w, ce->children + i);
+	}
+}
+
+CP_C_API cp_status_t cp_serialize_plugin_descriptor(const cp_plugin_info_t *plugin, char *buffer, unsigned int *buffer_len) {
+	serial_writer_t w;
+	unsigned int i;
+	
+	CHECK_NOT_NULL(plugin);
+	CHECK_NOT_NULL(buffer_len);
+	w.buffer = buffer;
+	w.size = *buffer_len;
+	w.len = 0;
+	
+	write_data(&w, CP_SERIALIZED_MARKER, strlen(CP_SERIALIZED_MARKER));
+	write_str(&w, plugin->identifier);
+	write_str(&w, plugin->name);
+	write_str(&w, plugin->version);
+	write_str(&w, plugin->provider_name);
+	write_str(&w, plugin->plugin_path);
+	write_str(&w, plugin->abi_bw_compatibility);
+	write_str(&w, plugin->api_bw_compatibility);
+	write_str(&w, plugin->req_cpluff_version);
+	write_uint(&w, plugin->num_imports);
+	for (i = 0; i < plugin->num_imports; i++) {
+		write_str(&w, plugin->imports[i].plugin_id);
+		write_str(&w, plugin->imports[i].version);
+		write_uint(&w, plugin->imports[i].optional ? 1 : 0);
+	}
+	write_str(&w, plugin->runtime_lib_name);
+	write_str(&w, plugin->runtime_funcs_symbol);
+	write_uint(&w, plugin->num_ext_points);
+	for (i = 0; i < plugin->num_ext_points; i++) {
+		write_str(&w, plugin->ext_points[i].local_id);
+		write_str(&w, plugin->ext_points[i].identifier);
+		write_str(&w, plugin->ext_points[i].name);
+		write_str(&w, plugin->ext_points[i].schema_path);
+	}
+	write_uint(&w, plugin->num_extensions);
+	for (i = 0; i < plugin->num_extensions; i++) {
+		write_str(&w, plugin->extensions[i].ext_point_id);
+		write_str(&w, plugin->extensions[i].local_id);
+		write_str(&w, plugin->extensions[i].identifier);
+		write_str(&w, plugin->extensions[i].name);
+		write_uint(&w, plugin->extensions[i].configuration != NULL ? 1 : 0);
+		if (plugin->extensions[i].configuration != NULL) {
+			write_cfg_element(&w, plugin->extensions[i].configuration);
+		}
+	}
+	
+	*buffer_len = w.len;
+	return (buffer != NULL && w.len <= w.size) ? CP_OK : CP_ERR_RESOURCE;
+}
+
+static unsigned int read_number(serial_reader_t *r, char terminator) {
+	unsigned int value = 0;
+	int digits = 0;
+	
+	while (r->pos < r->end && *r->pos >= '0' && *r->pos <= '9') {
+		value = value * 10 + (*r->pos - '0');
+		r->pos++;
+		digits++;
+	}
+	if (!digits || digits > 9 || r->pos >= r->end || *r->pos != terminator) {
+		r->error = 1;
+		return 0;
+	}
+	r->pos++;
+	return value;
+}
+
+static unsigned int read_uint(serial_reader_t *r) {
+	return r->error ? 0 : read_number(r, ';');
+}
+
+static char *read_str(serial_reader_t *r) {
+	unsigned int len;
+	char *str;
+	
+	if (r->error) {
+		return NULL;
+	}
+	if (r->pos < r->end && *r->pos == '-') {
+		r->pos++;
+		return NULL;
+	}
+	len = read_number(r, ':');
+	if (r->error || len > (unsigned int) (r->end - r->pos)) {
+		r->error = 1;
+		return NULL;
+	}
+	if ((str = malloc(len + 1)) == NULL) {
+		r->error = 1;
+		return NULL;
+	}
+	memcpy(str, r->pos, len);
+	str[len] = '\0';
+	r->pos += len;
+	return str;
+}
+
+/// Guards against counts that cannot fit the remaining input 
+static unsigned int read_count(serial_reader_t *r) {
+	unsigned int count = read_uint(r);
+	
+	if (count > (unsigned int) (r->end - r->pos)) {
+		r->error = 1;
+		return 0;
+	}
+	return count;
+}
+
+static void read_cfg_element(serial_reader_t *r, cp_cfg_element_t *ce, cp_cfg_element_t *parent, unsigned int index) {
+	unsigned int i;
+	
+	memset(ce, 0, sizeof(cp_cfg_element_t));
+	ce->parent = parent;
+	ce->index = index;
+	ce->name = read_str(r);
+	ce->num_atts = read_count(r);
+	if (ce->num_atts > 0 && !r->error) {
+		char **atts;
+		unsigned int size = 0, offset = 0;
+		
+		// the attributes share one block of memory, like parser_attsdup makes 
+		if ((atts = calloc(2 * ce->num_atts, sizeof(char *))) == NULL) {
+			r->error = 1;
+		} else {
+			for (i = 0; i < 2 * ce->num_atts; i++) {
+				if ((atts[i] = read_str(r)) == NULL) {
+					r->error = 1;
+					break;
+				}
+				size += strlen(atts[i]) + 1;
+			}
+			if (!r->error
+				&& (ce->atts = malloc(2 * ce->num_atts * sizeof(char *))) != NULL
+				&& (ce->atts[0] = malloc(size)) != NULL) {
+				for (i = 0; i < 2 * ce->num_atts; i++) {
+					ce->atts[i] = ce->atts[0] + offset;
+					strcpy(ce->atts[i], atts[i]);
+					offset += strlen(atts[i]) + 1;
+				}
+			} else {
+				free(ce->atts);
+				ce->atts = NULL;
+				r->error = 1;
+			}
+			for (i = 0; i < 2 * ce->num_atts; i++) {
+				free(atts[i]);
+			}
+			free(atts);
+		}
+	}
+	if (ce->atts == NULL) {
+		ce->num_atts = 0;
+	}
+	ce->value = read_str(r);
+	ce->num_children = read_count(r);
+	if (ce->num_children > 0 && !r->error) {
+		if ((ce->children = calloc(ce->num_children, sizeof(cp_cfg_element_t))) == NULL) {
+			r->error = 1;
+			ce->num_children = 0;
+		}
+		for (i = 0; i < ce->num_children; i++) {
+			read_cfg_element(r, ce->children + i, ce, i);
+		}
+	} else {
+		ce->num_children = 0;
+	}
+}
+
+CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_serialized(cp_context_t *context, const char *buffer, unsigned int buffer_len, cp_status_t *error) {
+	cp_status_t status = CP_OK;
+	cp_plugin_info_t *plugin = NULL;
+	serial_reader_t r;
+	unsigned int i, marker_len;
+
+	CHECK_NOT_NULL(context);
+	CHECK_NOT_NULL(buffer);
+	cpi_lock_context(context);
+	cpi_check_invocation(context, CPI_CF_ANY, __func__);
+	do {
+		r.pos = buffer;
+		r.end = buffer + buffer_len;
+		r.error = 0;
+		
+		marker_len = strlen(CP_SERIALIZED_MARKER);
+		if (buffer_len < marker_len || strncmp(buffer, CP_SERIALIZED_MARKER, marker_len)) {
+			status = CP_ERR_MALFORMED;
+			break;
+		}
+		r.pos += marker_len;
+		
+		if ((plugin = calloc(1, sizeof(cp_plugin_info_t))) == NULL) {
+			status = CP_ERR_RESOURCE;
+			break;
+		}
+		plugin->identifier = read_str(&r);
+		plugin->name = read_str(&r);
+		plugin->version = read_str(&r);
+		plugin->provider_name = read_str(&r);
+		plugin->plugin_path = read_str(&r);
+		plugin->abi_bw_compatibility = read_str(&r);
+		plugin->api_bw_compatibility = read_str(&r);
+		plugin->req_cpluff_version = read_str(&r);
+		
+		plugin->num_imports = read_count(&r);
+		if (plugin->num_imports > 0 && !r.error
+			&& (plugin->imports = calloc(plugin->num_imports, sizeof(cp_plugin_import_t))) == NULL) {
+			r.error = 1;
+		}
+		if (plugin->imports == NULL) {
+			plugin->num_imports = 0;
+		}
+		for (i = 0; i < plugin->num_imports; i++) {
+			plugin->imports[i].plugin_id = read_str(&r);
+			plugin->imports[i].version = read_str(&r);
+			plugin->imports[i].optional = read_uint(&r);
+		}
+		
+		plugin->runtime_lib_name = read_str(&r);
+		plugin->runtime_funcs_symbol = read_str(&r);
+		
+		plugin->num_ext_points = read_count(&r);
+		if (plugin->num_ext_points > 0 && !r.error
+			&& (plugin->ext_points = calloc(plugin->num_ext_points, sizeof(cp_ext_point_t))) == NULL) {
+			r.error = 1;
+		}
+		if (plugin->ext_points == NULL) {
+			plugin->num_ext_points = 0;
+		}
+		for (i = 0; i < plugin->num_ext_points; i++) {
+			plugin->ext_points[i].plugin = plugin;
+			plugin->ext_points[i].local_id = read_str(&r);
+			plugin->ext_points[i].identifier = read_str(&r);
+			plugin->ext_points[i].name = read_str(&r);
+			plugin->ext_points[i].schema_path = read_str(&r);
+		}
+		
+		plugin->num_extensions = read_count(&r);
+		if (plugin->num_extensions > 0 && !r.error
+			&& (plugin->extensions = calloc(plugin->num_extensions, sizeof(cp_extension_t))) == NULL) {
+			r.error = 1;
+		}
+		if (plugin->extensions == NULL) {
+			plugin->num_extensions = 0;
+		}
+		for (i = 0; i < plugin->num_extensions; i++) {
+			plugin->extensions[i].plugin = plugin;
+			plugin->extensions[i].ext_point_id = read_str(&r);
+			plugin->extensions[i].local_id = read_str(&r);
+			plugin->extensions[i].identifier = read_str(&r);
+			plugin->extensions[i].name = read_str(&r);
+			if (read_uint(&r) && !r.error) {
+				if ((plugin->extensions[i].configuration = malloc(sizeof(cp_cfg_element_t))) == NULL) {
+					r.error = 1;
+				} else {
+					read_cfg_element(&r, plugin->extensions[i].configuration, NULL, 0);
+				}
+			}
+		}
+		
+		if (r.error || r.pos != r.end || plugin->identifier == NULL || plugin->plugin_path == NULL) {
+			status = CP_ERR_MALFORMED;
+			break;
+		}
+		
+		// Increase plug-in usage count
+		if ((status = cpi_register_info(context, plugin, (void (*)(cp_context_t *, void *)) dealloc_plugin_info)) != CP_OK) {
+			break;
+		}
+		
+	} while (0);
+
+	// Report possible errors
+	if (status != CP_OK) {
+		switch (status) {
+			case CP_ERR_MALFORMED:
+				cpi_error(context,
+					N_("Serialized plug-in descriptor is invalid."));
+				break;
+			case CP_ERR_RESOURCE:
+				cpi_error(context,
+					N_("Insufficient system resources to load a serialized plug-in descriptor."));
+				break;
+			default:
+				cpi_error(context,
+					N_("Failed to load a serialized plug-in descriptor."));
+				break;
+		}
+	}
+	cpi_unlock_context(context);
+
+	// Release persistently allocated data on failure 
+	if (status != CP_OK && plugin != NULL) {
+		cpi_free_plugin(plugin);
+		plugin = NULL;
+	}
+
+	// Return error code
+	if (error != NULL) {
+		*error = status;
+	}
+
+	return plugin;
+}
@@ -0,0 +1,251 @@
+/*-------------------------------------------------------------------------
+ * C-Pluff, a plug-in framework for C
+ * Copyright 2007 Johannes Lehtinen
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *-----------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "test.h"
+
+/*
+ * Tests for serialized plug-in descriptors, which a main program can cache
+ * to avoid parsing the descriptors of unchanged plug-ins again.
+ */
+
+#define SERIALIZATION_TMPDIR "tmp" CP_FNAMESEP_STR "test-serialization"
+
+/// A descriptor like the ones of XBMC add-ons, with nested configuration and attributes
+static const char *descriptor =
+	"<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+	"<addon id=\"plugin.video.test%d\" name=\"Test plug-in %d\" version=\"1.%d.0\" provider-name=\"Test &amp; provider\">\n"
+	"  <requires>\n"
+	"    <import addon=\"xbmc.python\" version=\"1.0\"/>\n"
+	"    <import addon=\"script.module.test\" version=\"0.2\" optional=\"true\"/>\n"
+	"  </requires>\n"
+	"  <extension point=\"xbmc.python.pluginsource\" library=\"default.py\">\n"
+	"    <provides>video audio</provides>\n"
+	"  </extension>\n"
+	"  <extension point=\"xbmc.addon.metadata\">\n"
+	"    <summary lang=\"en\">A plug-in made up for testing</summary>\n"
+	"    <summary lang=\"de\">Ein Plug-in zum Testen</summary>\n"
+	"    <description lang=\"en\">It lists nothing at all, but it does so with a long description.</description>\n"
+	"    <platform>all</platform>\n"
+	"  </extension>\n"
+	"</addon>\n";
+
+static char *make_plugin_dir(int i) {
+	static char path[256];
+	char file[288];
+	FILE *fh;
+
+	sprintf(path, "%s" CP_FNAMESEP_STR "plugin%d", SERIALIZATION_TMPDIR, i);
+	mkdir("tmp", 0777);
+	mkdir(SERIALIZATION_TMPDIR, 0777);
+	mkdir(path, 0777);
+	sprintf(file, "%s" CP_FNAMESEP_STR "addon.xml", path);
+	check((fh = fopen(file, "w")) != NULL);
+	fprintf(fh, descriptor, i, i, i);
+	fclose(fh);
+	return path;
+}
+
+static int str_equals(const char *s1, const char *s2) {
+	return s1 == NULL ? s2 == NULL : (s2 != NULL && !strcmp(s1, s2));
+}
+
+static void check_cfg_equals(const cp_cfg_element_t *ce1, const cp_cfg_element_t *ce2, const cp_cfg_element_t *parent2) {
+	unsigned int i;
+
+	check(str_equals(ce1->name, ce2->name));
+	check(str_equals(ce1->value, ce2->value));
+	check(ce1->index == ce2->index);
+	check(ce2->parent == parent2);
+	check(ce1->num_atts == ce2->num_atts);
+	for (i = 0; i < 2 * ce1->num_atts; i++) {
+		check(str_equals(ce1->atts[i], ce2->atts[i]));
+	}
+	check(ce1->num_children == ce2->num_children);
+	for (i = 0; i < ce1->num_children; i++) {
+		check_cfg_equals(ce1->children + i, ce2->children + i, ce2);
+	}
+}
+
+static void check_plugin_equals(const cp_plugin_info_t *p1, const cp_plugin_info_t *p2) {
+	unsigned int i;
+
+	check(str_equals(p1->identifier, p2->identifier));
+	check(str_equals(p1->name, p2->name));
+	check(str_equals(p1->version, p2->version));
+	check(str_equals(p1->provider_name, p2->provider_name));
+	check(str_equals(p1->plugin_path, p2->plugin_path));
+	check(str_equals(p1->abi_bw_compatibility, p2->abi_bw_compatibility));
+	check(str_equals(p1->api_bw_compatibility, p2->api_bw_compatibility));
+	check(str_equals(p1->req_cpluff_version, p2->req_cpluff_version));
+	check(p1->num_imports == p2->num_imports);
+	for (i = 0; i < p1->num_imports; i++) {
+		check(str_equals(p1->imports[i].plugin_id, p2->imports[i].plugin_id));
+		check(str_equals(p1->imports[i].version, p2->imports[i].version));
+		check(!p1->imports[i].optional == !p2->imports[i].optional);
+	}
+	check(str_equals(p1->runtime_lib_name, p2->runtime_lib_name));
+	check(str_equals(p1->runtime_funcs_symbol, p2->runtime_funcs_symbol));
+	check(p1->num_ext_points == p2->num_ext_points);
+	for (i = 0; i < p1->num_ext_points; i++) {
+		check(p2->ext_points[i].plugin == p2);
+		check(str_equals(p1->ext_points[i].local_id, p2->ext_points[i].local_id));
+		check(str_equals(p1->ext_points[i].identifier, p2->ext_points[i].identifier));
+		check(str_equals(p1->ext_points[i].name, p2->ext_points[i].name));
+		check(str_equals(p1->ext_points[i].schema_path, p2->ext_points[i].schema_path));
+	}
+	check(p1->num_extensions == p2->num_extensions);
+	for (i = 0; i < p1->num_extensions; i++) {
+		check(p2->extensions[i].plugin == p2);
+		check(str_equals(p1->extensions[i].ext_point_id, p2->extensions[i].ext_point_id));
+		check(str_equals(p1->extensions[i].local_id, p2->extensions[i].local_id));
+		check(str_equals(p1->extensions[i].identifier, p2->extensions[i].identifier));
+		check(str_equals(p1->extensions[i].name, p2->extensions[i].name));
+		check((p1->extensions[i].configuration == NULL) == (p2->extensions[i].configuration == NULL));
+		if (p1->extensions[i].configuration != NULL) {
+			check_cfg_equals(p1->extensions[i].configuration, p2->extensions[i].configuration, NULL);
+		}
+	}
+}
+
+static char *serialize(const cp_plugin_info_t *plugin, unsigned int *len) {
+	char *buffer;
+
+	*len = 0;
+	check(cp_serialize_plugin_descriptor(plugin, NULL, len) == CP_ERR_RESOURCE);
+	check(*len > 0);
+	check((buffer = malloc(*len)) != NULL);
+	check(cp_serialize_plugin_descriptor(plugin, buffer, len) == CP_OK);
+	check(memchr(buffer, '\0', *len) == NULL);
+	return buffer;
+}
+
+void serializedescriptor(void) {
+	cp_context_t *ctx;
+	cp_plugin_info_t *plugin, *plugin2;
+	cp_status_t status;
+	char *buffer, *buffer2;
+	unsigned int len, len2;
+	int errors;
+
+	ctx = init_context(CP_LOG_ERROR + 1, &errors);
+	check((plugin = cp_load_plugin_descriptor(ctx, make_plugin_dir(0), &status)) != NULL && status == CP_OK);
+	buffer = serialize(plugin, &len);
+
+	// too small a buffer is not written past
+	len2 = len - 1;
+	check((buffer2 = malloc(len)) != NULL);
+	buffer2[len - 1] = '#';
+	check(cp_serialize_plugin_descriptor(plugin, buffer2, &len2) == CP_ERR_RESOURCE);
+	check(len2 == len && buffer2[len - 1] == '#');
+	free(buffer2);
+
+	// round trip
+	check((plugin2 = cp_load_plugin_descriptor_from_serialized(ctx, buffer, len, &status)) != NULL && status == CP_OK);
+	check_plugin_equals(plugin, plugin2);
+	buffer2 = serialize(plugin2, &len2);
+	check(len == len2 && !memcmp(buffer, buffer2, len));
+	free(buffer2);
+
+	// the loaded information can be installed like any other
+	check(cp_install_plugin(ctx, plugin2) == CP_OK);
+	check(cp_get_plugin_state(ctx, "plugin.video.test0") == CP_PLUGIN_INSTALLED);
+	cp_release_info(ctx, plugin2);
+	cp_release_info(ctx, plugin);
+	check(errors == 0);
+
+	// truncated or corrupt input is rejected
+	check(cp_load_plugin_descriptor_from_serialized(ctx, buffer, len - 1, &status) == NULL && status == CP_ERR_MALFORMED);
+	buffer[0] = 'x';
+	check(cp_load_plugin_descriptor_from_serialized(ctx, buffer, len, &status) == NULL && status == CP_ERR_MALFORMED);
+	check(errors == 2);
+	free(buffer);
+
+	cp_destroy();
+}
+
+static double elapsed_ms(clock_t start) {
+	return (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+void serializebenchmark(void) {
+	const int count = 1000;
+	cp_context_t *ctx;
+	cp_plugin_info_t *plugin;
+	cp_status_t status;
+	char **cache;
+	unsigned int *cache_len;
+	char path[256];
+	struct stat st;
+	clock_t start;
+	double scan, cached;
+	int i, errors;
+
+	check((cache = calloc(count, sizeof(char *))) != NULL);
+	check((cache_len = calloc(count, sizeof(unsigned int))) != NULL);
+
+	// a synthetic collection, serialized once
+	ctx = init_context(CP_LOG_ERROR, &errors);
+	for (i = 0; i < count; i++) {
+		check((plugin = cp_load_plugin_descriptor(ctx, make_plugin_dir(i), &status)) != NULL);
+		cache[i] = serialize(plugin, &cache_len[i]);
+		cp_release_info(ctx, plugin);
+	}
+	cp_destroy();
+
+	// how the collection is loaded without a cache
+	ctx = init_context(CP_LOG_ERROR, &errors);
+	start = clock();
+	check(cp_register_pcollection(ctx, SERIALIZATION_TMPDIR) == CP_OK);
+	check(cp_scan_plugins(ctx, CP_SP_UPGRADE) == CP_OK);
+	scan = elapsed_ms(start);
+	check(cp_get_plugin_state(ctx, "plugin.video.test999") == CP_PLUGIN_INSTALLED);
+	cp_destroy();
+
+	// and with it, checking each descriptor is unchanged first
+	ctx = init_context(CP_LOG_ERROR, &errors);
+	start = clock();
+	for (i = 0; i < count; i++) {
+		sprintf(path, "%s" CP_FNAMESEP_STR "plugin%d" CP_FNAMESEP_STR "addon.xml", SERIALIZATION_TMPDIR, i);
+		check(stat(path, &st) == 0);
+		check((plugin = cp_load_plugin_descriptor_from_serialized(ctx, cache[i], cache_len[i], &status)) != NULL);
+		check(cp_install_plugin(ctx, plugin) == CP_OK);
+		cp_release_info(ctx, plugin);
+	}
+	cached = elapsed_ms(start);
+	check(cp_get_plugin_state(ctx, "plugin.video.test999") == CP_PLUGIN_INSTALLED);
+	cp_destroy();
+	check(errors == 0);
+
+	printf("%d plug-ins: scanning %.1f ms, from serialized descriptors %.1f ms\n", count, scan, cached);
+	for (i = 0; i < count; i++) {
+		free(cache[i]);
+	}
+	free(cache);
+	free(cache_len);
+}
@@ -0,0 +1,161 @@
+#!/usr/bin/python
+#
+#      Copyright (C) 2005-2011 Team XBMC
+#      http://www.xbmc.org
+#
+#  This Program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2, or (at your option)
+#  any later version.
+#
+#  This Program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with XBMC; see the file COPYING.  If not, write to
+#  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+#  http://www.gnu.org/copyleft/gpl.html
+#
+
+# Load test for the JSON-RPC TCP server. Opens many connections at once, has
+# each of them send requests one after the other and reports the throughput
+# and the latency of the responses. Announcements sent to the connections
+# are counted but otherwise ignored.
+#
+#   jsonrpc-loadtest.py --connections 200 --requests 50
+#   jsonrpc-loadtest.py --method VideoLibrary.GetMovies --params '{"fields": ["title"]}'
+
+import json
+import optparse
+import socket
+import sys
+import threading
+import time
+
+class Framer:
+  """Splits the JSON texts received on a connection, as the server does."""
+  def __init__(self):
+    self.depth = 0
+    self.in_string = False
+    self.escaped = False
+    self.buffer = []
+
+  def push(self, data):
+    texts = []
+    for c in data:
+      if self.depth == 0:
+        if c not in '{[':
+          continue
+        self.depth = 1
+      elif self.in_string:
+        if self.escaped:
+          self.escaped = False
+        elif c == '\\':
+          self.escaped = True
+        elif c == '"':
+          self.in_string = False
+      elif c == '"':
+        self.in_string = True
+      elif c in '{[':
+        self.depth += 1
+      elif c in '}]':
+        self.depth -= 1
+      self.buffer.append(c)
+      if self.depth == 0:
+        texts.append(''.join(self.buffer))
+        self.buffer = []
+    return texts
+
+class Connection(threading.Thread):
+  def __init__(self, options, start_event):
+    threading.Thread.__init__(self)
+    self.options = options
+    self.start_event = start_event
+    self.latencies = []
+    self.errors = 0
+    self.announcements = 0
+    self.received = 0
+    self.failure = None
+
+  def run(self):
+    try:
+      sock = socket.create_connection((self.options.host, self.options.port))
+    except socket.error:
+      self.failure = sys.exc_info()[1]
+      return
+
+    framer = Framer()
+    params = json.loads(self.options.params)
+    self.start_event.wait()
+    try:
+      for i in range(self.options.requests):
+        request = json.dumps({'jsonrpc': '2.0', 'method': self.options.method, 'params': params, 'id': i})
+        start = time.time()
+        sock.sendall(request.encode('utf-8'))
+        response = None
+        while response is None:
+          data = sock.recv(65536)
+          if not data:
+            raise socket.error('connection closed by the server')
+          self.received += len(data)
+          for text in framer.push(data.decode('utf-8', 'replace')):
+            message = json.loads(text)
+            if 'id' not in message:
+              self.announcements += 1
+            elif message['id'] == i:
+              response = message
+        self.latencies.append(time.time() - start)
+        if 'error' in response:
+          self.errors += 1
+    except (socket.error, ValueError):
+      self.failure = sys.exc_info()[1]
+    sock.close()
+
+def percentile(values, fraction):
+  return values[min(len(values) - 1, int(len(values) * fraction))]
+
+def main():
+  parser = optparse.OptionParser()
+  parser.add_option('--host', default='localhost')
+  parser.add_option('--port', type='int', default=9090)
+  parser.add_option('--connections', type='int', default=100, help='connections open at the same time')
+  parser.add_option('--requests', type='int', default=100, help='requests sent on each connection')
+  parser.add_option('--method', default='JSONRPC.Ping')
+  parser.add_option('--params', default='{}', help='parameters of the requests as JSON')
+  options = parser.parse_args()[0]
+
+  start_event = threading.Event()
+  connections = [Connection(options, start_event) for i in range(options.connections)]
+  for connection in connections:
+    connection.start()
+
+  # let all connections get established before sending anything
+  time.sleep(1)
+  start = time.time()
+  start_event.set()
+  for connection in connections:
+    connection.join()
+  elapsed = time.time() - start
+
+  latencies = []
+  for connection in connections:
+    latencies.extend(connection.latencies)
+  latencies.sort()
+  failed = [c for c in connections if c.failure is not None]
+
+  print('%d connections, %d requests in %.2fs: %.1f requests/s, %d kB received' %
+        (len(connections), len(latencies), elapsed, len(latencies) / elapsed,
+         sum([c.received for c in connections]) / 1024))
+  print('%d error responses, %d announcements, %d connections failed' %
+        (sum([c.errors for c in connections]), sum([c.announcements for c in connections]), len(failed)))
+  if failed:
+    print('first failure: %s' % failed[0].failure)
+  if latencies:
+    print('latency ms: min %.2f, avg %.2f, 50%% %.2f, 95%% %.2f, 99%% %.2f, max %.2f' %
+          (latencies[0] * 1000, sum(latencies) / len(latencies) * 1000, percentile(latencies, 0.5) * 1000,
+           percentile(latencies, 0.95) * 1000, percentile(latencies, 0.99) * 1000, latencies[-1] * 1000))
+
+if __name__ == '__main__':
+  main()
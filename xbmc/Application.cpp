@@ -39,6 +39,7 @@
 #include "guilib/GUIControlProfiler.h"
 #include "utils/LangCodeExpander.h"
 #include "GUIInfoManager.h"
+#include "dbwrappers/DatabasePool.h"
 #include "playlists/PlayListFactory.h"
 #include "guilib/GUIFontManager.h"
 #include "guilib/GUIColorManager.h"
@@ -265,8 +266,14 @@
 
 #include "storage/MediaManager.h"
 #include "utils/JobManager.h"
+#include "utils/TaskGraph.h"
+#include "utils/StartupTrace.h"
 #include "utils/SaveFileStateJob.h"
 #include "utils/AlarmClock.h"
+#include "threads/TimerWheel.h"
+#ifdef XBMC_LOCK_PROFILER
+#include "threads/LockProfiler.h"
+#endif
 
 #ifdef _LINUX
 #include "XHandle.h"
@@ -445,6 +452,76 @@ void CApplication::Preflight()
 #endif
 }
 
+// Runs a step of startup as a task of a CTaskGraph
+class CStartupJob : public CJob
+{
+public:
+  CStartupJob(bool (*step)()) : m_step(step) {}
+  virtual bool DoWork() { return m_step(); }
+private:
+  bool (*m_step)();
+};
+
+class CLoadSkinStringsJob : public CJob
+{
+public:
+  CLoadSkinStringsJob(const CStdString &path, const CStdString &fallbackPath) : m_path(path), m_fallbackPath(fallbackPath) {}
+  virtual bool DoWork() { return g_localizeStrings.LoadSkinStrings(m_path, m_fallbackPath); }
+private:
+  CStdString m_path;
+  CStdString m_fallbackPath;
+};
+
+static CStdString GetLanguageFile(const char *file)
+{
+  CStdString strLanguage = g_guiSettings.GetString("locale.language");
+  strLanguage[0] = toupper(strLanguage[0]);
+
+  CStdString strPath;
+  strPath.Format("special://xbmc/language/%s/%s", strLanguage.c_str(), file);
+  return strPath;
+}
+
+static bool LoadLangInfo()
+{
+  // Load the langinfo to have user charset <-> utf-8 conversion
+  CStdString strLangInfoPath = GetLanguageFile("langinfo.xml");
+  CLog::Log(LOGINFO, "load language info file: %s", strLangInfoPath.c_str());
+  g_langInfo.Load(strLangInfoPath);
+  return true;
+}
+
+static bool LoadLanguageStrings()
+{
+  CStdString strLanguagePath = GetLanguageFile("strings.xml");
+  CLog::Log(LOGINFO, "load language file:%s", strLanguagePath.c_str());
+  return g_localizeStrings.Load(strLanguagePath);
+}
+
+static bool InitAddons()
+{
+  // start-up Addons Framework
+  // currently bails out if either cpluff Dll is unavailable or system dir can not be scanned
+  if (!CAddonMgr::Get().Init())
+  {
+    CLog::Log(LOGFATAL, "CApplication::Create: Unable to start CAddonMgr");
+    return false;
+  }
+  return true;
+}
+
+static bool LoadKeymaps()
+{
+  CLog::Log(LOGINFO, "load keymapping");
+  return CButtonTranslator::GetInstance().Load();
+}
+
+static bool OpenTextureDatabase()
+{
+  CTextureCache::Get().Initialize();
+  return true;
+}
+
 bool CApplication::Create()
 {
   g_settings.Initialize(); //Initialize default AdvancedSettings
@@ -602,6 +679,7 @@ bool CApplication::Create()
 
   CLog::Log(LOGNOTICE, "load settings...");
 
+  int64_t settingsStart = CurrentHostCounter();
   g_guiSettings.Initialize();  // Initialize default Settings - don't move
   g_powerManager.SetDefaults();
   if (!g_settings.Load())
@@ -614,36 +692,25 @@ bool CApplication::Create()
   CDirectory::Create(g_settings.GetUserDataFolder());
   CDirectory::Create(g_settings.GetProfileUserDataFolder());
   g_settings.CreateProfileFolders();
+  CStartupTrace::Get().Add("settings", settingsStart, CurrentHostCounter());
 
   update_emu_environ();//apply the GUI settings
 
   // initialize our charset converter
   g_charsetConverter.reset();
 
-  // Load the langinfo to have user charset <-> utf-8 conversion
-  CStdString strLanguage = g_guiSettings.GetString("locale.language");
-  strLanguage[0] = toupper(strLanguage[0]);
-
-  CStdString strLangInfoPath;
-  strLangInfoPath.Format("special://xbmc/language/%s/langinfo.xml", strLanguage.c_str());
-
-  CLog::Log(LOGINFO, "load language info file: %s", strLangInfoPath.c_str());
-  g_langInfo.Load(strLangInfoPath);
-
-  CStdString strLanguagePath;
-  strLanguagePath.Format("special://xbmc/language/%s/strings.xml", strLanguage.c_str());
+  // The steps below only read files and don't depend on the window or the render
+  // system, so run them alongside creating those. Nothing may use their results
+  // before waiting for them.
+  CTaskGraph startup(g_advancedSettings.m_parallelStartup);
+  startup.Add("langinfo", new CStartupJob(LoadLangInfo));
+  startup.Add("strings", new CStartupJob(LoadLanguageStrings), "langinfo");
+  startup.Add("addons", new CStartupJob(InitAddons), "langinfo");
+  startup.Add("keymaps", new CStartupJob(LoadKeymaps));
+  startup.Add("texture database", new CStartupJob(OpenTextureDatabase));
+  startup.Start();
 
-  CLog::Log(LOGINFO, "load language file:%s", strLanguagePath.c_str());
-  if (!g_localizeStrings.Load(strLanguagePath))
-    FatalErrorHandler(false, false, true);
-
-  // start-up Addons Framework
-  // currently bails out if either cpluff Dll is unavailable or system dir can not be scanned
-  if (!CAddonMgr::Get().Init())
-  {
-    CLog::Log(LOGFATAL, "CApplication::Create: Unable to start CAddonMgr");
-    FatalErrorHandler(true, true, true);
-  }
+  int64_t windowStart = CurrentHostCounter();
 
   // Create the Mouse, Keyboard, Remote, and Joystick devices
   // Initialize after loading settings to get joystick deadzone setting
@@ -719,9 +786,13 @@ bool CApplication::Create()
     m_splash->Show();
   }
 
-  CLog::Log(LOGINFO, "load keymapping");
-  if (!CButtonTranslator::GetInstance().Load())
+  CStartupTrace::Get().Add("window", windowStart, CurrentHostCounter());
+
+  if (!startup.Wait("strings") || !startup.Wait("keymaps"))
     FatalErrorHandler(false, false, true);
+  if (!startup.Wait("addons"))
+    FatalErrorHandler(true, true, true);
+  startup.WaitAll();
 
   int iResolution = g_graphicsContext.GetVideoResolution();
   CLog::Log(LOGINFO, "GUI format %ix%i %s",
@@ -1051,7 +1122,10 @@ bool CApplication::Initialize()
   }
 #endif
 
-  StartServices();
+  {
+    TRACE_STARTUP_PHASE("services")
+    StartServices();
+  }
 
   // Init DPMS, before creating the corresponding setting control.
   m_dpms = new DPMSSupport();
@@ -1155,12 +1229,15 @@ bool CApplication::Initialize()
   /* window id's 3000 - 3100 are reserved for python */
 
   /* start the audio engine */
+  {
+    TRACE_STARTUP_PHASE("audio engine")
 #ifdef __APPLE__
-  CAEFactory::LoadEngine(AE_ENGINE_COREAUDIO);
+    CAEFactory::LoadEngine(AE_ENGINE_COREAUDIO);
 #else
-  CAEFactory::LoadEngine(AE_ENGINE_SOFT);
+    CAEFactory::LoadEngine(AE_ENGINE_SOFT);
 #endif
-  SetHardwareVolume(CAEFactory::AE->GetVolume());
+    SetHardwareVolume(CAEFactory::AE->GetVolume());
+  }
 
   // Make sure we have at least the default skin
   if (!LoadSkin(g_guiSettings.GetString("lookandfeel.skin")) && !LoadSkin(DEFAULT_SKIN))
@@ -1218,6 +1295,7 @@ bool CApplication::Initialize()
   CAddonMgr::Get().StartServices(false);
 
   CLog::Log(LOGNOTICE, "initialize done");
+  CStartupTrace::Get().Finish();
 
   m_bInitializing = false;
 
@@ -1634,11 +1712,8 @@ void CApplication::LoadSkin(const SkinPtr& skin)
     else
       CLog::Log(LOGERROR, "    no ttf font found, but needed for the language %s.", g_guiSettings.GetString("locale.language").c_str());
   }
-  g_colorManager.Load(g_guiSettings.GetString("lookandfeel.skincolors"));
-
-  g_fontManager.LoadFonts(g_guiSettings.GetString("lookandfeel.font"));
 
-  // load in the skin strings
+  // load in the skin strings while the fonts are loaded, which needs the render thread
   CStdString langPath, skinEnglishPath;
   URIUtils::AddFileToFolder(skin->Path(), "language", langPath);
   URIUtils::AddFileToFolder(langPath, g_guiSettings.GetString("locale.language"), langPath);
@@ -1648,7 +1723,20 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   URIUtils::AddFileToFolder(skinEnglishPath, "English", skinEnglishPath);
   URIUtils::AddFileToFolder(skinEnglishPath, "strings.xml", skinEnglishPath);
 
-  g_localizeStrings.LoadSkinStrings(langPath, skinEnglishPath);
+  CTaskGraph tasks(g_advancedSettings.m_parallelStartup);
+  tasks.Add("skin strings", new CLoadSkinStringsJob(langPath, skinEnglishPath));
+  tasks.Start();
+
+  {
+    TRACE_STARTUP_PHASE("colors")
+    g_colorManager.Load(g_guiSettings.GetString("lookandfeel.skincolors"));
+  }
+  {
+    TRACE_STARTUP_PHASE("fonts")
+    g_fontManager.LoadFonts(g_guiSettings.GetString("lookandfeel.font"));
+  }
+
+  tasks.WaitAll();
 
   int64_t start;
   start = CurrentHostCounter();
@@ -1675,6 +1763,7 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   end = CurrentHostCounter();
   freq = CurrentHostFrequency();
   CLog::Log(LOGDEBUG,"Load Skin XML: %.2fms", 1000.f * (end - start) / freq);
+  CStartupTrace::Get().Add("skin xml", start, end);
 
   CLog::Log(LOGINFO, "  initialize new skin...");
   g_windowManager.AddMsgTarget(this);
@@ -1724,7 +1813,9 @@ void CApplication::UnloadSkin(bool forReload /* = false */)
   g_audioManager.Enable(false);
 
   g_windowManager.DeInitialize();
-  CTextureCache::Get().Deinitialize();
+  // at startup the texture database was opened ahead of the first skin
+  if (g_SkinInfo)
+    CTextureCache::Get().Deinitialize();
 
   // remove the skin-dependent window
   g_windowManager.Delete(WINDOW_DIALOG_FULLSCREEN_INFO);
@@ -3203,7 +3294,8 @@ void CApplication::Stop(int exitCode)
     // cancel any jobs from the jobmanager
     CJobManager::GetInstance().CancelJobs();
 
-    g_alarmClock.StopThread();
+    // alarms and delayed messages run off the timer thread
+    CTimerWheel::Get().Stop();
 
 #ifdef HAS_HTTPAPI
     if (m_pXbmcHttp)
@@ -3247,6 +3339,9 @@ void CApplication::Stop(int exitCode)
 
     m_applicationMessenger.Cleanup();
 
+    // deliver OnQuit and anything else still queued while the servers are up
+    CAnnouncementManager::Deinitialize();
+
     StopServices();
     //Sleep(5000);
 
@@ -3310,6 +3405,9 @@ void CApplication::Stop(int exitCode)
   CLog::Log(LOGNOTICE, "stop python");
   g_pythonParser.FreeResources();
 #endif
+
+    CDatabasePool::Get().Deinitialize();
+
 #ifdef HAS_LCD
     if (g_lcd)
     {
@@ -3328,6 +3426,10 @@ void CApplication::Stop(int exitCode)
     CAEFactory::LoadEngine(AE_ENGINE_NULL);
 #endif
 
+#ifdef XBMC_LOCK_PROFILER
+    XbmcThreads::CLockProfiler::Get().Dump();
+#endif
+
     CLog::Log(LOGNOTICE, "stopped");
   }
   catch (...)
@@ -68,27 +68,6 @@
 
 using namespace std;
 
-CDelayedMessage::CDelayedMessage(ThreadMessage& msg, unsigned int delay)
-{
-  m_msg.dwMessage  = msg.dwMessage;
-  m_msg.dwParam1   = msg.dwParam1;
-  m_msg.dwParam2   = msg.dwParam2;
-  m_msg.waitEvent  = msg.waitEvent;
-  m_msg.lpVoid     = msg.lpVoid;
-  m_msg.strParam   = msg.strParam;
-  m_msg.params     = msg.params;
-
-  m_delay = delay;
-}
-
-void CDelayedMessage::Process()
-{
-  Sleep(m_delay);
-
-  if (!m_bStop)
-    g_application.getApplicationMessenger().SendMessage(m_msg, false);
-}
-
 CApplicationMessenger::~CApplicationMessenger()
 {
   Cleanup();
@@ -98,6 +77,9 @@ void CApplicationMessenger::Cleanup()
 {
   CSingleLock lock (m_critSection);
 
+  // the timers of delayed messages may still fire, they find nothing to send
+  m_delayedMessages.clear();
+
   while (m_vecMessages.size() > 0)
   {
     ThreadMessage* pMsg = m_vecMessages.front();
@@ -121,6 +103,28 @@ void CApplicationMessenger::Cleanup()
   }
 }
 
+void CApplicationMessenger::SendMessageDelayed(ThreadMessage& message, unsigned int delay)
+{
+  CSingleLock lock (m_critSection);
+  unsigned int timerID = CTimerWheel::Get().Schedule(this, delay);
+  if (timerID)
+    m_delayedMessages.insert(make_pair(timerID, message));
+}
+
+void CApplicationMessenger::OnTimer(unsigned int timerID)
+{
+  ThreadMessage msg;
+  {
+    CSingleLock lock (m_critSection);
+    map<unsigned int, ThreadMessage>::iterator it = m_delayedMessages.find(timerID);
+    if (it == m_delayedMessages.end())
+      return;
+    msg = it->second;
+    m_delayedMessages.erase(it);
+  }
+  SendMessage(msg, false);
+}
+
 void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
 {
   message.waitEvent.reset();
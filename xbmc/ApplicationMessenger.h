@@ -24,9 +24,10 @@
 #include "threads/CriticalSection.h"
 #include "utils/StdString.h"
 #include "guilib/Key.h"
-#include "threads/Thread.h"
 #include "threads/Event.h"
+#include "threads/TimerWheel.h"
 
+#include <map>
 #include <queue>
 
 class CFileItem;
@@ -106,24 +107,13 @@ typedef struct
 }
 ThreadMessage;
 
-class CDelayedMessage : public CThread
-{
-  public:
-    CDelayedMessage(ThreadMessage& msg, unsigned int delay);
-    virtual void Process();
-
-  private:
-    unsigned int   m_delay;
-    ThreadMessage  m_msg;
-};
-
 struct ThreadMessageCallback
 {
   void (*callback)(void *userptr);
   void *userptr;
 };
 
-class CApplicationMessenger
+class CApplicationMessenger : public ITimerCallback
 {
 
 public:
@@ -132,6 +122,8 @@ public:
   void Cleanup();
   // if a message has to be send to the gui, use MSG_TYPE_WINDOW instead
   void SendMessage(ThreadMessage& msg, bool wait = false);
+  // sends the message once delay ms have passed, the delay is kept by the shared timer thread
+  void SendMessageDelayed(ThreadMessage& msg, unsigned int delay);
   void ProcessMessages(); // only call from main thread.
   void ProcessWindowMessages();
 
@@ -195,12 +187,15 @@ public:
 
   void ShowVolumeBar(bool up);
 
+  virtual void OnTimer(unsigned int timerID);
+
 private:
   void ProcessMessage(ThreadMessage *pMsg);
 
 
   std::queue<ThreadMessage*> m_vecMessages;
   std::queue<ThreadMessage*> m_vecWindowMessages;
+  std::map<unsigned int, ThreadMessage> m_delayedMessages; // by timer id
   CCriticalSection m_critSection;
   CCriticalSection m_critBuffer;
   CStdString bufferResponse;
@@ -971,7 +971,7 @@ CStdString CFileItem::GetCachedActorThumb() const
 void CFileItem::SetCachedArtistThumb()
 {
   CStdString thumb(GetCachedArtistThumb());
-  if (CFile::Exists(thumb))
+  if (CThumbnailCache::GetThumbnailCache()->FileExists(thumb))
   {
     // found it, we are finished.
     SetThumbnailImage(thumb);
@@ -991,7 +991,7 @@ void CFileItem::SetMusicThumb(bool alwaysCheckRemote /* = true */)
 void CFileItem::SetCachedSeasonThumb()
 {
   CStdString thumb(GetCachedSeasonThumb());
-  if (CFile::Exists(thumb))
+  if (CThumbnailCache::GetThumbnailCache()->FileExists(thumb))
   {
     // found it, we are finished.
     SetThumbnailImage(thumb);
@@ -2408,7 +2408,7 @@ CStdString CFileItem::GetPreviouslyCachedMusicThumb() const
   {
     // try permanent album thumb using "album name + artist name"
     CStdString thumb(CThumbnailCache::GetAlbumThumb(strAlbum, strArtist));
-    if (CFile::Exists(thumb))
+    if (CThumbnailCache::GetThumbnailCache()->FileExists(thumb))
       return thumb;
   }
 
@@ -2417,7 +2417,7 @@ CStdString CFileItem::GetPreviouslyCachedMusicThumb() const
   {
     // look for locally cached tbn
     CStdString thumb(CThumbnailCache::GetMusicThumb(m_strPath));
-    if (CFile::Exists(thumb))
+    if (CThumbnailCache::GetThumbnailCache()->FileExists(thumb))
       return thumb;
   }
 
@@ -2431,7 +2431,7 @@ CStdString CFileItem::GetPreviouslyCachedMusicThumb() const
   URIUtils::RemoveSlashAtEnd(strPath);
 
   CStdString thumb(CThumbnailCache::GetMusicThumb(strPath));
-  if (CFile::Exists(thumb))
+  if (CThumbnailCache::GetThumbnailCache()->FileExists(thumb))
     return thumb;
 
   return "";
@@ -2514,11 +2514,11 @@ void CFileItem::SetCachedVideoThumb()
   CStdString cachedThumb(GetCachedVideoThumb());
   if (HasVideoInfoTag() && !m_bIsFolder  &&
       GetVideoInfoTag()->m_iEpisode > -1 &&
-      CFile::Exists(GetCachedEpisodeThumb()))
+      CThumbnailCache::GetThumbnailCache()->FileExists(GetCachedEpisodeThumb()))
   {
     SetThumbnailImage(GetCachedEpisodeThumb());
   }
-  else if (CFile::Exists(cachedThumb))
+  else if (CThumbnailCache::GetThumbnailCache()->FileExists(cachedThumb))
     SetThumbnailImage(cachedThumb);
 }
 
@@ -2713,7 +2713,7 @@ bool CFileItem::CacheLocalFanart() const
 {
   // first check for an already cached fanart image
   CStdString cachedFanart(GetCachedFanart());
-  if (CFile::Exists(cachedFanart))
+  if (CThumbnailCache::GetThumbnailCache()->FileExists(cachedFanart))
     return true;
 
   // we don't have a cached image, so let's see if the user has a local image, and cache it if so
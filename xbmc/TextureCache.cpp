@@ -32,6 +32,7 @@
 #include "pictures/Picture.h"
 #include "guilib/TextureManager.h"
 #include "utils/URIUtils.h"
+#include "ThumbnailCache.h"
 
 using namespace XFILE;
 
@@ -184,7 +185,7 @@ CStdString CTextureCache::CheckAndCacheImage(const CStdString &url, bool returnD
     if (returnDDS && !URIUtils::IsInPath(url, "special://skin/")) // TODO: should skin images be .dds'd (currently they're not necessarily writeable)
     { // check for dds version
       CStdString ddsPath = URIUtils::ReplaceExtension(path, ".dds");
-      if (CFile::Exists(ddsPath))
+      if (CThumbnailCache::GetThumbnailCache()->FileExists(ddsPath))
         return ddsPath;
       if (g_advancedSettings.m_useDDSFanart)
         AddJob(new CDDSJob(path));
@@ -254,10 +255,11 @@ void CTextureCache::ClearCachedImage(const CStdString &url, bool deleteSource /*
   CStdString cachedFile;
   if (ClearCachedTexture(url, cachedFile))
     path = GetCachedPath(cachedFile);
-  if (CFile::Exists(path))
+  CThumbnailCache *thumbs = CThumbnailCache::GetThumbnailCache();
+  if (thumbs->FileExists(path))
     CFile::Delete(path);
   path = URIUtils::ReplaceExtension(path, ".dds");
-  if (CFile::Exists(path))
+  if (thumbs->FileExists(path))
     CFile::Delete(path);
 }
 
@@ -34,6 +34,9 @@
 #include "utils/log.h"
 #include "programs/Shortcut.h"
 #include "video/VideoInfoTag.h"
+#include "video/VideoDatabase.h"
+#include "settings/Settings.h"
+#include "Util.h"
 
 #include "cores/dvdplayer/DVDFileInfo.h"
 
@@ -155,6 +158,68 @@ bool CThumbExtractor::DoWork()
   return result;
 }
 
+CThumbBatchExtractor::CThumbBatchExtractor(const CStdString& path, bool chapters)
+{
+  m_path = path;
+  m_chapters = chapters;
+}
+
+CThumbBatchExtractor::~CThumbBatchExtractor()
+{
+}
+
+bool CThumbBatchExtractor::DoWork()
+{
+  CThumbExtractStats total;
+  unsigned int skipped = 0;
+
+  // listing a large tree can take a while, so it's done here rather than by the caller
+  CFileItemList items;
+  CUtil::GetRecursiveListing(m_path, items, g_settings.m_videoExtensions);
+
+  CVideoDatabase db;
+  bool dbOpen = db.Open();
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (ShouldCancel(i, items.Size()))
+      break;
+
+    CFileItem item(*items[i]);
+    if (item.m_bIsFolder || !item.IsVideo() || item.IsInternetStream() || item.IsPlayList()
+    ||  item.IsDVD() || item.IsDVDImage() || item.IsDVDFile(false, true))
+      continue;
+
+    CStdString path = item.m_strPath;
+    if (URIUtils::IsStack(path))
+      path = CStackDirectory::GetFirstStackedFile(path);
+
+    CStdString strPath, strFileName;
+    URIUtils::Split(item.GetCachedVideoThumb(), strPath, strFileName);
+    CStdString chapterTarget = strPath + "auto-" + strFileName;
+    CStdString target = chapterTarget;
+    if (CFile::Exists(target))
+    {
+      skipped++;
+      if (!m_chapters)
+        continue;
+      target.clear();
+    }
+
+    CStreamDetails details;
+    CDVDFileInfo::ExtractThumbs(path, target, m_chapters ? chapterTarget : "", &details, &total);
+    if (dbOpen && details.HasItems())
+      db.SetStreamDetailsForFile(details, item.m_strPath);
+  }
+
+  if (dbOpen)
+    db.Close();
+
+  CLog::Log(LOGINFO, "%s - extracted %u thumbs from %u files in %u ms, %u skipped (open %u, seek %u, decode %u, scale %u ms)",
+            __FUNCTION__, total.thumbs, total.files, total.total, skipped, total.open, total.seek, total.decode, total.scale);
+  return total.thumbs > 0;
+}
+
 CVideoThumbLoader::CVideoThumbLoader() :
   CThumbLoader(1), CJobQueue(true), m_pStreamDetailsObs(NULL)
 {
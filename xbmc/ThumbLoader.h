@@ -61,6 +61,36 @@ public:
   bool       m_thumb; ///< extract thumb?
 };
 
+/*!
+ \ingroup thumbs,jobs
+ \brief Batch thumb extractor job class
+
+ Extracts the auto thumbs and stream details of all videos below a path in a single job,
+ skipping files that already have an auto thumb. Optionally a thumb per chapter is
+ extracted as well. Per file and total timings are logged.
+
+ \sa CThumbExtractor and CJob
+ */
+class CThumbBatchExtractor : public CJob
+{
+public:
+  CThumbBatchExtractor(const CStdString& path, bool chapters = false);
+  virtual ~CThumbBatchExtractor();
+
+  /*!
+   \brief Work function that extracts the thumbs.
+   */
+  virtual bool DoWork();
+
+  virtual const char* GetType() const
+  {
+    return "thumbbatch";
+  }
+
+  CStdString m_path;  ///< folder the videos to extract thumbs from are in
+  bool       m_chapters; ///< extract chapter thumbs as well?
+};
+
 class CThumbLoader : public CBackgroundInfoLoader
 {
 public:
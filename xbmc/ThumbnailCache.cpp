@@ -32,7 +32,12 @@
 #include "settings/Settings.h"
 #include "utils/URIUtils.h"
 #include "utils/Crc32.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
 #include "filesystem/StackDirectory.h"
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
 
 using namespace std;
 using namespace XFILE;
@@ -42,11 +47,58 @@ CThumbnailCache* CThumbnailCache::m_pCacheInstance = NULL;
 
 CCriticalSection CThumbnailCache::m_cs;
 
+/*!
+ \brief Lists the files in the thumbnails folder and its subfolders.
+ */
+class CThumbnailIndexJob : public CJob
+{
+public:
+  CThumbnailIndexJob(const CStdString &root) : m_root(root) {}
+
+  virtual const char *GetType() const { return "thumbnailindex"; };
+
+  virtual bool DoWork()
+  {
+    return Scan(m_root);
+  }
+
+  std::vector<CStdString> m_files;
+
+private:
+  bool Scan(const CStdString &folder)
+  {
+    CFileItemList items;
+    if (!CDirectory::GetDirectory(folder, items, "", false, false, DIR_CACHE_NEVER, false))
+      return false;
+    for (int i = 0; i < items.Size(); i++)
+    {
+      const CFileItemPtr item = items[i];
+      if (ShouldCancel(0, 0))
+        return false;
+      if (item->m_bIsFolder)
+      {
+        // a partial index would report thumbs that are there as missing
+        if (!Scan(item->m_strPath))
+          return false;
+      }
+      else
+        m_files.push_back(item->m_strPath);
+    }
+    return true;
+  }
+
+  CStdString m_root;
+};
+
 CThumbnailCache::~CThumbnailCache()
 {}
 
 CThumbnailCache::CThumbnailCache()
 {
+  m_indexReady = false;
+  m_indexJob = 0;
+  m_statsAvoided = 0;
+  m_statsMade = 0;
 }
 
 CThumbnailCache* CThumbnailCache::GetThumbnailCache()
@@ -69,7 +121,7 @@ bool CThumbnailCache::ThumbExists(const CStdString& strFileName, bool bAddCache
   if (it != m_Cache.end())
     return it->second;
 
-  bool bExists = CFile::Exists(strFileName);
+  bool bExists = FileExists(strFileName);
 
   if (bAddCache)
     Add(strFileName, bExists);
@@ -89,13 +141,10 @@ void CThumbnailCache::Clear()
 {
   CSingleLock lock (m_cs);
 
-  if (m_pCacheInstance != NULL)
-  {
-    m_Cache.erase(m_Cache.begin(), m_Cache.end());
-    delete m_pCacheInstance;
-  }
-
-  m_pCacheInstance = NULL;
+  // the instance stays around as it holds the index of the thumbnails folder
+  m_Cache.clear();
+  CLog::Log(LOGDEBUG, "%s - %u thumbnail lookups answered from the index, %u stat'ed",
+            __FUNCTION__, m_statsAvoided, m_statsMade);
 }
 
 void CThumbnailCache::Add(const CStdString& strFileName, bool bExists)
@@ -110,6 +159,109 @@ void CThumbnailCache::Add(const CStdString& strFileName, bool bExists)
     m_Cache.insert(pair<CStdString, bool>(strFileName, bExists));
 }
 
+CStdString CThumbnailCache::NormalizePath(const CStdString &path)
+{
+  CStdString normalized = CSpecialProtocol::TranslatePath(path);
+#ifdef _WIN32
+  normalized.Replace('\\', '/');
+  normalized.ToLower();
+#endif
+  return normalized;
+}
+
+bool CThumbnailCache::InIndex(const CStdString &normalizedPath) const
+{
+  return !m_indexRoot.IsEmpty() && normalizedPath.size() > m_indexRoot.size() &&
+         normalizedPath.compare(0, m_indexRoot.size(), m_indexRoot) == 0;
+}
+
+bool CThumbnailCache::FileExists(const CStdString &path)
+{
+  if (path.IsEmpty())
+    return false;
+
+  CStdString normalized = NormalizePath(path);
+  {
+    CSingleLock lock(m_indexSection);
+    if (m_indexReady && InIndex(normalized))
+    {
+      m_statsAvoided++;
+      return m_index.find(normalized) != m_index.end();
+    }
+    m_statsMade++;
+  }
+  return CFile::Exists(path);
+}
+
+void CThumbnailCache::BuildIndex()
+{
+  CSingleLock lock(m_indexSection);
+  if (m_indexJob)
+    CJobManager::GetInstance().CancelJob(m_indexJob);
+  m_index.clear();
+  m_removed.clear();
+  m_indexReady = false;
+  m_indexJob = 0;
+  m_indexRoot.clear();
+  if (!g_advancedSettings.m_useThumbnailIndex)
+    return;
+
+  m_indexRoot = NormalizePath(g_settings.GetThumbnailsFolder());
+  if (!m_indexRoot.IsEmpty() && m_indexRoot[m_indexRoot.size() - 1] != '/')
+    m_indexRoot += '/';
+  m_indexJob = CJobManager::GetInstance().AddJob(new CThumbnailIndexJob(g_settings.GetThumbnailsFolder()), this);
+}
+
+void CThumbnailCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_indexSection);
+  if (jobID != m_indexJob)
+    return; // superseded by a newer index
+
+  m_indexJob = 0;
+  if (!success)
+  {
+    // keep stat'ing rather than trusting a partial index
+    CLog::Log(LOGERROR, "%s - unable to index %s", __FUNCTION__, m_indexRoot.c_str());
+    m_index.clear();
+    m_removed.clear();
+    return;
+  }
+
+  // files written while indexing are in the index already, those deleted must not be added
+  const vector<CStdString> &files = ((CThumbnailIndexJob *)job)->m_files;
+  for (vector<CStdString>::const_iterator i = files.begin(); i != files.end(); ++i)
+  {
+    CStdString normalized = NormalizePath(*i);
+    if (m_removed.find(normalized) == m_removed.end())
+      m_index.insert(normalized);
+  }
+  m_removed.clear();
+  m_indexReady = true;
+  CLog::Log(LOGDEBUG, "%s - indexed %u thumbnails in %s", __FUNCTION__, (unsigned int)m_index.size(), m_indexRoot.c_str());
+}
+
+void CThumbnailCache::OnFileWritten(const CStdString &path)
+{
+  CStdString normalized = NormalizePath(path);
+  CSingleLock lock(m_indexSection);
+  if (!InIndex(normalized))
+    return;
+  m_index.insert(normalized);
+  m_removed.erase(normalized);
+}
+
+void CThumbnailCache::OnFileDeleted(const CStdString &path)
+{
+  CStdString normalized = NormalizePath(path);
+  CSingleLock lock(m_indexSection);
+  if (!InIndex(normalized))
+    return;
+  m_index.erase(normalized);
+  if (!m_indexReady)
+    m_removed.insert(normalized);
+}
+
 CStdString CThumbnailCache::GetAlbumThumb(const CFileItem &item)
 {
   return GetAlbumThumb(item.GetMusicInfoTag());
@@ -21,10 +21,12 @@
  */
 
 #include "utils/StdString.h"
+#include "utils/Job.h"
+#include "threads/CriticalSection.h"
 
 #include <map>
+#include <set>
 
-class CCriticalSection;
 class CVideoInfoTag;
 namespace MUSIC_INFO 
 {
@@ -34,7 +36,7 @@ class CAlbum;
 class CArtist;
 class CFileItem;
 
-class CThumbnailCache
+class CThumbnailCache : public IJobCallback
 {
 private:
   CThumbnailCache();
@@ -47,6 +49,29 @@ public:
   void Clear();
   bool IsCached(const CStdString& strFileName);
 
+  /*! \brief Check whether a file exists.
+   Files in the thumbnails folder are looked up in an index of the folder once it has been
+   built, rather than stat'ed. Files elsewhere, and all files until the index is ready, are stat'ed.
+   \param path the file to check.
+   \return true if the file exists.
+   \sa BuildIndex
+   */
+  bool FileExists(const CStdString &path);
+
+  /*! \brief Start indexing the thumbnails folder of the current profile in the background.
+   Called on startup and whenever the profile changes. Any previous index is dropped.
+   */
+  void BuildIndex();
+
+  /*! \brief Keep the index current, called whenever a file has been written or deleted. */
+  void OnFileWritten(const CStdString &path);
+  void OnFileDeleted(const CStdString &path);
+
+  unsigned int GetStatsAvoided() const { return m_statsAvoided; };
+  unsigned int GetStatsMade() const { return m_statsMade; };
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
   static CStdString GetMusicThumb(const CStdString &path);
   static CStdString GetAlbumThumb(const CFileItem &item);
   static CStdString GetAlbumThumb(const MUSIC_INFO::CMusicInfoTag *musicInfo);
@@ -71,4 +96,18 @@ protected:
   std::map<CStdString, bool> m_Cache;
 
   static CCriticalSection m_cs;
+
+private:
+  static CStdString NormalizePath(const CStdString &path);
+  bool InIndex(const CStdString &normalizedPath) const;
+
+  CCriticalSection     m_indexSection;
+  std::set<CStdString> m_index;        ///< normalized paths of the files in the thumbnails folder
+  std::set<CStdString> m_removed;      ///< files deleted while the index is being built
+  CStdString           m_indexRoot;    ///< normalized thumbnails folder, with trailing slash
+  bool                 m_indexReady;
+  unsigned int         m_indexJob;
+
+  unsigned int m_statsAvoided;
+  unsigned int m_statsMade;
 };
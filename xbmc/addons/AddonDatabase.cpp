@@ -84,6 +84,10 @@ bool CAddonDatabase::CreateTables()
     CLog::Log(LOGINFO, "create broken table");
     m_pDS->exec("CREATE TABLE broken (id integer primary key, addonID text, reason text)\n");
     m_pDS->exec("CREATE UNIQUE INDEX idxBroken ON broken(addonID)");
+
+    CLog::Log(LOGINFO, "create manifest table");
+    m_pDS->exec("CREATE TABLE manifest (id integer primary key, path text, mtime integer, addonID text, version text, descriptor text)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX idxManifest ON manifest(path)");
   }
   catch (...)
   {
@@ -109,6 +113,11 @@ bool CAddonDatabase::UpdateOldVersion(int version)
     {
       m_pDS->exec("ALTER TABLE addon add minversion text");
     }
+    if (version < 15)
+    {
+      m_pDS->exec("CREATE TABLE manifest (id integer primary key, path text, mtime integer, addonID text, version text, descriptor text)\n");
+      m_pDS->exec("CREATE UNIQUE INDEX idxManifest ON manifest(path)");
+    }
   }
   catch (...)
   {
@@ -695,3 +704,69 @@ bool CAddonDatabase::HasDisabledAddons()
   }
   return false;
 }
+
+bool CAddonDatabase::GetManifests(map<CStdString, CAddonManifest> &manifests)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    m_pDS->query("select path, mtime, addonID, version, descriptor from manifest");
+    while (!m_pDS->eof())
+    {
+      CAddonManifest &manifest = manifests[m_pDS->fv(0).get_asString()];
+      manifest.mtime      = m_pDS->fv(1).get_asInt64();
+      manifest.addonID    = m_pDS->fv(2).get_asString();
+      manifest.version    = m_pDS->fv(3).get_asString();
+      manifest.descriptor = m_pDS->fv(4).get_asString();
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CAddonDatabase::SetManifest(const CStdString &path, const CAddonManifest &manifest)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString sql = PrepareSQL("delete from manifest where path='%s'", path.c_str());
+    m_pDS->exec(sql);
+    sql = PrepareSQL("insert into manifest (id, path, mtime, addonID, version, descriptor) values(NULL, '%s', %I64d, '%s', '%s', '%s')",
+                     path.c_str(), manifest.mtime, manifest.addonID.c_str(), manifest.version.c_str(), manifest.descriptor.c_str());
+    m_pDS->exec(sql);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
+
+bool CAddonDatabase::DeleteManifest(const CStdString &path)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString sql = PrepareSQL("delete from manifest where path='%s'", path.c_str());
+    m_pDS->exec(sql);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on path '%s'", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
@@ -25,6 +25,21 @@
 #include "utils/StdString.h"
 #include "FileItem.h"
 
+#include <map>
+
+/*! \brief A parsed addon descriptor, as kept in the index of the addon database
+ \sa CAddonDatabase::GetManifests
+ */
+class CAddonManifest
+{
+public:
+  CAddonManifest() : mtime(0) {}
+  int64_t    mtime;      ///< modification time of the addon.xml it was parsed from
+  CStdString addonID;
+  CStdString version;
+  std::string descriptor; ///< the descriptor as serialized by c-pluff
+};
+
 class CAddonDatabase : public CDatabase
 {
 public:
@@ -94,10 +109,30 @@ public:
    \sa BreakAddon */
   CStdString IsAddonBroken(const CStdString &addonID);
 
+  /*! \brief Fetch the index of parsed addon descriptors
+   Addons whose addon.xml hasn't been modified since can be loaded from here without parsing it again.
+   \param manifests [out] the parsed descriptors by addon folder
+   \return true on success, false otherwise
+   \sa SetManifest, DeleteManifest */
+  bool GetManifests(std::map<CStdString, CAddonManifest> &manifests);
+
+  /*! \brief Store the parsed descriptor of an addon in the index
+   \param path the addon folder
+   \param manifest the parsed descriptor
+   \return true on success, false otherwise
+   \sa GetManifests, DeleteManifest */
+  bool SetManifest(const CStdString &path, const CAddonManifest &manifest);
+
+  /*! \brief Remove an addon folder that is gone from the index
+   \param path the addon folder
+   \return true on success, false otherwise
+   \sa GetManifests, SetManifest */
+  bool DeleteManifest(const CStdString &path);
+
 protected:
   virtual bool CreateTables();
   virtual bool UpdateOldVersion(int version);
-  virtual int GetMinVersion() const { return 14; }
+  virtual int GetMinVersion() const { return 15; }
   const char *GetBaseDBName() const { return "Addons"; }
 };
 
@@ -31,6 +31,12 @@
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "tinyXML/tinyxml.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+#include "utils/TimeUtils.h"
+#include <set>
 
 
 #ifdef HAS_VISUALISATION
@@ -236,9 +242,13 @@ bool CAddonMgr::Init()
   // would allow partial unloading of addon framework
   m_cp_context = m_cpluff->create_context(&status);
   assert(m_cp_context);
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://home/addons"));
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://xbmc/addons"));
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://xbmcbin/addons"));
+  // in order of precedence for addons of the same version
+  m_collections.clear();
+  m_collections.push_back("special://home/addons");
+  m_collections.push_back("special://xbmc/addons");
+  m_collections.push_back("special://xbmcbin/addons");
+  for (unsigned int i = 0; i < m_collections.size(); i++)
+    status = m_cpluff->register_pcollection(m_cp_context, _P(m_collections[i]));
   if (status != CP_OK)
   {
     CLog::Log(LOGERROR, "ADDONS: Fatal Error, cp_register_pcollection() returned status: %i", status);
@@ -433,8 +443,130 @@ CStdString CAddonMgr::GetString(const CStdString &id, const int number)
 void CAddonMgr::FindAddons()
 {
   CSingleLock lock(m_critSection);
-  if (m_cpluff && m_cp_context)
-    m_cpluff->scan_plugins(m_cp_context, CP_SP_UPGRADE);
+  if (!m_cpluff || !m_cp_context)
+    return;
+
+  // This does what cp_scan_plugins(CP_SP_UPGRADE) does, but only parses the addon.xml
+  // of addons that are new or modified since the last scan. The others are loaded from
+  // the index in the database, or skipped when c-pluff has them installed already.
+  int64_t start = CurrentHostCounter();
+  map<CStdString, CAddonManifest> manifests;
+  m_database.GetManifests(manifests);
+  bool indexChanged = false;
+  unsigned int parsed = 0, indexed = 0, unchanged = 0;
+
+  map<CStdString, cp_plugin_info_t*> available;
+  set<CStdString> found;
+  for (unsigned int i = 0; i < m_collections.size(); i++)
+  {
+    CFileItemList items;
+    XFILE::CDirectory::GetDirectory(m_collections[i], items, "/", false, false, XFILE::DIR_CACHE_NEVER, false);
+    for (int j = 0; j < items.Size(); j++)
+    {
+      if (!items[j]->m_bIsFolder)
+        continue;
+
+      CStdString path = items[j]->m_strPath;
+      URIUtils::RemoveSlashAtEnd(path);
+      struct __stat64 st;
+      if (XFILE::CFile::Stat(URIUtils::AddFileToFolder(path, "addon.xml"), &st) != 0)
+        continue;
+      found.insert(path);
+
+      cp_status_t status;
+      cp_plugin_info_t *info = NULL;
+      map<CStdString, CAddonManifest>::const_iterator manifest = manifests.find(path);
+      if (manifest != manifests.end() && manifest->second.mtime == (int64_t)st.st_mtime)
+      {
+        cp_plugin_info_t *installed = m_cpluff->get_plugin_info(m_cp_context, manifest->second.addonID.c_str(), &status);
+        if (installed)
+        {
+          bool current = installed->version && manifest->second.version == installed->version;
+          m_cpluff->release_info(m_cp_context, installed);
+          if (current)
+          {
+            unchanged++;
+            continue;
+          }
+        }
+        info = m_cpluff->load_plugin_descriptor_from_serialized(m_cp_context, manifest->second.descriptor.c_str(),
+                                                                manifest->second.descriptor.size(), &status);
+        if (info)
+          indexed++;
+      }
+
+      if (!info)
+      {
+        info = m_cpluff->load_plugin_descriptor(m_cp_context, _P(path).c_str(), &status);
+        if (!info)
+          continue;
+        parsed++;
+
+        CAddonManifest parsedManifest;
+        parsedManifest.mtime   = st.st_mtime;
+        parsedManifest.addonID = info->identifier;
+        parsedManifest.version = info->version ? info->version : "";
+        unsigned int size = 0;
+        m_cpluff->serialize_plugin_descriptor(info, NULL, &size);
+        parsedManifest.descriptor.resize(size);
+        if (size && m_cpluff->serialize_plugin_descriptor(info, &parsedManifest.descriptor[0], &size) == CP_OK)
+        {
+          if (!indexChanged)
+            m_database.BeginTransaction();
+          indexChanged = true;
+          m_database.SetManifest(path, parsedManifest);
+        }
+      }
+
+      // keep the newest of an addon that is in more than one place
+      map<CStdString, cp_plugin_info_t*>::iterator other = available.find(info->identifier);
+      if (other == available.end())
+        available.insert(make_pair(CStdString(info->identifier), info));
+      else if (AddonVersion(info->version ? info->version : "") > AddonVersion(other->second->version ? other->second->version : ""))
+      {
+        m_cpluff->release_info(m_cp_context, other->second);
+        other->second = info;
+      }
+      else
+        m_cpluff->release_info(m_cp_context, info);
+    }
+  }
+
+  // install the new addons and upgrade the ones of a higher version
+  for (map<CStdString, cp_plugin_info_t*>::iterator it = available.begin(); it != available.end(); ++it)
+  {
+    cp_plugin_info_t *info = it->second;
+    cp_status_t status;
+    cp_plugin_info_t *installed = m_cpluff->get_plugin_info(m_cp_context, info->identifier, &status);
+    bool install = true;
+    if (installed)
+    {
+      install = AddonVersion(info->version ? info->version : "") > AddonVersion(installed->version ? installed->version : "");
+      m_cpluff->release_info(m_cp_context, installed);
+      if (install)
+        m_cpluff->uninstall_plugin(m_cp_context, info->identifier);
+    }
+    if (install && m_cpluff->install_plugin(m_cp_context, info) != CP_OK)
+      CLog::Log(LOGERROR, "ADDONS: failed to install %s from %s", info->identifier, info->plugin_path);
+    m_cpluff->release_info(m_cp_context, info);
+  }
+
+  // forget the addons that are gone
+  for (map<CStdString, CAddonManifest>::const_iterator it = manifests.begin(); it != manifests.end(); ++it)
+  {
+    if (found.find(it->first) != found.end())
+      continue;
+    if (!indexChanged)
+      m_database.BeginTransaction();
+    indexChanged = true;
+    m_database.DeleteManifest(it->first);
+  }
+  if (indexChanged)
+    m_database.CommitTransaction();
+
+  CLog::Log(LOGDEBUG, "ADDONS: found %u addons in %.1fms, %u unchanged, %u from the index, %u parsed",
+            (unsigned int)found.size(), (CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency(),
+            unchanged, indexed, parsed);
 }
 
 void CAddonMgr::RemoveAddon(const CStdString& ID)
@@ -53,6 +53,9 @@ public:
   virtual void release_symbol(cp_context_t *ctx, const void *ptr) =0;
   virtual cp_plugin_info_t *load_plugin_descriptor(cp_context_t *ctx, const char *path, cp_status_t *status) =0;
   virtual cp_plugin_info_t *load_plugin_descriptor_from_memory(cp_context_t *ctx, const char *buffer, unsigned int buffer_len, cp_status_t *status) =0;
+  virtual cp_status_t serialize_plugin_descriptor(const cp_plugin_info_t *plugin, char *buffer, unsigned int *buffer_len) =0;
+  virtual cp_plugin_info_t *load_plugin_descriptor_from_serialized(cp_context_t *ctx, const char *buffer, unsigned int buffer_len, cp_status_t *status) =0;
+  virtual cp_status_t install_plugin(cp_context_t *ctx, cp_plugin_info_t *pi)=0;
   virtual cp_status_t uninstall_plugin(cp_context_t *ctx, const char *id)=0;
 };
 
@@ -86,6 +89,9 @@ class DllLibCPluff : public DllDynamic, DllLibCPluffInterface
   DEFINE_METHOD2(void,                release_symbol,           (cp_context_t *p1, const void *p2))
   DEFINE_METHOD3(cp_plugin_info_t*,   load_plugin_descriptor,   (cp_context_t *p1, const char *p2, cp_status_t *p3))
   DEFINE_METHOD4(cp_plugin_info_t*,   load_plugin_descriptor_from_memory, (cp_context_t *p1, const char *p2, unsigned int p3, cp_status_t *p4))
+  DEFINE_METHOD3(cp_status_t,         serialize_plugin_descriptor, (const cp_plugin_info_t *p1, char *p2, unsigned int *p3))
+  DEFINE_METHOD4(cp_plugin_info_t*,   load_plugin_descriptor_from_serialized, (cp_context_t *p1, const char *p2, unsigned int p3, cp_status_t *p4))
+  DEFINE_METHOD2(cp_status_t,         install_plugin,           (cp_context_t *p1, cp_plugin_info_t *p2))
   DEFINE_METHOD2(cp_status_t,         uninstall_plugin,         (cp_context_t *p1, const char *p2))
 
   BEGIN_METHOD_RESOLVE()
@@ -112,6 +118,9 @@ class DllLibCPluff : public DllDynamic, DllLibCPluffInterface
     RESOLVE_METHOD_RENAME(cp_release_symbol, release_symbol)
     RESOLVE_METHOD_RENAME(cp_load_plugin_descriptor, load_plugin_descriptor)
     RESOLVE_METHOD_RENAME(cp_load_plugin_descriptor_from_memory, load_plugin_descriptor_from_memory)
+    RESOLVE_METHOD_RENAME(cp_serialize_plugin_descriptor, serialize_plugin_descriptor)
+    RESOLVE_METHOD_RENAME(cp_load_plugin_descriptor_from_serialized, load_plugin_descriptor_from_serialized)
+    RESOLVE_METHOD_RENAME(cp_install_plugin, install_plugin)
     RESOLVE_METHOD_RENAME(cp_uninstall_plugin, uninstall_plugin)
   END_METHOD_RESOLVE()
 };
@@ -47,7 +47,6 @@ CCoreAudioAEStream::CCoreAudioAEStream(enum AEDataFormat dataFormat, unsigned in
   m_volume          (1.0f ),
   m_rgain           (1.0f ),
   m_convertFn       (NULL ),
-  m_ssrc            (NULL ),
   m_draining        (false),
   m_disableCallbacks(false),
   m_cbDataFunc      (NULL ),
@@ -61,8 +60,6 @@ CCoreAudioAEStream::CCoreAudioAEStream(enum AEDataFormat dataFormat, unsigned in
   m_AvgBytesPerSec  (0    ),
   m_Buffer          (NULL)
 {
-  m_ssrcData.data_out             = NULL;
-
   m_StreamFormat.m_dataFormat     = dataFormat;
   m_StreamFormat.m_sampleRate     = sampleRate;
   m_StreamFormat.m_channelCount   = channelCount;
@@ -192,11 +189,8 @@ void CCoreAudioAEStream::Initialize(AEAudioFormat &outputFormat)
   /* if we need to resample, set it up */
   if (m_resample)
   {
-    int err;
-    m_ssrc                   = src_new(SRC_SINC_MEDIUM_QUALITY, m_StreamFormat.m_channelCount, &err);
-    m_ssrcData.src_ratio     = (double)m_OutputFormat.m_sampleRate / (double)m_StreamFormat.m_sampleRate;
-    m_ssrcData.data_in       = m_convertBuffer;
-    m_ssrcData.end_of_input  = 0;
+    m_resampler.Initialize(m_StreamFormat.m_channelCount, (double)m_OutputFormat.m_sampleRate / (double)m_StreamFormat.m_sampleRate,
+                           (CAEResample::Quality)g_advancedSettings.m_audioResampleQuality);
   }
 
   m_AvgBytesPerSec =  m_OutputFormat.m_frameSize * m_OutputFormat.m_sampleRate;
@@ -325,23 +319,15 @@ unsigned int CCoreAudioAEStream::AddData(void *data, unsigned int size)
   if (m_resample)
   {
     unsigned int resample_frames = samples / m_StreamFormat.m_channelCount;
+    unsigned int used;
     
     CheckOutputBufferSize((void **)&m_resampleBuffer, &m_resampleBufferSize, 
-                          resample_frames * MathUtils::ceil_int(m_ssrcData.src_ratio) * sizeof(float) * 2);
+                          resample_frames * MathUtils::ceil_int(m_resampler.GetRatio()) * sizeof(float) * 2);
     
-    m_ssrcData.input_frames   = resample_frames;
-    m_ssrcData.output_frames  = resample_frames * MathUtils::ceil_int(m_ssrcData.src_ratio);
-    m_ssrcData.data_in        = (float *)adddata;
-    m_ssrcData.data_out       = m_resampleBuffer;
-        
-    if (src_process(m_ssrc, &m_ssrcData) != 0) 
-    {
-      return 0;
-    }
-    
-    frames    = m_ssrcData.output_frames_gen;    
+    frames    = m_resampler.Process((float *)adddata, resample_frames, m_resampleBuffer,
+                                    resample_frames * MathUtils::ceil_int(m_resampler.GetRatio()), used);
     samples   = frames * m_StreamFormat.m_channelCount;
-    adddata   = (uint8_t *)m_ssrcData.data_out;
+    adddata   = (uint8_t *)m_resampleBuffer;
   }
   else
   {
@@ -555,10 +541,8 @@ void  CCoreAudioAEStream::SetReplayGain(float factor)
 void CCoreAudioAEStream::InternalFlush()
 {
   /* reset the resampler */
-  if (m_resample) {
-    m_ssrcData.end_of_input = 0;
-    src_reset(m_ssrc);
-  }
+  if (m_resample)
+    m_resampler.Reset();
 
   if(m_Buffer)
     m_Buffer->Reset();
@@ -601,7 +585,7 @@ double CCoreAudioAEStream::GetResampleRatio()
   if (!m_resample)
     return 1.0f;
 
-  double ret = m_ssrcData.src_ratio;
+  double ret = m_resampler.GetRatio();
   return ret;
 }
 
@@ -610,8 +594,7 @@ void CCoreAudioAEStream::SetResampleRatio(double ratio)
   if (!m_resample)
     return;
 
-  src_set_ratio(m_ssrc, ratio);
-  m_ssrcData.src_ratio = ratio;
+  m_resampler.SetRatio(ratio);
 }
 
 void CCoreAudioAEStream::RegisterAudioCallback(IAudioCallback* pCallback)
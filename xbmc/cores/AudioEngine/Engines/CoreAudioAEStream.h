@@ -22,13 +22,13 @@
 #ifndef __COREAUDIOAESTREAM_H__
 #define __COREAUDIOAESTREAM_H__
 
-#include <samplerate.h>
 #include <list>
 
 #include "AEStream.h"
 #include "AEAudioFormat.h"
 #include "AEConvert.h"
 #include "AERemap.h"
+#include "AEResample.h"
 #include "AEPostProc.h"
 #include "CoreAudioRingBuffer.h"
 #include "threads/CriticalSection.h"
@@ -126,8 +126,7 @@ private:
   uint8_t                *m_vizRemapBuffer;     /* buffer for remap data */
   int                     m_vizRemapBufferSize;
   
-  SRC_STATE              *m_ssrc;
-  SRC_DATA                m_ssrcData;
+  CAEResample             m_resampler;
   bool                    m_paused;
   bool                    m_draining;
   unsigned int            m_AvgBytesPerSec;
@@ -23,6 +23,7 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "settings/AdvancedSettings.h"
 #include "DllAvCore.h"
 
 #include "AEFactory.h"
@@ -48,7 +49,7 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_convertFn       (NULL ),
   m_frameBuffer     (NULL ),
   m_frameBufferSize (0    ),
-  m_ssrc            (NULL ),
+  m_resampleBuffer  (NULL ),
   m_framesBuffered  (0    ),
   m_vizPacketPos    (NULL ),
   m_draining        (false),
@@ -63,8 +64,6 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_vizBufferSamples(0    ),
   m_audioCallback   (NULL )
 {
-  m_ssrcData.data_out = NULL;
-
   m_initDataFormat    = dataFormat;
   m_initSampleRate    = sampleRate;
   m_initChannelCount  = channelCount;
@@ -111,8 +110,8 @@ void CSoftAEStream::Initialize()
 
     if (m_resample)
     {
-      _aligned_free(m_ssrcData.data_out);
-      m_ssrcData.data_out = NULL;
+      _aligned_free(m_resampleBuffer);
+      m_resampleBuffer = NULL;
     }
   }
 
@@ -196,13 +195,10 @@ void CSoftAEStream::Initialize()
   /* if we need to resample, set it up */
   if (m_resample)
   {
-    int err;
-    m_ssrc                   = src_new(SRC_SINC_MEDIUM_QUALITY, m_initChannelCount, &err);
-    m_ssrcData.data_in       = m_convertBuffer;
-    m_ssrcData.src_ratio     = (double)AE.GetSampleRate() / (double)m_initSampleRate;
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * std::ceil(m_ssrcData.src_ratio);
-    m_ssrcData.end_of_input  = 0;
+    double ratio = (double)AE.GetSampleRate() / (double)m_initSampleRate;
+    m_resampler.Initialize(m_initChannelCount, ratio, (CAEResample::Quality)g_advancedSettings.m_audioResampleQuality);
+    m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * std::ceil(ratio) * sizeof(float), 16);
+    m_resampleFrames = m_format.m_frames * std::ceil(ratio);
   }
 
   /* re-initialize post-proc objects */
@@ -254,9 +250,8 @@ CSoftAEStream::~CSoftAEStream()
 
   if (m_resample)
   {
-    _aligned_free(m_ssrcData.data_out);
-    src_delete(m_ssrc);
-    m_ssrc = NULL;
+    _aligned_free(m_resampleBuffer);
+    m_resampleBuffer = NULL;
   }
 
   _aligned_free(m_newPacket.data);
@@ -369,11 +364,10 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
   /* resample it if we need to */
   if (m_resample)
   {
-    m_ssrcData.input_frames = samples / m_format.m_channelCount;
-    if (src_process(m_ssrc, &m_ssrcData) != 0) return 0;
-    data     = (uint8_t*)m_ssrcData.data_out;
-    frames   = m_ssrcData.output_frames_gen;
-    consumed = m_ssrcData.input_frames_used * m_bytesPerFrame;
+    unsigned int used;
+    frames   = m_resampler.Process(m_convertBuffer, samples / m_format.m_channelCount, m_resampleBuffer, m_resampleFrames, used);
+    data     = (uint8_t*)m_resampleBuffer;
+    consumed = used * m_bytesPerFrame;
     if (!frames)
       return consumed;
 
@@ -608,10 +602,8 @@ void CSoftAEStream::Flush()
 void CSoftAEStream::InternalFlush()
 {
   /* reset the resampler */
-  if (m_resample) {
-    m_ssrcData.end_of_input = 0;
-    src_reset(m_ssrc);
-  }
+  if (m_resample)
+    m_resampler.Reset();
   
   /* invalidate any incoming samples */
   m_newPacket.samples = 0;
@@ -676,7 +668,7 @@ double CSoftAEStream::GetResampleRatio()
     return 1.0f;
 
   CSingleLock lock(m_critSection);
-  return m_ssrcData.src_ratio;
+  return m_resampler.GetRatio();
 }
 
 void CSoftAEStream::SetResampleRatio(double ratio)
@@ -686,17 +678,16 @@ void CSoftAEStream::SetResampleRatio(double ratio)
 
   CSingleLock lock(m_critSection);
 
-  int oldRatioInt = std::ceil(m_ssrcData.src_ratio);
+  int oldRatioInt = std::ceil(m_resampler.GetRatio());
 
-  src_set_ratio(m_ssrc, ratio);
-  m_ssrcData.src_ratio = ratio;
+  m_resampler.SetRatio(ratio);
 
   //Check the resample buffer size and resize if necessary.
-  if(oldRatioInt < std::ceil(m_ssrcData.src_ratio))
+  if(oldRatioInt < std::ceil(ratio))
   {
-    _aligned_free(m_ssrcData.data_out);
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * std::ceil(m_ssrcData.src_ratio);
+    _aligned_free(m_resampleBuffer);
+    m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * std::ceil(ratio) * sizeof(float), 16);
+    m_resampleFrames = m_format.m_frames * std::ceil(ratio);
   }
 }
 
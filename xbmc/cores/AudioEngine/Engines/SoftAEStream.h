@@ -20,7 +20,6 @@
  *
  */
 
-#include <samplerate.h>
 #include <list>
 
 #include "threads/CriticalSection.h"
@@ -30,6 +29,7 @@
 #include "Interfaces/AEPostProc.h"
 #include "Utils/AEConvert.h"
 #include "Utils/AERemap.h"
+#include "Utils/AEResample.h"
 
 class IAEPostProc;
 class CSoftAEStream : public IAEStream
@@ -136,8 +136,9 @@ private:
   enum AEChannel    *m_aeChannelLayout;
   unsigned int       m_aeChannelCount;
   unsigned int       m_aePacketSamples;
-  SRC_STATE         *m_ssrc;
-  SRC_DATA           m_ssrcData;
+  CAEResample        m_resampler;
+  float             *m_resampleBuffer;
+  unsigned int       m_resampleFrames;
   unsigned int       m_framesBuffered;
   std::list<PPacket> m_outBuffer;
   unsigned int       ProcessFrameBuffer();
@@ -0,0 +1,360 @@
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "AEResample.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* input frames buffered at once, on top of what the filter spans */
+#define HISTORY_FRAMES 1024
+
+/* the largest table of coefficients, fewer phases are used past it */
+#define MAX_FILTER_SIZE (1 << 20)
+
+/*
+  what each quality asks of the filter: the stop band attenuation in dB,
+  the part of the band passed untouched and the phases tabulated
+*/
+static const struct
+{
+  double       attenuation;
+  double       passband;
+  unsigned int phases;
+} qualities[] =
+{
+  {  60.0, 0.80,   64 }, /* QUALITY_LOW        */
+  {  90.0, 0.90,  256 }, /* QUALITY_MID        */
+  { 110.0, 0.93,  512 }, /* QUALITY_HIGH       */
+  { 130.0, 0.95, 1024 }  /* QUALITY_REALLYHIGH */
+};
+
+/* modified Bessel function of the first kind and order 0, for the Kaiser window */
+static double BesselI0(double x)
+{
+  double sum  = 1.0;
+  double term = 1.0;
+  for (int k = 1; term > sum * 1e-12; ++k)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum  += term;
+  }
+  return sum;
+}
+
+/* out = row0 + frac * (row1 - row0), n is a multiple of 8 */
+static inline void InterpolateRow(const float *row0, const float *row1, float frac, float *out, unsigned int n)
+{
+#if defined(__SSE__)
+  __m128 f = _mm_set1_ps(frac);
+  for (unsigned int i = 0; i < n; i += 4)
+  {
+    __m128 a = _mm_loadu_ps(row0 + i);
+    __m128 b = _mm_loadu_ps(row1 + i);
+    _mm_storeu_ps(out + i, _mm_add_ps(a, _mm_mul_ps(f, _mm_sub_ps(b, a))));
+  }
+#elif defined(__ARM_NEON__)
+  float32x4_t f = vdupq_n_f32(frac);
+  for (unsigned int i = 0; i < n; i += 4)
+  {
+    float32x4_t a = vld1q_f32(row0 + i);
+    float32x4_t b = vld1q_f32(row1 + i);
+    vst1q_f32(out + i, vmlaq_f32(a, f, vsubq_f32(b, a)));
+  }
+#else
+  for (unsigned int i = 0; i < n; ++i)
+    out[i] = row0[i] + frac * (row1[i] - row0[i]);
+#endif
+}
+
+/* the sum of a[i] * b[i], n is a multiple of 8 */
+static inline float DotProduct(const float *a, const float *b, unsigned int n)
+{
+#if defined(__SSE__)
+  __m128 sum0 = _mm_setzero_ps();
+  __m128 sum1 = _mm_setzero_ps();
+  for (unsigned int i = 0; i < n; i += 8)
+  {
+    sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i    ), _mm_loadu_ps(b + i    )));
+    sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  sum0 = _mm_add_ps(sum0, sum1);
+  sum0 = _mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0));
+  sum0 = _mm_add_ss(sum0, _mm_shuffle_ps(sum0, sum0, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(sum0);
+#elif defined(__ARM_NEON__)
+  float32x4_t sum0 = vdupq_n_f32(0.0f);
+  float32x4_t sum1 = vdupq_n_f32(0.0f);
+  for (unsigned int i = 0; i < n; i += 8)
+  {
+    sum0 = vmlaq_f32(sum0, vld1q_f32(a + i    ), vld1q_f32(b + i    ));
+    sum1 = vmlaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  sum0 = vaddq_f32(sum0, sum1);
+  float32x2_t sum = vadd_f32(vget_low_f32(sum0), vget_high_f32(sum0));
+  return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+  float sum0 = 0.0f, sum1 = 0.0f;
+  for (unsigned int i = 0; i < n; i += 2)
+  {
+    sum0 += a[i    ] * b[i    ];
+    sum1 += a[i + 1] * b[i + 1];
+  }
+  return sum0 + sum1;
+#endif
+}
+
+CAEResample::CAEResample() :
+  m_channels   (0),
+  m_quality    (QUALITY_MID),
+  m_ratio      (1.0),
+  m_step       (1.0),
+  m_filterRatio(1.0),
+  m_taps       (0),
+  m_before     (0),
+  m_phases     (0),
+  m_oldTaps    (0),
+  m_oldBefore  (0),
+  m_oldPhases  (0),
+  m_historySize(0),
+  m_historyFill(0),
+  m_historyStart(0),
+  m_position   (0.0)
+{
+}
+
+CAEResample::~CAEResample()
+{
+}
+
+bool CAEResample::Initialize(unsigned int channels, double ratio, Quality quality)
+{
+  if (channels == 0 || ratio <= 0.0 || quality < QUALITY_LOW || quality > QUALITY_REALLYHIGH)
+    return false;
+
+  m_channels    = channels;
+  m_quality     = quality;
+  m_ratio       = ratio;
+  m_step        = 1.0 / ratio;
+  m_filterRatio = ratio;
+
+  MakeFilter();
+  m_historySize = m_taps + HISTORY_FRAMES;
+  m_history.assign(m_channels * m_historySize, 0.0f);
+  Reset();
+  return true;
+}
+
+void CAEResample::MakeFilter()
+{
+  /* when downsampling the band has to end below the output's nyquist */
+  double cutoff      = std::min(1.0, m_filterRatio);
+  double attenuation = qualities[m_quality].attenuation;
+  double passband    = qualities[m_quality].passband * cutoff;
+  double center      = (passband + cutoff) / 2.0;
+
+  /* Kaiser's estimates of the window and the length giving the attenuation */
+  double beta = 0.1102 * (attenuation - 8.7);
+  double transition = (cutoff - passband) / 2.0; /* in cycles per input sample */
+  m_taps   = (unsigned int)ceil((attenuation - 8.0) / (2.285 * 2.0 * M_PI * transition));
+  m_taps   = std::max(8u, (m_taps + 7) & ~7u);
+  m_before = m_taps / 2 - 1;
+  m_phases = std::min(qualities[m_quality].phases, std::max(16u, MAX_FILTER_SIZE / m_taps));
+
+  /*
+    row p is the filter for an output p / m_phases of the way from the input
+    sample at m_before to the next, each normalized to unity gain at DC
+  */
+  double half = m_taps / 2.0;
+  double norm = BesselI0(beta);
+  m_filter.resize((m_phases + 1) * m_taps);
+  for (unsigned int p = 0; p <= m_phases; ++p)
+  {
+    float *row = &m_filter[p * m_taps];
+    double sum = 0.0;
+    std::vector<double> coefs(m_taps);
+    for (unsigned int i = 0; i < m_taps; ++i)
+    {
+      double x      = (double)i - m_before - (double)p / m_phases;
+      double r      = x / half;
+      double window = BesselI0(beta * sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+      double sinc   = x == 0.0 ? 1.0 : sin(M_PI * center * x) / (M_PI * center * x);
+      coefs[i] = center * sinc * window;
+      sum     += coefs[i];
+    }
+    for (unsigned int i = 0; i < m_taps; ++i)
+      row[i] = (float)(coefs[i] / sum);
+  }
+
+  m_kernel.resize(std::max(m_taps, m_oldTaps));
+}
+
+bool CAEResample::NeedsNewFilter(double ratio) const
+{
+  /* small changes, as in drift correction, keep the filter */
+  double cutoff    = std::min(1.0, ratio);
+  double oldCutoff = std::min(1.0, m_filterRatio);
+  return fabs(cutoff - oldCutoff) > oldCutoff * 0.02;
+}
+
+void CAEResample::SetRatio(double ratio)
+{
+  if (ratio <= 0.0 || m_channels == 0)
+    return;
+
+  m_ratio = ratio;
+  m_step  = 1.0 / ratio;
+  if (!NeedsNewFilter(ratio))
+    return;
+
+  /*
+    keep the filter in use until the new one has input for its full width,
+    unless the one before it is still being used
+  */
+  if (m_oldFilter.empty())
+  {
+    m_oldFilter.swap(m_filter);
+    m_oldTaps   = m_taps;
+    m_oldBefore = m_before;
+    m_oldPhases = m_phases;
+  }
+
+  m_filterRatio = ratio;
+  MakeFilter();
+
+  /* room in front for the taps before the position, nothing buffered is dropped */
+  unsigned int base  = (unsigned int)m_position;
+  unsigned int shift = m_before > base ? m_before - base : 0;
+  unsigned int size  = std::max(std::max(m_taps, m_oldTaps) + HISTORY_FRAMES, m_historyFill + shift);
+  if (shift || size != m_historySize)
+  {
+    std::vector<float> old;
+    old.swap(m_history);
+    m_history.assign(m_channels * size, 0.0f);
+    for (unsigned int c = 0; c < m_channels; ++c)
+      memcpy(&m_history[c * size + shift], &old[c * m_historySize], m_historyFill * sizeof(float));
+    m_historySize   = size;
+    m_historyFill  += shift;
+    m_historyStart += shift;
+    m_position     += shift;
+  }
+}
+
+void CAEResample::Reset()
+{
+  /* the first output is at the first input frame, with silence before it */
+  std::fill(m_history.begin(), m_history.end(), 0.0f);
+  m_historyFill  = m_before;
+  m_historyStart = 0;
+  m_position     = m_before;
+  m_oldFilter.clear();
+  m_oldTaps      = 0;
+}
+
+unsigned int CAEResample::Process(const float *in, unsigned int inputFrames, float *out, unsigned int outputFrames, unsigned int &inputUsed)
+{
+  unsigned int generated = 0;
+  inputUsed = 0;
+  if (m_channels == 0)
+    return 0;
+
+  for (;;)
+  {
+    /* output what the buffered input allows */
+    while (generated < outputFrames)
+    {
+      unsigned int base = (unsigned int)m_position;
+
+      /* once the new filter only covers input the old one is done with */
+      if (!m_oldFilter.empty() && base - m_before >= m_historyStart)
+      {
+        m_oldFilter.clear();
+        m_oldTaps = 0;
+      }
+
+      bool         useOld = !m_oldFilter.empty();
+      unsigned int taps   = useOld ? m_oldTaps   : m_taps;
+      unsigned int before = useOld ? m_oldBefore : m_before;
+      unsigned int phases = useOld ? m_oldPhases : m_phases;
+      if (base - before + taps > m_historyFill)
+        break;
+
+      float        phase = (float)(m_position - base) * phases;
+      unsigned int p     = std::min((unsigned int)phase, phases - 1);
+      const float *row   = useOld ? &m_oldFilter[p * taps] : &m_filter[p * taps];
+      InterpolateRow(row, row + taps, phase - p, &m_kernel[0], taps);
+
+      const float *src = &m_history[base - before];
+      for (unsigned int c = 0; c < m_channels; ++c, src += m_historySize)
+        *out++ = DotProduct(src, &m_kernel[0], taps);
+
+      ++generated;
+      m_position += m_step;
+    }
+
+    if (generated == outputFrames || inputUsed == inputFrames)
+      break;
+
+    /* drop the input the filters have passed */
+    unsigned int before = m_oldFilter.empty() ? m_before : std::max(m_before, m_oldBefore);
+    unsigned int drop   = std::min((unsigned int)m_position - before, m_historyFill);
+    if (drop)
+    {
+      for (unsigned int c = 0; c < m_channels; ++c)
+      {
+        float *row = &m_history[c * m_historySize];
+        memmove(row, row + drop, (m_historyFill - drop) * sizeof(float));
+      }
+      m_historyFill  -= drop;
+      m_historyStart -= std::min(drop, m_historyStart);
+      m_position     -= drop;
+    }
+
+    /* and take in more, a row for each channel */
+    unsigned int take = std::min(inputFrames - inputUsed, m_historySize - m_historyFill);
+    const float *src = in + inputUsed * m_channels;
+    for (unsigned int c = 0; c < m_channels; ++c)
+    {
+      float *dst = &m_history[c * m_historySize + m_historyFill];
+      for (unsigned int i = 0; i < take; ++i)
+        dst[i] = src[i * m_channels + c];
+    }
+    m_historyFill += take;
+    inputUsed     += take;
+  }
+
+  return generated;
+}
+
@@ -0,0 +1,95 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2010 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <vector>
+
+/**
+ * Polyphase FIR resampler for interleaved float audio.
+ *
+ * The filter is a Kaiser windowed sinc, tabulated at a number of phases
+ * between two input samples. The coefficients for an output sample are
+ * interpolated between the two nearest phases, so any ratio works and it
+ * can be changed between calls, e.g. to correct drift, without a glitch.
+ * A change large enough to need a new filter switches to it once there is
+ * input for its full width, until then the old one is kept.
+ * The inner loops use SSE or NEON when built for them.
+ */
+class CAEResample
+{
+public:
+  /* the tiers match RESAMPLE_LOW ... RESAMPLE_REALLYHIGH of the GUI settings */
+  enum Quality
+  {
+    QUALITY_LOW = 0,
+    QUALITY_MID,
+    QUALITY_HIGH,
+    QUALITY_REALLYHIGH
+  };
+
+  CAEResample();
+  ~CAEResample();
+
+  /* ratio is the output rate divided by the input rate */
+  bool Initialize(unsigned int channels, double ratio, Quality quality);
+  void SetRatio(double ratio);
+  double GetRatio() const { return m_ratio; }
+  unsigned int GetChannels() const { return m_channels; }
+
+  /* drop any input that is buffered, for a flush */
+  void Reset();
+
+  /*
+   * Resamples in, taking input for as long as there is room in out.
+   * inputUsed is set to the frames taken from in, the frames written to
+   * out are returned.
+   */
+  unsigned int Process(const float *in, unsigned int inputFrames, float *out, unsigned int outputFrames, unsigned int &inputUsed);
+
+private:
+  void MakeFilter();
+  bool NeedsNewFilter(double ratio) const;
+
+  unsigned int       m_channels;
+  Quality            m_quality;
+  double             m_ratio;
+  double             m_step;        /* input frames per output frame */
+  double             m_filterRatio; /* the ratio the filter was made for */
+
+  unsigned int       m_taps;        /* coefficients per phase, a multiple of 8 */
+  unsigned int       m_before;      /* taps before the output position */
+  unsigned int       m_phases;
+  std::vector<float> m_filter;      /* m_phases + 1 rows of m_taps */
+  std::vector<float> m_kernel;      /* the row interpolated for an output */
+
+  /* the filter before a rebuild, used while the new one reaches past the input */
+  unsigned int       m_oldTaps;
+  unsigned int       m_oldBefore;
+  unsigned int       m_oldPhases;
+  std::vector<float> m_oldFilter;
+
+  std::vector<float> m_history;     /* a row of m_historySize for each channel */
+  unsigned int       m_historySize;
+  unsigned int       m_historyFill;
+  unsigned int       m_historyStart; /* history before this was never input */
+  double             m_position;    /* where in the history the next output is */
+};
+
@@ -0,0 +1,345 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "Utils/AEResample.h"
+#include "utils/test/TestUtils.h"
+
+#include <samplerate.h>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const char *qualityNames[] = { "low", "mid", "high", "reallyhigh" };
+
+static std::vector<float> Sine(double frequency, double rate, unsigned int frames, unsigned int channels)
+{
+  std::vector<float> data(frames * channels);
+  for (unsigned int i = 0; i < frames; ++i)
+    for (unsigned int c = 0; c < channels; ++c)
+      data[i * channels + c] = (float)(0.5 * sin(2.0 * M_PI * frequency * i / rate + c));
+  return data;
+}
+
+/*
+  THD+N in dB of the first channel of data, a sine of w radians per frame:
+  what is left after taking out the sine and DC that fit it best. The ends,
+  where the filter runs in and out, are left out.
+*/
+static double THDN(const std::vector<float> &data, unsigned int channels, double w)
+{
+  unsigned int frames = data.size() / channels;
+  unsigned int from = 1000, to = frames - 1000;
+
+  /* least squares, solving the normal equations for a sin + b cos + c */
+  double m[3][3] = {{ 0 }}, v[3] = { 0 }, x[3];
+  for (unsigned int k = from; k < to; ++k)
+  {
+    double f[3] = { sin(w * k), cos(w * k), 1.0 };
+    for (int i = 0; i < 3; ++i)
+    {
+      v[i] += f[i] * data[k * channels];
+      for (int j = 0; j < 3; ++j)
+        m[i][j] += f[i] * f[j];
+    }
+  }
+  for (int i = 0; i < 3; ++i)
+    for (int r = i + 1; r < 3; ++r)
+    {
+      double q = m[r][i] / m[i][i];
+      for (int j = i; j < 3; ++j)
+        m[r][j] -= q * m[i][j];
+      v[r] -= q * v[i];
+    }
+  for (int i = 2; i >= 0; --i)
+  {
+    x[i] = v[i];
+    for (int j = i + 1; j < 3; ++j)
+      x[i] -= m[i][j] * x[j];
+    x[i] /= m[i][i];
+  }
+
+  double signal = 0.0, noise = 0.0;
+  for (unsigned int k = from; k < to; ++k)
+  {
+    double fit = x[0] * sin(w * k) + x[1] * cos(w * k) + x[2];
+    signal += fit * fit;
+    noise  += (data[k * channels] - fit) * (data[k * channels] - fit);
+  }
+  return 10.0 * log10(signal / noise);
+}
+
+static double Difference(const std::vector<float> &a, const std::vector<float> &b)
+{
+  double largest = 0.0;
+  for (unsigned int i = 0; i < a.size(); ++i)
+    largest = std::max(largest, (double)fabs(a[i] - b[i]));
+  return largest;
+}
+
+/* resamples in blocks, as the streams hand the data over */
+static std::vector<float> Resample(CAEResample &resample, const std::vector<float> &in, unsigned int block = 512)
+{
+  unsigned int channels = resample.GetChannels();
+  unsigned int frames = in.size() / channels;
+  std::vector<float> out;
+  std::vector<float> buffer(block * channels * ((unsigned int)ceil(resample.GetRatio()) + 1));
+  for (unsigned int done = 0; done < frames; )
+  {
+    unsigned int used;
+    unsigned int generated = resample.Process(&in[done * channels], std::min(block, frames - done), &buffer[0], buffer.size() / channels, used);
+    out.insert(out.end(), buffer.begin(), buffer.begin() + generated * channels);
+    done += used;
+  }
+  return out;
+}
+
+static std::vector<float> ResampleSRC(int converter, double ratio, const std::vector<float> &in, unsigned int channels, unsigned int block = 512)
+{
+  int error;
+  SRC_STATE *state = src_new(converter, channels, &error);
+  unsigned int frames = in.size() / channels;
+  std::vector<float> out;
+  std::vector<float> buffer(block * channels * ((unsigned int)ceil(ratio) + 1));
+  SRC_DATA data;
+  data.end_of_input = 0;
+  data.src_ratio    = ratio;
+  for (unsigned int done = 0; done < frames; )
+  {
+    data.data_in       = &in[done * channels];
+    data.input_frames  = std::min(block, frames - done);
+    data.data_out      = &buffer[0];
+    data.output_frames = buffer.size() / channels;
+    src_process(state, &data);
+    out.insert(out.end(), buffer.begin(), buffer.begin() + data.output_frames_gen * channels);
+    done += data.input_frames_used;
+  }
+  src_delete(state);
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(TestAEResampleTHDN)
+{
+  /* the least each quality gives for tones up to 18kHz going from 44.1 to 48kHz */
+  const double minimum[] = { 70.0, 100.0, 115.0, 125.0 };
+  const double frequencies[] = { 1000.0, 10000.0, 18000.0 };
+
+  for (int q = CAEResample::QUALITY_LOW; q <= CAEResample::QUALITY_REALLYHIGH; ++q)
+    for (unsigned int f = 0; f < sizeof(frequencies) / sizeof(frequencies[0]); ++f)
+    {
+      CAEResample resample;
+      BOOST_REQUIRE(resample.Initialize(2, 48000.0 / 44100.0, (CAEResample::Quality)q));
+      std::vector<float> out = Resample(resample, Sine(frequencies[f], 44100.0, 44100, 2));
+      double thdn = THDN(out, 2, 2.0 * M_PI * frequencies[f] / 48000.0);
+      BOOST_TEST_MESSAGE(qualityNames[q] << ", " << frequencies[f] << "Hz: " << thdn << "dB");
+      BOOST_CHECK(thdn >= minimum[q]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestAEResampleAliasing)
+{
+  /* a tone above the output's nyquist must not come through going from 48 to 44.1kHz */
+  const double maximum[] = { -58.0, -88.0, -108.0, -125.0 };
+
+  for (int q = CAEResample::QUALITY_LOW; q <= CAEResample::QUALITY_REALLYHIGH; ++q)
+  {
+    CAEResample resample;
+    BOOST_REQUIRE(resample.Initialize(1, 44100.0 / 48000.0, (CAEResample::Quality)q));
+    std::vector<float> out = Resample(resample, Sine(23000.0, 48000.0, 48000, 1));
+    double power = 0.0;
+    for (unsigned int k = 1000; k < out.size() - 1000; ++k)
+      power += out[k] * out[k];
+    double level = 10.0 * log10(power / (out.size() - 2000) / 0.125);
+    BOOST_TEST_MESSAGE(qualityNames[q] << ": 23kHz comes through at " << level << "dB");
+    BOOST_CHECK(level <= maximum[q]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestAEResampleBlocks)
+{
+  /* however the data is split up, the output is the same */
+  std::vector<float> in = Sine(1000.0, 44100.0, 20000, 6);
+  CAEResample whole;
+  whole.Initialize(6, 48000.0 / 44100.0, CAEResample::QUALITY_MID);
+  std::vector<float> expected(in.size() * 2);
+  unsigned int used;
+  expected.resize(whole.Process(&in[0], 20000, &expected[0], expected.size() / 6, used) * 6);
+  BOOST_CHECK_EQUAL(20000u, used);
+
+  CAEResample split;
+  split.Initialize(6, 48000.0 / 44100.0, CAEResample::QUALITY_MID);
+  std::vector<float> out;
+  srand(1);
+  for (unsigned int done = 0; done < 20000; )
+  {
+    unsigned int frames = std::min(20000u - done, (unsigned int)rand() % 3000);
+    std::vector<float> buffer(6 * (rand() % 100 + 1));
+    unsigned int generated = split.Process(&in[done * 6], frames, &buffer[0], buffer.size() / 6, used);
+    BOOST_REQUIRE(used <= frames);
+    out.insert(out.end(), buffer.begin(), buffer.begin() + generated * 6);
+    done += used;
+  }
+  /* what the last calls had no room for */
+  std::vector<float> buffer(6 * 100);
+  unsigned int generated;
+  while ((generated = split.Process(NULL, 0, &buffer[0], 100, used)) > 0)
+    out.insert(out.end(), buffer.begin(), buffer.begin() + generated * 6);
+
+  /* the position is kept relative to the history, so it rounds a little differently */
+  BOOST_REQUIRE_EQUAL(expected.size(), out.size());
+  BOOST_CHECK(Difference(expected, out) < 1e-6);
+
+  /* a reset starts over */
+  whole.Reset();
+  std::vector<float> again(expected.size());
+  again.resize(whole.Process(&in[0], 20000, &again[0], again.size() / 6, used) * 6);
+  BOOST_CHECK(expected == again);
+}
+
+BOOST_AUTO_TEST_CASE(TestAEResampleDrift)
+{
+  /* the ratio nudged on every block, as when correcting drift, gives no clicks */
+  const unsigned int frames = 44100 * 4;
+  std::vector<float> in = Sine(1000.0, 44100.0, frames, 2);
+  CAEResample resample;
+  resample.Initialize(2, 48000.0 / 44100.0, CAEResample::QUALITY_HIGH);
+
+  std::vector<float> out;
+  std::vector<float> buffer(2 * 2048);
+  double expected = 0.0;
+  srand(2);
+  for (unsigned int done = 0; done < frames; )
+  {
+    double ratio = 48000.0 / 44100.0 * (1.0 + ((double)rand() / RAND_MAX - 0.5) * 0.002);
+    resample.SetRatio(ratio);
+    unsigned int used;
+    unsigned int generated = resample.Process(&in[done * 2], std::min(1024u, frames - done), &buffer[0], 2048, used);
+    out.insert(out.end(), buffer.begin(), buffer.begin() + generated * 2);
+    expected += used * ratio;
+    done += used;
+  }
+
+  /* the output follows the ratios, bar what the filter holds back */
+  BOOST_CHECK(fabs(out.size() / 2 - expected) < 200);
+
+  /* a step between samples is never more than the sine can make */
+  double largest = 0.0;
+  for (unsigned int k = 2000; k + 2 < out.size(); k += 2)
+    largest = std::max(largest, (double)fabs(out[k + 2] - out[k]));
+  BOOST_CHECK(largest < 0.5 * 2.0 * M_PI * 1000.0 / (48000.0 * 1.001) * 1.01);
+
+  /* a large change makes a new filter, the output goes on from where it was */
+  resample.SetRatio(0.5);
+  std::vector<float> halved = Resample(resample, Sine(1000.0, 44100.0, 44100, 2));
+  BOOST_CHECK(THDN(halved, 2, 2.0 * M_PI * 1000.0 / 22050.0) >= 110.0);
+}
+
+BOOST_AUTO_TEST_CASE(TestAEResampleWiderFilter)
+{
+  /*
+    halving the ratio mid stream doubles the width of the filter, the output
+    around the switch still follows the input as closely as anywhere else
+  */
+  const unsigned int frames = 44100;
+  std::vector<float> in = Sine(1000.0, 44100.0, frames, 2);
+  CAEResample resample;
+  resample.Initialize(2, 48000.0 / 44100.0, CAEResample::QUALITY_HIGH);
+
+  /* small outputs, so the switch comes with little input buffered before the position */
+  std::vector<float> buffer(2 * 16);
+  double time = 0.0, step = 44100.0 / 48000.0, largest = 0.0;
+  unsigned int outputs = 0;
+  for (unsigned int done = 0; done < frames; )
+  {
+    if (done >= frames / 2 && resample.GetRatio() > 1.0)
+    {
+      resample.SetRatio(0.5);
+      step = 2.0;
+    }
+    unsigned int used;
+    unsigned int generated = resample.Process(&in[done * 2], std::min(512u, frames - done), &buffer[0], 16, used);
+    for (unsigned int k = 0; k < generated; ++k, ++outputs, time += step)
+    {
+      /* leave out where the filter runs in and out */
+      if (outputs < 1000 || time > frames - 1000)
+        continue;
+      for (unsigned int c = 0; c < 2; ++c)
+        largest = std::max(largest, fabs(buffer[k * 2 + c] - 0.5 * sin(2.0 * M_PI * 1000.0 * time / 44100.0 + c)));
+    }
+    done += used;
+  }
+
+  BOOST_TEST_MESSAGE("largest error around the switch " << 20.0 * log10(largest / 0.5) << "dB");
+  BOOST_CHECK(largest < 0.5 * 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(TestAEResampleAgainstLibsamplerate)
+{
+  /*
+    each quality against the libsamplerate converter the same setting used,
+    it has to be as clean, or past 130dB where float rounding takes over
+  */
+  const int converters[] = { SRC_LINEAR, SRC_SINC_FASTEST, SRC_SINC_MEDIUM_QUALITY, SRC_SINC_BEST_QUALITY };
+  const double frequencies[] = { 1000.0, 10000.0 };
+
+  for (int q = CAEResample::QUALITY_LOW; q <= CAEResample::QUALITY_REALLYHIGH; ++q)
+    for (unsigned int f = 0; f < sizeof(frequencies) / sizeof(frequencies[0]); ++f)
+    {
+      std::vector<float> in = Sine(frequencies[f], 44100.0, 44100, 2);
+      double w = 2.0 * M_PI * frequencies[f] / 48000.0;
+
+      CAEResample resample;
+      resample.Initialize(2, 48000.0 / 44100.0, (CAEResample::Quality)q);
+      double ours   = THDN(Resample(resample, in), 2, w);
+      double theirs = THDN(ResampleSRC(converters[q], 48000.0 / 44100.0, in, 2), 2, w);
+
+      BOOST_TEST_MESSAGE(qualityNames[q] << ", " << frequencies[f] << "Hz: " << ours << "dB, libsamplerate " << theirs << "dB");
+      BOOST_CHECK(ours >= std::min(theirs, 130.0) - 1.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestAEResampleBenchmark)
+{
+  /* a minute of stereo from 44.1 to 48kHz, in the blocks SoftAE uses */
+  const unsigned int frames = 44100 * 60;
+  const int converters[] = { SRC_LINEAR, SRC_SINC_FASTEST, SRC_SINC_MEDIUM_QUALITY, SRC_SINC_BEST_QUALITY };
+  std::vector<float> in = Sine(1000.0, 44100.0, frames, 2);
+
+  for (int q = CAEResample::QUALITY_LOW; q <= CAEResample::QUALITY_REALLYHIGH; ++q)
+  {
+    CAEResample resample;
+    resample.Initialize(2, 48000.0 / 44100.0, (CAEResample::Quality)q);
+    double start = NowMS();
+    Resample(resample, in);
+    double ours = NowMS() - start;
+
+    start = NowMS();
+    ResampleSRC(converters[q], 48000.0 / 44100.0, in, 2);
+    double theirs = NowMS() - start;
+
+    BOOST_TEST_MESSAGE(qualityNames[q] << ": a minute in " << ours << "ms, libsamplerate " << theirs << "ms");
+  }
+}
@@ -42,6 +42,7 @@
 #include "utils/log.h"
 #include "utils/GLUtils.h"
 #include "RenderCapture.h"
+#include "RenderBufferPool.h"
 
 #ifdef HAVE_LIBVDPAU
 #include "cores/dvdplayer/DVDCodecs/Video/VDPAU.h"
@@ -117,6 +118,7 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
   flipindex = 0;
+  buffer    = NULL;
 #ifdef HAVE_LIBVDPAU
   vdpau = NULL;
 #endif
@@ -124,6 +126,7 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
 
 CLinuxRendererGL::YUVBUFFER::~YUVBUFFER()
 {
+  SAFE_RELEASE(buffer);
 #ifdef HAVE_LIBVA
   delete &vaapi;
 #endif
@@ -318,6 +321,9 @@ int CLinuxRendererGL::GetImage(YV12Image *image, int source, bool readonly)
     if( ! m_eventTexturesDone[source]->WaitMSec(500))
       CLog::Log(LOGWARNING, "%s - Timeout waiting for texture %d", __FUNCTION__, source);
 
+    // textures are done, so the previous picture is no longer needed
+    SAFE_RELEASE(m_buffers[source].buffer);
+
     im.flags |= IMAGE_FLAG_WRITING;
   }
 
@@ -486,52 +492,65 @@ void CLinuxRendererGL::UploadYV12Texture(int source)
 
   glPixelStorei(GL_UNPACK_ALIGNMENT,1);
 
+  // pictures passed by reference are uploaded straight from the decoder memory
+  BYTE*    plane[MAX_PLANES];
+  unsigned stride[MAX_PLANES];
+  GLuint   nopbo = 0;
+  GLuint*  pbo   = NULL;
+  for (int p = 0; p < MAX_PLANES; p++)
+  {
+    plane[p]  = buf.buffer ? buf.buffer->plane[p]  : im->plane[p];
+    stride[p] = buf.buffer ? buf.buffer->stride[p] : im->stride[p];
+  }
+  if (buf.buffer)
+    pbo = &nopbo;
+
   if (deinterlacing)
   {
     // Load Even Y Field
     LoadPlane( fields[FIELD_TOP][0] , GL_LUMINANCE, buf.flipindex
              , im->width, im->height >> 1
-             , im->stride[0]*2, im->plane[0] );
+             , stride[0]*2, plane[0], pbo );
 
     //load Odd Y Field
     LoadPlane( fields[FIELD_BOT][0], GL_LUMINANCE, buf.flipindex
              , im->width, im->height >> 1
-             , im->stride[0]*2, im->plane[0] + im->stride[0]) ;
+             , stride[0]*2, plane[0] + stride[0], pbo );
 
     // Load Even U & V Fields
     LoadPlane( fields[FIELD_TOP][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[1]*2, im->plane[1] );
+             , stride[1]*2, plane[1], pbo );
 
     LoadPlane( fields[FIELD_TOP][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[2]*2, im->plane[2] );
+             , stride[2]*2, plane[2], pbo );
 
     // Load Odd U & V Fields
     LoadPlane( fields[FIELD_BOT][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[1]*2, im->plane[1] + im->stride[1] );
+             , stride[1]*2, plane[1] + stride[1], pbo );
 
     LoadPlane( fields[FIELD_BOT][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[2]*2, im->plane[2] + im->stride[2] );
+             , stride[2]*2, plane[2] + stride[2], pbo );
   }
   else
   {
     //Load Y plane
     LoadPlane( fields[FIELD_FULL][0], GL_LUMINANCE, buf.flipindex
              , im->width, im->height
-             , im->stride[0], im->plane[0] );
+             , stride[0], plane[0], pbo );
 
     //load U plane
     LoadPlane( fields[FIELD_FULL][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> im->cshift_y
-             , im->stride[1], im->plane[1] );
+             , stride[1], plane[1], pbo );
 
     //load V plane
     LoadPlane( fields[FIELD_FULL][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> im->cshift_y
-             , im->stride[2], im->plane[2] );
+             , stride[2], plane[2], pbo );
   }
 
   m_eventTexturesDone[source]->Set();
@@ -1673,6 +1692,8 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
   YUVFIELDS &fields = m_buffers[index].fields;
   GLuint    *pbo    = m_buffers[index].pbo;
 
+  SAFE_RELEASE(m_buffers[index].buffer);
+
   if( fields[FIELD_FULL][0].id == 0 ) return;
 
   /* finish up all textures, and delete them */
@@ -3092,4 +3113,16 @@ void CLinuxRendererGL::AddProcessor(VAAPI::CHolder& holder)
 }
 #endif
 
+bool CLinuxRendererGL::AddProcessor(CRenderBuffer* buffer)
+{
+  // only the yv12 upload knows how to read from a render buffer
+  if (m_textureUpload != &CLinuxRendererGL::UploadYV12Texture)
+    return false;
+
+  YUVBUFFER &buf = m_buffers[NextYV12Texture()];
+  SAFE_RELEASE(buf.buffer);
+  buf.buffer = buffer->Acquire();
+  return true;
+}
+
 #endif
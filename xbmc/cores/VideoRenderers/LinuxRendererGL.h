@@ -36,6 +36,7 @@
 class CRenderCapture;
 
 class CVDPAU;
+class CRenderBuffer;
 class CBaseTexture;
 namespace Shaders { class BaseYUV2RGBShader; }
 namespace Shaders { class BaseVideoFilterShader; }
@@ -147,6 +148,7 @@ public:
 #ifdef HAVE_LIBVA
   virtual void         AddProcessor(VAAPI::CHolder& holder);
 #endif
+  virtual bool         AddProcessor(CRenderBuffer* buffer);
 
   virtual void RenderUpdate(bool clear, DWORD flags = 0, DWORD alpha = 255);
 
@@ -259,6 +261,7 @@ protected:
     YV12Image image;
     unsigned  flipindex; /* used to decide if this has been uploaded */
     GLuint    pbo[MAX_PLANES];
+    CRenderBuffer* buffer; /* decoded picture to upload from instead of image */
 
 #ifdef HAVE_LIBVDPAU
     CVDPAU*   vdpau;
@@ -0,0 +1,187 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "RenderBufferPool.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+/* least alignment of the planes, whatever the decoder asks for */
+#define BUFFER_ALIGN 32
+#define ALIGN(value, alignment) (((value) + ((alignment) - 1)) & ~((alignment) - 1))
+
+CRenderBuffer::CRenderBuffer(CRenderBufferPool* pool, unsigned w, unsigned h, unsigned e, unsigned a)
+{
+  m_pool   = pool;
+  m_data   = NULL;
+  width    = w;
+  height   = h;
+  edge     = e;
+  align    = std::max(a, (unsigned)BUFFER_ALIGN);
+  cshift_x = 1;
+  cshift_y = 1;
+
+  /* horizontal padding is rounded up so every plane origin stays aligned */
+  unsigned pad = edge ? ALIGN(edge, align) : 0;
+  unsigned size[MAX_PLANES];
+  unsigned offset[MAX_PLANES];
+
+  for(int p = 0; p < MAX_PLANES; p++)
+  {
+    unsigned pw = p ? width  >> cshift_x : width;
+    unsigned ph = p ? height >> cshift_y : height;
+    unsigned pe = p ? edge   >> cshift_y : edge;
+
+    stride[p] = ALIGN(pw + 2 * pad, align);
+    size[p]   = ALIGN(stride[p] * (ph + 2 * pe + 1), align);
+    offset[p] = stride[p] * pe + pad;
+  }
+
+  unsigned total = size[0] + size[1] + size[2];
+  m_data = new BYTE[total + 2 * align];
+
+  BYTE* base = (BYTE*)ALIGN((uintptr_t)m_data, align);
+  for(int p = 0; p < MAX_PLANES; p++)
+  {
+    /* start from black, codecs may reference parts they never wrote */
+    memset(base, p ? 128 : 16, size[p]);
+    plane[p] = base + offset[p];
+    base    += size[p];
+  }
+}
+
+CRenderBuffer::~CRenderBuffer()
+{
+  delete[] m_data;
+}
+
+long CRenderBuffer::Release()
+{
+  long count = AtomicDecrement(&m_refs);
+  assert(count >= 0);
+  if (count == 0)
+    m_pool->Return(this);
+  return count;
+}
+
+bool CRenderBuffer::Matches(unsigned w, unsigned h, unsigned e, unsigned a) const
+{
+  return width == w && height == h && edge == e && align == std::max(a, (unsigned)BUFFER_ALIGN);
+}
+
+CRenderBufferPool::CRenderBufferPool(unsigned int maxFree)
+{
+  m_maxFree   = maxFree;
+  m_allocated = 0;
+}
+
+CRenderBufferPool::~CRenderBufferPool()
+{
+  Flush();
+}
+
+CRenderBuffer* CRenderBufferPool::Get(unsigned width, unsigned height, unsigned edge, unsigned align)
+{
+  std::vector<CRenderBuffer*> stale;
+  CRenderBuffer* buffer = NULL;
+  {
+    CSingleLock lock(m_section);
+    for(std::vector<CRenderBuffer*>::iterator it = m_free.begin(); it != m_free.end();)
+    {
+      if((*it)->Matches(width, height, edge, align))
+      {
+        if(!buffer)
+        {
+          buffer = *it;
+          buffer->m_refs = 1;
+        }
+        else
+        {
+          it++;
+          continue;
+        }
+      }
+      else
+        stale.push_back(*it);
+      it = m_free.erase(it);
+    }
+    m_allocated -= stale.size();
+  }
+
+  /* buffers of a previous stream size will never be used again */
+  for(std::vector<CRenderBuffer*>::iterator it = stale.begin(); it != stale.end(); it++)
+    delete *it;
+
+  if(buffer)
+  {
+    Acquire();
+    return buffer;
+  }
+
+  buffer = new CRenderBuffer(this, width, height, edge, align);
+  CLog::Log(LOGDEBUG, "CRenderBufferPool::Get - allocated new buffer of %ux%u", width, height);
+
+  /* every buffer handed out keeps the pool alive until it's returned */
+  Acquire();
+
+  CSingleLock lock(m_section);
+  m_allocated++;
+  return buffer;
+}
+
+void CRenderBufferPool::Return(CRenderBuffer* buffer)
+{
+  bool keep;
+  {
+    CSingleLock lock(m_section);
+    keep = m_free.size() < m_maxFree;
+    if(keep)
+      m_free.push_back(buffer);
+    else
+      m_allocated--;
+  }
+
+  if(!keep)
+    delete buffer;
+
+  /* may delete the pool, so it must happen outside of the lock */
+  Release();
+}
+
+void CRenderBufferPool::Flush()
+{
+  std::vector<CRenderBuffer*> free;
+  {
+    CSingleLock lock(m_section);
+    free.swap(m_free);
+    m_allocated -= free.size();
+  }
+
+  for(std::vector<CRenderBuffer*>::iterator it = free.begin(); it != free.end(); it++)
+    delete *it;
+}
+
+unsigned int CRenderBufferPool::GetAllocatedCount()
+{
+  CSingleLock lock(m_section);
+  return m_allocated;
+}
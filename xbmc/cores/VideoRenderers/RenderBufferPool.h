@@ -0,0 +1,99 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "BaseRenderer.h"
+#include "threads/CriticalSection.h"
+#include "cores/dvdplayer/DVDResource.h"
+
+#include <vector>
+
+class CRenderBufferPool;
+
+/*
+ * A planar YV12 picture that a decoder renders into directly and that
+ * is handed to the renderer by reference. The last Release() returns
+ * the memory to the pool it came from instead of freeing it.
+ */
+class CRenderBuffer : public IDVDResourceCounted<CRenderBuffer>
+{
+public:
+  virtual ~CRenderBuffer();
+  virtual long Release();
+
+  BYTE*    plane[MAX_PLANES];  // start of the visible picture, edges are in front of it
+  unsigned stride[MAX_PLANES];
+  unsigned width;              // aligned coded size of the picture, without edges
+  unsigned height;
+  unsigned edge;               // number of padding pixels around the luma plane
+  unsigned align;              // alignment of the strides and plane origins
+
+  unsigned cshift_x;
+  unsigned cshift_y;
+
+protected:
+  friend class CRenderBufferPool;
+
+  CRenderBuffer(CRenderBufferPool* pool, unsigned width, unsigned height, unsigned edge, unsigned align);
+
+  bool Matches(unsigned width, unsigned height, unsigned edge, unsigned align) const;
+
+  CRenderBufferPool* m_pool;
+  BYTE*              m_data;
+};
+
+/*
+ * Pool of render buffers owned by the render manager. Decoders acquire
+ * a reference to it and take buffers with Get(), all methods are safe
+ * to call from any thread.
+ */
+class CRenderBufferPool : public IDVDResourceCounted<CRenderBufferPool>
+{
+public:
+  CRenderBufferPool(unsigned int maxFree = 8);
+  virtual ~CRenderBufferPool();
+
+  /*
+   * returns a buffer with a reference count of 1. width and height
+   * must already be padded to what the decoder writes, e.g. by
+   * avcodec_align_dimensions2(), align is the power of two the
+   * strides have to be a multiple of.
+   */
+  CRenderBuffer* Get(unsigned width, unsigned height, unsigned edge, unsigned align);
+
+  /*
+   * drop all unused buffers, called when the video stream changes
+   */
+  void Flush();
+
+  unsigned int GetAllocatedCount();
+
+protected:
+  friend class CRenderBuffer;
+  void Return(CRenderBuffer* buffer);
+
+  CCriticalSection             m_section;
+  std::vector<CRenderBuffer*>  m_free;
+  unsigned int                 m_maxFree;
+  unsigned int                 m_allocated;
+};
@@ -46,6 +46,8 @@
 #endif
 
 #include "RenderCapture.h"
+#include "RenderBufferPool.h"
+#include "guilib/GUIQuadBatch.h"
 
 /* to use the same as player */
 #include "../dvdplayer/DVDClock.h"
@@ -102,12 +104,14 @@ CXBMCRenderManager::CXBMCRenderManager()
   m_presentmethod = VS_INTERLACEMETHOD_NONE;
   m_bReconfigured = false;
   m_hasCaptures = false;
+  m_bufferPool = new CRenderBufferPool();
 }
 
 CXBMCRenderManager::~CXBMCRenderManager()
 {
   delete m_pRenderer;
   m_pRenderer = NULL;
+  SAFE_RELEASE(m_bufferPool);
 }
 
 /* These is based on CurrentHostCounter() */
@@ -271,6 +275,9 @@ void CXBMCRenderManager::Update(bool bPauseDrawing)
 
 void CXBMCRenderManager::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
 {
+  /* the gui textures queued so far must be drawn before the video */
+  g_quadBatch.Flush();
+
   { CRetakeLock<CExclusiveLock> lock(m_sharedSection);
     if (!m_pRenderer)
       return;
@@ -337,6 +344,8 @@ void CXBMCRenderManager::UnInit()
   // TODO: we may also want to release the renderer here.
   if (m_pRenderer)
     m_pRenderer->UnInit();
+
+  m_bufferPool->Flush();
 }
 
 void CXBMCRenderManager::SetupScreenshot()
@@ -688,6 +697,11 @@ void CXBMCRenderManager::UpdateResolution()
 }
 
 
+CRenderBufferPool* CXBMCRenderManager::AcquireBufferPool()
+{
+  return m_bufferPool->Acquire();
+}
+
 int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
 {
   CSharedLock lock(m_sharedSection);
@@ -702,7 +716,12 @@ int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
 
   if(pic.format == DVDVideoPicture::FMT_YUV420P)
   {
-    CDVDCodecUtils::CopyPicture(&image, &pic);
+#ifdef HAS_GL
+    // post processing or overlays may have moved the data to a temporary picture
+    if(!pic.buffer || pic.data[0] != pic.buffer->plane[0]
+    || !m_pRenderer->AddProcessor(pic.buffer))
+#endif
+      CDVDCodecUtils::CopyPicture(&image, &pic);
   }
   else if(pic.format == DVDVideoPicture::FMT_NV12)
   {
@@ -39,6 +39,7 @@
 #include "OverlayRenderer.h"
 
 class CRenderCapture;
+class CRenderBufferPool;
 
 namespace DXVA { class CProcessor; }
 namespace VAAPI { class CSurfaceHolder; }
@@ -73,6 +74,13 @@ public:
 
   int AddVideoPicture(DVDVideoPicture& picture);
 
+  /*
+   * returns a reference to the pool decoders should render software
+   * decoded pictures into, so they can be passed without a copy.
+   * caller must Release() it when done.
+   */
+  CRenderBufferPool* AcquireBufferPool();
+
   void FlipPage(volatile bool& bStop, double timestamp = 0.0, int source = -1, EFIELDSYNC sync = FS_NONE);
   unsigned int PreInit();
   void UnInit();
@@ -169,6 +177,8 @@ protected:
   bool m_bIsStarted;
   CSharedSection m_sharedSection;
 
+  CRenderBufferPool* m_bufferPool;
+
   bool m_bReconfigured;
 
   int m_rendermethod;
@@ -37,6 +37,7 @@ namespace VAAPI { struct CHolder; }
 class CVDPAU;
 class COpenMax;
 class COpenMaxVideo;
+class CRenderBuffer;
 struct OpenMaxVideoBuffer;
 #ifdef HAVE_VIDEOTOOLBOXDECODER
   class CDVDVideoCodecVideoToolBox;
@@ -78,6 +79,8 @@ struct DVDVideoPicture
 #endif
   };
 
+  CRenderBuffer* buffer; // set if data points into a render buffer that can be passed by reference
+
   unsigned int iFlags;
 
   double       iRepeatPicture;
@@ -42,10 +42,12 @@
 #define RINT(x) ((x) >= 0 ? ((int)((x) + 0.5)) : ((int)((x) - 0.5)))
 #else
 #include <math.h>
+#include <algorithm>
 #define RINT lrint
 #endif
 
 #include "cores/VideoRenderers/RenderManager.h"
+#include "cores/VideoRenderers/RenderBufferPool.h"
 
 #ifdef HAVE_LIBVDPAU
 #include "VDPAU.h"
@@ -118,6 +120,99 @@ enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
   return ctx->m_dllAvCodec.avcodec_default_get_format(avctx, fmt);
 }
 
+/* padding ffmpeg draws around pictures when CODEC_FLAG_EMU_EDGE is not set */
+#define FF_EDGE_WIDTH 16
+
+int CDVDVideoCodecFFmpeg::GetBuffer(AVCodecContext *avctx, AVFrame *pic)
+{
+  CDVDVideoCodecFFmpeg* ctx = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  // only planar 4:2:0 can be handed to the renderer as is
+  if(avctx->pix_fmt != PIX_FMT_YUV420P
+  && avctx->pix_fmt != PIX_FMT_YUVJ420P)
+    return ctx->m_dllAvCodec.avcodec_default_get_buffer(avctx, pic);
+
+  // pad the size and strides the way the codec needs to write whole blocks
+  int width  = avctx->width;
+  int height = avctx->height;
+  int align[4];
+  ctx->m_dllAvCodec.avcodec_align_dimensions2(avctx, &width, &height, align);
+  int stride = std::max(align[0], std::max(align[1], align[2]));
+
+  unsigned edge = (avctx->flags & CODEC_FLAG_EMU_EDGE) ? 0 : FF_EDGE_WIDTH;
+  CRenderBuffer* buffer = ctx->m_pBufferPool->Get(width, height, edge, stride);
+
+  for(int i = 0; i < 3; i++)
+  {
+    pic->base[i]     = buffer->plane[i];
+    pic->data[i]     = buffer->plane[i];
+    pic->linesize[i] = buffer->stride[i];
+  }
+  pic->base[3]     = NULL;
+  pic->data[3]     = NULL;
+  pic->linesize[3] = 0;
+
+  pic->opaque = buffer;
+  pic->type   = FF_BUFFER_TYPE_USER;
+  // the content of a pooled buffer is unknown, so codecs must not skip unchanged blocks
+  pic->age    = 256*256*256*64;
+  pic->reordered_opaque = avctx->reordered_opaque;
+  return 0;
+}
+
+int CDVDVideoCodecFFmpeg::ReGetBuffer(AVCodecContext *avctx, AVFrame *pic)
+{
+  if(pic->data[0] == NULL)
+  {
+    pic->buffer_hints |= FF_BUFFER_HINTS_READABLE;
+    return avctx->get_buffer(avctx, pic);
+  }
+
+  pic->reordered_opaque = avctx->reordered_opaque;
+  if(pic->type != FF_BUFFER_TYPE_USER)
+    return 0;
+
+  // codecs using reget_buffer update the previous picture in place, if
+  // the renderer still holds it we have to continue on a copy of it
+  CRenderBuffer* buffer = (CRenderBuffer*)pic->opaque;
+  if(AtomicAdd(&buffer->m_refs, 0) <= 1)
+    return 0;
+
+  AVFrame previous = *pic;
+  if(GetBuffer(avctx, pic) < 0)
+    return -1;
+
+  for(int i = 0; i < 3; i++)
+  {
+    int w = i ? avctx->width  >> 1 : avctx->width;
+    int h = i ? avctx->height >> 1 : avctx->height;
+    for(int y = 0; y < h; y++)
+      memcpy(pic->data[i] + y * pic->linesize[i], previous.data[i] + y * previous.linesize[i], w);
+  }
+  buffer->Release();
+  return 0;
+}
+
+void CDVDVideoCodecFFmpeg::ReleaseBuffer(AVCodecContext *avctx, AVFrame *pic)
+{
+  CDVDVideoCodecFFmpeg* ctx = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  if(pic->type != FF_BUFFER_TYPE_USER)
+  {
+    ctx->m_dllAvCodec.avcodec_default_release_buffer(avctx, pic);
+    return;
+  }
+
+  // renderer may keep its own reference until the picture has been shown
+  ((CRenderBuffer*)pic->opaque)->Release();
+  pic->opaque = NULL;
+  for(int i = 0; i < 4; i++)
+  {
+    pic->base[i] = NULL;
+    pic->data[i] = NULL;
+  }
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
 {
   m_pCodecContext = NULL;
@@ -135,6 +230,7 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
   m_iScreenHeight = 0;
   m_bSoftware = false;
   m_pHardware = NULL;
+  m_pBufferPool = NULL;
   m_iLastKeyframe = 0;
   m_dts = DVD_NOPTS_VALUE;
   m_started = false;
@@ -223,6 +319,20 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     m_pCodecContext->flags |= CODEC_FLAG_EMU_EDGE;
 #endif
 
+#ifdef HAS_VIDEO_PLAYBACK
+  // decode straight into render buffers, so the renderer doesn't need to copy
+  // each picture. thumbnail extraction and dvd menus are flagged software and
+  // never reach the renderer. hardware decoders replace these callbacks.
+  if (g_advancedSettings.m_videoDirectRendering && !hints.software
+  &&  m_pHardware == NULL && pCodec->capabilities & CODEC_CAP_DR1)
+  {
+    m_pBufferPool = g_renderManager.AcquireBufferPool();
+    m_pCodecContext->get_buffer     = GetBuffer;
+    m_pCodecContext->reget_buffer   = ReGetBuffer;
+    m_pCodecContext->release_buffer = ReleaseBuffer;
+  }
+#endif
+
   // if we don't do this, then some codecs seem to fail.
   m_pCodecContext->coded_height = hints.height;
   m_pCodecContext->coded_width = hints.width;
@@ -250,6 +360,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     m_dllAvUtil.av_set_string3(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0, NULL);
   }
 
+  // avcodec_open fails if lowres is requested from a decoder that can't do it
+  if (m_pCodecContext->lowres > pCodec->max_lowres)
+    m_pCodecContext->lowres = pCodec->max_lowres;
+
 #if defined(__APPLE__) && defined(__arm__)
   m_dllAvCodec.avcodec_thread_init(m_pCodecContext, 1);
 #elif defined(_LINUX) || defined(_WIN32)
@@ -305,6 +419,7 @@ void CDVDVideoCodecFFmpeg::Dispose()
     m_pCodecContext = NULL;
   }
   SAFE_RELEASE(m_pHardware);
+  SAFE_RELEASE(m_pBufferPool);
 
   FilterClose();
 
@@ -547,6 +662,9 @@ void CDVDVideoCodecFFmpeg::Reset()
 
 bool CDVDVideoCodecFFmpeg::GetPictureCommon(DVDVideoPicture* pDvdVideoPicture)
 {
+  // the picture struct is reused by the caller, only pooled frames set this
+  pDvdVideoPicture->buffer = NULL;
+
   pDvdVideoPicture->iWidth = m_pCodecContext->width;
   pDvdVideoPicture->iHeight = m_pCodecContext->height;
 
@@ -638,6 +756,8 @@ bool CDVDVideoCodecFFmpeg::GetPictureCommon(DVDVideoPicture* pDvdVideoPicture)
 
 bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
 {
+  pDvdVideoPicture->buffer = NULL;
+
   if(m_pHardware)
     return m_pHardware->GetPicture(m_pCodecContext, m_pFrame, pDvdVideoPicture);
 
@@ -657,6 +777,10 @@ bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
       pDvdVideoPicture->data[i]      = m_pFrame->data[i];
     for (int i = 0; i < 4; i++)
       pDvdVideoPicture->iLineSize[i] = m_pFrame->linesize[i];
+
+    // the renderer can take a reference instead of copying the picture
+    if (m_pBufferPool && !m_pFilterGraph && m_pFrame->type == FF_BUFFER_TYPE_USER)
+      pDvdVideoPicture->buffer = (CRenderBuffer*)m_pFrame->opaque;
   }
 
   pDvdVideoPicture->iFlags |= pDvdVideoPicture->data[0] ? 0 : DVP_FLAG_DROPPED;
@@ -31,6 +31,7 @@
 
 class CVDPAU;
 class CCriticalSection;
+class CRenderBufferPool;
 
 class CDVDVideoCodecFFmpeg : public CDVDVideoCodec
 {
@@ -73,6 +74,9 @@ public:
 
 protected:
   static enum PixelFormat GetFormat(struct AVCodecContext * avctx, const PixelFormat * fmt);
+  static int  GetBuffer(struct AVCodecContext * avctx, AVFrame * pic);
+  static int  ReGetBuffer(struct AVCodecContext * avctx, AVFrame * pic);
+  static void ReleaseBuffer(struct AVCodecContext * avctx, AVFrame * pic);
 
   int  FilterOpen(const CStdString& filters);
   void FilterClose();
@@ -103,6 +107,7 @@ protected:
   std::string m_name;
   bool              m_bSoftware;
   IHardwareDecoder *m_pHardware;
+  CRenderBufferPool *m_pBufferPool; // set when decoding directly into render buffers
   int m_iLastKeyframe;
   double m_dts;
   bool   m_started;
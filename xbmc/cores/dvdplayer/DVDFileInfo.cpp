@@ -47,6 +47,7 @@
 #include "DllSwScale.h"
 #include "filesystem/File.h"
 
+#include <vector>
 
 bool CDVDFileInfo::GetFileDuration(const CStdString &path, int& duration)
 {
@@ -71,21 +72,124 @@ bool CDVDFileInfo::GetFileDuration(const CStdString &path, int& duration)
     return false;
 }
 
-bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &strTarget, CStreamDetails *pStreamDetails)
+void CThumbExtractStats::Reset()
 {
-  int nTime = CTimeUtils::GetTimeMS();
+  open    = 0;
+  seek    = 0;
+  decode  = 0;
+  scale   = 0;
+  total   = 0;
+  packets = 0;
+  thumbs  = 0;
+  files   = 0;
+}
+
+void CThumbExtractStats::Add(const CThumbExtractStats &stats)
+{
+  open    += stats.open;
+  seek    += stats.seek;
+  decode  += stats.decode;
+  scale   += stats.scale;
+  total   += stats.total;
+  packets += stats.packets;
+  thumbs  += stats.thumbs;
+  files   += stats.files;
+}
+
+/* open a software decoder that only outputs keyframes, at the lowest
+ * resolution that is still at least as large as the thumb */
+static CDVDVideoCodec* OpenThumbCodec(CDVDStreamInfo &hint)
+{
+  CDVDCodecOptions options;
+  options.push_back(CDVDCodecOption("skip_frame", "nokey"));
+  options.push_back(CDVDCodecOption("skip_loop_filter", "all"));
+
+  int lowres = 0;
+  while (lowres < 3 && (hint.width >> (lowres + 1)) >= g_advancedSettings.m_thumbSize)
+    lowres++;
+  if (lowres > 0)
+  {
+    CStdString value;
+    value.Format("%d", lowres);
+    options.push_back(CDVDCodecOption("lowres", value));
+  }
+
+  CDVDVideoCodec* pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, options);
+  if (pVideoCodec)
+    return pVideoCodec;
+
+  // libmpeg2 is not thread safe so only fall back for other codecs
+  if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
+    return NULL;
+  return CDVDFactoryCodec::CreateVideoCodec(hint);
+}
+
+/* read packets from the current position until the decoder returns a picture */
+static bool DecodeThumbPicture(CDVDDemux *pDemuxer, CDVDVideoCodec *pVideoCodec, int nVideoStream, DVDVideoPicture &picture, CThumbExtractStats &stats)
+{
+  int iDecoderState = VC_ERROR;
+
+  // num streams * 40 frames, should get a valid frame, if not abort.
+  int abort_index = pDemuxer->GetNrOfStreams() * 40;
+  do
+  {
+    DemuxPacket* pPacket = pDemuxer->Read();
+    if (!pPacket)
+      break;
+
+    stats.packets++;
+    if (pPacket->iStreamId != nVideoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    if (iDecoderState & VC_ERROR)
+      break;
+
+    if (iDecoderState & VC_PICTURE)
+    {
+      memset(&picture, 0, sizeof(DVDVideoPicture));
+      if (pVideoCodec->GetPicture(&picture))
+      {
+        if(!(picture.iFlags & DVP_FLAG_DROPPED))
+          break;
+      }
+    }
+
+  } while (abort_index--);
+
+  return (iDecoderState & VC_PICTURE) && !(picture.iFlags & DVP_FLAG_DROPPED);
+}
+
+bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &strTarget, CStreamDetails *pStreamDetails, CThumbExtractStats *pStats)
+{
+  return ExtractThumbs(strPath, strTarget, "", pStreamDetails, pStats) > 0;
+}
+
+int CDVDFileInfo::ExtractThumbs(const CStdString &strPath, const CStdString &strTarget, const CStdString &strChapterTarget, CStreamDetails *pStreamDetails, CThumbExtractStats *pStats)
+{
+  CThumbExtractStats stats;
+  stats.files = 1;
+
+  unsigned int nTime  = CTimeUtils::GetTimeMS();
+  unsigned int nStart = nTime;
+
   CDVDInputStream *pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, strPath, "");
   if (!pInputStream)
   {
     CLog::Log(LOGERROR, "InputStream: Error creating stream for %s", strPath.c_str());
-    return false;
+    return 0;
   }
 
   if (pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD))
   {
     CLog::Log(LOGERROR, "InputStream: dvd streams not supported for thumb extraction, file: %s", strPath.c_str());
     delete pInputStream;
-    return false;
+    return 0;
   }
 
   if (!pInputStream->Open(strPath.c_str(), ""))
@@ -93,7 +197,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
     CLog::Log(LOGERROR, "InputStream: Error opening, %s", strPath.c_str());
     if (pInputStream)
       delete pInputStream;
-    return false;
+    return 0;
   }
 
   CDVDDemux *pDemuxer = NULL;
@@ -105,7 +209,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
     {
       delete pInputStream;
       CLog::Log(LOGERROR, "%s - Error creating demuxer", __FUNCTION__);
-      return false;
+      return 0;
     }
   }
   catch(...)
@@ -114,7 +218,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
     if (pDemuxer)
       delete pDemuxer;
     delete pInputStream;
-    return false;
+    return 0;
   }
 
   if (pStreamDetails)
@@ -134,105 +238,119 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
     }
   }
 
-  bool bOk = false;
-  if (nVideoStream != -1)
+  // one entry per thumb, chapter number (1 based) or 0 for a third into the file
+  std::vector<int> positions;
+  std::vector<CStdString> targets;
+  if (!strTarget.IsEmpty())
+  {
+    positions.push_back(0);
+    targets.push_back(strTarget);
+  }
+  if (!strChapterTarget.IsEmpty())
   {
-    CDVDVideoCodec *pVideoCodec;
+    for (int i = 1; i <= pDemuxer->GetChapterCount(); i++)
+    {
+      CStdString strChapter;
+      strChapter.Format("-chapter%d", i);
+      positions.push_back(i);
+      targets.push_back(URIUtils::ReplaceExtension(strChapterTarget, strChapter + URIUtils::GetExtension(strChapterTarget)));
+    }
+  }
 
+  int nThumbs = 0;
+  bool bThumb = false;
+  if (nVideoStream != -1 && !positions.empty())
+  {
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
-    {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
-    }
-    else
-    {
-      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
-    }
+    CDVDVideoCodec *pVideoCodec = OpenThumbCodec(hint);
+
+    stats.open += CTimeUtils::GetTimeMS() - nTime;
 
     if (pVideoCodec)
     {
-      int nTotalLen = pDemuxer->GetStreamLength();
-      int nSeekTo = nTotalLen / 3;
+      DllSwScale dllSwScale;
+      dllSwScale.Load();
 
-      CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, strPath.c_str());
-      if (pDemuxer->SeekTime(nSeekTo, true))
-      {
-        DemuxPacket* pPacket = NULL;
-        int iDecoderState = VC_ERROR;
-        DVDVideoPicture picture;
+      struct SwsContext *context = NULL;
+      BYTE *pOutBuf = NULL;
+      int nWidth = 0, nHeight = 0, nSrcWidth = 0, nSrcHeight = 0;
 
-        // num streams * 40 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 40;
-        do
+      for (unsigned int i = 0; i < positions.size(); i++)
+      {
+        nTime = CTimeUtils::GetTimeMS();
+        bool bSeek;
+        if (positions[i] > 0)
         {
-          pPacket = pDemuxer->Read();
-          if (!pPacket)
-            break;
+          CLog::Log(LOGDEBUG,"%s - seeking to chapter %d in %s", __FUNCTION__, positions[i], strPath.c_str());
+          bSeek = pDemuxer->SeekChapter(positions[i]);
+        }
+        else
+        {
+          int nTotalLen = pDemuxer->GetStreamLength();
+          int nSeekTo = nTotalLen / 3;
 
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
+          CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, strPath.c_str());
+          bSeek = pDemuxer->SeekTime(nSeekTo, true);
+        }
+        pVideoCodec->Reset();
+        stats.seek += CTimeUtils::GetTimeMS() - nTime;
 
-          iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+        if (!bSeek)
+          continue;
 
-          if (iDecoderState & VC_ERROR)
-            break;
+        nTime = CTimeUtils::GetTimeMS();
+        DVDVideoPicture picture;
+        bool bPicture = DecodeThumbPicture(pDemuxer, pVideoCodec, nVideoStream, picture, stats);
+        stats.decode += CTimeUtils::GetTimeMS() - nTime;
 
-          if (iDecoderState & VC_PICTURE)
-          {
-            memset(&picture, 0, sizeof(DVDVideoPicture));
-            if (pVideoCodec->GetPicture(&picture))
-            {
-              if(!(picture.iFlags & DVP_FLAG_DROPPED))
-                break;
-            }
-          }
+        if (!bPicture)
+        {
+          CLog::Log(LOGDEBUG,"%s - decode failed in %s", __FUNCTION__, strPath.c_str());
+          continue;
+        }
 
-        } while (abort_index--);
+        nTime = CTimeUtils::GetTimeMS();
+        if (!context || nSrcWidth != (int)picture.iWidth || nSrcHeight != (int)picture.iHeight)
+        {
+          nSrcWidth  = picture.iWidth;
+          nSrcHeight = picture.iHeight;
+          nWidth     = g_advancedSettings.m_thumbSize;
+          double aspect = (double)picture.iWidth / (double)picture.iHeight;
+          nHeight    = (int)((double)g_advancedSettings.m_thumbSize / aspect);
+
+          if (context)
+            dllSwScale.sws_freeContext(context);
+          delete [] pOutBuf;
+
+          pOutBuf = new BYTE[nWidth * nHeight * 4];
+          context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight,
+                PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+        }
 
-        if (iDecoderState & VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+        if (context)
         {
+          uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
+          int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
+          uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+          int     dstStride[] = { nWidth*4, 0, 0, 0 };
+
+          dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+          if (CPicture::CreateThumbnailFromSurface(pOutBuf, nWidth, nHeight, nWidth * 4, targets[i]))
           {
-            int nWidth = g_advancedSettings.m_thumbSize;
-            double aspect = (double)picture.iWidth / (double)picture.iHeight;
-            int nHeight = (int)((double)g_advancedSettings.m_thumbSize / aspect);
-
-            DllSwScale dllSwScale;
-            dllSwScale.Load();
-
-            BYTE *pOutBuf = new BYTE[nWidth * nHeight * 4];
-            struct SwsContext *context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight,
-                  PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-            uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
-            int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
-            uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-            int     dstStride[] = { nWidth*4, 0, 0, 0 };
-
-            if (context)
-            {
-              dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              dllSwScale.sws_freeContext(context);
-
-              CPicture::CreateThumbnailFromSurface(pOutBuf, nWidth, nHeight, nWidth * 4, strTarget);
-              bOk = true;
-            }
-
-            dllSwScale.Unload();
-            delete [] pOutBuf;
+            nThumbs++;
+            if (positions[i] == 0)
+              bThumb = true;
           }
         }
-        else
-        {
-          CLog::Log(LOGDEBUG,"%s - decode failed in %s", __FUNCTION__, strPath.c_str());
-        }
+        stats.scale += CTimeUtils::GetTimeMS() - nTime;
       }
+
+      if (context)
+        dllSwScale.sws_freeContext(context);
+      dllSwScale.Unload();
+      delete [] pOutBuf;
       delete pVideoCodec;
     }
   }
@@ -242,16 +360,22 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, const CStdString &str
 
   delete pInputStream;
 
-  if(!bOk)
+  if(!bThumb && !strTarget.IsEmpty())
   {
     XFILE::CFile file;
     if(file.OpenForWrite(strTarget))
       file.Close();
   }
 
-  int nTotalTime = CTimeUtils::GetTimeMS() - nTime;
-  CLog::Log(LOGDEBUG,"%s - measured %d ms to extract thumb from file <%s> ", __FUNCTION__, nTotalTime, strPath.c_str());
-  return bOk;
+  stats.thumbs = nThumbs;
+  stats.total  = CTimeUtils::GetTimeMS() - nStart;
+  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract %d thumbs from file <%s> (open %u, seek %u, decode %u, scale %u ms, %u packets)",
+            __FUNCTION__, stats.total, nThumbs, strPath.c_str(), stats.open, stats.seek, stats.decode, stats.scale, stats.packets);
+
+  if (pStats)
+    pStats->Add(stats);
+
+  return nThumbs;
 }
 
 /**
@@ -27,11 +27,33 @@ class CDVDDemux;
 class CStreamDetails;
 class CDVDInputStream;
 
+// Time spent in each stage of thumb extraction, in ms. Can be summed over a batch of files.
+class CThumbExtractStats
+{
+public:
+  CThumbExtractStats() { Reset(); }
+  void Reset();
+  void Add(const CThumbExtractStats &stats);
+
+  unsigned int open;
+  unsigned int seek;
+  unsigned int decode;
+  unsigned int scale;
+  unsigned int total;
+  unsigned int packets;
+  unsigned int thumbs;
+  unsigned int files;
+};
+
 class CDVDFileInfo
 {
 public:
   // Extract a thumbnail immage from the media at strPath an image file in strTarget, optionally populating a streamdetails class with the data
-  static bool ExtractThumb(const CStdString &strPath, const CStdString &strTarget, CStreamDetails *pStreamDetails);
+  static bool ExtractThumb(const CStdString &strPath, const CStdString &strTarget, CStreamDetails *pStreamDetails, CThumbExtractStats *pStats = NULL);
+
+  // Extract the thumb above to strTarget and one thumb per chapter, chapter n (1 based) going to strChapterTarget with "-chapter<n>" before the extension,
+  // in a single pass over the file. Either target may be empty to skip it. Returns the number of thumbs written.
+  static int ExtractThumbs(const CStdString &strPath, const CStdString &strTarget, const CStdString &strChapterTarget, CStreamDetails *pStreamDetails, CThumbExtractStats *pStats = NULL);
 
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
@@ -67,64 +67,45 @@ VecOverlays* CDVDOverlayContainer::GetOverlays()
   return &m_overlays;
 }
 
-VecOverlaysIter CDVDOverlayContainer::Remove(VecOverlaysIter itOverlay)
-{
-  VecOverlaysIter itNext;
-  CDVDOverlay* pOverlay = *itOverlay;
-
-  {
-    CSingleLock lock(*this);
-    itNext = m_overlays.erase(itOverlay);
-  }
-
-  pOverlay->Release();
-
-  return itNext;
-}
-
 void CDVDOverlayContainer::CleanUp(double pts)
 {
   CDVDOverlay* pOverlay = NULL;
 
   CSingleLock lock(*this);
 
-  VecOverlaysIter it = m_overlays.begin();
-  while (it != m_overlays.end())
+  // forced overlays are replaced by the last forced one that has started
+  int iLastForced = -1;
+  for (int i = 0; i < (int)m_overlays.size(); i++)
+  {
+    if (m_overlays[i]->bForced && m_overlays[i]->iPTSStartTime <= pts)
+      iLastForced = i;
+  }
+
+  // the ones kept move up in place, so this is one pass however many go
+  unsigned int iKept = 0;
+  for (int i = 0; i < (int)m_overlays.size(); i++)
   {
-    pOverlay = *it;
+    pOverlay = m_overlays[i];
 
     // never delete forced overlays, they are used in menu's
     // clear takes care of removing them
     // also if stoptime = 0, it means the next subtitles will use its starttime as the stoptime
     // which means we cannot delete overlays with stoptime 0
-    if (!pOverlay->bForced && pOverlay->iPTSStopTime <= pts && pOverlay->iPTSStopTime != 0)
+    bool bRemove;
+    if (pOverlay->bForced)
+      bRemove = i < iLastForced;
+    else
+      bRemove = pOverlay->iPTSStopTime <= pts && pOverlay->iPTSStopTime != 0;
+
+    if (bRemove)
     {
-      //CLog::Log(LOGDEBUG,"CDVDOverlay::CleanUp, removing %d", (int)(pts / 1000));
       //CLog::Log(LOGDEBUG,"CDVDOverlay::CleanUp, remove, start : %d, stop : %d", (int)(pOverlay->iPTSStartTime / 1000), (int)(pOverlay->iPTSStopTime / 1000));
-      it = Remove(it);
-      continue;
+      pOverlay->Release();
     }
-    else if (pOverlay->bForced)
-    {
-      //Check for newer replacements
-      VecOverlaysIter it2 = it;
-      CDVDOverlay* pOverlay2;
-      bool bNewer = false;
-      while (!bNewer && ++it2 != m_overlays.end())
-      {
-        pOverlay2 = *it2;
-        if (pOverlay2->bForced && pOverlay2->iPTSStartTime <= pts) bNewer = true;
-      }
-
-      if (bNewer)
-      {
-        it = Remove(it);
-        continue;
-      }
-    }
-    it++;
+    else
+      m_overlays[iKept++] = pOverlay;
   }
-
+  m_overlays.resize(iKept);
 }
 
 void CDVDOverlayContainer::Remove()
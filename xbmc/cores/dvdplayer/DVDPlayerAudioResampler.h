@@ -20,7 +20,7 @@
  */
 #pragma once
 
-#include <samplerate.h>
+#include "cores/AudioEngine/Utils/AEResample.h"
 
 #define MAXRATIO 30
 
@@ -50,8 +50,7 @@ class CDVDPlayerResampler
 
     int        m_nrchannels;
     int        m_quality;
-    SRC_STATE* m_converter;
-    SRC_DATA   m_converterdata;
+    CAEResample m_converter;
     double     m_ratio;
 
     float*     m_buffer;     //buffer for the audioframes
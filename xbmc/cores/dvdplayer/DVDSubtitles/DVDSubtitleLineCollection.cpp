@@ -22,14 +22,20 @@
 #include "DVDSubtitleLineCollection.h"
 #include "DVDClock.h"
 
+#include <algorithm>
+#include <float.h>
+
+static bool CompareStartTime(const CDVDOverlay* p1, const CDVDOverlay* p2)
+{
+  return p1->iPTSStartTime < p2->iPTSStartTime;
+}
 
 CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
+  m_leaves = 0;
+  m_indexed = false;
 
-  m_iSize = 0;
+  m_current = 0;
   m_fLastPts = DVD_NOPTS_VALUE;
 }
 
@@ -40,90 +46,96 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
+  m_overlays.push_back(pOverlay);
+  m_indexed = false;
+}
 
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
+void CDVDSubtitleLineCollection::Sort()
+{
+  // overlays starting together stay in the order of the file
+  std::stable_sort(m_overlays.begin(), m_overlays.end(), CompareStartTime);
+  m_indexed = false;
+}
 
-  m_iSize++;
+void CDVDSubtitleLineCollection::BuildIndex()
+{
+  m_leaves = 1;
+  while (m_leaves < (int)m_overlays.size())
+    m_leaves *= 2;
+
+  // the leaves past the last overlay never match
+  m_maxStop.assign(2 * m_leaves, -DBL_MAX);
+  for (unsigned int i = 0; i < m_overlays.size(); i++)
+    m_maxStop[m_leaves + i] = m_overlays[i]->iPTSStopTime;
+  for (int node = m_leaves - 1; node > 0; node--)
+    m_maxStop[node] = std::max(m_maxStop[2 * node], m_maxStop[2 * node + 1]);
+
+  m_indexed = true;
 }
 
-void CDVDSubtitleLineCollection::Sort()
+int CDVDSubtitleLineCollection::FindNext(int first, double iPts) const
 {
-  if (!m_pHead || !m_pHead->pNext)
-    return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext->pNext != NULL; p1 = p1->pNext)
+  if (first >= (int)m_overlays.size())
+    return -1;
+
+  // climb until the subtree right of the path holds an overlay still showing
+  int node = m_leaves + first;
+  while (m_maxStop[node] < iPts)
   {
-    for (ListElement* p2 = p1->pNext; p2->pNext != NULL; p2 = p2->pNext)
+    while (node & 1)
     {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
+      if (node == 1)
+        return -1;
+      node /= 2;
     }
+    node++;
   }
+
+  // and go down to the first one in it
+  while (node < m_leaves)
+  {
+    node *= 2;
+    if (m_maxStop[node] < iPts)
+      node++;
+  }
+  return node - m_leaves;
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  if (!m_indexed)
+    BuildIndex();
 
   if (iPts < m_fLastPts)
     Reset();
 
-  if (m_pCurrent)
+  int next = FindNext(m_current, iPts);
+  if (next < 0)
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
-
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
-
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-      m_fLastPts = iPts;
-    }
+    m_current = m_overlays.size();
+    return NULL;
   }
-  return pOverlay;
+
+  // advance to the next overlay
+  m_current = next + 1;
+  m_fLastPts = iPts;
+  return m_overlays[next];
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
-
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  for (unsigned int i = 0; i < m_overlays.size(); i++)
+    m_overlays[i]->Release();
+  m_overlays.clear();
+  m_maxStop.clear();
+
+  m_leaves   = 0;
+  m_indexed  = false;
+  m_current  = 0;
   m_fLastPts = DVD_NOPTS_VALUE;
 }
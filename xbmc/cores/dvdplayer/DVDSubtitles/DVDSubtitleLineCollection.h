@@ -23,13 +23,16 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <vector>
 
+/*
+ * The overlays of a subtitle file, looked up by the time they are shown.
+ *
+ * The stop times are kept in a binary tree over the overlays, each node
+ * holding the latest stop time under it, so the next overlay still showing
+ * at a pts is found in O(log n) wherever playback is, also after a seek.
+ * The stop times are not to change once Get has been called.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
@@ -46,16 +49,19 @@ public:
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return m_overlays.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  void BuildIndex();
+  int FindNext(int first, double iPts) const; // first overlay from first on not stopped at iPts, -1 if none
+
+  VecOverlays m_overlays;
+  std::vector<double> m_maxStop; // the tree, node n has children 2n and 2n+1, the overlays are the leaves
+  int m_leaves;
+  bool m_indexed;
 
-  int m_iSize;
+  int m_current;
   double m_fLastPts;
   //CRITICAL_SECTION m_critSection;
 };
@@ -0,0 +1,180 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+#include "DVDSubtitles/DVDSubtitleLineCollection.h"
+#include "DVDClock.h"
+#include "utils/test/TestUtils.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+static bool CompareStart(const CDVDOverlay* p1, const CDVDOverlay* p2)
+{
+  return p1->iPTSStartTime < p2->iPTSStartTime;
+}
+
+// how Get worked on the linked list, walking on from the last overlay and from the start after a seek back
+class CListLookup
+{
+  const VecOverlays& m_overlays;
+  unsigned int m_current;
+  double m_fLastPts;
+public:
+  CListLookup(const VecOverlays& overlays) : m_overlays(overlays), m_current(0), m_fLastPts(DVD_NOPTS_VALUE) {}
+
+  CDVDOverlay* Get(double iPts)
+  {
+    if (iPts < m_fLastPts)
+      m_current = 0;
+    while (m_current < m_overlays.size() && m_overlays[m_current]->iPTSStopTime < iPts)
+      m_current++;
+    if (m_current == m_overlays.size())
+      return NULL;
+    m_fLastPts = iPts;
+    return m_overlays[m_current++];
+  }
+};
+
+/*
+ * Cues like a karaoke track has them, a line every couple of seconds and
+ *  syllables on top of it, with now and then one staying up for long.
+ *  overlays gets them in the order they are shown.
+ */
+static double MakeCues(CDVDSubtitleLineCollection& collection, VecOverlays& overlays, unsigned int count)
+{
+  srand(1);
+  double start = 0;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    CDVDOverlay* pOverlay = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+    pOverlay->iPTSStartTime = start;
+    if (i % 500 == 0)
+      pOverlay->iPTSStopTime = start + 600 * DVD_TIME_BASE;
+    else
+      pOverlay->iPTSStopTime = start + (rand() % 4000 + 100) * (DVD_TIME_BASE / 1000);
+    overlays.push_back(pOverlay);
+    if (rand() % 3)
+      start += (rand() % 500) * (DVD_TIME_BASE / 1000);
+  }
+
+  // added out of order, as the parsers may
+  for (unsigned int i = 0; i + 1 < count; i += 7)
+    std::swap(overlays[i], overlays[i + 1]);
+  for (unsigned int i = 0; i < count; i++)
+    collection.Add(overlays[i]);
+  collection.Sort();
+  std::stable_sort(overlays.begin(), overlays.end(), CompareStart);
+
+  return start;
+}
+
+BOOST_AUTO_TEST_CASE(TestDVDSubtitleLineCollectionGet)
+{
+  CDVDSubtitleLineCollection collection;
+  BOOST_CHECK(collection.Get(0) == NULL);
+
+  double times[][2] = { { 30, 40 }, { 10, 20 }, { 10, 15 }, { 12, 50 }, { 60, 70 } };
+  CDVDOverlay* overlays[5];
+  for (unsigned int i = 0; i < 5; i++)
+  {
+    overlays[i] = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+    overlays[i]->iPTSStartTime = times[i][0];
+    overlays[i]->iPTSStopTime  = times[i][1];
+    collection.Add(overlays[i]);
+  }
+  collection.Sort();
+  BOOST_CHECK_EQUAL(5, collection.GetSize());
+
+  // in order of starting, the ones starting together as they were added
+  BOOST_CHECK(collection.Get(0) == overlays[1]);
+  BOOST_CHECK(collection.Get(0) == overlays[2]);
+  BOOST_CHECK(collection.Get(0) == overlays[3]);
+  BOOST_CHECK(collection.Get(0) == overlays[0]);
+  BOOST_CHECK(collection.Get(0) == overlays[4]);
+  BOOST_CHECK(collection.Get(0) == NULL);
+
+  // skipping what has stopped, and starting over after a seek back
+  collection.Reset();
+  BOOST_CHECK(collection.Get(18) == overlays[1]);
+  BOOST_CHECK(collection.Get(45) == overlays[3]);
+  BOOST_CHECK(collection.Get(45) == overlays[4]);
+  BOOST_CHECK(collection.Get(41) == overlays[3]);
+  BOOST_CHECK(collection.Get(80) == NULL);
+
+  collection.Reset();
+  BOOST_CHECK(collection.Get(80) == NULL);
+  collection.Reset();
+  BOOST_CHECK(collection.Get(70) == overlays[4]);
+
+  collection.Clear();
+  BOOST_CHECK_EQUAL(0, collection.GetSize());
+  BOOST_CHECK(collection.Get(0) == NULL);
+}
+
+BOOST_AUTO_TEST_CASE(TestDVDSubtitleLineCollectionSeeks)
+{
+  CDVDSubtitleLineCollection collection;
+  VecOverlays overlays;
+  double length = MakeCues(collection, overlays, 3000);
+  CListLookup list(overlays);
+
+  // playing along, with seeks both ways
+  double pts = 0;
+  for (unsigned int i = 0; i < 20000; i++)
+  {
+    if (rand() % 50 == 0)
+      pts = ((double)rand() / RAND_MAX) * length;
+    else
+      pts += (rand() % 100) * (DVD_TIME_BASE / 1000);
+    BOOST_REQUIRE(collection.Get(pts) == list.Get(pts));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestDVDSubtitleLineCollectionBenchmark)
+{
+  const unsigned int cues = 50000;
+  const unsigned int seeks = 20000;
+  CDVDSubtitleLineCollection collection;
+  VecOverlays overlays;
+  double length = MakeCues(collection, overlays, cues);
+
+  std::vector<double> seek(seeks);
+  for (unsigned int i = 0; i < seeks; i++)
+    seek[i] = ((double)rand() / RAND_MAX) * length;
+
+  CListLookup list(overlays);
+  std::vector<CDVDOverlay*> found(seeks);
+  double start = NowMS();
+  for (unsigned int i = 0; i < seeks; i++)
+    found[i] = list.Get(seek[i]);
+  double walked = (NowMS() - start) * 1000.0 / seeks;
+
+  start = NowMS();
+  for (unsigned int i = 0; i < seeks; i++)
+    BOOST_REQUIRE(collection.Get(seek[i]) == found[i]);
+  double indexed = (NowMS() - start) * 1000.0 / seeks;
+
+  BOOST_TEST_MESSAGE(cues << " cues, a lookup after a random seek: " << walked << "us walking the list, "
+                     << indexed << "us with the index");
+}
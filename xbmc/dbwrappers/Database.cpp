@@ -20,6 +20,7 @@
  */
 
 #include "Database.h"
+#include "DatabasePool.h"
 #include "Util.h"
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
@@ -148,6 +149,33 @@ CStdString CDatabase::GetSingleValue(const CStdString &strTable, const CStdStrin
   return strReturn;
 }
 
+int CDatabase::GetRowCount(const CStdString &strTable, const CStdString &strWhereClause /* = CStdString() */)
+{
+  int count = -1;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return count;
+    if (NULL == m_pDS.get()) return count;
+
+    // the where clause may contain joins and is already formatted
+    CStdString strQuery = "SELECT COUNT(1) FROM " + strTable + " " + strWhereClause;
+    if (!m_pDS->query(strQuery.c_str())) return count;
+
+    if (m_pDS->num_rows() > 0)
+      count = m_pDS->fv(0).get_asInt();
+
+    m_pDS->close();
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to count rows of '%s' (%s)",
+        __FUNCTION__, strTable.c_str(), strWhereClause.c_str());
+  }
+
+  return count;
+}
+
 bool CDatabase::DeleteValues(const CStdString &strTable, const CStdString &strWhereClause /* = CStdString() */)
 {
   bool bReturn = true;
@@ -273,6 +301,26 @@ bool CDatabase::Open(DatabaseSettings &dbSettings)
       CLog::Log(LOGINFO, "essential mysql database information is missing (eg. host, name, user, pass)");
   }
 
+  // reuse a connection that was opened and version checked before if we have one
+  CStdString versionedName;
+  versionedName.Format("%s%d", GetBaseDBName(), GetMinVersion());
+  CStdString poolKey;
+  if (m_sqlite)
+    poolKey = CDatabasePool::GetKey("sqlite3", _P(g_settings.GetDatabaseFolder()), "", "", versionedName);
+  else
+    poolKey = CDatabasePool::GetKey(dbSettings.type, dbSettings.host, dbSettings.port, dbSettings.user, dbSettings.name + "/" + versionedName);
+
+  CDatabasePool::Connection connection;
+  if (CDatabasePool::Get().Borrow(poolKey, connection))
+  {
+    m_pDB.reset(connection.db);
+    m_pDS.reset(connection.ds);
+    m_pDS2.reset(connection.ds2);
+    m_poolKey = poolKey;
+    m_openCount = 1;
+    return true;
+  }
+
   // always safely fallback to sqlite3, and use separate, versioned database
   if (m_sqlite)
   {
@@ -311,7 +359,10 @@ bool CDatabase::Open(DatabaseSettings &dbSettings)
         }
         // yay - we have a copy of our db, now do our worst with it
         if (UpdateVersion(dbSettings.name))
+        {
+          m_poolKey = poolKey;
           return true;
+        }
         // update failed - loop around and see if we have another one available
         Close();
       }
@@ -323,7 +374,10 @@ bool CDatabase::Open(DatabaseSettings &dbSettings)
   }
 
   if (Connect(dbSettings, true) && UpdateVersion(dbSettings.name))
+  {
+    m_poolKey = poolKey;
     return true;
+  }
   // failed to update or open the database
   Close();
   CLog::Log(LOGERROR, "Unable to open database %s", dbSettings.name.c_str());
@@ -444,6 +498,19 @@ void CDatabase::Close()
   m_openCount = 0;
 
   if (NULL == m_pDB.get() ) return ;
+
+  // hand the connection back to the pool rather than disconnecting
+  if (!m_poolKey.IsEmpty())
+  {
+    CDatabasePool::Connection connection;
+    connection.db  = m_pDB.release();
+    connection.ds  = m_pDS.release();
+    connection.ds2 = m_pDS2.release();
+    CDatabasePool::Get().Return(m_poolKey, connection);
+    m_poolKey.clear();
+    return;
+  }
+
   if (NULL != m_pDS.get()) m_pDS->close();
   m_pDB->disconnect();
   m_pDB.reset();
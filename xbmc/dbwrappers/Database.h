@@ -63,6 +63,15 @@ public:
    */
   CStdString GetSingleValue(const CStdString &strTable, const CStdString &strColumn, const CStdString &strWhereClause = CStdString(), const CStdString &strOrderBy = CStdString());
 
+  /*!
+   * @brief Count the rows of a table or view.
+   * @remarks The value of the strWhereClause parameter has to be FormatSQL'ed when used.
+   * @param strTable The table or view to count the rows of.
+   * @param strWhereClause If set, the joins and WHERE clause to apply, including the WHERE keyword.
+   * @return The number of rows, or -1 if the query failed.
+   */
+  int GetRowCount(const CStdString &strTable, const CStdString &strWhereClause = CStdString());
+
   /*!
    * @brief Delete values from a table.
    * @remarks The value of the strWhereClause parameter has to be FormatSQL'ed when used.
@@ -131,4 +140,5 @@ private:
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
+  CStdString m_poolKey; ///< \brief database our connection is returned to on Close(), empty if it's not pooled
 };
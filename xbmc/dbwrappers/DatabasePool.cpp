@@ -0,0 +1,241 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "DatabasePool.h"
+#include "dataset.h"
+#include "threads/SingleLock.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+using namespace dbiplus;
+
+// connections idle for longer than this are checked before being handed out
+#define HEALTH_CHECK_INTERVAL 5000
+
+CDatabasePool &CDatabasePool::Get()
+{
+  static CDatabasePool s_pool;
+  return s_pool;
+}
+
+CDatabasePool::CDatabasePool()
+{
+  m_enabled = true;
+  m_connectsAvoided = 0;
+  m_connectsMade = 0;
+  m_waitTime = 0;
+}
+
+CDatabasePool::~CDatabasePool()
+{
+  Deinitialize();
+}
+
+CStdString CDatabasePool::GetKey(const CStdString &type, const CStdString &host, const CStdString &port,
+                                 const CStdString &user, const CStdString &name)
+{
+  CStdString key;
+  key.Format("%s://%s@%s:%s/%s", type.c_str(), user.c_str(), host.c_str(), port.c_str(), name.c_str());
+  return key;
+}
+
+bool CDatabasePool::Borrow(const CStdString &key, Connection &connection)
+{
+  unsigned int start = CTimeUtils::GetTimeMS();
+  std::vector<Connection> expired;
+  bool found = false;
+  Entry entry;
+  {
+    CSingleLock lock(m_section);
+    Expire(start, expired);
+
+    Pool::iterator it = m_pool.find(key);
+    if (it != m_pool.end() && !it->second.empty())
+    {
+      // prefer the connection this thread used last, otherwise the most recently used one
+      Entries &entries = it->second;
+      Entries::iterator match = entries.end() - 1;
+      ThreadIdentifier thread = CThread::GetCurrentThreadId();
+      for (Entries::iterator i = entries.begin(); i != entries.end(); ++i)
+      {
+        if (i->thread == thread)
+          match = i;
+      }
+      entry = *match;
+      entries.erase(match);
+      found = true;
+    }
+  }
+
+  for (std::vector<Connection>::iterator it = expired.begin(); it != expired.end(); ++it)
+    Disconnect(*it);
+
+  if (found && start - entry.released > HEALTH_CHECK_INTERVAL && !IsHealthy(entry.connection))
+  {
+    CLog::Log(LOGDEBUG, "%s - dropping stale connection to %s", __FUNCTION__, entry.connection.db->getDatabase());
+    Disconnect(entry.connection);
+    found = false;
+  }
+
+  CSingleLock lock(m_section);
+  m_waitTime += CTimeUtils::GetTimeMS() - start;
+  if (!found)
+  {
+    m_connectsMade++;
+    return false;
+  }
+
+  m_connectsAvoided++;
+  connection = entry.connection;
+  return true;
+}
+
+void CDatabasePool::Return(const CStdString &key, const Connection &connection)
+{
+  if (!connection.db)
+    return;
+
+  // leave the connection as a fresh one would be
+  try
+  {
+    if (connection.ds)
+      connection.ds->close();
+    if (connection.ds2)
+    {
+      connection.ds2->close();
+      connection.ds2->clear_insert_sql();
+    }
+    if (connection.db->in_transaction())
+      connection.db->rollback_transaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to reset connection to %s", __FUNCTION__, connection.db->getDatabase());
+    Disconnect(connection);
+    return;
+  }
+
+  unsigned int now = CTimeUtils::GetTimeMS();
+  std::vector<Connection> expired;
+  bool pooled = false;
+  {
+    CSingleLock lock(m_section);
+    Expire(now, expired);
+
+    Entries &entries = m_pool[key];
+    if (m_enabled && entries.size() < (unsigned int)g_advancedSettings.m_databasePoolSize)
+    {
+      Entry entry;
+      entry.connection = connection;
+      entry.thread     = CThread::GetCurrentThreadId();
+      entry.released   = now;
+      entries.push_back(entry);
+      pooled = true;
+    }
+  }
+
+  if (!pooled)
+    expired.push_back(connection);
+  for (std::vector<Connection>::iterator it = expired.begin(); it != expired.end(); ++it)
+    Disconnect(*it);
+}
+
+void CDatabasePool::Clear()
+{
+  std::vector<Connection> connections;
+  {
+    CSingleLock lock(m_section);
+    for (Pool::iterator it = m_pool.begin(); it != m_pool.end(); ++it)
+    {
+      for (Entries::iterator i = it->second.begin(); i != it->second.end(); ++i)
+        connections.push_back(i->connection);
+    }
+    m_pool.clear();
+  }
+
+  for (std::vector<Connection>::iterator it = connections.begin(); it != connections.end(); ++it)
+    Disconnect(*it);
+}
+
+void CDatabasePool::Deinitialize()
+{
+  {
+    CSingleLock lock(m_section);
+    if (!m_enabled)
+      return;
+    m_enabled = false;
+    CLog::Log(LOGDEBUG, "%s - %u connects avoided, %u connects made, %u ms spent borrowing",
+              __FUNCTION__, m_connectsAvoided, m_connectsMade, m_waitTime);
+  }
+  Clear();
+}
+
+bool CDatabasePool::IsHealthy(const Connection &connection)
+{
+  try
+  {
+    if (!connection.db->isActive() || !connection.ds->query("SELECT 1"))
+      return false;
+    connection.ds->close();
+    return true;
+  }
+  catch (...)
+  {
+  }
+  return false;
+}
+
+void CDatabasePool::Expire(unsigned int now, std::vector<Connection> &expired)
+{
+  unsigned int timeout = g_advancedSettings.m_databasePoolIdleTimeout * 1000;
+  for (Pool::iterator it = m_pool.begin(); it != m_pool.end(); ++it)
+  {
+    Entries &entries = it->second;
+    for (Entries::iterator i = entries.begin(); i != entries.end(); )
+    {
+      if (now - i->released > timeout)
+      {
+        expired.push_back(i->connection);
+        i = entries.erase(i);
+      }
+      else
+        ++i;
+    }
+  }
+}
+
+void CDatabasePool::Disconnect(const Connection &connection)
+{
+  try
+  {
+    if (connection.ds)
+      connection.ds->close();
+    connection.db->disconnect();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to disconnect from %s", __FUNCTION__, connection.db->getDatabase());
+  }
+  delete connection.ds;
+  delete connection.ds2;
+  delete connection.db;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <vector>
+
+namespace dbiplus {
+  class Database;
+  class Dataset;
+}
+
+/*!
+ \brief Keeps opened database connections around for reuse.
+
+ Most users of CDatabase open a database, run a query or two and close it again,
+ which for a MySQL backend means a TCP connect and handshake, and for both backends
+ reading the version table every time. Closing a database instead parks its
+ connection here, keyed on the database it's connected to, so the next Open() of
+ the same database borrows it without connecting or checking versions again.
+
+ A borrowed connection is owned by the borrower until it's returned, so it's never
+ used by two threads at once. Connections last used by the calling thread are
+ preferred. Connections idle for a while get a cheap query before being handed
+ out, and are dropped altogether once they've been idle longer than the timeout.
+ */
+class CDatabasePool
+{
+public:
+  struct Connection
+  {
+    Connection() : db(NULL), ds(NULL), ds2(NULL) {}
+
+    dbiplus::Database *db;
+    dbiplus::Dataset  *ds;
+    dbiplus::Dataset  *ds2;
+  };
+
+  static CDatabasePool &Get();
+
+  /*! \brief Borrow an idle connection to a database.
+   \param key identifies the database, as returned from GetKey().
+   \param connection receives the connection, owned by the caller until it's returned.
+   \return true if a connection was available, false if the caller needs to connect.
+   */
+  bool Borrow(const CStdString &key, Connection &connection);
+
+  /*! \brief Return a borrowed or newly opened connection to the pool.
+   The connection is disconnected and deleted if the pool is full or disabled.
+   */
+  void Return(const CStdString &key, const Connection &connection);
+
+  /*! \brief Disconnect all idle connections. */
+  void Clear();
+
+  /*! \brief Disconnect all idle connections and stop pooling, for shutdown. */
+  void Deinitialize();
+
+  static CStdString GetKey(const CStdString &type, const CStdString &host, const CStdString &port,
+                           const CStdString &user, const CStdString &name);
+
+  unsigned int GetConnectsAvoided() const { return m_connectsAvoided; }
+  unsigned int GetConnectsMade() const    { return m_connectsMade; }
+  /*! \brief Total time in ms spent borrowing connections, including health checks. */
+  unsigned int GetWaitTime() const        { return m_waitTime; }
+
+private:
+  CDatabasePool();
+  ~CDatabasePool();
+
+  struct Entry
+  {
+    Connection       connection;
+    ThreadIdentifier thread;    ///< last thread to use the connection
+    unsigned int     released;  ///< time the connection was returned
+  };
+
+  typedef std::vector<Entry> Entries;
+  typedef std::map<CStdString, Entries> Pool;
+
+  bool IsHealthy(const Connection &connection);
+  void Expire(unsigned int now, std::vector<Connection> &expired);
+  static void Disconnect(const Connection &connection);
+
+  CCriticalSection m_section;
+  Pool             m_pool;
+  bool             m_enabled;
+
+  unsigned int m_connectsAvoided;
+  unsigned int m_connectsMade;
+  unsigned int m_waitTime;
+};
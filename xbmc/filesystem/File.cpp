@@ -33,6 +33,7 @@
 #include "utils/Win32Exception.h"
 #endif
 #include "URL.h"
+#include "ThumbnailCache.h"
 
 using namespace XFILE;
 using namespace std;
@@ -310,6 +311,7 @@ bool CFile::OpenForWrite(const CStdString& strFileName, bool bOverWrite)
     {
       // add this file to our directory cache (if it's stored)
       g_directoryCache.AddFile(strFileName);
+      CThumbnailCache::GetThumbnailCache()->OnFileWritten(strFileName);
       return true;
     }
     return false;
@@ -681,6 +683,7 @@ bool CFile::Delete(const CStdString& strFileName)
     if(pFile->Delete(url))
     {
       g_directoryCache.ClearFile(strFileName);
+      CThumbnailCache::GetThumbnailCache()->OnFileDeleted(strFileName);
       return true;
     }
   }
@@ -718,6 +721,8 @@ bool CFile::Rename(const CStdString& strFileName, const CStdString& strNewFileNa
     {
       g_directoryCache.ClearFile(strFileName);
       g_directoryCache.ClearFile(strNewFileName);
+      CThumbnailCache::GetThumbnailCache()->OnFileDeleted(strFileName);
+      CThumbnailCache::GetThumbnailCache()->OnFileWritten(strNewFileName);
       return true;
     }
   }
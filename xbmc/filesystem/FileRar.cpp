@@ -40,6 +40,8 @@ using namespace XFILE;
 using namespace std;
 
 #define SEEKTIMOUT 30000
+// how much of a compressed file is unpacked ahead of the reader
+#define UNPACK_BUFFER_SIZE (4 * 1024 * 1024)
 
 #ifdef HAS_FILESYSTEM_RAR
 CFileRarExtractThread::CFileRarExtractThread() : hRunning(true), hQuit(true)
@@ -47,6 +49,7 @@ CFileRarExtractThread::CFileRarExtractThread() : hRunning(true), hQuit(true)
   m_pArc = NULL;
   m_pCmd = NULL;
   m_pExtract = NULL;
+  m_pBuffer = NULL;
   StopThread();
   Create();
 }
@@ -58,12 +61,15 @@ CFileRarExtractThread::~CFileRarExtractThread()
   StopThread();
 }
 
-void CFileRarExtractThread::Start(Archive* pArc, CommandData* pCmd, CmdExtract* pExtract, int iSize)
+void CFileRarExtractThread::Start(Archive* pArc, CommandData* pCmd, CmdExtract* pExtract, int iSize, CRarUnpackBuffer* pBuffer)
 {
   m_pArc = pArc;
   m_pCmd = pCmd;
   m_pExtract = pExtract;
   m_iSize = iSize;
+  m_pBuffer = pBuffer;
+  if (m_pBuffer)
+    m_pExtract->GetDataIO().UnpackToSink = this;
 
   m_pExtract->GetDataIO().hBufferFilled = new CEvent;
   m_pExtract->GetDataIO().hBufferEmpty = new CEvent;
@@ -91,11 +97,18 @@ void CFileRarExtractThread::Process()
     {
       bool Repeat = false;
       m_pExtract->ExtractCurrentFile(m_pCmd,*m_pArc,m_iSize,Repeat);
+      if (m_pBuffer)
+        m_pBuffer->Finish();
       hRunning.Reset();
     }
   }
   hRestart.Set();
 }
+
+bool CFileRarExtractThread::Write(const byte* Addr, uint Count)
+{
+  return m_pBuffer->Write(Addr, Count);
+}
 #endif
 
 CFileRar::CFileRar()
@@ -110,11 +123,13 @@ CFileRar::CFileRar()
   m_pCmd = NULL;
   m_pExtract = NULL;
   m_pExtractThread = NULL;
+  m_pUnpackBuffer = NULL;
 #endif
   m_szBuffer = NULL;
   m_szStartOfBuffer = NULL;
   m_iDataInBuffer = 0;
   m_bUseFile = false;
+  m_bUseVolumes = false;
   m_bOpen = false;
   m_bSeekable = true;
 }
@@ -130,6 +145,8 @@ CFileRar::~CFileRar()
     m_File.Close();
     g_RarManager.ClearCachedFile(m_strRarPath,m_strPathInRar);
   }
+  else if (m_bUseVolumes)
+    m_volumes.Close();
   else
   {
     CleanUp();
@@ -158,6 +175,15 @@ bool CFileRar::Open(const CURL& url)
   {
     if (items[i]->m_idepth == 0x30) // stored
     {
+      if (OpenVolumes())
+      {
+        m_iFileSize = m_volumes.GetLength();
+        m_bUseVolumes = true;
+        m_bOpen = true;
+        return true;
+      }
+
+      // encrypted, so it has to go through unrar
       if (!OpenInArchive())
         return false;
 
@@ -165,24 +191,30 @@ bool CFileRar::Open(const CURL& url)
       m_bOpen = true;
 
       // perform 'noidx' check
-      CFileInfo* pFile = g_RarManager.GetFileInRar(m_strRarPath,m_strPathInRar);
-      if (pFile)
+      int iSeekable = g_RarManager.GetSeekable(m_strRarPath,m_strPathInRar);
+      if (iSeekable == -1)
       {
-        if (pFile->m_iIsSeekable == -1)
+        if (Seek(-1,SEEK_END) == -1)
         {
-          if (Seek(-1,SEEK_END) == -1)
-          {
-            m_bSeekable = false;
-            pFile->m_iIsSeekable = 0;
-          }
+          m_bSeekable = false;
+          g_RarManager.SetSeekable(m_strRarPath,m_strPathInRar,0);
         }
-        else
-          m_bSeekable = (pFile->m_iIsSeekable == 1);
       }
+      else
+        m_bSeekable = (iSeekable == 1);
       return true;
     }
     else
     {
+      // unpack while we read unless the archive is solid, as that means
+      // unpacking the files before this one too
+      if (OpenInArchive(true))
+      {
+        m_iFileSize = items[i]->m_dwSize;
+        m_bOpen = true;
+        return true;
+      }
+
       m_bUseFile = true;
       CStdString strPathInCache;
 
@@ -254,9 +286,15 @@ unsigned int CFileRar::Read(void *lpBuf, int64_t uiBufSize)
   if (m_bUseFile)
     return m_File.Read(lpBuf,uiBufSize);
 
+  if (m_bUseVolumes)
+    return m_volumes.Read(lpBuf, (unsigned int)uiBufSize);
+
   if (m_iFilePosition >= GetLength()) // we are done
     return 0;
 
+  if (m_pUnpackBuffer)
+    return ReadUnpacked(lpBuf, uiBufSize);
+
   if( !m_pExtract->GetDataIO().hBufferEmpty->WaitMSec(5000) )
   {
     CLog::Log(LOGERROR, "%s - Timeout waiting for buffer to empty", __FUNCTION__);
@@ -342,6 +380,12 @@ void CFileRar::Close()
     g_RarManager.ClearCachedFile(m_strRarPath,m_strPathInRar);
     m_bOpen = false;
   }
+  else if (m_bUseVolumes)
+  {
+    m_volumes.Close();
+    m_bUseVolumes = false;
+    m_bOpen = false;
+  }
   else
   {
     CleanUp();
@@ -367,6 +411,20 @@ int64_t CFileRar::Seek(int64_t iFilePosition, int iWhence)
   if (m_bUseFile)
     return m_File.Seek(iFilePosition,iWhence);
 
+  if (m_bUseVolumes)
+    return m_volumes.Seek(iFilePosition,iWhence);
+
+  if (m_pUnpackBuffer)
+  {
+    if (iWhence == SEEK_CUR)
+      iFilePosition += m_iFilePosition;
+    else if (iWhence == SEEK_END)
+      iFilePosition += GetLength();
+    else if (iWhence != SEEK_SET)
+      return -1;
+    return SeekUnpacked(iFilePosition);
+  }
+
   if( !m_pExtract->GetDataIO().hBufferEmpty->WaitMSec(SEEKTIMOUT) )
   {
     CLog::Log(LOGERROR, "%s - Timeout waiting for buffer to empty", __FUNCTION__);
@@ -472,6 +530,9 @@ int64_t CFileRar::GetLength()
   if (m_bUseFile)
     return m_File.GetLength();
 
+  if (m_bUseVolumes)
+    return m_volumes.GetLength();
+
   return m_iFileSize;
 }
 
@@ -483,6 +544,9 @@ int64_t CFileRar::GetPosition()
   if (m_bUseFile)
     return m_File.GetPosition();
 
+  if (m_bUseVolumes)
+    return m_volumes.GetPosition();
+
   return m_iFilePosition;
 }
 
@@ -534,6 +598,8 @@ void CFileRar::CleanUp()
   {
     if (m_pExtractThread->hRunning.WaitMSec(1))
     {
+      if (m_pUnpackBuffer)
+        m_pUnpackBuffer->Abort();
       m_pExtract->GetDataIO().hQuit->Set();
       while (m_pExtractThread->hRunning.WaitMSec(1))
         Sleep(1);
@@ -565,10 +631,73 @@ void CFileRar::CleanUp()
     m_szBuffer = NULL;
     m_szStartOfBuffer = NULL;
   }
+  if (m_pUnpackBuffer)
+  {
+    delete m_pUnpackBuffer;
+    m_pUnpackBuffer = NULL;
+  }
 #endif
 }
 
-bool CFileRar::OpenInArchive()
+#ifdef HAS_FILESYSTEM_RAR
+static void InitCommand(CommandData& cmd, const CStdString& strRarPath, const CStdString& strPassword,
+                        const CStdString& strCacheDir)
+{
+  // Set the arguments for the extract command
+  strcpy(cmd.Command, "X");
+
+  cmd.AddArcName(const_cast<char*>(strRarPath.c_str()),NULL);
+
+  strncpy(cmd.ExtrPath, strCacheDir.c_str(), sizeof (cmd.ExtrPath) - 2);
+  cmd.ExtrPath[sizeof (cmd.ExtrPath) - 2] = 0;
+  AddEndSlash(cmd.ExtrPath);
+
+  // Set password for encrypted archives
+  if ((strPassword.size() > 0) &&
+      (strPassword.size() < sizeof (cmd.Password)))
+  {
+    strcpy(cmd.Password, strPassword.c_str());
+  }
+
+  cmd.ParseDone();
+}
+
+// reads headers until the one of strPathInRar, returns its size or 0 if it isn't there
+static int FindFileInArchive(Archive& arc, const CStdString& strPathInRar)
+{
+  while (true)
+  {
+    int iHeaderSize = arc.ReadHeader();
+    if (iHeaderSize <= 0)
+      return 0;
+
+    if (arc.GetHeaderType() == FILE_HEAD)
+    {
+      CStdString strFileName;
+
+      if (arc.NewLhd.FileNameW && wcslen(arc.NewLhd.FileNameW) > 0)
+      {
+        g_charsetConverter.wToUTF8(arc.NewLhd.FileNameW, strFileName);
+      }
+      else
+      {
+        g_charsetConverter.unknownToUTF8(arc.NewLhd.FileName, strFileName);
+      }
+
+      /* replace back slashes into forward slashes */
+      /* this could get us into troubles, file could two different files, one with / and one with \ */
+      strFileName.Replace('\\', '/');
+
+      if (strFileName == strPathInRar)
+        return iHeaderSize;
+    }
+
+    arc.SeekToNext();
+  }
+}
+#endif
+
+bool CFileRar::OpenInArchive(bool bUnpackToBuffer)
 {
 #ifdef HAS_FILESYSTEM_RAR
   int iHeaderSize;
@@ -581,24 +710,7 @@ bool CFileRar::OpenInArchive()
     CleanUp();
     return false;
   }
-
-  // Set the arguments for the extract command
-  strcpy(m_pCmd->Command, "X");
-
-  m_pCmd->AddArcName(const_cast<char*>(m_strRarPath.c_str()),NULL);
-
-  strncpy(m_pCmd->ExtrPath, m_strCacheDir.c_str(), sizeof (m_pCmd->ExtrPath) - 2);
-  m_pCmd->ExtrPath[sizeof (m_pCmd->ExtrPath) - 2] = 0;
-  AddEndSlash(m_pCmd->ExtrPath);
-
-  // Set password for encrypted archives
-  if ((m_strPassword.size() > 0) &&
-      (m_strPassword.size() < sizeof (m_pCmd->Password)))
-  {
-    strcpy(m_pCmd->Password, m_strPassword.c_str());
-  }
-
-  m_pCmd->ParseDone();
+  InitCommand(*m_pCmd, m_strRarPath, m_strPassword, m_strCacheDir);
 
   // Open the archive
   m_pArc = new Archive(m_pCmd);
@@ -624,61 +736,160 @@ bool CFileRar::OpenInArchive()
     CleanUp();
     return false;
   }
-  m_pExtract->GetDataIO().SetUnpackToMemory(m_szBuffer,0);
+  if (!bUnpackToBuffer)
+    m_pExtract->GetDataIO().SetUnpackToMemory(m_szBuffer,0);
   m_pExtract->GetDataIO().SetCurrentCommand(*(m_pCmd->Command));
   struct FindData FD;
   if (FindFile::FastFind(m_strRarPath.c_str(),NULL,&FD))
     m_pExtract->GetDataIO().TotalArcSize+=FD.Size;
   m_pExtract->ExtractArchiveInit(m_pCmd,*m_pArc);
 
-  while (true)
+  if ((iHeaderSize = FindFileInArchive(*m_pArc, m_strPathInRar)) <= 0)
   {
-    if ((iHeaderSize = m_pArc->ReadHeader()) <= 0)
+    CleanUp();
+    return false;
+  }
+
+  m_iFilePosition = 0;
+  m_iBufferStart = 0;
+
+  if (bUnpackToBuffer)
+  {
+    if (m_pArc->Solid || (m_pArc->NewLhd.Flags & LHD_SOLID) || (m_pArc->NewLhd.Flags & LHD_SPLIT_BEFORE))
     {
       CleanUp();
       return false;
     }
+    m_pUnpackBuffer = new CRarUnpackBuffer(UNPACK_BUFFER_SIZE);
+  }
+  else
+  {
+    m_szBuffer = new byte[MAXWINMEMSIZE];
+    m_szStartOfBuffer = m_szBuffer;
+    m_pExtract->GetDataIO().SetUnpackToMemory(m_szBuffer,0);
+    m_iDataInBuffer = -1;
+  }
 
-    if (m_pArc->GetHeaderType() == FILE_HEAD)
-    {
-      CStdString strFileName;
+  delete m_pExtractThread;
+  m_pExtractThread = new CFileRarExtractThread();
+  m_pExtractThread->Start(m_pArc,m_pCmd,m_pExtract,iHeaderSize,m_pUnpackBuffer);
 
-      if (m_pArc->NewLhd.FileNameW && wcslen(m_pArc->NewLhd.FileNameW) > 0)
-      {
-        g_charsetConverter.wToUTF8(m_pArc->NewLhd.FileNameW, strFileName);
-      }
-      else
-      {
-        g_charsetConverter.unknownToUTF8(m_pArc->NewLhd.FileName, strFileName);
-      }
+  return true;
+#else
+  return false;
+#endif
+}
 
-      /* replace back slashes into forward slashes */
-      /* this could get us into troubles, file could two different files, one with / and one with \ */
-      strFileName.Replace('\\', '/');
+bool CFileRar::OpenVolumes()
+{
+#ifdef HAS_FILESYSTEM_RAR
+  // where the file is in the volumes doesn't change, so it's looked up once
+  vector<RarVolumeSegment> segments = g_RarManager.GetVolumes(m_strRarPath,m_strPathInRar);
+  if (!segments.empty())
+  {
+    m_volumes.Open(segments);
+    return true;
+  }
 
-      if (strFileName == m_strPathInRar)
-      {
-        break;
-      }
-    }
+  InitCRC();
 
-    m_pArc->SeekToNext();
-  }
+  CommandData cmd;
+  InitCommand(cmd, m_strRarPath, m_strPassword, m_strCacheDir);
+  Archive arc(&cmd);
+  if (!arc.WOpen(m_strRarPath.c_str(),NULL) || !(arc.IsOpened() && arc.IsArchive(true)))
+    return false;
+  if (FindFileInArchive(arc, m_strPathInRar) <= 0)
+    return false;
+  if (arc.NewLhd.Method != 0x30 || (arc.NewLhd.Flags & LHD_PASSWORD))
+    return false;
 
-  m_szBuffer = new byte[MAXWINMEMSIZE];
-  m_szStartOfBuffer = m_szBuffer;
-  m_pExtract->GetDataIO().SetUnpackToMemory(m_szBuffer,0);
-  m_iDataInBuffer = -1;
-  m_iFilePosition = 0;
-  m_iBufferStart = 0;
+  int64_t iSize = 0;
+  while (true)
+  {
+    RarVolumeSegment segment;
+    segment.volume = arc.FileName;
+    segment.offset = arc.NextBlockPos - arc.NewLhd.FullPackSize;
+    segment.size = arc.NewLhd.FullPackSize;
+    segment.start = iSize;
+    segments.push_back(segment);
+    iSize += segment.size;
 
-  delete m_pExtractThread;
-  m_pExtractThread = new CFileRarExtractThread();
-  m_pExtractThread->Start(m_pArc,m_pCmd,m_pExtract,iHeaderSize);
+    if (!(arc.NewLhd.Flags & LHD_SPLIT_AFTER))
+      break;
+    if (!MergeArchive(arc,NULL,false,*cmd.Command) || arc.GetHeaderType() != FILE_HEAD ||
+        !(arc.NewLhd.Flags & LHD_SPLIT_BEFORE))
+    {
+      CLog::Log(LOGERROR, "%s - no volume after %s for %s", __FUNCTION__, segment.volume.c_str(), m_strPathInRar.c_str());
+      return false;
+    }
+  }
+
+  if (iSize != arc.NewLhd.FullUnpSize)
+  {
+    CLog::Log(LOGERROR, "%s - %s is %"PRId64" bytes in the volumes, expected %"PRId64, __FUNCTION__,
+              m_strPathInRar.c_str(), iSize, (int64_t)arc.NewLhd.FullUnpSize);
+    return false;
+  }
 
+  CLog::Log(LOGDEBUG, "%s - reading %s from %u volumes", __FUNCTION__, m_strPathInRar.c_str(), (unsigned int)segments.size());
+  g_RarManager.SetVolumes(m_strRarPath,m_strPathInRar,segments);
+  m_volumes.Open(segments);
   return true;
 #else
   return false;
 #endif
 }
 
+unsigned int CFileRar::ReadUnpacked(void* lpBuf, int64_t uiBufSize)
+{
+#ifdef HAS_FILESYSTEM_RAR
+  if (uiBufSize > GetLength() - m_iFilePosition)
+    uiBufSize = GetLength() - m_iFilePosition;
+
+  unsigned int iRead = m_pUnpackBuffer->Read(lpBuf, (unsigned int)uiBufSize, 5000);
+  if (iRead == 0 && uiBufSize > 0)
+    CLog::Log(LOGERROR, "%s - no data unpacked from %s at %"PRId64, __FUNCTION__, m_strPathInRar.c_str(), m_iFilePosition);
+  m_iFilePosition += iRead;
+  return iRead;
+#else
+  return 0;
+#endif
+}
+
+int64_t CFileRar::SeekUnpacked(int64_t iFilePosition)
+{
+#ifdef HAS_FILESYSTEM_RAR
+  if (iFilePosition < 0 || iFilePosition > GetLength())
+    return -1;
+
+  // unpacking starts at the beginning of the file, so going back means starting over
+  if (iFilePosition < m_iFilePosition)
+  {
+    CleanUp();
+    if (!OpenInArchive(true))
+    {
+      m_bOpen = false;
+      return -1;
+    }
+  }
+
+  // and going forward means unpacking what is in between
+  byte skip[32768];
+  while (m_iFilePosition < iFilePosition)
+  {
+    int64_t iChunk = iFilePosition - m_iFilePosition;
+    if (iChunk > (int64_t)sizeof(skip))
+      iChunk = sizeof(skip);
+    unsigned int iRead = m_pUnpackBuffer->Read(skip, (unsigned int)iChunk, SEEKTIMOUT);
+    if (iRead == 0)
+    {
+      CLog::Log(LOGERROR, "%s - Timeout unpacking up to %"PRId64, __FUNCTION__, iFilePosition);
+      return -1;
+    }
+    m_iFilePosition += iRead;
+  }
+  return m_iFilePosition;
+#else
+  return -1;
+#endif
+}
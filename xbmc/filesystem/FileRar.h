@@ -26,6 +26,7 @@
 #define FILERAR_H_
 
 #include "File.h"
+#include "RarStream.h"
 #include "UnrarXLib/rar.hpp"
 #include "threads/Thread.h"
 #include "threads/Event.h"
@@ -33,17 +34,21 @@
 namespace XFILE
 {
 #ifdef HAS_FILESYSTEM_RAR
-  class CFileRarExtractThread : public CThread
+  class CFileRarExtractThread : public CThread, public ComprDataSink
   {
   public:
     CFileRarExtractThread();
     ~CFileRarExtractThread();
 
-    void Start(Archive* pArc, CommandData* pCmd, CmdExtract* pExtract, int iSize);
+    /*! \brief Extract the file in pArc, to pBuffer if given or else to the
+     *  memory the ComprDataIO of pExtract is set to unpack to.
+     */
+    void Start(Archive* pArc, CommandData* pCmd, CmdExtract* pExtract, int iSize, CRarUnpackBuffer* pBuffer = NULL);
 
     virtual void OnStartup();
     virtual void OnExit();
     virtual void Process();
+    virtual bool Write(const byte* Addr, uint Count);
 
     CEvent hRunning;
     CEvent hRestart;
@@ -54,6 +59,7 @@ namespace XFILE
     CommandData* m_pCmd;
     CmdExtract* m_pExtract;
     int m_iSize;
+    CRarUnpackBuffer* m_pBuffer;
   };
 #endif
 
@@ -85,13 +91,17 @@ namespace XFILE
     BYTE m_bFileOptions;
     void Init();
     void InitFromUrl(const CURL& url);
-    bool OpenInArchive();
+    bool OpenInArchive(bool bUnpackToBuffer = false);
+    bool OpenVolumes();
+    unsigned int ReadUnpacked(void* lpBuf, int64_t uiBufSize);
+    int64_t SeekUnpacked(int64_t iFilePosition);
     void CleanUp();
 
     int64_t m_iFilePosition;
     int64_t m_iFileSize;
     // rar stuff
     bool m_bUseFile;
+    bool m_bUseVolumes; // stored, read from the volumes
     bool m_bOpen;
     bool m_bSeekable;
     CFile m_File; // for packed source
@@ -100,7 +110,9 @@ namespace XFILE
     CommandData* m_pCmd;
     CmdExtract* m_pExtract;
     CFileRarExtractThread* m_pExtractThread;
+    CRarUnpackBuffer* m_pUnpackBuffer; // compressed, unpacked while we read
 #endif
+    CRarVolumeReader<CFile> m_volumes;
     byte* m_szBuffer;
     byte* m_szStartOfBuffer;
     int64_t m_iDataInBuffer;
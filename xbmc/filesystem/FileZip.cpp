@@ -83,10 +83,33 @@ bool CFileZip::Open(const CURL&url)
     CLog::Log(LOGERROR,"FileZip: unable to open zip file %s!",url.GetHostName().c_str());
     return false;
   }
+  if (mZipItem.offset < 0 && !ReadLocalHeader())
+  {
+    CLog::Log(LOGERROR,"FileZip: broken local header for %s in %s!",mZipItem.name,url.GetHostName().c_str());
+    mFile.Close();
+    return false;
+  }
   mFile.Seek(mZipItem.offset,SEEK_SET);
   return InitDecompress();
 }
 
+bool CFileZip::ReadLocalHeader()
+{
+  // the data follows the local header, whose extra field can differ from the central one
+  char buffer[LHDR_SIZE];
+  SZipEntry local;
+  if (mFile.Seek(mZipItem.lhdrOffset,SEEK_SET) != mZipItem.lhdrOffset ||
+      mFile.Read(buffer,LHDR_SIZE) != LHDR_SIZE)
+    return false;
+  CZipManager::readHeader(buffer,local);
+  if (local.header != ZIP_LOCAL_HEADER)
+    return false;
+
+  mZipItem.elength = local.elength;
+  mZipItem.offset = mZipItem.lhdrOffset + LHDR_SIZE + local.flength + local.elength;
+  return true;
+}
+
 bool CFileZip::InitDecompress()
 {
   m_iRead = 1;
@@ -50,6 +50,7 @@ namespace XFILE
     int UnpackFromMemory(std::string& strDest, const std::string& strInput, bool isGZ=false);
   private:
     bool InitDecompress();
+    bool ReadLocalHeader();
     bool FillBuffer();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
     CFile mFile;
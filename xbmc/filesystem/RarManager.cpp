@@ -360,6 +360,60 @@ CFileInfo* CRarManager::GetFileInRar(const CStdString& strRarPath, const CStdStr
   return NULL;
 }
 
+CFileInfo* CRarManager::FindOrAddFileInRar(const CStdString& strRarPath, const CStdString& strPathInRar)
+{
+#ifdef HAS_FILESYSTEM_RAR
+  CFileInfo* pFile = GetFileInRar(strRarPath, strPathInRar);
+  if (pFile)
+    return pFile;
+
+  // the archive is listed when the file is opened, without it there's nowhere to keep this
+  map<CStdString,pair<ArchiveList_struct*,vector<CFileInfo> > >::iterator j = m_ExFiles.find(strRarPath);
+  if (j == m_ExFiles.end())
+    return NULL;
+
+  CFileInfo fileInfo;
+  fileInfo.m_strPathInRar = strPathInRar;
+  fileInfo.m_bAutoDel = false;
+  j->second.second.push_back(fileInfo);
+  return &j->second.second.back();
+#else
+  return NULL;
+#endif
+}
+
+vector<RarVolumeSegment> CRarManager::GetVolumes(const CStdString& strRarPath, const CStdString& strPathInRar)
+{
+  CSingleLock lock(m_CritSection);
+  CFileInfo* pFile = GetFileInRar(strRarPath, strPathInRar);
+  if (pFile)
+    return pFile->m_volumes;
+  return vector<RarVolumeSegment>();
+}
+
+void CRarManager::SetVolumes(const CStdString& strRarPath, const CStdString& strPathInRar, const vector<RarVolumeSegment>& volumes)
+{
+  CSingleLock lock(m_CritSection);
+  CFileInfo* pFile = FindOrAddFileInRar(strRarPath, strPathInRar);
+  if (pFile)
+    pFile->m_volumes = volumes;
+}
+
+int CRarManager::GetSeekable(const CStdString& strRarPath, const CStdString& strPathInRar)
+{
+  CSingleLock lock(m_CritSection);
+  CFileInfo* pFile = GetFileInRar(strRarPath, strPathInRar);
+  return pFile ? pFile->m_iIsSeekable : -1;
+}
+
+void CRarManager::SetSeekable(const CStdString& strRarPath, const CStdString& strPathInRar, int iSeekable)
+{
+  CSingleLock lock(m_CritSection);
+  CFileInfo* pFile = FindOrAddFileInRar(strRarPath, strPathInRar);
+  if (pFile)
+    pFile->m_iIsSeekable = iSeekable;
+}
+
 bool CRarManager::GetPathInCache(CStdString& strPathInCache, const CStdString& strRarPath, const CStdString& strPathInRar)
 {
 #ifdef HAS_FILESYSTEM_RAR
@@ -30,6 +30,7 @@
 #include <map>
 #include "UnrarXLib/UnrarX.hpp"
 #include "utils/Stopwatch.h"
+#include "RarStream.h"
 
 #include "threads/Thread.h"
 
@@ -62,6 +63,7 @@ public:
   }
   CStopWatch watch;
   int m_iIsSeekable;
+  std::vector<XFILE::RarVolumeSegment> m_volumes; ///< where a stored file is in the volumes
 };
 
 class CRarManager
@@ -77,6 +79,12 @@ public:
   bool GetFilesInRar(CFileItemList& vecpItems, const CStdString& strRarPath,
                      bool bMask=true, const CStdString& strPathInRar="");
   CFileInfo* GetFileInRar(const CStdString& strRarPath, const CStdString& strPathInRar);
+  /*! \brief where a stored file is in the volumes, empty until SetVolumes() */
+  std::vector<XFILE::RarVolumeSegment> GetVolumes(const CStdString& strRarPath, const CStdString& strPathInRar);
+  void SetVolumes(const CStdString& strRarPath, const CStdString& strPathInRar, const std::vector<XFILE::RarVolumeSegment>& volumes);
+  /*! \brief whether a file unpacked in memory can seek, -1 until it's known */
+  int GetSeekable(const CStdString& strRarPath, const CStdString& strPathInRar);
+  void SetSeekable(const CStdString& strRarPath, const CStdString& strPathInRar, int iSeekable);
   bool IsFileInRar(bool& bResult, const CStdString& strRarPath, const CStdString& strPathInRar);
   void ClearCache(bool force=false);
   void ClearCachedFile(const CStdString& strRarPath, const CStdString& strPathInRar);
@@ -84,6 +92,7 @@ public:
 protected:
 
   bool ListArchive(const CStdString& strRarPath, ArchiveList_struct* &pArchiveList);
+  CFileInfo* FindOrAddFileInRar(const CStdString& strRarPath, const CStdString& strPathInRar);
   std::map<CStdString, std::pair<ArchiveList_struct*,std::vector<CFileInfo> > > m_ExFiles;
   CCriticalSection m_CritSection;
 
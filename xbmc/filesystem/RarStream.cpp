@@ -0,0 +1,115 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "RarStream.h"
+#include "threads/SingleLock.h"
+
+#include <string.h>
+
+using namespace XFILE;
+
+CRarUnpackBuffer::CRarUnpackBuffer(unsigned int size) : m_buffer(size)
+{
+  m_readPos = 0;
+  m_fill = 0;
+  m_maxFill = 0;
+  m_finished = false;
+  m_aborted = false;
+}
+
+bool CRarUnpackBuffer::Write(const void* data, unsigned int size)
+{
+  const char* src = (const char*)data;
+  CSingleLock lock(m_section);
+  while (size > 0)
+  {
+    while (m_fill == m_buffer.size() && !m_aborted)
+      m_writable.wait(lock);
+    if (m_aborted)
+      return false;
+
+    // copy up to the end of the buffer, the rest goes round at the next pass
+    unsigned int writePos = (m_readPos + m_fill) % m_buffer.size();
+    unsigned int chunk = m_buffer.size() - m_fill;
+    if (chunk > m_buffer.size() - writePos)
+      chunk = m_buffer.size() - writePos;
+    if (chunk > size)
+      chunk = size;
+    memcpy(&m_buffer[writePos], src, chunk);
+    src += chunk;
+    size -= chunk;
+    m_fill += chunk;
+    if (m_fill > m_maxFill)
+      m_maxFill = m_fill;
+    m_readable.notifyAll();
+  }
+  return true;
+}
+
+void CRarUnpackBuffer::Finish()
+{
+  CSingleLock lock(m_section);
+  m_finished = true;
+  m_readable.notifyAll();
+}
+
+unsigned int CRarUnpackBuffer::Read(void* data, unsigned int size, unsigned int timeout)
+{
+  char* dest = (char*)data;
+  CSingleLock lock(m_section);
+  while (m_fill == 0 && !m_finished && !m_aborted)
+  {
+    if (m_readable.wait(lock, timeout) == XbmcThreads::ConditionVariable::TW_TIMEDOUT && m_fill == 0)
+      return 0;
+  }
+  if (m_aborted)
+    return 0;
+
+  unsigned int done = 0;
+  while (done < size && m_fill > 0)
+  {
+    unsigned int chunk = m_fill;
+    if (chunk > m_buffer.size() - m_readPos)
+      chunk = m_buffer.size() - m_readPos;
+    if (chunk > size - done)
+      chunk = size - done;
+    memcpy(dest + done, &m_buffer[m_readPos], chunk);
+    done += chunk;
+    m_fill -= chunk;
+    m_readPos = (m_readPos + chunk) % m_buffer.size();
+  }
+  m_writable.notifyAll();
+  return done;
+}
+
+void CRarUnpackBuffer::Abort()
+{
+  CSingleLock lock(m_section);
+  m_aborted = true;
+  m_readable.notifyAll();
+  m_writable.notifyAll();
+}
+
+unsigned int CRarUnpackBuffer::GetMaxFill()
+{
+  CSingleLock lock(m_section);
+  return m_maxFill;
+}
@@ -0,0 +1,203 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+#include "threads/Condition.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+namespace XFILE
+{
+  /**
+   * The part of a file stored in a rar archive that is in one of its volumes.
+   */
+  struct RarVolumeSegment
+  {
+    CStdString volume; ///< path of the volume
+    int64_t    offset; ///< where the data starts in the volume
+    int64_t    size;
+    int64_t    start;  ///< where the data starts in the file, set by CRarVolumeReader
+  };
+
+  /**
+   * Reads a file stored without compression in a rar archive straight from
+   *  the volumes it is split over, so it can be played and seeked in without
+   *  being extracted first.
+   *
+   * F is the class the volumes are read with, XFILE::CFile but for the tests.
+   */
+  template<class F> class CRarVolumeReader
+  {
+  public:
+    CRarVolumeReader() : m_position(0), m_length(0), m_current(-1), m_volumePosition(-1) {}
+    ~CRarVolumeReader() { Close(); }
+
+    void Open(const std::vector<RarVolumeSegment>& segments)
+    {
+      Close();
+      m_segments = segments;
+      m_length = 0;
+      for (unsigned int i = 0; i < m_segments.size(); i++)
+      {
+        m_segments[i].start = m_length;
+        m_length += m_segments[i].size;
+      }
+      m_position = 0;
+    }
+
+    void Close()
+    {
+      if (m_current >= 0)
+        m_file.Close();
+      m_current = -1;
+    }
+
+    int64_t GetLength() const { return m_length; }
+    int64_t GetPosition() const { return m_position; }
+
+    int64_t Seek(int64_t position, int whence)
+    {
+      if (whence == SEEK_CUR)
+        position += m_position;
+      else if (whence == SEEK_END)
+        position += m_length;
+      else if (whence != SEEK_SET)
+        return -1;
+
+      if (position < 0 || position > m_length)
+        return -1;
+      // the volume is only seeked when we read
+      m_position = position;
+      return m_position;
+    }
+
+    unsigned int Read(void* buffer, unsigned int size)
+    {
+      unsigned int done = 0;
+      while (done < size && m_position < m_length)
+      {
+        int index = FindSegment(m_position);
+        const RarVolumeSegment& segment = m_segments[index];
+        if (index != m_current)
+        {
+          Close();
+          if (!m_file.Open(segment.volume))
+            break;
+          m_current = index;
+          m_volumePosition = -1;
+        }
+
+        int64_t position = segment.offset + m_position - segment.start;
+        if (position != m_volumePosition && m_file.Seek(position, SEEK_SET) != position)
+          break;
+
+        int64_t left = segment.start + segment.size - m_position;
+        unsigned int chunk = size - done < left ? size - done : (unsigned int)left;
+        unsigned int read = m_file.Read((char*)buffer + done, chunk);
+        if (read == 0)
+          break;
+        done += read;
+        m_position += read;
+        m_volumePosition = position + read;
+      }
+      return done;
+    }
+
+  private:
+    // the last segment starting at or before position
+    int FindSegment(int64_t position) const
+    {
+      int first = 0, last = (int)m_segments.size() - 1;
+      while (first < last)
+      {
+        int middle = (first + last + 1) / 2;
+        if (m_segments[middle].start <= position)
+          first = middle;
+        else
+          last = middle - 1;
+      }
+      return first;
+    }
+
+    std::vector<RarVolumeSegment> m_segments;
+    int64_t m_position;
+    int64_t m_length;
+    F m_file;
+    int m_current;            ///< segment m_file has open, -1 if none
+    int64_t m_volumePosition; ///< where m_file is, -1 if unknown
+  };
+
+  /**
+   * A bounded buffer between the thread unpacking a compressed file and the
+   *  one reading it. The unpacking thread blocks while it is full, so reading
+   *  a file of any size takes no more memory than the buffer.
+   */
+  class CRarUnpackBuffer
+  {
+  public:
+    CRarUnpackBuffer(unsigned int size);
+
+    /**
+     * Adds data, waiting for room as long as it takes.
+     * \return false once the buffer is aborted
+     */
+    bool Write(const void* data, unsigned int size);
+
+    /**
+     * Marks the end of the data, reads return what is left and then 0.
+     */
+    void Finish();
+
+    /**
+     * Takes data, waiting for some to arrive for up to timeout milliseconds.
+     * \return the bytes read, 0 at the end, after an abort or on timeout
+     */
+    unsigned int Read(void* data, unsigned int size, unsigned int timeout);
+
+    /**
+     * Wakes up and fails the reads and writes, for closing the file.
+     */
+    void Abort();
+
+    unsigned int GetSize() const { return m_buffer.size(); }
+
+    /**
+     * The most the buffer has held at once.
+     */
+    unsigned int GetMaxFill();
+
+  private:
+    CCriticalSection m_section;
+    XbmcThreads::ConditionVariable m_readable;
+    XbmcThreads::ConditionVariable m_writable;
+    std::vector<char> m_buffer;
+    unsigned int m_readPos;
+    unsigned int m_fill;
+    unsigned int m_maxFill;
+    bool m_finished;
+    bool m_aborted;
+  };
+}
@@ -28,6 +28,7 @@
 #include "utils/EndianSwap.h"
 #include "utils/URIUtils.h"
 #include "SpecialProtocol.h"
+#include "threads/SingleLock.h"
 
 
 #ifndef min
@@ -63,11 +64,13 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
     return false;
   }
 
-  map<CStdString,vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
   {
-    map<CStdString,int64_t>::iterator it2=mZipDate.find(strFile);
-    CLog::Log(LOGDEBUG,"statdata: %"PRId64" new: %"PRIu64, it2->second, (uint64_t)m_StatData.st_mtime);
+    CSingleLock lock(m_critSection);
+    map<CStdString,vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
+    if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
+    {
+      map<CStdString,int64_t>::iterator it2=mZipDate.find(strFile);
+      CLog::Log(LOGDEBUG,"statdata: %"PRId64" new: %"PRIu64, it2->second, (uint64_t)m_StatData.st_mtime);
 
       if (m_StatData.st_mtime == it2->second)
       {
@@ -76,8 +79,11 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
       }
       mZipMap.erase(it);
       mZipDate.erase(it2);
+      mZipIndex.erase(strFile);
+    }
   }
 
+  // the archive is read without holding the lock, a large one on a slow share takes a while
   CFile mFile;
   if (!mFile.Open(strFile))
   {
@@ -85,129 +91,23 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
     return false;
   }
 
-  SZipEntry ze;
-  unsigned int hdr;
-  mFile.Read(&hdr, 4);
-  if( Endian_SwapLE32(hdr) != ZIP_LOCAL_HEADER )
-  {
-    CLog::Log(LOGDEBUG,"ZipManager: not a zip file!");
-    mFile.Close();
-    return false;
-  }
-  // push date for update detection
-  mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
-
-
-  // Look for end of central directory record
-  // Zipfile comment may be up to 65535 bytes
-  // End of central directory record is 22 bytes (ECDREC_SIZE)
-  // -> need to check the last 65557 bytes
-  int64_t fileSize = mFile.GetLength();
-  // Don't need to look in the last 18 bytes (ECDREC_SIZE-4)
-  // But as we need to do overlapping between blocks (3 bytes),
-  // we start the search at ECDREC_SIZE-1 from the end of file
-  int searchSize = (int) min(65557, fileSize-ECDREC_SIZE+1);
-  int blockSize = (int) min(1024, searchSize);
-  int nbBlock = searchSize / blockSize;
-  int extraBlockSize = searchSize % blockSize;
-  // Signature is on 4 bytes
-  // It could be between 2 blocks, so we need to read 3 extra bytes
-  char *buffer = new char[blockSize+3];
-  bool found = false;
-
-  // Loop through blocks starting at the end of the file (minus ECDREC_SIZE-1)
-  for (int nb=1; !found && (nb <= nbBlock); nb++)
-  {
-    mFile.Seek(fileSize-ECDREC_SIZE+1-(blockSize*nb),SEEK_SET);
-    mFile.Read(buffer,blockSize+3);
-    for (int i=blockSize-1; !found && (i >= 0); i--)
-    {
-      if ( Endian_SwapLE32(*((unsigned int*)(buffer+i))) == ZIP_END_CENTRAL_HEADER )
-      {
-        // Set current position to start of end of central directory
-        mFile.Seek(fileSize-ECDREC_SIZE+1-(blockSize*nb)+i,SEEK_SET);
-        found = true;
-      }
-    }
-  }
-
-  // If not found, look in the last block left...
-  if ( !found && (extraBlockSize > 0) )
-  {
-    mFile.Seek(fileSize-ECDREC_SIZE+1-searchSize,SEEK_SET);
-    mFile.Read(buffer,extraBlockSize+3);
-    for (int i=extraBlockSize-1; !found && (i >= 0); i--)
-    {
-      if ( Endian_SwapLE32(*((unsigned int*)(buffer+i))) == ZIP_END_CENTRAL_HEADER )
-      {
-        // Set current position to start of end of central directory
-        mFile.Seek(fileSize-ECDREC_SIZE+1-searchSize+i,SEEK_SET);
-        found = true;
-      }
-    }
-  }
-
-  delete [] buffer;
-
-  if ( !found )
+  vector<SZipEntry> entries;
+  map<CStdString,unsigned int> names;
+  bool listed = ReadCentralDirectory(mFile, g_charsetConverter, entries, names);
+  mFile.Close();
+  if (!listed)
   {
-    CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
-    mFile.Close();
+    CLog::Log(LOGDEBUG,"ZipManager: %s is not a zip file or broken!",strFile.c_str());
     return false;
   }
 
-  unsigned int cdirOffset, cdirSize;
-  // Get size of the central directory
-  mFile.Seek(12,SEEK_CUR);
-  mFile.Read(&cdirSize,4);
-  cdirSize = Endian_SwapLE32(cdirSize);
-  // Get Offset of start of central directory with respect to the starting disk number
-  mFile.Read(&cdirOffset,4);
-  cdirOffset = Endian_SwapLE32(cdirOffset);
-
-  // Go to the start of central directory
-  mFile.Seek(cdirOffset,SEEK_SET);
+  items.insert(items.end(), entries.begin(), entries.end());
 
-  char temp[CHDR_SIZE];
-  while (mFile.GetPosition() < cdirOffset + cdirSize)
-  {
-    mFile.Read(temp,CHDR_SIZE);
-    readCHeader(temp, ze);
-    if (ze.header != ZIP_CENTRAL_HEADER)
-    {
-      CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
-      mFile.Close();
-      return false;
-    }
-
-    // Get the filename just after the central file header
-    CStdString strName;
-    mFile.Read(strName.GetBuffer(ze.flength), ze.flength);
-    strName.ReleaseBuffer();
-    g_charsetConverter.unknownToUTF8(strName);
-    ZeroMemory(ze.name, 255);
-    strncpy(ze.name, strName.c_str(), strName.size()>254 ? 254 : strName.size());
-
-    // Save the current position
-    int64_t savePos = mFile.GetPosition();
-
-    // Go to the local file header to get the extra field length
-    // !! local header extra field length != central file header extra field length !!
-    mFile.Seek(ze.lhdrOffset+28,SEEK_SET);
-    mFile.Read(&(ze.elength),2);
-    ze.elength = Endian_SwapLE16(ze.elength);
-
-    // Compressed data offset = local header offset + size of local header + filename length + local file header extra field length
-    ze.offset = ze.lhdrOffset + LHDR_SIZE + ze.flength + ze.elength;
-
-    // Jump after central file header extra field and file comment
-    mFile.Seek(savePos + ze.eclength + ze.clength,SEEK_SET);
-	
-    items.push_back(ze);
-  }
-
-  mZipMap.insert(make_pair(strFile,items));
-  mFile.Close();
+  // push date for update detection, if the archive was listed meanwhile this listing replaces it
+  CSingleLock lock(m_critSection);
+  mZipDate[strFile] = m_StatData.st_mtime;
+  mZipMap[strFile].swap(entries);
+  mZipIndex[strFile].swap(names);
   return true;
 }
 
@@ -217,27 +117,26 @@ bool CZipManager::GetZipEntry(const CStdString& strPath, SZipEntry& item)
 
   CStdString strFile = url.GetHostName();
 
-  map<CStdString,vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  vector<SZipEntry> items;
-  if (it == mZipMap.end()) // we need to list the zip
-  {
-    GetZipList(strPath,items);
-  }
-  else
+  CSingleLock lock(m_critSection);
+  if (mZipMap.find(strFile) == mZipMap.end()) // we need to list the zip
   {
-    items = it->second;
+    lock.Leave();
+    vector<SZipEntry> items;
+    if (!GetZipList(strPath,items))
+      return false;
+    lock.Enter();
   }
 
-  CStdString strFileName = url.GetFileName();
-  for (vector<SZipEntry>::iterator it2=items.begin();it2 != items.end();++it2)
-  {
-    if (CStdString(it2->name) == strFileName)
-    {
-      memcpy(&item,&(*it2),sizeof(SZipEntry));
-      return true;
-    }
-  }
-  return false;
+  map<CStdString,map<CStdString,unsigned int> >::iterator it = mZipIndex.find(strFile);
+  if (it == mZipIndex.end())
+    return false;
+
+  map<CStdString,unsigned int>::iterator it2 = it->second.find(url.GetFileName());
+  if (it2 == it->second.end())
+    return false;
+
+  item = mZipMap[strFile][it2->second];
+  return true;
 }
 
 bool CZipManager::ExtractArchive(const CStdString& strArchive, const CStdString& strPath)
@@ -277,52 +176,17 @@ void CZipManager::CleanUp(const CStdString& strArchive, const CStdString& strPat
   }
 }
 
-// Read local file header
-void CZipManager::readHeader(const char* buffer, SZipEntry& info)
-{
-  info.header = Endian_SwapLE32(*(unsigned int*)buffer);
-  info.version = Endian_SwapLE16(*(unsigned short*)(buffer+4));
-  info.flags = Endian_SwapLE16(*(unsigned short*)(buffer+6));
-  info.method = Endian_SwapLE16(*(unsigned short*)(buffer+8));
-  info.mod_time = Endian_SwapLE16(*(unsigned short*)(buffer+10));
-  info.mod_date = Endian_SwapLE16(*(unsigned short*)(buffer+12));
-  info.crc32 = Endian_SwapLE32(*(unsigned int*)(buffer+14));
-  info.csize = Endian_SwapLE32(*(unsigned int*)(buffer+18));
-  info.usize = Endian_SwapLE32(*(unsigned int*)(buffer+22));
-  info.flength = Endian_SwapLE16(*(unsigned short*)(buffer+26));
-  info.elength = Endian_SwapLE16(*(unsigned short*)(buffer+28));
-}
-
-// Read central file header (from central directory)
-void CZipManager::readCHeader(const char* buffer, SZipEntry& info)
-{
-  info.header = Endian_SwapLE32(*(unsigned int*)buffer);
-  // Skip version made by
-  info.version = Endian_SwapLE16(*(unsigned short*)(buffer+6));
-  info.flags = Endian_SwapLE16(*(unsigned short*)(buffer+8));
-  info.method = Endian_SwapLE16(*(unsigned short*)(buffer+10));
-  info.mod_time = Endian_SwapLE16(*(unsigned short*)(buffer+12));
-  info.mod_date = Endian_SwapLE16(*(unsigned short*)(buffer+14));
-  info.crc32 = Endian_SwapLE32(*(unsigned int*)(buffer+16));
-  info.csize = Endian_SwapLE32(*(unsigned int*)(buffer+20));
-  info.usize = Endian_SwapLE32(*(unsigned int*)(buffer+24));
-  info.flength = Endian_SwapLE16(*(unsigned short*)(buffer+28));
-  info.eclength = Endian_SwapLE16(*(unsigned short*)(buffer+30));
-  info.clength = Endian_SwapLE16(*(unsigned short*)(buffer+32));
-  // Skip disk number start, internal/external file attributes
-  info.lhdrOffset = Endian_SwapLE32(*(unsigned int*)(buffer+42));
-
-}
-
 void CZipManager::release(const CStdString& strPath)
 {
   CURL url(strPath);
+  CSingleLock lock(m_critSection);
   map<CStdString,vector<SZipEntry> >::iterator it= mZipMap.find(url.GetHostName());
   if (it != mZipMap.end())
   {
     map<CStdString,int64_t>::iterator it2=mZipDate.find(url.GetHostName());
     mZipMap.erase(it);
     mZipDate.erase(it2);
+    mZipIndex.erase(url.GetHostName());
   }
 }
 
@@ -31,8 +31,13 @@
 #define ECDREC_SIZE 22
 
 #include  "utils/StdString.h"
+#include "utils/EndianSwap.h"
+#include "threads/CriticalSection.h"
 
 #include <memory.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
 #include <vector>
 #include <map>
 
@@ -51,7 +56,7 @@ struct SZipEntry {
   unsigned short eclength; // extra field length (central file header)
   unsigned short clength; // file comment length (central file header)
   unsigned int lhdrOffset; // Relative offset of local header
-  int64_t offset;         // offset in file to compressed data
+  int64_t offset;         // offset in file to compressed data, -1 until read from the local header
   char name[255];
 
   SZipEntry()
@@ -108,11 +113,166 @@ public:
   void release(const CStdString& strPath); // release resources used by list zip
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
+
+  /*! \brief Read the central directory of an opened zip archive.
+   The entries are indexed by name, the first of a name wins.
+   F is the class the archive is read with, XFILE::CFile but for the tests, and
+   C converts the names to UTF-8 like CCharsetConverter::unknownToUTF8.
+   \return false if the file isn't a zip archive or is broken
+   */
+  template<class F, class C>
+  static bool ReadCentralDirectory(F& file, C& charset, std::vector<SZipEntry>& entries, std::map<CStdString,unsigned int>& names);
 private:
   std::map<CStdString,std::vector<SZipEntry> > mZipMap;
   std::map<CStdString,int64_t> mZipDate;
+  std::map<CStdString,std::map<CStdString,unsigned int> > mZipIndex; // entries of mZipMap by name
+  CCriticalSection m_critSection;
 };
 
+// Read local file header
+inline void CZipManager::readHeader(const char* buffer, SZipEntry& info)
+{
+  info.header = Endian_SwapLE32(*(unsigned int*)buffer);
+  info.version = Endian_SwapLE16(*(unsigned short*)(buffer+4));
+  info.flags = Endian_SwapLE16(*(unsigned short*)(buffer+6));
+  info.method = Endian_SwapLE16(*(unsigned short*)(buffer+8));
+  info.mod_time = Endian_SwapLE16(*(unsigned short*)(buffer+10));
+  info.mod_date = Endian_SwapLE16(*(unsigned short*)(buffer+12));
+  info.crc32 = Endian_SwapLE32(*(unsigned int*)(buffer+14));
+  info.csize = Endian_SwapLE32(*(unsigned int*)(buffer+18));
+  info.usize = Endian_SwapLE32(*(unsigned int*)(buffer+22));
+  info.flength = Endian_SwapLE16(*(unsigned short*)(buffer+26));
+  info.elength = Endian_SwapLE16(*(unsigned short*)(buffer+28));
+}
+
+// Read central file header (from central directory)
+inline void CZipManager::readCHeader(const char* buffer, SZipEntry& info)
+{
+  info.header = Endian_SwapLE32(*(unsigned int*)buffer);
+  // Skip version made by
+  info.version = Endian_SwapLE16(*(unsigned short*)(buffer+6));
+  info.flags = Endian_SwapLE16(*(unsigned short*)(buffer+8));
+  info.method = Endian_SwapLE16(*(unsigned short*)(buffer+10));
+  info.mod_time = Endian_SwapLE16(*(unsigned short*)(buffer+12));
+  info.mod_date = Endian_SwapLE16(*(unsigned short*)(buffer+14));
+  info.crc32 = Endian_SwapLE32(*(unsigned int*)(buffer+16));
+  info.csize = Endian_SwapLE32(*(unsigned int*)(buffer+20));
+  info.usize = Endian_SwapLE32(*(unsigned int*)(buffer+24));
+  info.flength = Endian_SwapLE16(*(unsigned short*)(buffer+28));
+  info.eclength = Endian_SwapLE16(*(unsigned short*)(buffer+30));
+  info.clength = Endian_SwapLE16(*(unsigned short*)(buffer+32));
+  // Skip disk number start, internal/external file attributes
+  info.lhdrOffset = Endian_SwapLE32(*(unsigned int*)(buffer+42));
+}
+
+template<class F, class C>
+bool CZipManager::ReadCentralDirectory(F& file, C& charset, std::vector<SZipEntry>& entries, std::map<CStdString,unsigned int>& names)
+{
+  SZipEntry ze;
+  unsigned int hdr;
+  if (file.Read(&hdr, 4) != 4 || Endian_SwapLE32(hdr) != ZIP_LOCAL_HEADER)
+    return false;
+
+  // Look for end of central directory record
+  // Zipfile comment may be up to 65535 bytes
+  // End of central directory record is 22 bytes (ECDREC_SIZE)
+  // -> need to check the last 65557 bytes
+  int64_t fileSize = file.GetLength();
+  if (fileSize < ECDREC_SIZE)
+    return false;
+  // Don't need to look in the last 18 bytes (ECDREC_SIZE-4)
+  // But as we need to do overlapping between blocks (3 bytes),
+  // we start the search at ECDREC_SIZE-1 from the end of file
+  int searchSize = (int) std::min<int64_t>(65557, fileSize-ECDREC_SIZE+1);
+  int blockSize = (int) std::min(1024, searchSize);
+  int nbBlock = searchSize / blockSize;
+  int extraBlockSize = searchSize % blockSize;
+  // Signature is on 4 bytes
+  // It could be between 2 blocks, so we need to read 3 extra bytes
+  std::vector<char> buffer(blockSize+3);
+  bool found = false;
+
+  // Loop through blocks starting at the end of the file (minus ECDREC_SIZE-1)
+  for (int nb=1; !found && (nb <= nbBlock); nb++)
+  {
+    file.Seek(fileSize-ECDREC_SIZE+1-(blockSize*nb),SEEK_SET);
+    file.Read(&buffer[0],blockSize+3);
+    for (int i=blockSize-1; !found && (i >= 0); i--)
+    {
+      if ( Endian_SwapLE32(*((unsigned int*)(&buffer[i]))) == ZIP_END_CENTRAL_HEADER )
+      {
+        // Set current position to start of end of central directory
+        file.Seek(fileSize-ECDREC_SIZE+1-(blockSize*nb)+i,SEEK_SET);
+        found = true;
+      }
+    }
+  }
+
+  // If not found, look in the last block left...
+  if ( !found && (extraBlockSize > 0) )
+  {
+    file.Seek(fileSize-ECDREC_SIZE+1-searchSize,SEEK_SET);
+    file.Read(&buffer[0],extraBlockSize+3);
+    for (int i=extraBlockSize-1; !found && (i >= 0); i--)
+    {
+      if ( Endian_SwapLE32(*((unsigned int*)(&buffer[i]))) == ZIP_END_CENTRAL_HEADER )
+      {
+        // Set current position to start of end of central directory
+        file.Seek(fileSize-ECDREC_SIZE+1-searchSize+i,SEEK_SET);
+        found = true;
+      }
+    }
+  }
+
+  if ( !found )
+    return false;
+
+  unsigned int cdirOffset, cdirSize;
+  // Get size of the central directory
+  file.Seek(12,SEEK_CUR);
+  file.Read(&cdirSize,4);
+  cdirSize = Endian_SwapLE32(cdirSize);
+  // Get Offset of start of central directory with respect to the starting disk number
+  file.Read(&cdirOffset,4);
+  cdirOffset = Endian_SwapLE32(cdirOffset);
+
+  // Read the central directory in one go, it is parsed from memory
+  std::vector<char> cdir(cdirSize + 1);
+  file.Seek(cdirOffset,SEEK_SET);
+  if (cdirOffset + (int64_t)cdirSize > fileSize || file.Read(&cdir[0],cdirSize) != cdirSize)
+    return false;
+
+  unsigned int pos = 0;
+  while (pos < cdirSize)
+  {
+    if (pos + CHDR_SIZE > cdirSize)
+      return false;
+    readCHeader(&cdir[pos], ze);
+    if (ze.header != ZIP_CENTRAL_HEADER || pos + CHDR_SIZE + ze.flength > cdirSize)
+      return false;
+
+    // Get the filename just after the central file header
+    CStdString strName(&cdir[pos + CHDR_SIZE], ze.flength);
+    charset.unknownToUTF8(strName);
+    memset(ze.name, 0, 255);
+    strncpy(ze.name, strName.c_str(), strName.size()>254 ? 254 : strName.size());
+
+    // The local header extra field length, which can differ from the central one, is
+    // only needed to find the data. It's read when the entry is opened rather than
+    // seeking to the local header of every entry here.
+    ze.elength = 0;
+    ze.offset = -1;
+
+    // Jump after central file header extra field and file comment
+    pos += CHDR_SIZE + ze.flength + ze.eclength + ze.clength;
+
+    // lookups find the first entry of a name, as they did going through the list
+    names.insert(std::make_pair(CStdString(ze.name), (unsigned int)entries.size()));
+    entries.push_back(ze);
+  }
+  return true;
+}
+
 extern CZipManager g_ZipManager;
 
 #endif
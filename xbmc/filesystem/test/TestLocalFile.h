@@ -0,0 +1,46 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+// a local file read with stdio in place of CFile, for the archive tests
+class LocalFile
+{
+  FILE* m_file;
+public:
+  LocalFile() : m_file(NULL) {}
+  bool Open(const CStdString& path) { return (m_file = fopen(path.c_str(), "rb")) != NULL; }
+  void Close() { fclose(m_file); m_file = NULL; }
+  int64_t Seek(int64_t position, int whence) { return fseeko(m_file, position, whence) == 0 ? (int64_t)ftello(m_file) : -1; }
+  unsigned int Read(void* buffer, int64_t size) { return fread(buffer, 1, (size_t)size, m_file); }
+  int64_t GetLength()
+  {
+    int64_t position = ftello(m_file);
+    fseeko(m_file, 0, SEEK_END);
+    int64_t length = ftello(m_file);
+    fseeko(m_file, position, SEEK_SET);
+    return length;
+  }
+};
@@ -0,0 +1,281 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "filesystem/RarStream.h"
+#include "utils/test/TestUtils.h"
+#include "filesystem/test/TestLocalFile.h"
+
+#include <boost/thread/thread.hpp>
+#include <stdlib.h>
+
+using namespace XFILE;
+
+// what is at position in the file
+static char Expected(int64_t position)
+{
+  return (char)(position * 7 + (position >> 13));
+}
+
+static bool Matches(const char* data, unsigned int size, int64_t position)
+{
+  for (unsigned int i = 0; i < size; i++)
+  {
+    if (data[i] != Expected(position + i))
+      return false;
+  }
+  return true;
+}
+
+/*
+ * Writes a file split over volumes like a multi-volume rar archive stores it,
+ *  each part between headers of its own.
+ */
+static std::vector<RarVolumeSegment> MakeVolumes(const char* name, unsigned int volumes, int64_t volumeSize)
+{
+  std::vector<RarVolumeSegment> segments;
+  std::vector<char> data(1024 * 1024);
+  int64_t position = 0;
+  for (unsigned int i = 0; i < volumes; i++)
+  {
+    RarVolumeSegment segment;
+    segment.volume.Format("%s.r%02u", name, i);
+    segment.offset = 20 + 13 * i + (i ? 0 : 7);
+    // the last part is what is left over
+    segment.size = i + 1 < volumes ? volumeSize : volumeSize / 3;
+    segment.start = 0;
+
+    FILE* file = fopen(segment.volume.c_str(), "wb");
+    BOOST_REQUIRE(file != NULL);
+    std::vector<char> header((size_t)segment.offset, 'h');
+    fwrite(&header[0], 1, header.size(), file);
+    for (int64_t done = 0; done < segment.size; )
+    {
+      unsigned int chunk = (unsigned int)std::min<int64_t>(data.size(), segment.size - done);
+      for (unsigned int j = 0; j < chunk; j++)
+        data[j] = Expected(position + j);
+      fwrite(&data[0], 1, chunk, file);
+      done += chunk;
+      position += chunk;
+    }
+    fwrite("end of archive", 1, 14, file);
+    fclose(file);
+    segments.push_back(segment);
+  }
+  return segments;
+}
+
+static void RemoveVolumes(const std::vector<RarVolumeSegment>& segments)
+{
+  for (unsigned int i = 0; i < segments.size(); i++)
+    remove(segments[i].volume.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(TestRarVolumeReader)
+{
+  const int64_t volumeSize = 100000;
+  std::vector<RarVolumeSegment> segments = MakeVolumes("TestRarVolumeReader", 5, volumeSize);
+  const int64_t length = 4 * volumeSize + volumeSize / 3;
+
+  CRarVolumeReader<LocalFile> reader;
+  reader.Open(segments);
+  BOOST_CHECK_EQUAL(length, reader.GetLength());
+
+  // all of it in reads that cross the volumes at odd places
+  std::vector<char> buffer(70001);
+  int64_t position = 0;
+  unsigned int read;
+  while ((read = reader.Read(&buffer[0], buffer.size())) > 0)
+  {
+    BOOST_REQUIRE(Matches(&buffer[0], read, position));
+    position += read;
+  }
+  BOOST_CHECK_EQUAL(length, position);
+  BOOST_CHECK_EQUAL(length, reader.GetPosition());
+
+  // seeking about, including across and onto the boundaries
+  int64_t positions[] = { 0, volumeSize - 1, volumeSize, 3 * volumeSize + 5, 17, length - 10 };
+  for (unsigned int i = 0; i < sizeof(positions) / sizeof(positions[0]); i++)
+  {
+    BOOST_REQUIRE_EQUAL(positions[i], reader.Seek(positions[i], SEEK_SET));
+    read = reader.Read(&buffer[0], 1000);
+    BOOST_CHECK_EQUAL(std::min<int64_t>(1000, length - positions[i]), read);
+    BOOST_CHECK(Matches(&buffer[0], read, positions[i]));
+  }
+
+  BOOST_CHECK_EQUAL(length - 1, reader.Seek(-1, SEEK_END));
+  BOOST_CHECK_EQUAL(length - 11, reader.Seek(-10, SEEK_CUR));
+  BOOST_CHECK_EQUAL(-1, reader.Seek(length + 1, SEEK_SET));
+  BOOST_CHECK_EQUAL(-1, reader.Seek(-1, SEEK_SET));
+  BOOST_CHECK_EQUAL(length - 11, reader.GetPosition());
+
+  // a missing volume ends the read short
+  reader.Close();
+  remove(segments[2].volume.c_str());
+  reader.Seek(volumeSize, SEEK_SET);
+  std::vector<char> big((size_t)volumeSize + 1000);
+  BOOST_CHECK_EQUAL((unsigned int)volumeSize, reader.Read(&big[0], big.size()));
+  BOOST_CHECK(Matches(&big[0], (unsigned int)volumeSize, volumeSize));
+
+  RemoveVolumes(segments);
+}
+
+BOOST_AUTO_TEST_CASE(TestRarVolumeReaderBenchmark)
+{
+  // a 200MB stored file in 10MB volumes, like a scene release scaled down
+  const unsigned int volumes = 21;
+  const int64_t volumeSize = 10 * 1024 * 1024;
+  std::vector<RarVolumeSegment> segments = MakeVolumes("TestRarVolumeReaderBenchmark", volumes, volumeSize);
+  std::vector<char> buffer(256 * 1024);
+
+  // the old way: the whole file is copied to the cache before the first byte
+  double start = NowMS();
+  {
+    CRarVolumeReader<LocalFile> reader;
+    reader.Open(segments);
+    FILE* cache = fopen("TestRarVolumeReaderBenchmark.cache", "wb");
+    BOOST_REQUIRE(cache != NULL);
+    unsigned int read;
+    while ((read = reader.Read(&buffer[0], buffer.size())) > 0)
+      fwrite(&buffer[0], 1, read, cache);
+    fclose(cache);
+    cache = fopen("TestRarVolumeReaderBenchmark.cache", "rb");
+    BOOST_CHECK_EQUAL(buffer.size(), fread(&buffer[0], 1, buffer.size(), cache));
+    fclose(cache);
+    remove("TestRarVolumeReaderBenchmark.cache");
+  }
+  double cached = NowMS() - start;
+
+  start = NowMS();
+  CRarVolumeReader<LocalFile> reader;
+  reader.Open(segments);
+  BOOST_CHECK_EQUAL(buffer.size(), reader.Read(&buffer[0], buffer.size()));
+  double firstByte = NowMS() - start;
+  BOOST_CHECK(Matches(&buffer[0], buffer.size(), 0));
+
+  const unsigned int seeks = 500;
+  srand(1);
+  start = NowMS();
+  for (unsigned int i = 0; i < seeks; i++)
+  {
+    int64_t position = (int64_t)(((double)rand() / RAND_MAX) * (reader.GetLength() - 4096));
+    reader.Seek(position, SEEK_SET);
+    BOOST_REQUIRE_EQUAL(4096u, reader.Read(&buffer[0], 4096));
+    BOOST_REQUIRE(Matches(&buffer[0], 4096, position));
+  }
+  double seek = (NowMS() - start) / seeks;
+
+  BOOST_TEST_MESSAGE(reader.GetLength() / (1024 * 1024) << "MB in " << volumes << " volumes: first byte after "
+                     << firstByte << "ms reading the volumes, " << cached << "ms extracting to the cache first, "
+                     << seek << "ms a seek and read");
+  RemoveVolumes(segments);
+}
+
+class unpacker
+{
+  CRarUnpackBuffer& buffer;
+  int64_t size;
+public:
+  bool aborted;
+  unpacker(CRarUnpackBuffer& b, int64_t s) : buffer(b), size(s), aborted(false) {}
+
+  void operator()()
+  {
+    std::vector<char> data(100000);
+    int64_t position = 0;
+    while (position < size)
+    {
+      // unrar writes whatever it has unpacked, which varies
+      unsigned int chunk = (unsigned int)std::min<int64_t>(1 + rand() % data.size(), size - position);
+      for (unsigned int i = 0; i < chunk; i++)
+        data[i] = Expected(position + i);
+      if (!buffer.Write(&data[0], chunk))
+      {
+        aborted = true;
+        return;
+      }
+      position += chunk;
+    }
+    buffer.Finish();
+  }
+};
+
+BOOST_AUTO_TEST_CASE(TestRarUnpackBuffer)
+{
+  const int64_t size = 20 * 1024 * 1024;
+  CRarUnpackBuffer buffer(1024 * 1024);
+  unpacker producer(buffer, size);
+
+  double start = NowMS();
+  boost::thread thread(boost::ref(producer));
+  std::vector<char> data(65536);
+  unsigned int read = buffer.Read(&data[0], data.size(), 5000);
+  double firstByte = NowMS() - start;
+
+  int64_t position = 0;
+  while (read > 0)
+  {
+    BOOST_REQUIRE(Matches(&data[0], read, position));
+    position += read;
+    read = buffer.Read(&data[0], 1 + rand() % data.size(), 5000);
+  }
+  double all = NowMS() - start;
+  thread.join();
+
+  BOOST_CHECK_EQUAL(size, position);
+  BOOST_CHECK(!producer.aborted);
+  BOOST_CHECK(buffer.GetMaxFill() <= buffer.GetSize());
+  BOOST_TEST_MESSAGE("unpack buffer: first byte after " << firstByte << "ms, " << size / (1024 * 1024) << "MB through "
+                     << buffer.GetSize() / 1024 << "KB in " << all << "ms");
+}
+
+BOOST_AUTO_TEST_CASE(TestRarUnpackBufferAbort)
+{
+  CRarUnpackBuffer buffer(4096);
+  unpacker producer(buffer, 1024 * 1024);
+  boost::thread thread(boost::ref(producer));
+
+  // nothing is read, so the unpacker blocks on the full buffer until the file is closed
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+  BOOST_CHECK_EQUAL(4096u, buffer.GetMaxFill());
+  buffer.Abort();
+  thread.join();
+  BOOST_CHECK(producer.aborted);
+
+  char data[16];
+  BOOST_CHECK_EQUAL(0u, buffer.Read(data, sizeof(data), 1000));
+}
+
+BOOST_AUTO_TEST_CASE(TestRarUnpackBufferTimeout)
+{
+  CRarUnpackBuffer buffer(4096);
+  char data[16];
+  double start = NowMS();
+  BOOST_CHECK_EQUAL(0u, buffer.Read(data, sizeof(data), 100));
+  BOOST_CHECK(NowMS() - start >= 90);
+
+  // what is left is read after the end
+  BOOST_CHECK(buffer.Write("0123456789", 10));
+  buffer.Finish();
+  BOOST_CHECK_EQUAL(10u, buffer.Read(data, sizeof(data), 100));
+  BOOST_CHECK_EQUAL(0u, buffer.Read(data, sizeof(data), 100));
+}
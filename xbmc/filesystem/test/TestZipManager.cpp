@@ -0,0 +1,226 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "filesystem/ZipManager.h"
+#include "utils/test/TestUtils.h"
+#include "filesystem/test/TestLocalFile.h"
+
+#include <stdlib.h>
+
+// the names are plain ascii, there is nothing to convert
+class KeepNames
+{
+public:
+  void unknownToUTF8(CStdStringA& sourceDest) {}
+};
+
+static void Put16(std::vector<char>& out, unsigned int value)
+{
+  out.push_back((char)(value & 0xff));
+  out.push_back((char)((value >> 8) & 0xff));
+}
+
+static void Put32(std::vector<char>& out, unsigned int value)
+{
+  Put16(out, value & 0xffff);
+  Put16(out, value >> 16);
+}
+
+static CStdString EntryName(unsigned int i)
+{
+  CStdString name;
+  name.Format("textures/%02u/file%05u.png", i % 50, i);
+  return name;
+}
+
+/*
+ * Writes a zip archive of files stored without compression, like the packed
+ * textures of a skin. The local header offset of each file is returned.
+ */
+static std::vector<unsigned int> MakeZip(const char* path, unsigned int files)
+{
+  std::vector<char> data, cdir;
+  std::vector<unsigned int> offsets;
+  for (unsigned int i = 0; i < files; i++)
+  {
+    CStdString name = EntryName(i);
+    unsigned int size = 50 + i % 200;
+    offsets.push_back(data.size());
+
+    Put32(data, ZIP_LOCAL_HEADER);
+    Put16(data, 10);   // version needed
+    Put16(data, 0);    // flags
+    Put16(data, 0);    // stored
+    Put16(data, 0);    // time
+    Put16(data, 0);    // date
+    Put32(data, i);    // crc, not checked here
+    Put32(data, size);
+    Put32(data, size);
+    Put16(data, name.size());
+    Put16(data, 4);    // an extra field the central header doesn't have
+    data.insert(data.end(), name.begin(), name.end());
+    Put32(data, 0);
+    data.insert(data.end(), size, (char)i);
+
+    Put32(cdir, ZIP_CENTRAL_HEADER);
+    Put16(cdir, 20);   // version made by
+    Put16(cdir, 10);
+    Put16(cdir, 0);
+    Put16(cdir, 0);
+    Put16(cdir, 0);
+    Put16(cdir, 0);
+    Put32(cdir, i);
+    Put32(cdir, size);
+    Put32(cdir, size);
+    Put16(cdir, name.size());
+    Put16(cdir, 0);    // extra field
+    Put16(cdir, 0);    // comment
+    Put16(cdir, 0);    // disk
+    Put16(cdir, 0);    // internal attributes
+    Put32(cdir, 0);    // external attributes
+    Put32(cdir, offsets.back());
+    cdir.insert(cdir.end(), name.begin(), name.end());
+  }
+
+  unsigned int cdirOffset = data.size();
+  data.insert(data.end(), cdir.begin(), cdir.end());
+  Put32(data, ZIP_END_CENTRAL_HEADER);
+  Put16(data, 0);
+  Put16(data, 0);
+  Put16(data, files);
+  Put16(data, files);
+  Put32(data, cdir.size());
+  Put32(data, cdirOffset);
+  Put16(data, 0);      // comment
+
+  FILE* file = fopen(path, "wb");
+  BOOST_REQUIRE(file != NULL);
+  fwrite(&data[0], 1, data.size(), file);
+  fclose(file);
+  return offsets;
+}
+
+static bool List(const char* path, std::vector<SZipEntry>& entries, std::map<CStdString,unsigned int>& names)
+{
+  LocalFile file;
+  KeepNames charset;
+  if (!file.Open(path))
+    return false;
+  bool listed = CZipManager::ReadCentralDirectory(file, charset, entries, names);
+  file.Close();
+  return listed;
+}
+
+BOOST_AUTO_TEST_CASE(TestZipCentralDirectory)
+{
+  std::vector<unsigned int> offsets = MakeZip("TestZipCentralDirectory.zip", 100);
+
+  std::vector<SZipEntry> entries;
+  std::map<CStdString,unsigned int> names;
+  BOOST_REQUIRE(List("TestZipCentralDirectory.zip", entries, names));
+  BOOST_REQUIRE_EQUAL(100u, entries.size());
+  BOOST_REQUIRE_EQUAL(100u, names.size());
+  for (unsigned int i = 0; i < entries.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(EntryName(i), entries[i].name);
+    BOOST_CHECK_EQUAL(offsets[i], entries[i].lhdrOffset);
+    BOOST_CHECK_EQUAL(50 + i % 200, entries[i].usize);
+    // the local header is only read when the entry is opened
+    BOOST_CHECK_EQUAL(-1, entries[i].offset);
+    BOOST_CHECK_EQUAL(i, names[EntryName(i)]);
+  }
+
+  // cut short in the central directory
+  FILE* file = fopen("TestZipCentralDirectory.zip", "rb");
+  std::vector<char> data(100000);
+  data.resize(fread(&data[0], 1, data.size(), file));
+  fclose(file);
+  file = fopen("TestZipCentralDirectory.zip", "wb");
+  fwrite(&data[0], 1, data.size() - 100, file);
+  fclose(file);
+  entries.clear();
+  names.clear();
+  BOOST_CHECK(!List("TestZipCentralDirectory.zip", entries, names));
+
+  // not a zip at all
+  file = fopen("TestZipCentralDirectory.zip", "wb");
+  fwrite("not a zip archive", 1, 17, file);
+  fclose(file);
+  BOOST_CHECK(!List("TestZipCentralDirectory.zip", entries, names));
+  remove("TestZipCentralDirectory.zip");
+}
+
+BOOST_AUTO_TEST_CASE(TestZipCentralDirectoryBenchmark)
+{
+  const unsigned int files = 10000;
+  MakeZip("TestZipCentralDirectoryBenchmark.zip", files);
+
+  const unsigned int lists = 20;
+  std::vector<SZipEntry> entries;
+  std::map<CStdString,unsigned int> names;
+  double start = NowMS();
+  for (unsigned int i = 0; i < lists; i++)
+  {
+    entries.clear();
+    names.clear();
+    BOOST_REQUIRE(List("TestZipCentralDirectoryBenchmark.zip", entries, names));
+  }
+  double list = (NowMS() - start) / lists;
+  BOOST_REQUIRE_EQUAL(files, entries.size());
+
+  // every file looked up once, through the index and going through the list as it was done before
+  std::vector<CStdString> lookups;
+  for (unsigned int i = 0; i < files; i++)
+    lookups.push_back(EntryName((i * 7919) % files));
+
+  start = NowMS();
+  unsigned int found = 0;
+  for (unsigned int i = 0; i < files; i++)
+  {
+    std::map<CStdString,unsigned int>::iterator it = names.find(lookups[i]);
+    if (it != names.end() && entries[it->second].name == lookups[i])
+      found++;
+  }
+  double indexed = NowMS() - start;
+  BOOST_CHECK_EQUAL(files, found);
+
+  start = NowMS();
+  found = 0;
+  for (unsigned int i = 0; i < files; i++)
+  {
+    for (unsigned int j = 0; j < entries.size(); j++)
+    {
+      if (lookups[i] == entries[j].name)
+      {
+        found++;
+        break;
+      }
+    }
+  }
+  double linear = NowMS() - start;
+  BOOST_CHECK_EQUAL(files, found);
+
+  BOOST_TEST_MESSAGE(files << " files: listed in " << list << "ms, " << files << " lookups in "
+                     << indexed << "ms through the index, " << linear << "ms going through the list");
+  remove("TestZipCentralDirectoryBenchmark.zip");
+}
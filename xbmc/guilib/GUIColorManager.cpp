@@ -20,6 +20,7 @@
  */
 
 #include "GUIColorManager.h"
+#include "GUITextLayout.h"
 #include "filesystem/SpecialProtocol.h"
 #include "addons/Skin.h"
 #include "utils/log.h"
@@ -47,6 +48,9 @@ void CGUIColorManager::Load(const CStdString &colorFile)
 {
   Clear();
 
+  // cached labels have their [COLOR] tags resolved already
+  CGUITextLayout::ClearCache();
+
   // load the global color map if it exists
   TiXmlDocument xmlDoc;
   if (xmlDoc.LoadFile(PTH_IC("special://xbmc/system/colors.xml")))
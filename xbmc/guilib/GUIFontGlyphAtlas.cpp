@@ -0,0 +1,243 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "GUIFontGlyphAtlas.h"
+
+#define MIN_TABLE_SIZE 64
+
+CGUIFontGlyphAtlas::CGUIFontGlyphAtlas()
+{
+  m_width = m_shelfHeight = m_maxHeight = 0;
+  m_tableMask = 0;
+  m_tableShift = 32;
+  m_count = 0;
+  m_newest = m_oldest = -1;
+  m_hits = m_misses = m_evictions = 0;
+}
+
+void CGUIFontGlyphAtlas::Reset(unsigned int width, unsigned int shelfHeight, unsigned int maxHeight)
+{
+  m_width       = width;
+  m_shelfHeight = shelfHeight;
+  m_maxHeight   = maxHeight;
+
+  m_shelves.clear();
+  m_slots.clear();
+  m_freeSlots.clear();
+  m_count = 0;
+  m_newest = m_oldest = -1;
+  Rehash(MIN_TABLE_SIZE);
+}
+
+int CGUIFontGlyphAtlas::Insert(uint32_t key, unsigned int width, unsigned int &x, unsigned int &y)
+{
+  unsigned int shelf = 0;
+  x = 0;
+  if (width && !Allocate(width, shelf, x))
+    return -1;
+  y = shelf * m_shelfHeight;
+
+  // keep the table at most half full so probe sequences stay short
+  if (2 * (m_count + 1) > m_table.size())
+    Rehash(2 * m_table.size());
+
+  int slot;
+  if (!m_freeSlots.empty())
+  {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+  else
+  {
+    slot = m_slots.size();
+    m_slots.push_back(Slot());
+  }
+
+  Slot &s = m_slots[slot];
+  s.key   = key;
+  s.x     = x;
+  s.width = width;
+  s.shelf = shelf;
+  s.inUse = true;
+
+  // zero width glyphs are never evicted so they stay off the list
+  s.newer = s.older = -1;
+  if (width)
+    LinkNewest(slot);
+
+  HashInsert(slot);
+  m_count++;
+  return slot;
+}
+
+bool CGUIFontGlyphAtlas::EvictOldest(uint32_t &key, unsigned int &x, unsigned int &y, unsigned int &width)
+{
+  int oldest = m_oldest;
+  if (oldest < 0)
+    return false;
+
+  const Slot &s = m_slots[oldest];
+  key   = s.key;
+  x     = s.x;
+  y     = s.shelf * m_shelfHeight;
+  width = s.width;
+
+  Remove(oldest);
+  m_evictions++;
+  return true;
+}
+
+void CGUIFontGlyphAtlas::Remove(int slot)
+{
+  Slot &s = m_slots[slot];
+  if (!s.inUse)
+    return;
+
+  HashRemove(slot);
+  if (s.width)
+  {
+    Unlink(slot);
+    Free(s.shelf, s.x, s.width);
+  }
+  s.inUse = false;
+  m_freeSlots.push_back(slot);
+  m_count--;
+}
+
+bool CGUIFontGlyphAtlas::Allocate(unsigned int width, unsigned int &shelf, unsigned int &x)
+{
+  if (width > m_width)
+    return false;
+
+  for (unsigned int i = 0; i < m_shelves.size(); i++)
+  {
+    // the maximum height may have shrunk if the texture failed to grow
+    if ((i + 1) * m_shelfHeight > m_maxHeight)
+      break;
+
+    std::vector<Span> &spans = m_shelves[i].free;
+    for (std::vector<Span>::iterator it = spans.begin(); it != spans.end(); ++it)
+    {
+      if (it->width >= width)
+      {
+        shelf = i;
+        x = it->x;
+        it->x     += width;
+        it->width -= width;
+        if (!it->width)
+          spans.erase(it);
+        return true;
+      }
+    }
+  }
+
+  // open a new shelf at the bottom of the texture
+  if ((m_shelves.size() + 1) * m_shelfHeight > m_maxHeight)
+    return false;
+
+  Span span;
+  span.x     = width;
+  span.width = m_width - width;
+  m_shelves.push_back(Shelf());
+  if (span.width)
+    m_shelves.back().free.push_back(span);
+
+  shelf = m_shelves.size() - 1;
+  x = 0;
+  return true;
+}
+
+void CGUIFontGlyphAtlas::Free(unsigned int shelf, unsigned int x, unsigned int width)
+{
+  // spans are kept sorted by position so neighbours can be merged
+  std::vector<Span> &spans = m_shelves[shelf].free;
+  std::vector<Span>::iterator it = spans.begin();
+  while (it != spans.end() && it->x < x)
+    ++it;
+
+  Span span;
+  span.x     = x;
+  span.width = width;
+  it = spans.insert(it, span);
+
+  std::vector<Span>::iterator next = it + 1;
+  if (next != spans.end() && it->x + it->width == next->x)
+  {
+    it->width += next->width;
+    spans.erase(next);
+  }
+  if (it != spans.begin())
+  {
+    std::vector<Span>::iterator prev = it - 1;
+    if (prev->x + prev->width == it->x)
+    {
+      prev->width += it->width;
+      spans.erase(it);
+    }
+  }
+}
+
+void CGUIFontGlyphAtlas::HashInsert(int slot)
+{
+  unsigned int i = Hash(m_slots[slot].key);
+  while (m_table[i] >= 0)
+    i = (i + 1) & m_tableMask;
+  m_table[i] = slot;
+}
+
+void CGUIFontGlyphAtlas::HashRemove(int slot)
+{
+  unsigned int i = Hash(m_slots[slot].key);
+  while (m_table[i] != slot)
+    i = (i + 1) & m_tableMask;
+  m_table[i] = -1;
+
+  // shift back any entries of the following run that would no longer be reachable
+  for (unsigned int j = (i + 1) & m_tableMask; m_table[j] >= 0; j = (j + 1) & m_tableMask)
+  {
+    unsigned int home = Hash(m_slots[m_table[j]].key);
+    // the entry can move to the hole unless its home lies cyclically in (i, j]
+    bool reachable = (i <= j) ? (home > i && home <= j) : (home > i || home <= j);
+    if (!reachable)
+    {
+      m_table[i] = m_table[j];
+      m_table[j] = -1;
+      i = j;
+    }
+  }
+}
+
+void CGUIFontGlyphAtlas::Rehash(unsigned int size)
+{
+  unsigned int bits = 0;
+  while ((1U << bits) < size)
+    bits++;
+
+  m_table.assign(1U << bits, -1);
+  m_tableMask  = (1U << bits) - 1;
+  m_tableShift = 32 - bits;
+
+  for (unsigned int i = 0; i < m_slots.size(); i++)
+  {
+    if (m_slots[i].inUse)
+      HashInsert(i);
+  }
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Bookkeeping for the glyphs cached in a font texture.
+
+ The texture is split into shelves of a fixed height (the font's cell height),
+ each shelf keeps a list of free horizontal spans. Glyphs are found through an
+ open addressing hash on their letter and style, and when the texture can't grow
+ any further the least recently used glyphs are evicted one at a time. Glyphs
+ are kept on a list in order of use so the oldest one is found without a search.
+
+ The atlas only hands out slot numbers and texture positions, the font keeps
+ the glyph metrics in its own array indexed by slot.
+ */
+class CGUIFontGlyphAtlas
+{
+public:
+  CGUIFontGlyphAtlas();
+
+  /*! \brief Drop all glyphs and set up an empty atlas.
+   \param width width of the texture in pixels.
+   \param shelfHeight height of each shelf in pixels.
+   \param maxHeight maximum height the texture can grow to.
+   */
+  void Reset(unsigned int width, unsigned int shelfHeight, unsigned int maxHeight);
+
+  /*! \brief Find the slot of a cached glyph and mark it as recently used.
+   \return the slot, or -1 if the glyph isn't cached.
+   */
+  inline int Find(uint32_t key)
+  {
+    if (m_table.empty())
+      return -1;
+    for (unsigned int i = Hash(key); ; i = (i + 1) & m_tableMask)
+    {
+      int slot = m_table[i];
+      if (slot < 0)
+      {
+        m_misses++;
+        return -1;
+      }
+      if (m_slots[slot].key == key)
+      {
+        m_hits++;
+        if (slot != m_newest && m_slots[slot].width)
+        {
+          Unlink(slot);
+          LinkNewest(slot);
+        }
+        return slot;
+      }
+    }
+  }
+
+  /*! \brief Reserve a region of the texture for a new glyph.
+   Space is taken from the first free span that fits, a new shelf is opened if
+   none does. Zero width glyphs don't take any space.
+   \param key letter and style of the glyph.
+   \param width width of the region in pixels.
+   \param x,y receives the top left corner of the region.
+   \return the slot of the glyph, or -1 if there is no room without evicting.
+   */
+  int Insert(uint32_t key, unsigned int width, unsigned int &x, unsigned int &y);
+
+  /*! \brief Evict the least recently used glyph.
+   \param key,x,y,width receive the evicted glyph and the region it occupied.
+   \return false if the atlas is empty.
+   */
+  bool EvictOldest(uint32_t &key, unsigned int &x, unsigned int &y, unsigned int &width);
+
+  /*! \brief Remove a single glyph, freeing its region. */
+  void Remove(int slot);
+
+  unsigned int GetHeight() const { return m_shelves.size() * m_shelfHeight; }
+  unsigned int GetMaxHeight() const { return m_maxHeight; }
+  void SetMaxHeight(unsigned int maxHeight) { m_maxHeight = maxHeight; }
+
+  /*! \brief Number of slots that have been allocated, some may be free. Slots are in [0, GetSlotCount()) */
+  unsigned int GetSlotCount() const { return m_slots.size(); }
+  unsigned int GetGlyphCount() const { return m_count; }
+
+  unsigned int GetHits() const      { return m_hits; }
+  unsigned int GetMisses() const    { return m_misses; }
+  unsigned int GetEvictions() const { return m_evictions; }
+
+private:
+  struct Span
+  {
+    uint16_t x;
+    uint16_t width;
+  };
+
+  struct Shelf
+  {
+    std::vector<Span> free;
+  };
+
+  struct Slot
+  {
+    uint32_t key;
+    int      newer;   ///< neighbours in the list of glyphs ordered by use, -1 at the ends
+    int      older;
+    uint16_t x;
+    uint16_t width;
+    uint16_t shelf;
+    bool     inUse;
+  };
+
+  inline unsigned int Hash(uint32_t key) const
+  {
+    return (key * 2654435761U) >> m_tableShift & m_tableMask;
+  }
+
+  inline void Unlink(int slot)
+  {
+    Slot &s = m_slots[slot];
+    if (s.newer >= 0) m_slots[s.newer].older = s.older; else m_newest = s.older;
+    if (s.older >= 0) m_slots[s.older].newer = s.newer; else m_oldest = s.newer;
+  }
+
+  inline void LinkNewest(int slot)
+  {
+    Slot &s = m_slots[slot];
+    s.newer = -1;
+    s.older = m_newest;
+    if (m_newest >= 0) m_slots[m_newest].newer = slot; else m_oldest = slot;
+    m_newest = slot;
+  }
+
+  bool Allocate(unsigned int width, unsigned int &shelf, unsigned int &x);
+  void Free(unsigned int shelf, unsigned int x, unsigned int width);
+  void HashInsert(int slot);
+  void HashRemove(int slot);
+  void Rehash(unsigned int size);
+
+  unsigned int m_width;
+  unsigned int m_shelfHeight;
+  unsigned int m_maxHeight;
+
+  std::vector<Shelf> m_shelves;
+  std::vector<Slot>  m_slots;
+  std::vector<int>   m_freeSlots;
+  std::vector<int>   m_table;      ///< hash table of slot numbers, -1 for empty entries
+  unsigned int       m_tableMask;
+  unsigned int       m_tableShift;
+  unsigned int       m_count;
+  int                m_newest;     ///< most recently used glyph that takes up space
+  int                m_oldest;
+
+  unsigned int m_hits;
+  unsigned int m_misses;
+  unsigned int m_evictions;
+};
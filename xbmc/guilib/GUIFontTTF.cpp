@@ -48,7 +48,6 @@ using namespace std;
 
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
-#define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
@@ -70,6 +69,18 @@ public:
 
   FT_Face GetFont(const CStdString &filename, float size, float aspect)
   {
+    // fonts that only differ by border or style share the same face
+    CStdString key;
+    key.Format("%s_%f_%f", _P(filename).c_str(), size, aspect);
+    for (vector<SharedFace>::iterator it = m_faces.begin(); it != m_faces.end(); ++it)
+    {
+      if (it->key == key)
+      {
+        it->references++;
+        return it->face;
+      }
+    }
+
     // don't have it yet - create it
     if (!m_library)
       FT_Init_FreeType(&m_library);
@@ -98,6 +109,8 @@ public:
       return NULL;
     }
 
+    SharedFace shared = { key, face, 1 };
+    m_faces.push_back(shared);
     return face;
   };
   
@@ -116,6 +129,18 @@ public:
   void ReleaseFont(FT_Face face)
   {
     assert(face);
+    for (vector<SharedFace>::iterator it = m_faces.begin(); it != m_faces.end(); ++it)
+    {
+      if (it->face == face)
+      {
+        if (--it->references == 0)
+        {
+          FT_Done_Face(face);
+          m_faces.erase(it);
+        }
+        return;
+      }
+    }
     FT_Done_Face(face);
   };
   
@@ -131,7 +156,15 @@ public:
   };
 
 private:
+  struct SharedFace
+  {
+    CStdString   key;
+    FT_Face      face;
+    unsigned int references;
+  };
+
   FT_Library   m_library;
+  vector<SharedFace> m_faces;
 };
 
 CFreeTypeLibrary g_freeTypeLibrary; // our freetype library
@@ -139,8 +172,6 @@ CFreeTypeLibrary g_freeTypeLibrary; // our freetype library
 CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 {
   m_texture = NULL;
-  m_char = NULL;
-  m_maxChars = 0;
   m_nestedBeginCount = 0;
 
   m_bTextureLoaded = false;
@@ -149,13 +180,10 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 
   m_face = NULL;
   m_stroker = NULL;
-  memset(m_charquick, 0, sizeof(m_charquick));
   m_strFileName = strFileName;
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
-  m_numChars = 0;
-  m_posX = m_posY = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -183,35 +211,17 @@ void CGUIFontTTFBase::RemoveReference()
 }
 
 
-void CGUIFontTTFBase::ClearCharacterCache()
-{
-  delete(m_texture);
-
-  DeleteHardwareTexture();
-
-  m_texture = NULL;
-  delete[] m_char;
-  m_char = new Character[CHAR_CHUNK];
-  memset(m_charquick, 0, sizeof(m_charquick));
-  m_numChars = 0;
-  m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)m_cellHeight;
-  m_textureHeight = 0;
-}
-
 void CGUIFontTTFBase::Clear()
 {
+  if (m_atlas.GetHits() + m_atlas.GetMisses())
+    CLog::Log(LOGDEBUG, "%s - font %s: %u glyphs cached, %u hits, %u misses, %u evicted", __FUNCTION__,
+              m_strFileName.c_str(), m_atlas.GetGlyphCount(), m_atlas.GetHits(), m_atlas.GetMisses(), m_atlas.GetEvictions());
+
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  memset(m_charquick, 0, sizeof(m_charquick));
-  m_char = NULL;
-  m_maxChars = 0;
-  m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
+  m_char.clear();
+  m_atlas.Reset(0, 0, 0);
+  m_textureHeight = 0;
   m_nestedBeginCount = 0;
 
   if (m_face)
@@ -278,11 +288,7 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
 
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  m_char = NULL;
-
-  m_maxChars = 0;
-  m_numChars = 0;
+  m_char.clear();
 
   m_strFilename = strFilename;
 
@@ -294,9 +300,9 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
   if (m_textureWidth > g_Windowing.GetMaxTextureSize())
     m_textureWidth = g_Windowing.GetMaxTextureSize();
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)m_cellHeight;
+  // our texture will be created on first character write.
+  m_textureHeight = 0;
+  m_atlas.Reset(m_textureWidth, m_cellHeight, g_Windowing.GetMaxTextureSize());
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -453,86 +459,30 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (letter == L'\r')
     return NULL;
 
-  // quick access to ascii chars
-  if (letter < 255)
-  {
-    character_t ch = (style << 8) | letter;
-    if (m_charquick[ch])
-      return m_charquick[ch];
-  }
-
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  int mid;
-  while (low <= high)
-  {
-    mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
-  }
-  // if we get to here, then low is where we should insert the new character
-
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
+  int slot = m_atlas.Find(ch);
+  if (slot >= 0)
+    return &m_char[slot];
 
-  }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-  }
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
-    {
-      CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
-    }
-  }
+  slot = CacheCharacter(letter, style);
+  if (slot < 0)
+    CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
-  memset(m_charquick, 0, sizeof(m_charquick));
-  for(int i=0;i<m_numChars;i++)
-  {
-    if ((m_char[i].letterAndStyle & 0xffff) < 255)
-    {
-      character_t ch = ((m_char[i].letterAndStyle & 0xffff0000) >> 8) | (m_char[i].letterAndStyle & 0xff);
-      m_charquick[ch] = m_char+i;
-    }
-  }
-
-  return m_char + low;
+  if (slot < 0)
+    return NULL;
+  return &m_char[slot];
 }
 
-bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+int CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style)
 {
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
@@ -540,7 +490,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
-    return false;
+    return -1;
   }
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
@@ -552,7 +502,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (FT_Get_Glyph(m_face->glyph, &glyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
-    return false;
+    return -1;
   }
   if (m_stroker)
     FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
@@ -560,57 +510,65 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
-    return false;
+    return -1;
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
   FT_Bitmap bitmap = bitGlyph->bitmap;
-  if (bitGlyph->left < 0)
-    m_posX += -bitGlyph->left;
-
-  // check we have enough room for the character
-  if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
-  { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-    m_posX = 0;
-    m_posY += m_cellHeight;
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
-
-    if(m_posY + m_cellHeight >= m_textureHeight)
+
+  // find room for the character, leaving a column free so filtering doesn't pick up our neighbour
+  character_t key = (style << 16) | letter;
+  unsigned int width = bitmap.width ? bitmap.width + 1 : 0;
+  unsigned int posX, posY;
+  int slot;
+  while ((slot = m_atlas.Insert(key, width, posX, posY)) < 0)
+  {
+    // the texture is full - drop the character that was used the longest time ago
+    uint32_t oldKey;
+    unsigned int oldX, oldY, oldWidth;
+    if (!m_atlas.EvictOldest(oldKey, oldX, oldY, oldWidth))
     {
-      // create the new larger texture
-      unsigned int newHeight = m_posY + m_cellHeight;
-      // check for max height
-      if (newHeight > g_Windowing.GetMaxTextureSize())
-      {
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
-        FT_Done_Glyph(glyph);
-        return false;
-      }
+      CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Character %x is too large for the cache texture", letter);
+      FT_Done_Glyph(glyph);
+      return -1;
+    }
+    ClearTextureRegion(oldX, oldY, oldWidth);
+  }
 
-      CBaseTexture* newTexture = NULL;
-      newTexture = ReallocTexture(newHeight);
-      if(newTexture == NULL)
-      {
-        FT_Done_Glyph(glyph);
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Failed to allocate new texture of height %u", newHeight);
-        return false;
-      }
-      m_texture = newTexture;
+  if (posY + m_cellHeight > m_textureHeight)
+  {
+    // create the new larger texture
+    unsigned int newHeight = posY + m_cellHeight;
+    CBaseTexture* newTexture = ReallocTexture(newHeight);
+    if (newTexture == NULL)
+    {
+      CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Failed to allocate new texture of height %u", newHeight);
+      // don't try to grow again, further characters will replace old ones
+      m_atlas.Remove(slot);
+      m_atlas.SetMaxHeight(m_textureHeight);
+      FT_Done_Glyph(glyph);
+      return -1;
     }
+    m_texture = newTexture;
   }
 
   if(m_texture == NULL)
   {
     CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: no texture to cache character to");
-    return false;
+    m_atlas.Remove(slot);
+    FT_Done_Glyph(glyph);
+    return -1;
   }
 
+  if ((unsigned int)slot >= m_char.size())
+    m_char.resize(m_atlas.GetSlotCount());
+
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
+  Character *ch = &m_char[slot];
+  ch->letterAndStyle = key;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)max((short)m_cellBaseLine - bitGlyph->top, 0);
-  ch->left = (float)m_posX + ch->offsetX;
-  ch->top = (float)m_posY + ch->offsetY;
+  ch->left = (float)posX;
+  ch->top = (float)posY + ch->offsetY;
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
   ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
@@ -620,8 +578,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   {
     CopyCharToTexture(bitGlyph, ch);
   }
-  m_posX += 1 + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
-  m_numChars++;
 
   m_textureScaleX = 1.0f / m_textureWidth;
   m_textureScaleY = 1.0f / m_textureHeight;
@@ -629,7 +585,30 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   // free the glyph
   FT_Done_Glyph(glyph);
 
-  return true;
+  return slot;
+}
+
+void CGUIFontTTFBase::ClearTextureRegion(unsigned int x, unsigned int y, unsigned int width)
+{
+  if (!m_texture || !width)
+    return;
+
+  // blank out an evicted character by copying an empty bitmap over it
+  vector<unsigned char> blank(width * m_cellHeight, 0);
+  FT_BitmapGlyphRec bitGlyph;
+  memset(&bitGlyph, 0, sizeof(bitGlyph));
+  bitGlyph.bitmap.rows   = m_cellHeight;
+  bitGlyph.bitmap.width  = width;
+  bitGlyph.bitmap.pitch  = width;
+  bitGlyph.bitmap.buffer = &blank[0];
+
+  Character region;
+  memset(&region, 0, sizeof(region));
+  region.left   = (float)x;
+  region.top    = (float)y;
+  region.right  = (float)(x + width);
+  region.bottom = (float)(y + m_cellHeight);
+  CopyCharToTexture(&bitGlyph, &region);
 }
 
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX)
@@ -28,6 +28,8 @@
  *
  */
 
+#include "GUIFontGlyphAtlas.h"
+
 // forward definition
 class CBaseTexture;
 
@@ -108,9 +110,9 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
-  bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  int CacheCharacter(wchar_t letter, uint32_t style);
+  void ClearTextureRegion(unsigned int x, unsigned int y, unsigned int width);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
-  void ClearCharacterCache();
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch) = 0;
@@ -124,15 +126,11 @@ protected:
 
   unsigned int m_textureWidth;       // width of our texture
   unsigned int m_textureHeight;      // heigth of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
 
   color_t m_color;
 
-  Character *m_char;                 // our characters
-  Character *m_charquick[256*4];     // ascii chars (4 styles) here
-  int m_maxChars;                    // size of character array (can be incremented)
-  int m_numChars;                    // the current number of cached characters
+  std::vector<Character> m_char;     // our characters, indexed by atlas slot
+  CGUIFontGlyphAtlas m_atlas;        // where the characters are in the texture
 
   float m_ellipsesWidth;               // this is used every character (width of '.')
 
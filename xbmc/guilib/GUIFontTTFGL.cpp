@@ -25,6 +25,7 @@
 #include "GUIFontManager.h"
 #include "Texture.h"
 #include "GraphicContext.h"
+#include "GUIQuadBatch.h"
 #include "gui3d.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -56,6 +57,9 @@ void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0)
   {
+    // draw any pending GUI textures first so they stay behind the text
+    g_quadBatch.Flush();
+
     if (!m_bTextureLoaded)
     {
       // Have OpenGL generate a texture object handle for us
@@ -202,7 +206,7 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character* ch)
   FT_Bitmap bitmap = bitGlyph->bitmap;
 
   unsigned char* source = (unsigned char*) bitmap.buffer;
-  unsigned char* target = (unsigned char*) m_texture->GetPixels() + (m_posY + ch->offsetY) * m_texture->GetPitch() + m_posX + bitGlyph->left;
+  unsigned char* target = (unsigned char*) m_texture->GetPixels() + (int)ch->top * m_texture->GetPitch() + (int)ch->left;
 
   for (int y = 0; y < bitmap.rows; y++)
   {
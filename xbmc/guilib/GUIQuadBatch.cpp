@@ -0,0 +1,71 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "GUIQuadBatch.h"
+
+CGUIQuadBatch g_quadBatch;
+
+CGUIQuadBatch::CGUIQuadBatch()
+{
+  m_renderer = NULL;
+  m_count = 0;
+  m_quads = m_drawCalls = 0;
+}
+
+void CGUIQuadBatch::Flush()
+{
+  if (!m_count)
+    return;
+
+  // reset the count first, the renderer may end up back here
+  unsigned int count = m_count;
+  m_count = 0;
+  if (m_renderer)
+  {
+    m_renderer->Draw(m_state, &m_vertices[0], count);
+    m_drawCalls++;
+  }
+}
+
+void CGUIQuadBatch::FlushTexture(unsigned int texture)
+{
+  if (m_count && texture && (m_state.texture == texture || m_state.diffuse == texture))
+    Flush();
+}
+
+void CGUIQuadRecorder::Draw(const GUIQuadState &state, const GUIQuadVertex *vertices, unsigned int count)
+{
+  Command command;
+  command.state = state;
+  command.quads = count / 4;
+  m_commands.push_back(command);
+
+  if (m_next)
+    m_next->Draw(state, vertices, count);
+}
+
+unsigned int CGUIQuadRecorder::GetQuads() const
+{
+  unsigned int quads = 0;
+  for (std::vector<Command>::const_iterator it = m_commands.begin(); it != m_commands.end(); ++it)
+    quads += it->quads;
+  return quads;
+}
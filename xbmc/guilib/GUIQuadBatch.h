@@ -0,0 +1,155 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief State a batch of GUI quads is drawn with.
+
+ All GUI quads are alpha blended, so quads only differ in the textures they
+ sample. A texture of 0 draws untextured (vertex colored) quads.
+ */
+struct GUIQuadState
+{
+  GUIQuadState() : texture(0), diffuse(0) {}
+  GUIQuadState(unsigned int tex, unsigned int diff) : texture(tex), diffuse(diff) {}
+
+  bool operator==(const GUIQuadState &right) const { return texture == right.texture && diffuse == right.diffuse; }
+  bool operator!=(const GUIQuadState &right) const { return !(*this == right); }
+
+  unsigned int texture;  ///< texture object of the main texture
+  unsigned int diffuse;  ///< texture object of the diffuse texture, 0 if there is none
+};
+
+struct GUIQuadVertex
+{
+  float   x, y, z;
+  uint8_t r, g, b, a;
+  float   u1, v1;        ///< main texture coordinates
+  float   u2, v2;        ///< diffuse texture coordinates
+};
+
+/*!
+ \ingroup textures
+ \brief Backend that performs the draws of a quad batch.
+ */
+class IGUIQuadRenderer
+{
+public:
+  virtual ~IGUIQuadRenderer() {}
+
+  /*! \brief Draw a run of quads sharing the same state.
+   \param state textures the quads are drawn with.
+   \param vertices 4 vertices per quad, in top left, top right, bottom right, bottom left order.
+   \param count number of vertices.
+   */
+  virtual void Draw(const GUIQuadState &state, const GUIQuadVertex *vertices, unsigned int count) = 0;
+};
+
+/*!
+ \ingroup textures
+ \brief Collects the quads of GUI textures so runs sharing a state go out in one draw.
+
+ Quads are kept in the order they were submitted as the GUI relies on painter's
+ order for blending, so only consecutive quads with the same state are merged.
+ Anything that draws outside the batch or changes the transform, viewport or
+ scissor must call Flush() first.
+ */
+class CGUIQuadBatch
+{
+public:
+  CGUIQuadBatch();
+
+  void SetRenderer(IGUIQuadRenderer *renderer) { m_renderer = renderer; }
+  IGUIQuadRenderer *GetRenderer() const { return m_renderer; }
+
+  /*! \brief Add a quad, flushing the pending quads if the state differs.
+   \return 4 vertices to be filled in by the caller, valid until the next call.
+   */
+  inline GUIQuadVertex *AddQuad(const GUIQuadState &state)
+  {
+    if (m_count && state != m_state)
+      Flush();
+    m_state = state;
+    if (m_count + 4 > m_vertices.size())
+      m_vertices.resize(m_vertices.empty() ? 256 : 2 * m_vertices.size());
+    GUIQuadVertex *quad = &m_vertices[m_count];
+    m_count += 4;
+    m_quads++;
+    return quad;
+  }
+
+  /*! \brief Send the pending quads to the renderer. */
+  void Flush();
+
+  /*! \brief Flush if any pending quad uses the given texture object, as it's about to be deleted or reloaded. */
+  void FlushTexture(unsigned int texture);
+
+  /*! \brief Number of quads submitted and draws issued since the batch was created. */
+  unsigned int GetQuads() const     { return m_quads; }
+  unsigned int GetDrawCalls() const { return m_drawCalls; }
+
+private:
+  IGUIQuadRenderer          *m_renderer;
+  std::vector<GUIQuadVertex> m_vertices;
+  unsigned int               m_count;
+  GUIQuadState               m_state;
+
+  unsigned int m_quads;
+  unsigned int m_drawCalls;
+};
+
+/*!
+ \ingroup textures
+ \brief Renderer that records the draws it's asked for instead of drawing them.
+
+ Lets the draw calls of a window be counted and compared without a GPU. Draws
+ can optionally be passed on to another renderer so they're recorded while the
+ GUI is displayed as normal.
+ */
+class CGUIQuadRecorder : public IGUIQuadRenderer
+{
+public:
+  struct Command
+  {
+    GUIQuadState state;
+    unsigned int quads;
+  };
+
+  CGUIQuadRecorder(IGUIQuadRenderer *next = NULL) : m_next(next) {}
+
+  virtual void Draw(const GUIQuadState &state, const GUIQuadVertex *vertices, unsigned int count);
+
+  void Clear() { m_commands.clear(); }
+  const std::vector<Command> &GetCommands() const { return m_commands; }
+  unsigned int GetQuads() const;
+
+private:
+  IGUIQuadRenderer    *m_next;
+  std::vector<Command> m_commands;
+};
+
+extern CGUIQuadBatch g_quadBatch;
@@ -25,11 +25,150 @@
 #include "GUIColorManager.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#include <list>
+#include <map>
 
 using namespace std;
 
 #define WORK_AROUND_NEEDED_FOR_LINE_BREAKS
 
+#define LAYOUT_CACHE_SIZE 1024 // number of laid out labels to keep
+
+// Layouts of recently seen labels. List items tend to show the same strings in
+// many rows and again every time they scroll back into view, so this saves
+// parsing, wrapping and bidi flipping them over and over.
+class CTextLayoutCache
+{
+public:
+  struct Key
+  {
+    CStdStringW text;
+    CGUIFont   *font;
+    float       maxWidth;
+    float       maxHeight;
+    color_t     color;
+    bool        wrap;
+    bool        forceLTR;
+
+    bool operator<(const Key &right) const
+    {
+      if (font != right.font) return font < right.font;
+      if (maxWidth != right.maxWidth) return maxWidth < right.maxWidth;
+      if (maxHeight != right.maxHeight) return maxHeight < right.maxHeight;
+      if (color != right.color) return color < right.color;
+      if (wrap != right.wrap) return wrap < right.wrap;
+      if (forceLTR != right.forceLTR) return forceLTR < right.forceLTR;
+      return text.compare(right.text) < 0;
+    }
+  };
+
+  CTextLayoutCache()
+  {
+    m_hits = m_misses = 0;
+    m_frameLayouts = m_lastFrameLayouts = 0;
+    m_frameTime = m_lastFrameTime = 0;
+  }
+
+  bool Get(const Key &key, vector<CGUIString> &lines, vecColors &colors, float &width, float &height)
+  {
+    CSingleLock lock(m_section);
+    iEntry it = m_entries.find(key);
+    if (it == m_entries.end())
+      return false;
+
+    m_hits++;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+    lines  = it->second.lines;
+    colors = it->second.colors;
+    width  = it->second.width;
+    height = it->second.height;
+    return true;
+  }
+
+  void Add(const Key &key, const vector<CGUIString> &lines, const vecColors &colors, float width, float height, int64_t time)
+  {
+    CSingleLock lock(m_section);
+    m_misses++;
+    m_frameLayouts++;
+    m_frameTime += time;
+
+    if (m_entries.find(key) != m_entries.end())
+      return;
+
+    if (m_entries.size() >= LAYOUT_CACHE_SIZE)
+    {
+      m_entries.erase(*m_lru.back());
+      m_lru.pop_back();
+    }
+
+    iEntry it = m_entries.insert(make_pair(key, Entry())).first;
+    Entry &entry = it->second;
+    entry.lines  = lines;
+    entry.colors = colors;
+    entry.width  = width;
+    entry.height = height;
+    m_lru.push_front(&it->first);
+    entry.lru = m_lru.begin();
+  }
+
+  void Clear()
+  {
+    CSingleLock lock(m_section);
+    if (m_hits + m_misses)
+      CLog::Log(LOGDEBUG, "%s - %u layouts cached, %u hits, %u misses", __FUNCTION__, (unsigned int)m_entries.size(), m_hits, m_misses);
+    m_entries.clear();
+    m_lru.clear();
+  }
+
+  void NextFrame()
+  {
+    CSingleLock lock(m_section);
+    m_lastFrameLayouts = m_frameLayouts;
+    m_lastFrameTime = m_frameTime;
+    m_frameLayouts = 0;
+    m_frameTime = 0;
+  }
+
+  void GetStats(unsigned int &hits, unsigned int &misses, unsigned int &frameLayouts, float &frameTime)
+  {
+    CSingleLock lock(m_section);
+    hits = m_hits;
+    misses = m_misses;
+    frameLayouts = m_lastFrameLayouts;
+    frameTime = 1000.0f * m_lastFrameTime / CurrentHostFrequency();
+  }
+
+private:
+  struct Entry
+  {
+    vector<CGUIString> lines;
+    vecColors colors;
+    float width;
+    float height;
+    list<const Key*>::iterator lru;
+  };
+  typedef map<Key, Entry> mapEntries;
+  typedef mapEntries::iterator iEntry;
+
+  CCriticalSection m_section;
+  mapEntries       m_entries;
+  list<const Key*> m_lru;       // keys of m_entries, most recently used first
+
+  unsigned int m_hits;
+  unsigned int m_misses;
+  unsigned int m_frameLayouts;
+  unsigned int m_lastFrameLayouts;
+  int64_t      m_frameTime;
+  int64_t      m_lastFrameTime;
+};
+
+static CTextLayoutCache g_textLayoutCache;
+
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
   m_text.assign(start, end);
@@ -53,6 +192,7 @@ CGUITextLayout::CGUITextLayout(CGUIFont *font, bool wrap, float fHeight, CGUIFon
   m_maxHeight = fHeight;
   m_textWidth = 0;
   m_textHeight = 0;
+  m_lastUtf8Valid = false;
 }
 
 void CGUITextLayout::SetWrap(bool bWrap)
@@ -195,12 +335,19 @@ void CGUITextLayout::RenderOutline(float x, float y, color_t color, color_t outl
 
 bool CGUITextLayout::Update(const CStdString &text, float maxWidth, bool forceUpdate /*= false*/, bool forceLTRReadingOrder /*= false*/)
 {
+  // no need to convert if we already have this text
+  if (m_lastUtf8Valid && !forceUpdate && text.Equals(m_lastUtf8Text))
+    return false;
+
   // convert to utf16
   CStdStringW utf16;
   utf8ToW(text, utf16);
 
   // update
-  return UpdateW(utf16, maxWidth, forceUpdate, forceLTRReadingOrder);
+  bool changed = UpdateW(utf16, maxWidth, forceUpdate, forceLTRReadingOrder);
+  m_lastUtf8Text = text;
+  m_lastUtf8Valid = true;
+  return changed;
 }
 
 bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bool forceUpdate /*= false*/, bool forceLTRReadingOrder /*= false*/)
@@ -208,6 +355,22 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
   if (text.Equals(m_lastText) && !forceUpdate)
     return false;
 
+  m_lastText = text;
+  m_lastUtf8Valid = false;
+
+  // see if an identical label has been laid out already
+  CTextLayoutCache::Key key;
+  key.text      = text;
+  key.font      = m_font;
+  key.maxWidth  = (m_wrap && maxWidth > 0) ? maxWidth : 0;
+  key.maxHeight = m_maxHeight;
+  key.color     = m_textColor;
+  key.wrap      = m_wrap;
+  key.forceLTR  = forceLTRReadingOrder;
+  if (g_textLayoutCache.Get(key, m_lines, m_colors, m_textWidth, m_textHeight))
+    return true;
+
+  int64_t start = CurrentHostCounter();
   vecText parsedText;
 
   // empty out our previous string
@@ -236,7 +399,7 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
   // and cache the width and height for later reading
   CalcTextExtent();
 
-  m_lastText = text;
+  g_textLayoutCache.Add(key, m_lines, m_colors, m_textWidth, m_textHeight, CurrentHostCounter() - start);
   return true;
 }
 
@@ -631,7 +794,21 @@ void CGUITextLayout::Reset()
 {
   m_lines.clear();
   m_lastText.Empty();
+  m_lastUtf8Valid = false;
   m_textWidth = m_textHeight = 0;
 }
 
+void CGUITextLayout::ClearCache()
+{
+  g_textLayoutCache.Clear();
+}
 
+void CGUITextLayout::NextFrame()
+{
+  g_textLayoutCache.NextFrame();
+}
+
+void CGUITextLayout::GetCacheStats(unsigned int &hits, unsigned int &misses, unsigned int &frameLayouts, float &frameTime)
+{
+  g_textLayoutCache.GetStats(hits, misses, frameLayouts, frameTime);
+}
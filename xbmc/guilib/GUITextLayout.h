@@ -100,6 +100,23 @@ public:
   static void DrawText(CGUIFont *font, float x, float y, color_t color, color_t shadowColor, const CStdString &text, uint32_t align);
   static void Filter(CStdString &text);
 
+  /*! \brief Drop all cached layouts.
+   Needs to be called whenever fonts or skin colors are (re)loaded, as cached layouts refer to both.
+   */
+  static void ClearCache();
+
+  /*! \brief Mark the start of a new frame for the per frame layout statistics.
+   */
+  static void NextFrame();
+
+  /*! \brief Retrieve statistics of the layout cache.
+   \param hits [out] number of layouts taken from the cache
+   \param misses [out] number of layouts that had to be computed
+   \param frameLayouts [out] number of layouts computed during the last frame
+   \param frameTime [out] time in ms spent computing layouts during the last frame
+   */
+  static void GetCacheStats(unsigned int &hits, unsigned int &misses, unsigned int &frameLayouts, float &frameTime);
+
 protected:
   void ParseText(const CStdStringW &text, vecText &parsedText);
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
@@ -123,6 +140,8 @@ protected:
   color_t m_textColor;
 
   CStdStringW m_lastText;
+  CStdString  m_lastUtf8Text;   // utf8 version of m_lastText if we were last updated through Update()
+  bool        m_lastUtf8Valid;
   float m_textWidth;
   float m_textHeight;
 private:
@@ -30,18 +30,33 @@
  */
 
 #include "GUITexture.h"
+#include "GUIQuadBatch.h"
+
+/*!
+ \ingroup textures
+ \brief Draws batched GUI quads from client side vertex arrays.
+ */
+class CGUIQuadRendererGL : public IGUIQuadRenderer
+{
+public:
+  virtual void Draw(const GUIQuadState &state, const GUIQuadVertex *vertices, unsigned int count);
+};
 
 class CGUITextureGL : public CGUITextureBase
 {
 public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+  static IGUIQuadRenderer *GetRenderer() { return &m_renderer; }
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   void End();
 private:
   GLubyte m_col[4];
+  GUIQuadState m_state;
+
+  static CGUIQuadRendererGL m_renderer;
 };
 
 #endif
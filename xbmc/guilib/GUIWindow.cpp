@@ -27,6 +27,7 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUIQuadBatch.h"
 #include "settings/Settings.h"
 #ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
 #include "GUIEditControl.h"
@@ -58,6 +59,7 @@ CGUIWindow::CGUIWindow(int id, const CStdString &xmlFile)
   m_windowLoaded = false;
   m_loadOnDemand = true;
   m_renderOrder = 0;
+  m_drawCalls = 0;
   m_dynamicResourceAlloc = true;
   m_previousWindow = WINDOW_INVALID;
   m_animationsEnabled = true;
@@ -305,8 +307,13 @@ void CGUIWindow::DoRender()
   g_graphicsContext.SetRenderingResolution(m_coordsRes, m_needsScaling);
 
   g_graphicsContext.ResetWindowTransform();
+  unsigned int drawCalls = g_quadBatch.GetDrawCalls();
   CGUIControlGroup::DoRender();
 
+  // flush so the window's own quads are counted against it
+  g_quadBatch.Flush();
+  m_drawCalls = g_quadBatch.GetDrawCalls() - drawCalls;
+
   if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndFrame();
 }
 
@@ -142,6 +142,8 @@ public:
   void LoadOnDemand(bool loadOnDemand) { m_loadOnDemand = loadOnDemand; };
   bool GetLoadOnDemand() { return m_loadOnDemand; }
   int GetRenderOrder() { return m_renderOrder; };
+  /*! \brief Number of batched GUI texture draws issued by the last render of this window */
+  unsigned int GetDrawCalls() const { return m_drawCalls; };
   virtual void SetInitialVisibility();
 
   enum OVERLAY_STATE { OVERLAY_STATE_PARENT_WINDOW=0, OVERLAY_STATE_SHOWN, OVERLAY_STATE_HIDDEN };
@@ -260,6 +262,7 @@ protected:
   CGUIInfoColor m_clearBackground; // colour to clear the window
 
   int m_renderOrder;      // for render order of dialogs
+  unsigned int m_drawCalls;
 
   /*! \brief Grabs the window's top,left position in skin coordinates
    The window origin may change based on <origin> tag conditions in the skin.
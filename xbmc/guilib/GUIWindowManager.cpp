@@ -32,6 +32,7 @@
 #include "settings/AdvancedSettings.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUITextLayout.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/TimeUtils.h"
 
@@ -588,6 +589,8 @@ void CGUIWindowManager::FrameMove()
   assert(g_application.IsCurrentThread());
   CSingleLock lock(g_graphicsContext);
 
+  CGUITextLayout::NextFrame();
+
   if(m_iNested == 0)
   {
     // delete any windows queued for deletion
@@ -344,8 +344,7 @@ void CGraphicContext::SetVideoResolution(RESOLUTION res, bool forceUpdate)
     {
       g_application.m_pPlayer->Pause();
       ThreadMessage msg = {TMSG_MEDIA_UNPAUSE};
-      CDelayedMessage* pauseMessage = new CDelayedMessage(msg, delay * 100);
-      pauseMessage->Create(true);
+      g_application.getApplicationMessenger().SendMessageDelayed(msg, delay * 100);
     }
   }
 
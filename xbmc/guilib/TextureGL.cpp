@@ -21,6 +21,7 @@
 
 #include "system.h"
 #include "TextureGL.h"
+#include "GUIQuadBatch.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -50,7 +51,10 @@ void CGLTexture::CreateTextureObject()
 void CGLTexture::DestroyTextureObject()
 {
   if (m_texture)
+  {
+    g_quadBatch.FlushTexture(m_texture);
     glDeleteTextures(1, (GLuint*) &m_texture);
+  }
 }
 
 void CGLTexture::LoadToGPU()
@@ -66,6 +70,11 @@ void CGLTexture::LoadToGPU()
     // this happens only one time - the first time the texture is loaded
     CreateTextureObject();
   }
+  else
+  {
+    // pending quads have to be drawn with what the texture holds now
+    g_quadBatch.FlushTexture(m_texture);
+  }
 
   // Bind the texture object
   glBindTexture(GL_TEXTURE_2D, m_texture);
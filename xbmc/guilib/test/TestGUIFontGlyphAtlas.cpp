@@ -0,0 +1,253 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "guilib/GUIFontGlyphAtlas.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <vector>
+#include <stdlib.h>
+#include <time.h>
+
+#define TEXTURE_WIDTH 512
+#define CELL_HEIGHT   24
+#define MAX_HEIGHT    2048
+
+struct Region
+{
+  unsigned int x, y, width;
+};
+
+// check that no two cached glyphs share any texels
+static bool NoOverlap(const std::map<uint32_t, Region> &glyphs)
+{
+  std::vector<unsigned char> used(TEXTURE_WIDTH * (MAX_HEIGHT / CELL_HEIGHT), 0);
+  for (std::map<uint32_t, Region>::const_iterator it = glyphs.begin(); it != glyphs.end(); ++it)
+  {
+    unsigned int row = it->second.y / CELL_HEIGHT;
+    for (unsigned int x = it->second.x; x < it->second.x + it->second.width; x++)
+    {
+      if (used[row * TEXTURE_WIDTH + x]++)
+        return false;
+    }
+  }
+  return true;
+}
+
+// glyph width by script, roughly what a 20pt font gives
+static unsigned int GlyphWidth(uint32_t letter)
+{
+  if (letter < 0x80)
+    return 8 + letter % 5;
+  if (letter < 0x3000)
+    return 11 + letter % 3;
+  return 21;
+}
+
+BOOST_AUTO_TEST_CASE(TestGlyphAtlasInsertFind)
+{
+  CGUIFontGlyphAtlas atlas;
+  atlas.Reset(TEXTURE_WIDTH, CELL_HEIGHT, MAX_HEIGHT);
+
+  unsigned int x, y;
+  int a = atlas.Insert('a', 10, x, y);
+  BOOST_CHECK(a >= 0);
+  BOOST_CHECK_EQUAL(0u, x);
+  BOOST_CHECK_EQUAL(0u, y);
+
+  int b = atlas.Insert('b', 10, x, y);
+  BOOST_CHECK(b >= 0 && b != a);
+  BOOST_CHECK_EQUAL(10u, x);
+
+  // zero width glyphs (spaces) don't take any room
+  int space = atlas.Insert(' ', 0, x, y);
+  BOOST_CHECK(space >= 0);
+
+  BOOST_CHECK_EQUAL(a, atlas.Find('a'));
+  BOOST_CHECK_EQUAL(b, atlas.Find('b'));
+  BOOST_CHECK_EQUAL(space, atlas.Find(' '));
+  BOOST_CHECK_EQUAL(-1, atlas.Find('c'));
+  BOOST_CHECK_EQUAL(3u, atlas.GetGlyphCount());
+  BOOST_CHECK_EQUAL((unsigned int)CELL_HEIGHT, atlas.GetHeight());
+
+  // glyphs that don't fit in the first shelf open a new one
+  int wide = atlas.Insert(0x4e00, TEXTURE_WIDTH - 10, x, y);
+  BOOST_CHECK(wide >= 0);
+  BOOST_CHECK_EQUAL(0u, x);
+  BOOST_CHECK_EQUAL((unsigned int)CELL_HEIGHT, y);
+
+  // and nothing wider than the texture is accepted
+  BOOST_CHECK_EQUAL(-1, atlas.Insert(0x4e01, TEXTURE_WIDTH + 1, x, y));
+}
+
+BOOST_AUTO_TEST_CASE(TestGlyphAtlasEvictsLeastRecentlyUsed)
+{
+  // room for exactly four glyphs
+  CGUIFontGlyphAtlas atlas;
+  atlas.Reset(40, CELL_HEIGHT, 2 * CELL_HEIGHT);
+
+  unsigned int x, y;
+  for (uint32_t letter = 'a'; letter < 'e'; letter++)
+    BOOST_CHECK(atlas.Insert(letter, 20, x, y) >= 0);
+  BOOST_CHECK_EQUAL(-1, atlas.Insert('e', 20, x, y));
+
+  // touch 'a' so 'b' becomes the oldest
+  atlas.Find('a');
+
+  uint32_t key;
+  unsigned int width;
+  BOOST_CHECK(atlas.EvictOldest(key, x, y, width));
+  BOOST_CHECK_EQUAL((uint32_t)'b', key);
+  BOOST_CHECK_EQUAL(-1, atlas.Find('b'));
+  BOOST_CHECK_EQUAL(1u, atlas.GetEvictions());
+
+  // the evicted region is handed out again
+  unsigned int newX, newY;
+  BOOST_CHECK(atlas.Insert('e', 20, newX, newY) >= 0);
+  BOOST_CHECK_EQUAL(x, newX);
+  BOOST_CHECK_EQUAL(y, newY);
+  BOOST_CHECK(atlas.Find('a') >= 0);
+  BOOST_CHECK(atlas.Find('e') >= 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestGlyphAtlasMergesFreeSpans)
+{
+  CGUIFontGlyphAtlas atlas;
+  atlas.Reset(30, CELL_HEIGHT, CELL_HEIGHT);
+
+  unsigned int x, y;
+  int a = atlas.Insert('a', 10, x, y);
+  int b = atlas.Insert('b', 10, x, y);
+  int c = atlas.Insert('c', 10, x, y);
+  BOOST_CHECK(c >= 0);
+
+  // freeing two neighbours makes room for a glyph as wide as both
+  atlas.Remove(b);
+  atlas.Remove(a);
+  int wide = atlas.Insert('w', 20, x, y);
+  BOOST_CHECK(wide >= 0);
+  BOOST_CHECK_EQUAL(0u, x);
+  BOOST_CHECK_EQUAL(c, atlas.Find('c'));
+}
+
+BOOST_AUTO_TEST_CASE(TestGlyphAtlasMatchesReference)
+{
+  // random inserts, lookups and evictions checked against a map
+  CGUIFontGlyphAtlas atlas;
+  atlas.Reset(TEXTURE_WIDTH, CELL_HEIGHT, 16 * CELL_HEIGHT);
+  std::map<uint32_t, Region> reference;
+  std::map<uint32_t, int> slots;
+
+  srand(1);
+  for (int i = 0; i < 50000; i++)
+  {
+    uint32_t letter = 0x20 + rand() % 3000;
+    int slot = atlas.Find(letter);
+    if (reference.count(letter))
+    {
+      BOOST_REQUIRE_EQUAL(slots[letter], slot);
+      continue;
+    }
+    BOOST_REQUIRE_EQUAL(-1, slot);
+
+    Region region;
+    region.width = GlyphWidth(letter);
+    while ((slot = atlas.Insert(letter, region.width, region.x, region.y)) < 0)
+    {
+      uint32_t key;
+      Region old;
+      BOOST_REQUIRE(atlas.EvictOldest(key, old.x, old.y, old.width));
+      BOOST_REQUIRE(reference.count(key));
+      reference.erase(key);
+      slots.erase(key);
+    }
+    reference[letter] = region;
+    slots[letter] = slot;
+  }
+
+  BOOST_CHECK_EQUAL(reference.size(), atlas.GetGlyphCount());
+  BOOST_CHECK(atlas.GetEvictions() > 0);
+  BOOST_CHECK(NoOverlap(reference));
+}
+
+// Lay out a large set of strings mixing latin, cyrillic, greek and CJK text,
+// the way a list of foreign movie titles would be drawn.
+BOOST_AUTO_TEST_CASE(BenchmarkGlyphAtlasMultilingual)
+{
+  const int numStrings = 200000;
+  const int stringLength = 24;
+
+  std::vector<uint32_t> text;
+  text.reserve(numStrings * stringLength);
+  srand(2);
+  for (int i = 0; i < numStrings; i++)
+  {
+    int script = rand() % 4;
+    for (int j = 0; j < stringLength; j++)
+    {
+      uint32_t letter;
+      switch (script)
+      {
+      case 0:  letter = 0x20 + rand() % 0x5f; break;     // latin
+      case 1:  letter = 0x410 + rand() % 0x40; break;    // cyrillic
+      case 2:  letter = 0x391 + rand() % 0x38; break;    // greek
+      default:
+        // common CJK ideographs are used far more often than rare ones
+        letter = 0x4e00 + (rand() % 64) * (rand() % 64);
+        break;
+      }
+      // a few bold or italic runs
+      if (i % 7 == 0)
+        letter |= (rand() % 4) << 16;
+      text.push_back(letter);
+    }
+  }
+
+  CGUIFontGlyphAtlas atlas;
+  atlas.Reset(TEXTURE_WIDTH, CELL_HEIGHT, MAX_HEIGHT);
+
+  clock_t start = clock();
+  unsigned int x, y;
+  for (std::vector<uint32_t>::const_iterator it = text.begin(); it != text.end(); ++it)
+  {
+    if (atlas.Find(*it) >= 0)
+      continue;
+
+    unsigned int width = GlyphWidth(*it & 0xffff);
+    while (atlas.Insert(*it, width, x, y) < 0)
+    {
+      uint32_t key;
+      unsigned int oldX, oldY, oldWidth;
+      if (!atlas.EvictOldest(key, oldX, oldY, oldWidth))
+        break;
+    }
+  }
+  double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+  BOOST_TEST_MESSAGE("glyph atlas: " << text.size() << " characters in " << elapsed << "s ("
+                     << elapsed * 1e9 / text.size() << " ns/char), " << atlas.GetHits() << " hits, "
+                     << atlas.GetMisses() << " misses, " << atlas.GetEvictions() << " evictions, "
+                     << atlas.GetGlyphCount() << " glyphs cached");
+
+  BOOST_CHECK_EQUAL((unsigned int)text.size(), atlas.GetHits() + atlas.GetMisses());
+  BOOST_CHECK(atlas.GetHits() > atlas.GetMisses());
+}
@@ -0,0 +1,133 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "guilib/GUIQuadBatch.h"
+
+#include <boost/test/unit_test.hpp>
+
+static void AddQuad(CGUIQuadBatch &batch, unsigned int texture, unsigned int diffuse, float x)
+{
+  GUIQuadVertex *v = batch.AddQuad(GUIQuadState(texture, diffuse));
+  for (int i = 0; i < 4; i++)
+  {
+    v[i].x = x + (i == 1 || i == 2);
+    v[i].y = (float)(i >= 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestQuadBatchMergesRuns)
+{
+  CGUIQuadRecorder recorder;
+  CGUIQuadBatch batch;
+  batch.SetRenderer(&recorder);
+
+  // a border texture drawn as 9 quads goes out in one draw
+  for (int i = 0; i < 9; i++)
+    AddQuad(batch, 1, 0, (float)i);
+  BOOST_CHECK(recorder.GetCommands().empty());
+
+  // a change of texture flushes the pending run
+  AddQuad(batch, 2, 0, 0);
+  BOOST_REQUIRE_EQUAL(1u, recorder.GetCommands().size());
+  BOOST_CHECK_EQUAL(9u, recorder.GetCommands()[0].quads);
+  BOOST_CHECK_EQUAL(1u, recorder.GetCommands()[0].state.texture);
+
+  // as does a change of diffuse texture alone
+  AddQuad(batch, 2, 3, 0);
+  batch.Flush();
+  BOOST_REQUIRE_EQUAL(3u, recorder.GetCommands().size());
+  BOOST_CHECK_EQUAL(3u, recorder.GetCommands()[2].state.diffuse);
+
+  // flushing an empty batch doesn't draw
+  batch.Flush();
+  BOOST_CHECK_EQUAL(3u, batch.GetDrawCalls());
+  BOOST_CHECK_EQUAL(11u, batch.GetQuads());
+  BOOST_CHECK_EQUAL(11u, recorder.GetQuads());
+}
+
+BOOST_AUTO_TEST_CASE(TestQuadBatchKeepsPaintersOrder)
+{
+  CGUIQuadRecorder recorder;
+  CGUIQuadBatch batch;
+  batch.SetRenderer(&recorder);
+
+  // overlapping quads of alternating textures must not be reordered
+  AddQuad(batch, 1, 0, 0);
+  AddQuad(batch, 2, 0, 0);
+  AddQuad(batch, 1, 0, 0);
+  batch.Flush();
+
+  const std::vector<CGUIQuadRecorder::Command> &commands = recorder.GetCommands();
+  BOOST_REQUIRE_EQUAL(3u, commands.size());
+  BOOST_CHECK_EQUAL(1u, commands[0].state.texture);
+  BOOST_CHECK_EQUAL(2u, commands[1].state.texture);
+  BOOST_CHECK_EQUAL(1u, commands[2].state.texture);
+}
+
+BOOST_AUTO_TEST_CASE(TestQuadBatchFlushTexture)
+{
+  CGUIQuadRecorder recorder;
+  CGUIQuadBatch batch;
+  batch.SetRenderer(&recorder);
+
+  AddQuad(batch, 1, 2, 0);
+  batch.FlushTexture(5);
+  BOOST_CHECK(recorder.GetCommands().empty());
+
+  // deleting a texture that's waiting to be drawn flushes it first
+  batch.FlushTexture(2);
+  BOOST_CHECK_EQUAL(1u, recorder.GetCommands().size());
+}
+
+// A list of 50 items as a typical skin draws it: a focus/nofocus background,
+// an icon, a watched overlay and a separator per item, followed by the
+// scrollbar. Backgrounds, overlays and separators share their textures.
+BOOST_AUTO_TEST_CASE(TestQuadBatchListDrawCalls)
+{
+  CGUIQuadRecorder recorder;
+  CGUIQuadBatch batch;
+  batch.SetRenderer(&recorder);
+
+  const unsigned int background = 1, separator = 2, overlay = 3, scrollbar = 4;
+  const unsigned int firstIcon = 100;
+  const int items = 50;
+
+  // the backgrounds of all items, then the separators, as a list that
+  // groups its layouts by control draws them
+  for (int i = 0; i < items; i++)
+    AddQuad(batch, background, 0, 0);
+  for (int i = 0; i < items; i++)
+    AddQuad(batch, separator, 0, 0);
+  // icons each have their own texture, overlays share one
+  for (int i = 0; i < items; i++)
+  {
+    AddQuad(batch, firstIcon + i, 0, 0);
+    AddQuad(batch, overlay, 0, 0);
+  }
+  // the scrollbar is a 3 part border texture
+  for (int i = 0; i < 3; i++)
+    AddQuad(batch, scrollbar, 0, 0);
+  batch.Flush();
+
+  BOOST_CHECK_EQUAL(4u * items + 3, recorder.GetQuads());
+  // 1 + 1 + 2 per item + 1, against a draw per quad before batching
+  BOOST_CHECK_EQUAL(2u * items + 3, recorder.GetCommands().size());
+}
@@ -23,6 +23,7 @@
 #include "threads/SingleLock.h"
 #include <stdio.h>
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "utils/Variant.h"
 #include "FileItem.h"
 #include "music/tags/MusicInfoTag.h"
@@ -31,9 +32,23 @@
 using namespace std;
 using namespace ANNOUNCEMENT;
 
+// announcers taking longer than this to handle an announcement are logged
+#define SLOW_ANNOUNCER_TIME 100
+
 CCriticalSection CAnnouncementManager::m_critSection;
 vector<IAnnouncer *> CAnnouncementManager::m_announcers;
 
+deque<CAnnouncementManager::Announcement> CAnnouncementManager::m_queue;
+CCriticalSection CAnnouncementManager::m_queueSection;
+CEvent CAnnouncementManager::m_queueEvent;
+CAnnouncementManager::CDispatcher *CAnnouncementManager::m_dispatcher = NULL;
+bool CAnnouncementManager::m_stopped = false;
+
+unsigned int CAnnouncementManager::m_delivered = 0;
+unsigned int CAnnouncementManager::m_maxDepth = 0;
+unsigned int CAnnouncementManager::m_totalLatency = 0;
+unsigned int CAnnouncementManager::m_maxLatency = 0;
+
 void CAnnouncementManager::AddAnnouncer(IAnnouncer *listener)
 {
   CSingleLock lock (m_critSection);
@@ -62,9 +77,40 @@ void CAnnouncementManager::Announce(EAnnouncementFlag flag, const char *sender,
 void CAnnouncementManager::Announce(EAnnouncementFlag flag, const char *sender, const char *message, CVariant &data)
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
-  CSingleLock lock (m_critSection);
-  for (unsigned int i = 0; i < m_announcers.size(); i++)
-    m_announcers[i]->Announce(flag, sender, message, data);
+
+  {
+    CSingleLock lock (m_queueSection);
+    if (!m_stopped)
+    {
+      m_queue.push_back(Announcement());
+      Announcement &announcement = m_queue.back();
+      announcement.flag    = flag;
+      announcement.sender  = sender;
+      announcement.message = message;
+      announcement.data    = data;
+      announcement.queued  = CTimeUtils::GetTimeMS();
+
+      if (m_queue.size() > m_maxDepth)
+        m_maxDepth = m_queue.size();
+
+      if (!m_dispatcher)
+      {
+        m_dispatcher = new CDispatcher();
+        m_dispatcher->Create();
+      }
+      m_queueEvent.Set();
+      return;
+    }
+  }
+
+  // the dispatcher is gone, deliver right away
+  Announcement announcement;
+  announcement.flag    = flag;
+  announcement.sender  = sender;
+  announcement.message = message;
+  announcement.data    = data;
+  announcement.queued  = CTimeUtils::GetTimeMS();
+  Deliver(announcement);
 }
 
 void CAnnouncementManager::Announce(EAnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item)
@@ -104,3 +150,91 @@ void CAnnouncementManager::Announce(EAnnouncementFlag flag, const char *sender,
 
   Announce(flag, sender, message, object);
 }
+
+void CAnnouncementManager::Deinitialize()
+{
+  CDispatcher *dispatcher = NULL;
+  {
+    CSingleLock lock (m_queueSection);
+    if (m_stopped)
+      return;
+    m_stopped = true;
+    dispatcher = m_dispatcher;
+    m_dispatcher = NULL;
+  }
+
+  if (dispatcher)
+  {
+    dispatcher->StopThread();
+    delete dispatcher;
+  }
+
+  // deliver whatever the dispatcher didn't get to
+  DeliverQueued();
+
+  CSingleLock lock (m_queueSection);
+  CLog::Log(LOGDEBUG, "CAnnouncementManager - %u announcements delivered, average latency %u ms, max latency %u ms, max queue depth %u",
+            m_delivered, m_delivered ? m_totalLatency / m_delivered : 0, m_maxLatency, m_maxDepth);
+}
+
+void CAnnouncementManager::GetQueueStats(unsigned int &depth, unsigned int &maxDepth, unsigned int &averageLatency, unsigned int &maxLatency)
+{
+  CSingleLock lock (m_queueSection);
+  depth          = m_queue.size();
+  maxDepth       = m_maxDepth;
+  averageLatency = m_delivered ? m_totalLatency / m_delivered : 0;
+  maxLatency     = m_maxLatency;
+}
+
+void CAnnouncementManager::DeliverQueued()
+{
+  while (true)
+  {
+    Announcement announcement;
+    {
+      CSingleLock lock (m_queueSection);
+      if (m_queue.empty())
+        return;
+
+      Announcement &front = m_queue.front();
+      announcement.flag    = front.flag;
+      announcement.sender  = front.sender;
+      announcement.message = front.message;
+      announcement.queued  = front.queued;
+      announcement.data.swap(front.data);
+      m_queue.pop_front();
+    }
+
+    Deliver(announcement);
+  }
+}
+
+void CAnnouncementManager::Deliver(const Announcement &announcement)
+{
+  CSingleLock lock (m_critSection);
+
+  unsigned int start = CTimeUtils::GetTimeMS();
+  unsigned int latency = start - announcement.queued;
+  for (unsigned int i = 0; i < m_announcers.size(); i++)
+    m_announcers[i]->Announce(announcement.flag, announcement.sender.c_str(), announcement.message.c_str(), announcement.data);
+
+  unsigned int duration = CTimeUtils::GetTimeMS() - start;
+  if (duration > SLOW_ANNOUNCER_TIME)
+    CLog::Log(LOGDEBUG, "CAnnouncementManager - delivering %s from %s took %u ms",
+              announcement.message.c_str(), announcement.sender.c_str(), duration);
+
+  CSingleLock queueLock (m_queueSection);
+  m_delivered++;
+  m_totalLatency += latency;
+  if (latency > m_maxLatency)
+    m_maxLatency = latency;
+}
+
+void CAnnouncementManager::CDispatcher::Process()
+{
+  while (!m_bStop)
+  {
+    AbortableWait(m_queueEvent);
+    DeliverQueued();
+  }
+}
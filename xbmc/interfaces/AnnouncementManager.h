@@ -23,10 +23,24 @@
 #include "IAnnouncer.h"
 #include "FileItem.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/Variant.h"
+#include <deque>
+#include <string>
 #include <vector>
 
 namespace ANNOUNCEMENT
 {
+  /*!
+   \brief Delivers announcements to the registered announcers.
+
+   Announcements are queued and delivered in order on a dispatcher thread, so
+   the thread raising an announcement never waits for the announcers. Once the
+   manager is deinitialized announcements are delivered synchronously.
+   RemoveAnnouncer() waits for a delivery in progress, so an announcer is never
+   called once it has been removed.
+   */
   class CAnnouncementManager
   {
   public:
@@ -36,8 +50,50 @@ namespace ANNOUNCEMENT
     static void Announce(EAnnouncementFlag flag, const char *sender, const char *message, CVariant &data);
     static void Announce(EAnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item);
     static void Announce(EAnnouncementFlag flag, const char *sender, const char *message, CFileItemPtr item, CVariant &data);
+
+    /*! \brief Deliver the queued announcements and stop the dispatcher thread. */
+    static void Deinitialize();
+
+    /*! \brief Retrieve statistics of the announcement queue, shown in the debug info.
+     \param depth [out] number of announcements waiting to be delivered
+     \param maxDepth [out] most announcements that were waiting at once
+     \param averageLatency [out] average time in ms from queueing an announcement to its delivery
+     \param maxLatency [out] longest time in ms from queueing an announcement to its delivery
+     */
+    static void GetQueueStats(unsigned int &depth, unsigned int &maxDepth, unsigned int &averageLatency, unsigned int &maxLatency);
   private:
+    struct Announcement
+    {
+      EAnnouncementFlag flag;
+      std::string       sender;
+      std::string       message;
+      CVariant          data;
+      unsigned int      queued;  ///< time the announcement was queued
+    };
+
+    class CDispatcher : public CThread
+    {
+    public:
+      CDispatcher() : CThread("CAnnouncementManager") {}
+    protected:
+      virtual void Process();
+    };
+
+    static void DeliverQueued();
+    static void Deliver(const Announcement &announcement);
+
     static std::vector<IAnnouncer *> m_announcers;
     static CCriticalSection m_critSection;
+
+    static std::deque<Announcement> m_queue;
+    static CCriticalSection m_queueSection;
+    static CEvent m_queueEvent;
+    static CDispatcher *m_dispatcher;
+    static bool m_stopped;
+
+    static unsigned int m_delivered;
+    static unsigned int m_maxDepth;
+    static unsigned int m_totalLatency;
+    static unsigned int m_maxLatency;
   };
 }
@@ -50,9 +50,11 @@
 #include "utils/RssReader.h"
 #include "PartyModeManager.h"
 #include "settings/Settings.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "Util.h"
+#include "ThumbLoader.h"
 
 #include "filesystem/PluginDirectory.h"
 #ifdef HAS_FILESYSTEM_RAR
@@ -85,6 +87,10 @@
 #include "cdrip/CDDARipper.h"
 #endif
 
+#ifdef XBMC_LOCK_PROFILER
+#include "threads/LockProfiler.h"
+#endif
+
 #include <vector>
 
 using namespace std;
@@ -164,6 +170,7 @@ const BUILT_IN commands[] = {
   { "UpdateLibrary",              true,   "Update the selected library (music or video)" },
   { "CleanLibrary",               true,   "Clean the video/music library" },
   { "ExportLibrary",              true,   "Export the video/music library" },
+  { "ExtractThumbs",              true,   "Extract the thumbs of all videos below the given path, and of their chapters if the second parameter is chapters" },
   { "PageDown",                   true,   "Send a page down event to the pagecontrol with given id" },
   { "PageUp",                     true,   "Send a page up event to the pagecontrol with given id" },
   { "LastFM.Love",                false,  "Add the current playing last.fm radio track to the last.fm loved tracks" },
@@ -205,6 +212,12 @@ const BUILT_IN commands[] = {
   { "LCD.Suspend",                false,  "Suspends LCDproc" },
   { "LCD.Resume",                 false,  "Resumes LCDproc" },
 #endif
+#ifdef XBMC_LOCK_PROFILER
+  { "System.LockProfile",         false,  "Logs the most contended locks, send System.LockProfile(reset) to start counting again" },
+#endif
+#ifdef HAS_PYTHON
+  { "System.PythonBenchmark",     false,  "Logs how long a number of plugin runs (default 100) take with and without the python interpreter pool" },
+#endif
 };
 
 bool CBuiltins::HasCommand(const CStdString& execString)
@@ -1212,6 +1225,16 @@ int CBuiltins::Execute(const CStdString& execString)
       }
     }
   }
+  else if (execute.Equals("extractthumbs"))
+  {
+    if (!params.size())
+    {
+      CLog::Log(LOGERROR, "XBMC.ExtractThumbs called with no parameters");
+      return -1;
+    }
+    bool chapters = params.size() > 1 && params[1].Equals("chapters");
+    CJobManager::GetInstance().AddJob(new CThumbBatchExtractor(params[0], chapters), NULL, CJob::PRIORITY_LOW);
+  }
   else if (execute.Equals("exportlibrary"))
   {
     int iHeading = 647;
@@ -1509,6 +1532,23 @@ int CBuiltins::Execute(const CStdString& execString)
     CGUIMessage msg(GUI_MSG_MOVE_OFFSET, 0, 0, 0);
     g_windowManager.SendMessage(msg, WINDOW_WEATHER);
   }
+#ifdef XBMC_LOCK_PROFILER
+  else if (execute.Equals("system.lockprofile"))
+  {
+    XbmcThreads::CLockProfiler::Get().Dump();
+    if (params.size() && params[0].CompareNoCase("reset") == 0)
+      XbmcThreads::CLockProfiler::Get().Reset();
+  }
+#endif
+#ifdef HAS_PYTHON
+  else if (execute.Equals("system.pythonbenchmark"))
+  {
+    int count = params.size() ? atoi(params[0].c_str()) : 100;
+    // the plugin runs take a while, so they don't hold up the caller
+    unsigned int poolSize = std::max(1, g_advancedSettings.m_pythonInterpreterPool);
+    CJobManager::GetInstance().AddJob(new CPythonBenchmarkJob(count > 0 ? count : 100, poolSize), NULL, CJob::PRIORITY_LOW);
+  }
+#endif
   else
     return -1;
   return 0;
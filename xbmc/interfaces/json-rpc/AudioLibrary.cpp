@@ -35,6 +35,29 @@ using namespace MUSIC_INFO;
 using namespace JSONRPC;
 using namespace XFILE;
 
+static const SQLSortColumn AlbumSortColumns[] = {
+  { "label",      "strAlbum",  true  },
+  { "album",      "strAlbum",  true  },
+  { "artist",     "strArtist", true  },
+  { "genre",      "strGenre",  true  },
+  { "year",       "iYear",     false },
+  { NULL,         NULL,        false }
+};
+
+static const SQLSortColumn SongSortColumns[] = {
+  { "label",      "strTitle",   true  },
+  { "title",      "strTitle",   true  },
+  { "track",      "iTrack",     false },
+  { "duration",   "iDuration",  false },
+  { "year",       "iYear",      false },
+  { "artist",     "strArtist",  true  },
+  { "album",      "strAlbum",   true  },
+  { "genre",      "strGenre",   true  },
+  { "songrating", "rating",     false },
+  { "lastplayed", "lastplayed", false },
+  { NULL,         NULL,         false }
+};
+
 JSON_STATUS CAudioLibrary::GetArtists(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CMusicDatabase musicdatabase;
@@ -51,7 +74,7 @@ JSON_STATUS CAudioLibrary::GetArtists(const CStdString &method, ITransportLayer
 
   CFileItemList items;
   if (musicdatabase.GetArtistsNav("", items, genreID, false))
-    HandleFileItemList("artistid", false, "artists", items, param, result);
+    StreamFileItemList("artistid", false, "artists", items, param, result);
 
   musicdatabase.Close();
   return OK;
@@ -93,11 +116,21 @@ JSON_STATUS CAudioLibrary::GetAlbums(const CStdString &method, ITransportLayer *
   int genreID   = (int)parameterObject["genreid"].asInteger();
 
   CFileItemList items;
-  if (musicdatabase.GetAlbumsNav("", items, genreID, artistID, -1, -1))
-    HandleFileItemList("albumid", false, "albums", items, parameterObject, result);
+  JSON_STATUS ret = OK;
+  CStdString order;
+  if (GetSQLPaging(parameterObject, AlbumSortColumns, order))
+  {
+    int total = musicdatabase.GetAlbumsNavCount(genreID, artistID);
+    if (total < 0 || (!IsEmptyPage(parameterObject, total) && !musicdatabase.GetAlbumsNav("", items, genreID, artistID, -1, -1, order)))
+      ret = InternalError;
+    else
+      StreamFileItemList("albumid", false, "albums", items, parameterObject, result, total);
+  }
+  else if (musicdatabase.GetAlbumsNav("", items, genreID, artistID, -1, -1))
+    StreamFileItemList("albumid", false, "albums", items, parameterObject, result);
 
   musicdatabase.Close();
-  return OK;
+  return ret;
 }
 
 JSON_STATUS CAudioLibrary::GetAlbumDetails(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
@@ -137,11 +170,21 @@ JSON_STATUS CAudioLibrary::GetSongs(const CStdString &method, ITransportLayer *t
   int genreID  = (int)parameterObject["genreid"].asInteger();
 
   CFileItemList items;
-  if (musicdatabase.GetSongsNav("", items, genreID, artistID, albumID))
-    HandleFileItemList("songid", true, "songs", items, parameterObject, result);
+  JSON_STATUS ret = OK;
+  CStdString order;
+  if (GetSQLPaging(parameterObject, SongSortColumns, order))
+  {
+    int total = musicdatabase.GetSongsNavCount(genreID, artistID, albumID);
+    if (total < 0 || (!IsEmptyPage(parameterObject, total) && !musicdatabase.GetSongsNav("", items, genreID, artistID, albumID, order)))
+      ret = InternalError;
+    else
+      StreamFileItemList("songid", true, "songs", items, parameterObject, result, total);
+  }
+  else if (musicdatabase.GetSongsNav("", items, genreID, artistID, albumID))
+    StreamFileItemList("songid", true, "songs", items, parameterObject, result);
 
   musicdatabase.Close();
-  return OK;
+  return ret;
 }
 
 JSON_STATUS CAudioLibrary::GetSongDetails(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
@@ -190,7 +233,7 @@ JSON_STATUS CAudioLibrary::GetRecentlyAddedAlbums(const CStdString &method, ITra
       items.Add(item);
     }
 
-    HandleFileItemList("albumid", false, "albums", items, parameterObject, result);
+    StreamFileItemList("albumid", false, "albums", items, parameterObject, result);
   }
 
   musicdatabase.Close();
@@ -209,7 +252,7 @@ JSON_STATUS CAudioLibrary::GetRecentlyAddedSongs(const CStdString &method, ITran
 
   CFileItemList items;
   if (musicdatabase.GetRecentlyAddedAlbumSongs("musicdb://", items, (unsigned int)amount))
-    HandleFileItemList("songid", true, "songs", items, parameterObject, result);
+    StreamFileItemList("songid", true, "songs", items, parameterObject, result);
 
   musicdatabase.Close();
   return OK;
@@ -228,7 +271,7 @@ JSON_STATUS CAudioLibrary::GetGenres(const CStdString &method, ITransportLayer *
     for (unsigned int i = 0; i < (unsigned int)items.Size(); i++)
       items[i]->GetMusicInfoTag()->SetTitle(items[i]->GetLabel());
 
-    HandleFileItemList("genreid", false, "genres", items, parameterObject, result);
+    StreamFileItemList("genreid", false, "genres", items, parameterObject, result);
   }
 
   musicdatabase.Close();
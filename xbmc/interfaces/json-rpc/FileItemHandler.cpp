@@ -20,6 +20,7 @@
  */
 
 #include <string.h>
+#include <limits.h>
 #include "FileItemHandler.h"
 #include "PlaylistOperations.h"
 #include "AudioLibrary.h"
@@ -87,31 +88,120 @@ void CFileItemHandler::FillDetails(ISerializable* info, CFileItemPtr item, const
   }
 }
 
-void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result)
+// Writes a page of items straight into the response
+class CFileItemHandler::CFileItemListWriter : public IStreamedResult
+{
+public:
+  CFileItemListWriter(const char *ID, bool allowFile, const CVariant &fields)
+    : m_ID(ID), m_allowFile(allowFile), m_fields(fields) {}
+
+  void Add(CFileItemPtr item) { m_items.push_back(item); }
+
+  virtual bool Write(CJSONStreamWriter &writer)
+  {
+    bool success = writer.OpenArray();
+    for (std::vector<CFileItemPtr>::const_iterator it = m_items.begin(); it != m_items.end() && success; it++)
+    {
+      CVariant object;
+      SerializeFileItem(m_ID, m_allowFile, *it, m_fields, object);
+      success = writer.Write(object);
+    }
+    return success && writer.CloseArray();
+  }
+
+private:
+  const char *m_ID;
+  bool m_allowFile;
+  CVariant m_fields;
+  std::vector<CFileItemPtr> m_items;
+};
+
+void CFileItemHandler::GetPage(CFileItemList &items, const CVariant &parameterObject, CVariant &result, int total, int &first, int &count)
 {
-  int size  = items.Size();
   int start = (int)parameterObject["limits"]["start"].asInteger();
   int end   = (int)parameterObject["limits"]["end"].asInteger();
-  end = (end <= 0 || end > size) ? size : end;
-  start = start > end ? end : start;
+  first = 0;
 
-  Sort(items, parameterObject["sort"]);
+  if (total < 0)
+  {
+    total = items.Size();
+    end = (end <= 0 || end > total) ? total : end;
+    start = start > end ? end : start;
+
+    Sort(items, parameterObject["sort"]);
+    first = start;
+  }
+  else
+  {
+    // the database already returned only the requested page
+    start = start < 0 ? 0 : (start > total ? total : start);
+    end = start + items.Size();
+  }
 
   result["limits"]["start"] = start;
   result["limits"]["end"]   = end;
-  result["limits"]["total"] = size;
+  result["limits"]["total"] = total;
+
+  count = end - start;
+}
+
+void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int total /* = -1 */)
+{
+  int first, count;
+  GetPage(items, parameterObject, result, total, first, count);
 
-  for (int i = start; i < end; i++)
+  // an empty page is still listed, e.g. when paging past the end
+  if (count <= 0)
+    result[resultname] = CVariant(CVariant::VariantTypeArray);
+
+  for (int i = 0; i < count; i++)
   {
-    CVariant object;
-    CFileItemPtr item = items.Get(i);
+    CFileItemPtr item = items.Get(first + i);
     HandleFileItem(ID, allowFile, resultname, item, parameterObject, parameterObject["fields"], result);
   }
 }
 
+void CFileItemHandler::StreamFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int total /* = -1 */)
+{
+  if (!CJSONRPC::CanStreamResult(result))
+  {
+    HandleFileItemList(ID, allowFile, resultname, items, parameterObject, result, total);
+    return;
+  }
+
+  int first, count;
+  GetPage(items, parameterObject, result, total, first, count);
+
+  if (count <= 0)
+  {
+    result[resultname] = CVariant(CVariant::VariantTypeArray);
+    return;
+  }
+
+  CFileItemListWriter *writer = new CFileItemListWriter(ID, allowFile, parameterObject["fields"]);
+  for (int i = 0; i < count; i++)
+    writer->Add(items.Get(first + i));
+
+  if (!CJSONRPC::StreamResult(result, resultname, writer))
+    delete writer;
+}
+
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append /* = true */)
 {
   CVariant object;
+  SerializeFileItem(ID, allowFile, item, validFields, object);
+
+  if (resultname)
+  {
+    if (append)
+      result[resultname].append(object);
+    else
+      result[resultname] = object;
+  }
+}
+
+void CFileItemHandler::SerializeFileItem(const char *ID, bool allowFile, CFileItemPtr item, const CVariant &validFields, CVariant &object)
+{
   bool hasFileField = false;
   bool hasThumbnailField = false;
 
@@ -186,14 +276,6 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
     FillDetails(item->GetMusicInfoTag(), item, validFields, object);
 
   object["label"] = item->GetLabel().c_str();
-
-  if (resultname)
-  {
-    if (append)
-      result[resultname].append(object);
-    else
-      result[resultname] = object;
-  }
 }
 
 bool CFileItemHandler::FillFileItemList(const CVariant &parameterObject, CFileItemList &list)
@@ -228,6 +310,60 @@ bool CFileItemHandler::FillFileItemList(const CVariant &parameterObject, CFileIt
   return (list.Size() > 0);
 }
 
+bool CFileItemHandler::GetSQLPaging(const CVariant &parameterObject, const SQLSortColumn *columns, CStdString &order)
+{
+  int start = (int)parameterObject["limits"]["start"].asInteger();
+  int end   = (int)parameterObject["limits"]["end"].asInteger();
+  if (start < 0)
+    start = 0;
+
+  // without limits the whole listing is read and sorted in memory as before
+  order.clear();
+  if (end <= 0 && start == 0)
+    return false;
+
+  const CVariant &sort = parameterObject["sort"];
+  CStdString method    = sort["method"].asString();
+  CStdString direction = sort["order"].asString();
+
+  method = method.ToLower();
+  direction = direction.ToLower();
+
+  if (!method.IsEmpty() && !method.Equals("none"))
+  {
+    // articles can't be skipped in sql
+    if (sort["ignorearticle"].asBoolean())
+      return false;
+
+    const SQLSortColumn *column = columns;
+    while (column->method && !method.Equals(column->method))
+      column++;
+    if (!column->method)
+      return false;
+
+    order.Format(column->text ? "order by lower(%s) %s" : "order by %s %s",
+                 column->column, direction.Equals("descending") ? "desc" : "asc");
+  }
+
+  if (end > 0)
+    order.AppendFormat(" limit %i,%i", start, end > start ? end - start : 0);
+  else if (start > 0)
+    order.AppendFormat(" limit %i,%i", start, INT_MAX);
+
+  order.TrimLeft();
+  return true;
+}
+
+bool CFileItemHandler::IsEmptyPage(const CVariant &parameterObject, int total)
+{
+  int start = (int)parameterObject["limits"]["start"].asInteger();
+  int end   = (int)parameterObject["limits"]["end"].asInteger();
+  if (start < 0)
+    start = 0;
+
+  return start >= total || (end > 0 && end <= start);
+}
+
 bool CFileItemHandler::ParseSortMethods(const CStdString &method, const bool &ignorethe, const CStdString &order, SORT_METHOD &sortmethod, SORT_ORDER &sortorder)
 {
   if (order.Equals("ascending"))
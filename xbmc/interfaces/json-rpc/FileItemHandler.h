@@ -27,15 +27,64 @@
 
 namespace JSONRPC
 {
+  /*!
+   \brief A sort method the database can do itself and the column it sorts by.
+   \sa CFileItemHandler::GetSQLPaging
+   */
+  struct SQLSortColumn
+  {
+    const char *method;
+    const char *column;
+    bool        text;     ///< text columns are sorted case insensitively
+  };
+
   class CFileItemHandler : public CJSONUtils
   {
   protected:
     static void FillDetails(ISerializable* info, CFileItemPtr item, const CVariant& fields, CVariant &result);
-    static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result);
+
+    /*!
+     \brief Add the items of a listing to the result, applying "sort" and "limits".
+     \param total the number of items in the whole listing if items only holds
+     the requested page, already sorted by the database (see GetSQLPaging).
+     -1 if items holds the whole listing, which is then sorted and limited here.
+     */
+    static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int total = -1);
+
+    /*!
+     \brief Same as HandleFileItemList() but lets the items be written straight
+     into the response when possible, rather than building all of them as CVariants
+     first. Only streams when result is the result object of the method being
+     executed, and only for handlers which don't touch the items in the result afterwards.
+     */
+    static void StreamFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int total = -1);
+
     static void HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append = true);
+    static void SerializeFileItem(const char *ID, bool allowFile, CFileItemPtr item, const CVariant &validFields, CVariant &object);
 
     static bool FillFileItemList(const CVariant &parameterObject, CFileItemList &list);
+
+    /*!
+     \brief Translate "sort" and "limits" into ORDER BY and LIMIT clauses so only
+     the requested page is read from the database.
+     \param columns the sort methods the database can do, terminated by an entry with a NULL method.
+     \param order receives the clauses.
+     \return false if no limits are given or the requested sort has to be done in memory over the whole listing.
+     \note text columns are ordered by lower(), which doesn't sort numbers within the
+     text by their value like the in-memory sort does, "Part 10" comes before "Part 9".
+     */
+    static bool GetSQLPaging(const CVariant &parameterObject, const SQLSortColumn *columns, CStdString &order);
+
+    /*!
+     \brief Check whether the requested page has no items, in which case there
+     is nothing to read from the database.
+     \param total the number of items in the whole listing.
+     */
+    static bool IsEmptyPage(const CVariant &parameterObject, int total);
   private:
+    class CFileItemListWriter;
+
+    static void GetPage(CFileItemList &items, const CVariant &parameterObject, CVariant &result, int total, int &first, int &count);
     static bool ParseSortMethods(const CStdString &method, const bool &ignorethe, const CStdString &order, SORT_METHOD &sortmethod, SORT_ORDER &sortorder);
     static void Sort(CFileItemList &items, const CVariant& parameterObject);
   };
@@ -25,6 +25,8 @@
 #include "interfaces/AnnouncementUtils.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
+#include "utils/TimeUtils.h"
+#include "threads/ThreadLocal.h"
 #include <string.h>
 #include "ServiceDescription.h"
 
@@ -34,6 +36,48 @@ using namespace std;
 
 bool CJSONRPC::m_initialized = false;
 
+namespace
+{
+  // The member of the result of the method being executed
+  // on a thread that is written by an IStreamedResult
+  struct StreamedResult
+  {
+    StreamedResult() : result(NULL), value(NULL) {}
+
+    const CVariant *result;
+    std::string member;
+    IStreamedResult *value;
+  };
+
+  XbmcThreads::ThreadLocal<StreamedResult> s_streamedResult;
+
+  // Measures how long it takes until the first part of the response goes out
+  class CTimedOutput : public IJSONOutput
+  {
+  public:
+    CTimedOutput(IJSONOutput &output) : m_output(output), m_start(CTimeUtils::GetTimeMS()), m_firstByte(0), m_started(false) {}
+
+    virtual bool Write(const char *data, unsigned int length)
+    {
+      if (!m_started)
+      {
+        m_firstByte = CTimeUtils::GetTimeMS() - m_start;
+        m_started = true;
+      }
+      return m_output.Write(data, length);
+    }
+
+    unsigned int GetFirstByte() const { return m_firstByte; }
+    unsigned int GetElapsed() const   { return CTimeUtils::GetTimeMS() - m_start; }
+
+  private:
+    IJSONOutput &m_output;
+    unsigned int m_start;
+    unsigned int m_firstByte;
+    bool m_started;
+  };
+}
+
 void CJSONRPC::Initialize()
 {
   if (m_initialized)
@@ -138,7 +182,18 @@ JSON_STATUS CJSONRPC::NotifyAll(const CStdString &method, ITransportLayer *trans
 
 CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client)
 {
+  CJSONStringOutput output;
+  if (!MethodCall(inputString, transport, client, output))
+    return "";
+
+  return output.GetString();
+}
+
+bool CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client, IJSONOutput &output)
+{
+  CTimedOutput timedOutput(output);
   CVariant inputroot, outputroot, result;
+  StreamedResult streamed;
   bool hasResponse = false;
 
   inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
@@ -166,7 +221,13 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
       }
     }
     else
+    {
+      // Only the result of a single call can be streamed,
+      // the responses of a batch call are collected first
+      s_streamedResult.set(&streamed);
       hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+      s_streamedResult.set(NULL);
+    }
   }
   else
   {
@@ -175,8 +236,75 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
     hasResponse = true;
   }
 
-  CStdString str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  bool success = true;
+  if (hasResponse)
+  {
+    CJSONStreamWriter writer(timedOutput, g_advancedSettings.m_jsonOutputCompact);
+    success = WriteResponse(writer, outputroot, streamed.member, streamed.value) && writer.Flush();
+
+    if (streamed.value != NULL)
+      CLog::Log(LOGDEBUG, "JSONRPC: Streamed response of %u bytes, first byte after %u ms, done after %u ms",
+                writer.GetBytesWritten(), timedOutput.GetFirstByte(), timedOutput.GetElapsed());
+  }
+  delete streamed.value;
+
+  return success;
+}
+
+bool CJSONRPC::CanStreamResult(const CVariant &result)
+{
+  StreamedResult *streamed = s_streamedResult.get();
+  return streamed != NULL && streamed->result == &result && streamed->value == NULL;
+}
+
+bool CJSONRPC::StreamResult(const CVariant &result, const std::string &member, IStreamedResult *value)
+{
+  if (!CanStreamResult(result))
+    return false;
+
+  StreamedResult *streamed = s_streamedResult.get();
+  streamed->member = member;
+  streamed->value = value;
+  return true;
+}
+
+bool CJSONRPC::WriteResponse(CJSONStreamWriter &writer, const CVariant &response, const std::string &member, IStreamedResult *value)
+{
+  if (value == NULL || !response.isMember("result") || !response["result"].isObject())
+    return writer.Write(response);
+
+  // Write the response like CJSONVariantWriter would with the
+  // streamed member at its place among the members of the result
+  bool success = writer.OpenObject();
+  for (CVariant::const_iterator_map itr = response.begin_map(); itr != response.end_map() && success; itr++)
+  {
+    success = writer.Key(itr->first);
+    if (!success)
+      break;
+
+    if (itr->first != "result")
+    {
+      success = writer.Write(itr->second);
+      continue;
+    }
+
+    bool written = false;
+    success = writer.OpenObject();
+    for (CVariant::const_iterator_map resultItr = itr->second.begin_map(); resultItr != itr->second.end_map() && success; resultItr++)
+    {
+      if (!written && member < resultItr->first)
+      {
+        success = writer.Key(member) && value->Write(writer);
+        written = true;
+      }
+      success = success && writer.Key(resultItr->first) && writer.Write(resultItr->second);
+    }
+    if (success && !written)
+      success = writer.Key(member) && value->Write(writer);
+    success = success && writer.CloseObject();
+  }
+
+  return success && writer.CloseObject();
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
@@ -185,6 +313,10 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
   CVariant result;
   bool isNotification = false;
 
+  StreamedResult *streamed = s_streamedResult.get();
+  if (streamed != NULL)
+    streamed->result = &result;
+
   if (IsProperJSONRPC(request))
   {
     isNotification = !request.isMember("id");
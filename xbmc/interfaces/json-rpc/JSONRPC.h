@@ -32,6 +32,27 @@
 
 namespace JSONRPC
 {
+  /*!
+   \ingroup jsonrpc
+   \brief Member of a result which is written
+   straight into the response rather than being
+   built as a CVariant first.
+
+   \sa CJSONRPC::StreamResult
+   */
+  class IStreamedResult
+  {
+  public:
+    virtual ~IStreamedResult() {}
+
+    /*!
+     \brief Writes the value of the member
+     \param writer Writer of the response
+     \return True if the value has been written otherwise false
+     */
+    virtual bool Write(CJSONStreamWriter &writer) = 0;
+  };
+
   /*!
    \ingroup jsonrpc
    \brief JSON RPC handler
@@ -63,6 +84,37 @@ namespace JSONRPC
      */
     static CStdString MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON RPC request and writes the response
+     to the given output while it is being generated
+     \param inputString received JSON RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param output Output receiving the JSON RPC response
+     \return False if the response could not be written completely
+     */
+    static bool MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client, IJSONOutput &output);
+
+    /*
+     \brief Whether a member of the result of the method currently
+     being executed on this thread can be streamed with StreamResult()
+     \param result Result object passed to the method
+     */
+    static bool CanStreamResult(const CVariant &result);
+
+    /*
+     \brief Has a member of the result of the method currently being
+     executed on this thread written by the given object while the
+     response is written. The member must not be part of the result.
+     \param result Result object passed to the method
+     \param member Name of the member of the result
+     \param value Object writing the value of the member, deleted
+     once the response has been written
+     \return False if the result can't be streamed, in which case
+     the caller still owns the given object
+     */
+    static bool StreamResult(const CVariant &result, const std::string &member, IStreamedResult *value);
+
     static JSON_STATUS Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSON_STATUS Version(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSON_STATUS Permission(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -75,6 +127,7 @@ namespace JSONRPC
     static void setup();
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
+    static bool WriteResponse(CJSONStreamWriter &writer, const CVariant &response, const std::string &member, IStreamedResult *value);
 
     inline static void BuildResponse(const CVariant& request, JSON_STATUS code, const CVariant& result, CVariant& response);
 
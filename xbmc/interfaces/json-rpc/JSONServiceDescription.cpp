@@ -345,6 +345,7 @@ bool CJSONServiceDescription::addMethod(std::string &jsonMethod, MethodCall meth
     return false;
   }
 
+  newMethod.validator.Compile(newMethod.parameters);
   m_actionMap.add(newMethod);
 
   return true;
@@ -607,6 +608,13 @@ JSON_STATUS CJSONServiceDescription::CheckCall(const char* const method, const C
     {
       methodCall = iter->second.method;
 
+      // Most requests are valid so try the compiled validator
+      // first and only fall back to walking the type definitions
+      // to find out what's wrong with the parameters
+      if (iter->second.validator.CheckParameters(requestParameters, outputParameters))
+        return OK;
+      outputParameters = CVariant();
+
       // Count the number of actually handled (present)
       // parameters
       unsigned int handled = 0;
@@ -1466,16 +1474,269 @@ void CJSONServiceDescription::getReferencedTypes(const JSONSchemaTypeDefinition
   }
 }
 
+void CJSONSchemaValidator::Compile(const std::vector<JSONSchemaTypeDefinition> &parameters)
+{
+  m_nodes.clear();
+  m_children.clear();
+  m_properties.clear();
+  m_enums.clear();
+  m_parameters.clear();
+
+  for (std::vector<JSONSchemaTypeDefinition>::const_iterator it = parameters.begin(); it != parameters.end(); it++)
+    m_parameters.push_back(compileProperty(*it));
+}
+
+bool CJSONSchemaValidator::CheckParameters(const CVariant &requestParameters, CVariant &outputParameters) const
+{
+  // Same rules as CJSONServiceDescription::checkParameter()
+  unsigned int handled = 0;
+  for (unsigned int position = 0; position < m_parameters.size(); position++)
+  {
+    const Property &parameter = m_parameters[position];
+    if (IsValueMember(requestParameters, parameter.name))
+    {
+      if (!checkType(requestParameters[parameter.name], parameter.node, outputParameters[parameter.name]))
+        return false;
+      handled++;
+    }
+    else if (requestParameters.isArray() && requestParameters.size() > position)
+    {
+      if (!checkType(requestParameters[position], parameter.node, outputParameters[parameter.name]))
+        return false;
+      handled++;
+    }
+    else if (parameter.optional)
+      outputParameters[parameter.name] = parameter.defaultValue;
+    else
+      return false;
+  }
+
+  return handled >= requestParameters.size();
+}
+
+unsigned int CJSONSchemaValidator::compileType(const JSONSchemaTypeDefinition &type)
+{
+  // Compile the nested types first so that the
+  // ranges of this node's children are contiguous
+  std::vector<unsigned int> items, additionalItems;
+  for (unsigned int index = 0; index < type.items.size(); index++)
+    items.push_back(compileType(type.items.at(index)));
+  for (unsigned int index = 0; index < type.additionalItems.size(); index++)
+    additionalItems.push_back(compileType(type.additionalItems.at(index)));
+
+  std::vector<Property> properties;
+  JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator propertiesEnd = type.properties.end();
+  JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator propertiesIterator;
+  for (propertiesIterator = type.properties.begin(); propertiesIterator != propertiesEnd; propertiesIterator++)
+  {
+    Property property = compileProperty(propertiesIterator->second);
+    property.name = propertiesIterator->first;
+    properties.push_back(property);
+  }
+
+  Node node;
+  node.type = type.type;
+  node.minimum = type.minimum;
+  node.maximum = type.maximum;
+  node.exclusiveMinimum = type.exclusiveMinimum;
+  node.exclusiveMaximum = type.exclusiveMaximum;
+  node.divisibleBy = type.divisibleBy;
+  node.minItems = type.minItems;
+  node.maxItems = type.maxItems;
+  node.uniqueItems = type.uniqueItems;
+
+  node.firstEnum = m_enums.size();
+  node.enumCount = type.enums.size();
+  m_enums.insert(m_enums.end(), type.enums.begin(), type.enums.end());
+
+  node.firstItem = m_children.size();
+  node.itemCount = items.size();
+  m_children.insert(m_children.end(), items.begin(), items.end());
+
+  node.firstAdditional = m_children.size();
+  node.additionalCount = additionalItems.size();
+  m_children.insert(m_children.end(), additionalItems.begin(), additionalItems.end());
+
+  node.firstProperty = m_properties.size();
+  node.propertyCount = properties.size();
+  m_properties.insert(m_properties.end(), properties.begin(), properties.end());
+
+  m_nodes.push_back(node);
+  return m_nodes.size() - 1;
+}
+
+CJSONSchemaValidator::Property CJSONSchemaValidator::compileProperty(const JSONSchemaTypeDefinition &type)
+{
+  Property property;
+  property.name = type.name;
+  property.optional = type.optional;
+  property.defaultValue = type.defaultValue;
+  property.node = compileType(type);
+  return property;
+}
+
+bool CJSONSchemaValidator::checkType(const CVariant &value, unsigned int index, CVariant &outputValue) const
+{
+  // Same rules as CJSONServiceDescription::checkType()
+  const Node &node = m_nodes[index];
+  if (!IsType(value, node.type) || (value.isNull() && !HasType(node.type, NullValue)))
+    return false;
+
+  if (HasType(node.type, ArrayValue) && value.isArray())
+  {
+    outputValue = CVariant(CVariant::VariantTypeArray);
+    if ((node.minItems > 0 && value.size() < node.minItems) || (node.maxItems > 0 && value.size() > node.maxItems))
+      return false;
+
+    if (node.itemCount == 0)
+      outputValue = value;
+    else if (node.itemCount == 1)
+    {
+      unsigned int itemNode = m_children[node.firstItem];
+      for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
+      {
+        CVariant temp;
+        bool ok = checkType(value[arrayIndex], itemNode, temp);
+        outputValue.push_back(temp);
+        if (!ok)
+          return false;
+      }
+    }
+    else
+    {
+      if (value.size() < node.itemCount || (value.size() != node.itemCount && node.additionalCount == 0))
+        return false;
+
+      unsigned int arrayIndex;
+      for (arrayIndex = 0; arrayIndex < node.itemCount; arrayIndex++)
+      {
+        if (!checkType(value[arrayIndex], m_children[node.firstItem + arrayIndex], outputValue[arrayIndex]))
+          return false;
+      }
+
+      for (; arrayIndex < value.size(); arrayIndex++)
+      {
+        bool ok = false;
+        for (unsigned int additionalIndex = 0; additionalIndex < node.additionalCount && !ok; additionalIndex++)
+          ok = checkType(value[arrayIndex], m_children[node.firstAdditional + additionalIndex], outputValue[arrayIndex]);
+        if (!ok)
+          return false;
+      }
+    }
+
+    if (node.uniqueItems)
+    {
+      for (unsigned int checkingIndex = 0; checkingIndex < outputValue.size(); checkingIndex++)
+      {
+        for (unsigned int checkedIndex = checkingIndex + 1; checkedIndex < outputValue.size(); checkedIndex++)
+        {
+          if (outputValue[checkingIndex] == outputValue[checkedIndex])
+            return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  if (HasType(node.type, ObjectValue) && value.isObject())
+  {
+    unsigned int handled = 0;
+    for (unsigned int propertyIndex = node.firstProperty; propertyIndex < node.firstProperty + node.propertyCount; propertyIndex++)
+    {
+      const Property &property = m_properties[propertyIndex];
+      if (value.isMember(property.name))
+      {
+        if (!checkType(value[property.name], property.node, outputValue[property.name]))
+          return false;
+        handled++;
+      }
+      else if (property.optional)
+        outputValue[property.name] = property.defaultValue;
+      else
+        return false;
+    }
+
+    return handled >= value.size();
+  }
+
+  if (node.enumCount > 0)
+  {
+    bool valid = false;
+    for (unsigned int enumIndex = node.firstEnum; enumIndex < node.firstEnum + node.enumCount && !valid; enumIndex++)
+      valid = m_enums[enumIndex] == value;
+    if (!valid)
+      return false;
+  }
+
+  if ((HasType(node.type, NumberValue) || HasType(node.type, IntegerValue)) && value.isDouble())
+  {
+    double numberValue = value.asDouble();
+    if ((node.exclusiveMinimum && numberValue <= node.minimum) || (!node.exclusiveMinimum && numberValue < node.minimum) ||
+        (node.exclusiveMaximum && numberValue >= node.maximum) || (!node.exclusiveMaximum && numberValue > node.maximum))
+      return false;
+    if (HasType(node.type, IntegerValue) && node.divisibleBy > 0 && ((int)numberValue % node.divisibleBy) != 0)
+      return false;
+  }
+
+  outputValue = value;
+  return true;
+}
+
 CJSONServiceDescription::CJsonRpcMethodMap::CJsonRpcMethodMap()
 {
   m_actionmap = std::map<std::string, JsonRpcMethod>();
+  m_tableMask = 0;
 }
 
 void CJSONServiceDescription::CJsonRpcMethodMap::add(const JsonRpcMethod &method)
 {
   CStdString name = method.name;
   name = name.ToLower();
-  m_actionmap[name] = method;
+
+  std::pair<std::map<std::string, JsonRpcMethod>::iterator, bool> result = m_actionmap.insert(std::make_pair(name, method));
+  if (!result.second)
+  {
+    result.first->second = method;
+    return;
+  }
+
+  // Keep the table at most half full so probe sequences stay short
+  if (2 * m_actionmap.size() > m_table.size())
+    rehash(m_table.empty() ? 256 : 2 * m_table.size());
+  else
+  {
+    unsigned int index = hash(name) & m_tableMask;
+    while (m_table[index] != m_actionmap.end())
+      index = (index + 1) & m_tableMask;
+    m_table[index] = result.first;
+  }
+}
+
+unsigned int CJSONServiceDescription::CJsonRpcMethodMap::hash(const std::string &key)
+{
+  // FNV-1a
+  unsigned int hash = 2166136261U;
+  for (std::string::const_iterator it = key.begin(); it != key.end(); it++)
+  {
+    hash ^= (unsigned char)*it;
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+void CJSONServiceDescription::CJsonRpcMethodMap::rehash(unsigned int size)
+{
+  m_table.assign(size, m_actionmap.end());
+  m_tableMask = size - 1;
+
+  for (JsonRpcMethodIterator it = m_actionmap.begin(); it != m_actionmap.end(); it++)
+  {
+    unsigned int index = hash(it->first) & m_tableMask;
+    while (m_table[index] != m_actionmap.end())
+      index = (index + 1) & m_tableMask;
+    m_table[index] = it;
+  }
 }
 
 CJSONServiceDescription::CJsonRpcMethodMap::JsonRpcMethodIterator CJSONServiceDescription::CJsonRpcMethodMap::begin() const
@@ -1485,7 +1746,16 @@ CJSONServiceDescription::CJsonRpcMethodMap::JsonRpcMethodIterator CJSONServiceDe
 
 CJSONServiceDescription::CJsonRpcMethodMap::JsonRpcMethodIterator CJSONServiceDescription::CJsonRpcMethodMap::find(const std::string& key) const
 {
-  return m_actionmap.find(key);
+  if (m_table.empty())
+    return m_actionmap.end();
+
+  for (unsigned int index = hash(key) & m_tableMask; m_table[index] != m_actionmap.end(); index = (index + 1) & m_tableMask)
+  {
+    if (m_table[index]->first == key)
+      return m_table[index];
+  }
+
+  return m_actionmap.end();
 }
 
 CJSONServiceDescription::CJsonRpcMethodMap::JsonRpcMethodIterator CJSONServiceDescription::CJsonRpcMethodMap::end() const
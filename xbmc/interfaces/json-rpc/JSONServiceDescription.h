@@ -164,6 +164,75 @@ namespace JSONRPC
     CJsonSchemaPropertiesMap properties;
   } JSONSchemaTypeDefinition;
 
+  /*!
+   \ingroup jsonrpc
+   \brief Flattened form of the json schema
+   type definitions of a method's parameters.
+
+   Every type definition, including the ones
+   pulled in through "$ref", is compiled into
+   a single array of nodes which refer to their
+   items and properties by index, so checking
+   a request neither walks nor copies the type
+   definitions and doesn't build any error data.
+   Only when a request fails to validate are the
+   type definitions walked again to describe
+   the error.
+   */
+  class CJSONSchemaValidator : public CJSONUtils
+  {
+  public:
+    /*!
+     \brief Compiles the given parameter definitions
+     \param parameters Parameter definitions of a method
+     */
+    void Compile(const std::vector<JSONSchemaTypeDefinition> &parameters);
+
+    /*!
+     \brief Checks the parameters of a request
+     \param requestParameters Parameters from the request
+     \param outputParameters Cleaned up parameter list
+     \return True if the parameters are valid otherwise false
+     */
+    bool CheckParameters(const CVariant &requestParameters, CVariant &outputParameters) const;
+
+  private:
+    typedef struct
+    {
+      JSONSchemaType type;
+      double minimum;
+      double maximum;
+      bool exclusiveMinimum;
+      bool exclusiveMaximum;
+      unsigned int divisibleBy;
+      unsigned int minItems;
+      unsigned int maxItems;
+      bool uniqueItems;
+      unsigned int firstEnum, enumCount;             ///< range in m_enums
+      unsigned int firstItem, itemCount;             ///< range in m_children
+      unsigned int firstAdditional, additionalCount; ///< range in m_children
+      unsigned int firstProperty, propertyCount;     ///< range in m_properties
+    } Node;
+
+    typedef struct
+    {
+      std::string name;
+      unsigned int node;
+      bool optional;
+      CVariant defaultValue;
+    } Property;
+
+    unsigned int compileType(const JSONSchemaTypeDefinition &type);
+    Property compileProperty(const JSONSchemaTypeDefinition &type);
+    bool checkType(const CVariant &value, unsigned int index, CVariant &outputValue) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<unsigned int> m_children;
+    std::vector<Property> m_properties;
+    std::vector<CVariant> m_enums;
+    std::vector<Property> m_parameters;
+  };
+
   /*! 
    \ingroup jsonrpc
    \brief Structure for a published json
@@ -206,6 +275,11 @@ namespace JSONRPC
      \brief Definition of the return value
      */
     JSONSchemaTypeDefinition returns;
+    /*!
+     \brief Compiled form of the parameter
+     definitions
+     */
+    CJSONSchemaValidator validator;
   } JsonRpcMethod;
 
   /*! 
@@ -340,7 +414,18 @@ namespace JSONRPC
       JsonRpcMethodIterator find(const std::string& key) const;
       JsonRpcMethodIterator end() const;
     private:
+      static unsigned int hash(const std::string &key);
+      void rehash(unsigned int size);
+
       std::map<std::string, JsonRpcMethod> m_actionmap;
+
+      /*!
+       \brief Open addressing hash table over the
+       methods in m_actionmap, which has to stay
+       a sorted map for printing the description
+       */
+      std::vector<JsonRpcMethodIterator> m_table;
+      unsigned int m_tableMask;
     };
 
     static CJsonRpcMethodMap m_actionMap;
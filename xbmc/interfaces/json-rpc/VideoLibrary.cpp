@@ -25,9 +25,35 @@
 #include "Util.h"
 #include "utils/URIUtils.h"
 #include "Application.h"
+#include "GUIPassword.h"
+#include "settings/Settings.h"
 
 using namespace JSONRPC;
 
+static const SQLSortColumn MovieSortColumns[] = {
+  { "label",      "movieview.c00",        true  },
+  { "title",      "movieview.c00",        true  },
+  { "videotitle", "movieview.c00",        true  },
+  { "lastplayed", "movieview.lastPlayed", false },
+  { NULL,         NULL,                   false }
+};
+
+static const SQLSortColumn EpisodeSortColumns[] = {
+  { "label",      "episodeview.c00",        true  },
+  { "title",      "episodeview.c00",        true  },
+  { "videotitle", "episodeview.c00",        true  },
+  { "lastplayed", "episodeview.lastPlayed", false },
+  { NULL,         NULL,                     false }
+};
+
+// movies in locked sources are dropped after the query, so the database
+// can't page them unless every source is accessible
+static bool CanPageMovies()
+{
+  return g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
+         g_passwordManager.bMasterUser;
+}
+
 JSON_STATUS CVideoLibrary::GetMovies(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CVideoDatabase videodatabase;
@@ -36,7 +62,16 @@ JSON_STATUS CVideoLibrary::GetMovies(const CStdString &method, ITransportLayer *
 
   CFileItemList items;
   JSON_STATUS ret = OK;
-  if (videodatabase.GetMoviesByWhere("videodb://", "", "", items))
+  CStdString order;
+  if (CanPageMovies() && GetSQLPaging(parameterObject, MovieSortColumns, order))
+  {
+    int total = videodatabase.GetRowCount("movieview");
+    if (total < 0 || (!IsEmptyPage(parameterObject, total) && !videodatabase.GetMoviesByWhere("videodb://", "", order, items)))
+      ret = InternalError;
+    else
+      ret = GetAdditionalMovieDetails(parameterObject, items, result, total);
+  }
+  else if (videodatabase.GetMoviesByWhere("videodb://", "", "", items))
     ret = GetAdditionalMovieDetails(parameterObject, items, result);
 
   videodatabase.Close();
@@ -73,7 +108,7 @@ JSON_STATUS CVideoLibrary::GetMovieSets(const CStdString &method, ITransportLaye
 
   CFileItemList items;
   if (videodatabase.GetSetsNav("videodb://1/7/", items, VIDEODB_CONTENT_MOVIES))
-    HandleFileItemList("setid", false, "sets", items, parameterObject, result);
+    StreamFileItemList("setid", false, "sets", items, parameterObject, result);
 
   videodatabase.Close();
   return OK;
@@ -132,7 +167,7 @@ JSON_STATUS CVideoLibrary::GetTVShows(const CStdString &method, ITransportLayer
       for (int index = 0; index < items.Size(); index++)
         videodatabase.GetTvShowInfo("", *(items[index]->GetVideoInfoTag()), items[index]->GetVideoInfoTag()->m_iDbId);
     }
-    HandleFileItemList("tvshowid", true, "tvshows", items, parameterObject, result);
+    StreamFileItemList("tvshowid", true, "tvshows", items, parameterObject, result);
   }
 
   videodatabase.Close();
@@ -171,7 +206,7 @@ JSON_STATUS CVideoLibrary::GetSeasons(const CStdString &method, ITransportLayer
 
   CFileItemList items;
   if (videodatabase.GetSeasonsNav("videodb://", items, -1, -1, -1, -1, tvshowID))
-    HandleFileItemList(NULL, false, "seasons", items, parameterObject, result);
+    StreamFileItemList(NULL, false, "seasons", items, parameterObject, result);
 
   videodatabase.Close();
   return OK;
@@ -187,11 +222,22 @@ JSON_STATUS CVideoLibrary::GetEpisodes(const CStdString &method, ITransportLayer
     return InternalError;
 
   CFileItemList items;
-  if (videodatabase.GetEpisodesNav("videodb://2/2/-1/-1/", items, -1, -1, -1, -1, tvshowID, season))
-    GetAdditionalEpisodeDetails(parameterObject, items, result);
+  JSON_STATUS ret = OK;
+  CStdString order;
+  // without a season the movies linked to the show are listed as well, so those are paged in memory
+  if ((season != -1 || tvshowID == -1) && GetSQLPaging(parameterObject, EpisodeSortColumns, order))
+  {
+    int total = videodatabase.GetEpisodesNavCount(-1, -1, -1, -1, tvshowID, season);
+    if (total < 0 || (!IsEmptyPage(parameterObject, total) && !videodatabase.GetEpisodesNav("videodb://2/2/-1/-1/", items, -1, -1, -1, -1, tvshowID, season, order)))
+      ret = InternalError;
+    else
+      ret = GetAdditionalEpisodeDetails(parameterObject, items, result, total);
+  }
+  else if (videodatabase.GetEpisodesNav("videodb://2/2/-1/-1/", items, -1, -1, -1, -1, tvshowID, season))
+    ret = GetAdditionalEpisodeDetails(parameterObject, items, result);
 
   videodatabase.Close();
-  return OK;
+  return ret;
 }
 
 JSON_STATUS CVideoLibrary::GetEpisodeDetails(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
@@ -325,7 +371,7 @@ JSON_STATUS CVideoLibrary::GetGenres(const CStdString &method, ITransportLayer *
     for (unsigned int i = 0; i < (unsigned int)items.Size(); i++)
       items[i]->GetVideoInfoTag()->m_strTitle = items[i]->GetLabel();
  
-    HandleFileItemList("genreid", false, "genres", items, parameterObject, result);
+    StreamFileItemList("genreid", false, "genres", items, parameterObject, result);
   }
 
   videodatabase.Close();
@@ -439,7 +485,7 @@ bool CVideoLibrary::FillFileItemList(const CVariant &parameterObject, CFileItemL
   return false;
 }
 
-JSON_STATUS CVideoLibrary::GetAdditionalMovieDetails(const CVariant &parameterObject, CFileItemList &items, CVariant &result)
+JSON_STATUS CVideoLibrary::GetAdditionalMovieDetails(const CVariant &parameterObject, CFileItemList &items, CVariant &result, int total /* = -1 */)
 {
   CVideoDatabase videodatabase;
   if (!videodatabase.Open())
@@ -458,12 +504,12 @@ JSON_STATUS CVideoLibrary::GetAdditionalMovieDetails(const CVariant &parameterOb
     for (int index = 0; index < items.Size(); index++)
       videodatabase.GetMovieInfo("", *(items[index]->GetVideoInfoTag()), items[index]->GetVideoInfoTag()->m_iDbId);
   }
-  HandleFileItemList("movieid", true, "movies", items, parameterObject, result);
+  StreamFileItemList("movieid", true, "movies", items, parameterObject, result, total);
 
   return OK;
 }
 
-JSON_STATUS CVideoLibrary::GetAdditionalEpisodeDetails(const CVariant &parameterObject, CFileItemList &items, CVariant &result)
+JSON_STATUS CVideoLibrary::GetAdditionalEpisodeDetails(const CVariant &parameterObject, CFileItemList &items, CVariant &result, int total /* = -1 */)
 {
   CVideoDatabase videodatabase;
   if (!videodatabase.Open())
@@ -482,7 +528,7 @@ JSON_STATUS CVideoLibrary::GetAdditionalEpisodeDetails(const CVariant &parameter
     for (int index = 0; index < items.Size(); index++)
       videodatabase.GetEpisodeInfo("", *(items[index]->GetVideoInfoTag()), items[index]->GetVideoInfoTag()->m_iDbId);
   }
-  HandleFileItemList("episodeid", true, "episodes", items, parameterObject, result);
+  StreamFileItemList("episodeid", true, "episodes", items, parameterObject, result, total);
 
   return OK;
 }
@@ -506,7 +552,7 @@ JSON_STATUS CVideoLibrary::GetAdditionalMusicVideoDetails(const CVariant &parame
     for (int index = 0; index < items.Size(); index++)
       videodatabase.GetMusicVideoInfo("", *(items[index]->GetVideoInfoTag()), items[index]->GetVideoInfoTag()->m_iDbId);
   }
-  HandleFileItemList("musicvideoid", true, "musicvideos", items, parameterObject, result);
+  StreamFileItemList("musicvideoid", true, "musicvideos", items, parameterObject, result);
 
   return OK;
 }
@@ -67,6 +67,7 @@ XBPyThread::XBPyThread(XBPython *pExecuter, int id)
   m_threadState = NULL;
   m_id          = id;
   m_stopping    = false;
+  m_interpreterPool = 0;
   m_argv        = NULL;
   m_source      = NULL;
   m_argc        = 0;
@@ -142,17 +143,13 @@ void XBPyThread::Process()
 
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  PyThreadState* state = (PyThreadState*)m_pExecuter->NewInterpreter(addon, m_interpreterPool);
   if (!state)
   {
     PyEval_ReleaseLock();
     CLog::Log(LOGERROR,"Python thread: FAILED to get thread state!");
     return;
   }
-  // swap in my thread state
-  PyThreadState_Swap(state);
-
-  m_pExecuter->InitializeInterpreter(addon);
 
   CLog::Log(LOGDEBUG, "%s - The source file to load is %s", __FUNCTION__, m_source);
 
@@ -372,17 +369,18 @@ void XBPyThread::Process()
   PyThreadState_Swap(NULL);
   PyEval_ReleaseLock();
 
+  // an interpreter that was asked to stop may still have the abort pending
+  unsigned int poolSize = 0;
   { CSingleLock lock(m_pExecuter->m_critSection);
     m_threadState = NULL;
+    if (!m_stopping)
+      poolSize = m_interpreterPool;
   }
 
   PyEval_AcquireLock();
   PyThreadState_Swap(state);
 
-  m_pExecuter->DeInitializeInterpreter();
-
-  Py_EndInterpreter(state);
-  PyThreadState_Swap(NULL);
+  m_pExecuter->EndInterpreter(state, poolSize);
 
   PyEval_ReleaseLock();
 }
@@ -39,6 +39,8 @@ public:
   void stop();
 
   void setAddon(ADDON::AddonPtr _addon) { addon = _addon; }
+  // keep up to size idle interpreters for later plugin runs, 0 to end the interpreter when done
+  void setInterpreterPool(unsigned int size) { m_interpreterPool = size; }
 
 protected:
   XBPython *m_pExecuter;
@@ -49,6 +51,7 @@ protected:
   char **m_argv;
   unsigned int  m_argc;
   bool m_stopping;
+  unsigned int m_interpreterPool;
   int  m_id;
   ADDON::AddonPtr addon;
 
@@ -25,6 +25,7 @@
 
 // python.h should always be included first before any other includes
 #include <Python.h>
+#include <pythread.h>
 
 #include "system.h"
 #include "cores/DllLoader/DllLoaderContainer.h"
@@ -32,6 +33,7 @@
 
 #include "XBPython.h"
 #include "settings/Settings.h"
+#include "settings/AdvancedSettings.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
 #include "utils/log.h"
@@ -276,6 +278,12 @@ void XBPython::UnloadExtensionLibs()
 #define RUNSCRIPT_COMPLIANT \
   RUNSCRIPT_PRAMBLE RUNSCRIPT_POSTSCRIPT
 
+static bool IsBwCompatible(ADDON::AddonPtr addon)
+{
+  CStdString addonVer = ADDON::GetXbmcApiVersionDependency(addon);
+  return (addon.get() == NULL || (ADDON::AddonVersion(addonVer) <= ADDON::AddonVersion("1.0")));
+}
+
 void XBPython::InitializeInterpreter(ADDON::AddonPtr addon)
 {
   InitXBMCModule(); // init xbmc modules
@@ -284,9 +292,7 @@ void XBPython::InitializeInterpreter(ADDON::AddonPtr addon)
   InitAddonModule(); // init xbmcaddon modules
   InitVFSModule(); // init xbmcvfs modules
 
-  CStdString addonVer = ADDON::GetXbmcApiVersionDependency(addon);
-  bool bwcompatMode = (addon.get() == NULL || (ADDON::AddonVersion(addonVer) <= ADDON::AddonVersion("1.0")));
-  const char* runscript = bwcompatMode ? RUNSCRIPT_BWCOMPATIBLE : RUNSCRIPT_COMPLIANT;
+  const char* runscript = IsBwCompatible(addon) ? RUNSCRIPT_BWCOMPATIBLE : RUNSCRIPT_COMPLIANT;
 
   // redirecting default output to debug console
   if (PyRun_SimpleString(runscript) == -1)
@@ -304,6 +310,148 @@ void XBPython::DeInitializeInterpreter()
   DeinitVFSModule();
 }
 
+void* XBPython::NewInterpreter(ADDON::AddonPtr addon, unsigned int poolSize)
+{
+  bool bwcompat = IsBwCompatible(addon);
+  bool reuse = poolSize > 0;
+
+  if (reuse)
+  {
+    for (PyInterpreterPool::iterator it = m_interpreters.begin(); it != m_interpreters.end(); ++it)
+    {
+      if (it->busy || it->bwcompat != bwcompat)
+        continue;
+
+      PyThreadState* state = (PyThreadState*)it->state;
+      // the interpreter was last used by another thread
+      state->thread_id = PyThread_get_thread_ident();
+      PyThreadState_Swap(state);
+      it->busy = true;
+      return state;
+    }
+  }
+
+  PyThreadState* state = Py_NewInterpreter();
+  if (!state)
+    return NULL;
+  // swap in my thread state
+  PyThreadState_Swap(state);
+
+  InitializeInterpreter(addon);
+
+  if (reuse)
+  {
+    // remember what the interpreter looks like before the plugin runs, so it can be put back
+    PyInterpreter interpreter;
+    interpreter.state    = state;
+    interpreter.bwcompat = bwcompat;
+    interpreter.busy     = true;
+    interpreter.sysDict  = PyDict_Copy(state->interp->sysdict);
+    interpreter.modules  = PyDict_Copy(state->interp->modules);
+    interpreter.mainDict = PyDict_Copy(PyModule_GetDict(PyImport_AddModule((char*)"__main__")));
+    m_interpreters.push_back(interpreter);
+  }
+  return state;
+}
+
+void XBPython::EndInterpreter(void* state, unsigned int poolSize)
+{
+  PyInterpreterPool::iterator it = m_interpreters.end();
+  unsigned int idle = 0;
+  for (PyInterpreterPool::iterator i = m_interpreters.begin(); i != m_interpreters.end(); ++i)
+  {
+    if (i->state == state)
+      it = i;
+    else if (!i->busy)
+      idle++;
+  }
+
+  if (it != m_interpreters.end())
+  {
+    if (idle < poolSize)
+    {
+      ResetInterpreter(*it);
+      it->busy = false;
+      PyThreadState_Swap(NULL);
+      return;
+    }
+
+    Py_XDECREF((PyObject*)it->sysDict);
+    Py_XDECREF((PyObject*)it->modules);
+    Py_XDECREF((PyObject*)it->mainDict);
+    m_interpreters.erase(it);
+  }
+
+  DeInitializeInterpreter();
+
+  Py_EndInterpreter((PyThreadState*)state);
+  PyThreadState_Swap(NULL);
+}
+
+/**
+* Put an interpreter back to how it was before its first plugin ran.
+* Modules imported by xbmc itself stay imported, which is what saves the time.
+*/
+void XBPython::ResetInterpreter(PyInterpreter &interpreter)
+{
+  PyThreadState* state = (PyThreadState*)interpreter.state;
+  PyObject* modules = state->interp->modules;
+
+  // forget the modules the plugin imported, the next plugin may have its own by the same name
+  PyObject* names = PyDict_Keys(modules);
+  for (Py_ssize_t i = 0; names && i < PyList_GET_SIZE(names); i++)
+  {
+    PyObject* name = PyList_GET_ITEM(names, i);
+    if (!PyDict_Contains((PyObject*)interpreter.modules, name))
+      PyDict_DelItem(modules, name);
+  }
+  Py_XDECREF(names);
+  PyDict_Update(modules, (PyObject*)interpreter.modules);
+
+  // sys.argv, sys.path and the output redirection
+  PyDict_Update(state->interp->sysdict, (PyObject*)interpreter.sysDict);
+
+  PyObject* mainDict = PyModule_GetDict(PyImport_AddModule((char*)"__main__"));
+  PyDict_Clear(mainDict);
+  PyDict_Update(mainDict, (PyObject*)interpreter.mainDict);
+
+  PyObject *m = PyImport_AddModule((char*)"xbmc");
+  if(!m || PyObject_SetAttrString(m, (char*)"abortRequested", PyBool_FromLong(0)))
+    CLog::Log(LOGERROR, "%s - failed to reset abortRequested", __FUNCTION__);
+
+  Py_CLEAR(state->exc_type);
+  Py_CLEAR(state->exc_value);
+  Py_CLEAR(state->exc_traceback);
+  Py_CLEAR(state->async_exc);
+  PyErr_Clear();
+
+  // free what the plugin left in reference cycles now rather than in the next plugin
+  PyGC_Collect();
+}
+
+/**
+* End the interpreters kept for plugins, with the GIL held.
+*/
+void XBPython::ClearInterpreterPool()
+{
+  for (PyInterpreterPool::iterator it = m_interpreters.begin(); it != m_interpreters.end(); ++it)
+  {
+    // a script that died never gave its interpreter back, leave it be
+    if (it->busy)
+      continue;
+
+    PyThreadState* state = (PyThreadState*)it->state;
+    PyThreadState_Swap(state);
+    Py_XDECREF((PyObject*)it->sysDict);
+    Py_XDECREF((PyObject*)it->modules);
+    Py_XDECREF((PyObject*)it->mainDict);
+    DeInitializeInterpreter();
+    Py_EndInterpreter(state);
+  }
+  m_interpreters.clear();
+  PyThreadState_Swap(NULL);
+}
+
 /**
 * Should be called before executing a script
 */
@@ -414,6 +562,7 @@ void XBPython::Finalize()
     CLog::Log(LOGINFO, "Python, unloading python shared library because no scripts are running anymore");
 
     PyEval_AcquireLock();
+    ClearInterpreterPool();
     PyThreadState_Swap((PyThreadState*)m_mainThreadState);
 
     Py_Finalize();
@@ -540,6 +689,8 @@ int XBPython::evalFile(const CStdString &src, const std::vector<CStdString> &arg
   XBPyThread *pyThread = new XBPyThread(this, m_nextid);
   pyThread->setArgv(argv);
   pyThread->setAddon(addon);
+  if (addon.get() != NULL && addon->Type() == ADDON::ADDON_PLUGIN && g_advancedSettings.m_pythonInterpreterPool > 0)
+    pyThread->setInterpreterPool(g_advancedSettings.m_pythonInterpreterPool);
   pyThread->evalFile(src);
   PyElem inf;
   inf.id        = m_nextid;
@@ -713,3 +864,54 @@ int XBPython::evalString(const CStdString &src, const std::vector<CStdString> &a
 
   return m_nextid;
 }
+
+void XBPython::BenchmarkInterpreterPool(unsigned int count, unsigned int poolSize)
+{
+  // a plugin that does nothing, so that only getting an interpreter is timed
+  static const char *plugin = "import sys, xbmc, xbmcgui, xbmcplugin, xbmcaddon\n"
+                              "handle = int(sys.argv[1])\n";
+  std::vector<CStdString> argv;
+  argv.push_back("plugin://plugin.benchmark/");
+  argv.push_back("-1");
+  argv.push_back("");
+
+  {
+    CSingleLock lock(m_critSection);
+    // keeps python loaded until the FinalizeScript() below
+    Initialize();
+    if (!m_bInitialized)
+      return;
+  }
+
+  double elapsed[2];
+  for (int reuse = 0; reuse < 2; reuse++)
+  {
+    int64_t start = CurrentHostCounter();
+    for (unsigned int i = 0; i < count; i++)
+    {
+      int id;
+      {
+        CSingleLock lock(m_critSection);
+        id = ++m_nextid;
+      }
+      // not in m_vecPyList, so it's ours to wait for and delete
+      XBPyThread pyThread(this, id);
+      pyThread.setArgv(argv);
+      pyThread.setInterpreterPool(reuse ? poolSize : 0);
+      pyThread.evalString(plugin);
+      pyThread.WaitForThreadExit(INFINITE);
+    }
+    elapsed[reuse] = (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+  }
+
+  FinalizeScript();
+
+  CLog::Log(LOGNOTICE, "Python: %u plugin runs took %.1fms with a new interpreter each (%.2fms per run), %.1fms with a pool of %u interpreters (%.2fms per run)",
+            count, elapsed[0], elapsed[0] / count, elapsed[1], poolSize, elapsed[1] / count);
+}
+
+bool CPythonBenchmarkJob::DoWork()
+{
+  g_pythonParser.BenchmarkInterpreterPool(m_count, m_poolSize);
+  return true;
+}
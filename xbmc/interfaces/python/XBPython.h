@@ -25,6 +25,7 @@
 #include "cores/IPlayer.h"
 #include "threads/CriticalSection.h"
 #include "addons/IAddon.h"
+#include "utils/Job.h"
 
 #include <vector>
 
@@ -35,9 +36,19 @@ typedef struct {
   XBPyThread *pyThread;
 }PyElem;
 
+typedef struct {
+  void* state;      // PyThreadState of the interpreter
+  bool  bwcompat;   // initialized for scripts depending on xbmc.python 1.0
+  bool  busy;       // running a script
+  void* sysDict;    // copy of sys.__dict__ right after initialization
+  void* modules;    // copy of sys.modules right after initialization
+  void* mainDict;   // copy of __main__.__dict__ right after initialization
+}PyInterpreter;
+
 class LibraryLoader;
 
 typedef std::vector<PyElem> PyList;
+typedef std::vector<PyInterpreter> PyInterpreterPool;
 typedef std::vector<PVOID> PlayerCallbackList;
 typedef std::vector<LibraryLoader*> PythonExtensionLibraries;
 
@@ -69,6 +80,13 @@ public:
   int evalFile(const CStdString &src, const std::vector<CStdString> &argv, ADDON::AddonPtr addon);
   int evalString(const CStdString &src, const std::vector<CStdString> &argv);
 
+  /*! \brief Time consecutive runs of a trivial plugin with and without the interpreter pool
+   Blocks until all runs are done, see CPythonBenchmarkJob to run it in the background.
+   \param count number of runs to time each way
+   \param poolSize interpreters to keep for the runs with the pool
+   */
+  void BenchmarkInterpreterPool(unsigned int count, unsigned int poolSize);
+
   bool isRunning(int scriptId);
   bool isStopping(int scriptId);
   void setDone(int id);
@@ -86,6 +104,16 @@ public:
   // remove modules and references when interpreter done
   void DeInitializeInterpreter();
 
+  // get an interpreter to run a script in, with the GIL held. It is swapped in
+  // and has the xbmc modules imported. When poolSize isn't 0, it is taken from the
+  // pool of interpreters of earlier plugin runs, if there is one to fit.
+  void* NewInterpreter(ADDON::AddonPtr addon, unsigned int poolSize);
+
+  // done with an interpreter from NewInterpreter, with the GIL held and the
+  // interpreter swapped in. If it came from the pool and fewer than poolSize
+  // others are idle it is reset and put back for the next plugin, otherwise it is ended.
+  void EndInterpreter(void* state, unsigned int poolSize);
+
   void RegisterExtensionLib(LibraryLoader *pLib);
   void UnregisterExtensionLib(LibraryLoader *pLib);
   void UnloadExtensionLibs();
@@ -105,6 +133,8 @@ public:
   CCriticalSection    m_critSection;
 private:
   bool              FileExist(const char* strFile);
+  void              ResetInterpreter(PyInterpreter &interpreter);
+  void              ClearInterpreterPool();
 
   int               m_nextid;
   void*             m_mainThreadState;
@@ -119,6 +149,9 @@ private:
   PlayerCallbackList  m_vecPlayerCallbackList;
   LibraryLoader*      m_pDll;
 
+  // interpreters of plugins, protected by the GIL rather than m_critSection
+  PyInterpreterPool   m_interpreters;
+
   // any global events that scripts should be using
   CEvent m_globalEvent;
 
@@ -128,3 +161,15 @@ private:
 };
 
 extern XBPython g_pythonParser;
+
+/*! \brief Runs XBPython::BenchmarkInterpreterPool on a job thread
+ */
+class CPythonBenchmarkJob : public CJob
+{
+public:
+  CPythonBenchmarkJob(unsigned int count, unsigned int poolSize) : m_count(count), m_poolSize(poolSize) {}
+  virtual bool DoWork();
+private:
+  unsigned int m_count;
+  unsigned int m_poolSize;
+};
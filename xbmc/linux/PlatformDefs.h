@@ -330,6 +330,8 @@ typedef struct _TIME_ZONE_INFORMATION {
 #define WSAECONNREFUSED ECONNREFUSED
 #define WSAECONNABORTED ECONNABORTED
 #define WSAETIMEDOUT ETIMEDOUT
+#define WSAEINTR EINTR
+#define WSAEWOULDBLOCK EWOULDBLOCK
 
 typedef int SOCKET;
 
@@ -2834,15 +2834,8 @@ bool CMusicDatabase::GetAlbumFromSong(const CSong &song, CAlbum &album)
   return false;
 }
 
-bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, int start, int end)
+CStdString CMusicDatabase::GetAlbumsNavWhere(int idGenre, int idArtist)
 {
-  //Create limit
-  CStdString limit;
-  if (start >= 0 && end >= 0)
-  {
-    limit.Format(" limit %i,%i", start, end);
-  }
-
   // where clause
   CStdString strWhere;
   if (idGenre!=-1)
@@ -2858,7 +2851,7 @@ bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& i
                             "join exgenresong on song.idSong=exgenresong.idSong "
                           "where exgenresong.idGenre=%i"
                           ")"
-                        ") " + limit
+                        ") "
                         , idGenre, idGenre);
   }
 
@@ -2890,18 +2883,36 @@ bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& i
                               "select exartistalbum.idAlbum from exartistalbum " // All albums where extra album artists fit
                               "where exartistalbum.idArtist=%i"
                             ")"
-                          ") " + limit
+                          ") "
                           , idArtist, idArtist, idArtist, idArtist);
   }
   else
   { // no artist given, so exclude any single albums (aka empty tagged albums)
     if (strWhere.IsEmpty())
-      strWhere += "where albumview.strAlbum <> ''" + limit;
+      strWhere += "where albumview.strAlbum <> ''";
     else
-      strWhere += "and albumview.strAlbum <> ''" + limit;
+      strWhere += "and albumview.strAlbum <> ''";
   }
 
-  bool bResult = GetAlbumsByWhere(strBaseDir, strWhere, "", items);
+  return strWhere;
+}
+
+int CMusicDatabase::GetAlbumsNavCount(int idGenre, int idArtist)
+{
+  return GetRowCount("albumview", GetAlbumsNavWhere(idGenre, idArtist));
+}
+
+bool CMusicDatabase::GetAlbumsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, int start, int end, const CStdString &order /* = "" */)
+{
+  CStdString strOrder;
+  if (!order.IsEmpty())
+    strOrder = " " + order;
+
+  //Create limit
+  if (start >= 0 && end >= 0)
+    strOrder.AppendFormat(" limit %i,%i", start, end);
+
+  bool bResult = GetAlbumsByWhere(strBaseDir, GetAlbumsNavWhere(idGenre, idArtist), strOrder, items);
   if (bResult && idArtist != -1)
   {
     CStdString strArtist = GetArtistById(idArtist);
@@ -3032,7 +3043,7 @@ bool CMusicDatabase::GetSongsByYear(const CStdString& baseDir, CFileItemList& it
   return GetSongsByWhere(baseDir, where, items);
 }
 
-bool CMusicDatabase::GetSongsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist,int idAlbum)
+CStdString CMusicDatabase::GetSongsNavWhere(int idGenre, int idArtist, int idAlbum)
 {
   CStdString strWhere;
 
@@ -3086,6 +3097,20 @@ bool CMusicDatabase::GetSongsNav(const CStdString& strBaseDir, CFileItemList& it
                           , idArtist, idArtist, idArtist, idArtist);
   }
 
+  return strWhere;
+}
+
+int CMusicDatabase::GetSongsNavCount(int idGenre, int idArtist, int idAlbum)
+{
+  return GetRowCount("songview", GetSongsNavWhere(idGenre, idArtist, idAlbum));
+}
+
+bool CMusicDatabase::GetSongsNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idArtist, int idAlbum, const CStdString &order /* = "" */)
+{
+  CStdString strWhere = GetSongsNavWhere(idGenre, idArtist, idAlbum);
+  if (!order.IsEmpty())
+    strWhere += " " + order;
+
   // run query
   bool bResult = GetSongsByWhere(strBaseDir, strWhere, items);
   if (bResult && idArtist != -1)
@@ -20,11 +20,9 @@
  */
 
 #include "APEv2Tag.h"
-#include "filesystem/File.h"
+#include "TagFileReader.h"
 #include <climits>
 
-using namespace XFILE;
-
 struct _ape_file_io
 {
   size_t (*read_func)  (void *ptr, size_t size, size_t nmemb, void *datasource);
@@ -37,19 +35,19 @@ using namespace MUSIC_INFO;
 
 size_t CAPEv2Tag::fread_callback(void *ptr, size_t size, size_t nmemb, void *fp)
 {
-  CFile *file = (CFile *)fp;
+  CTagFileReader *file = (CTagFileReader *)fp;
   return file->Read(ptr, size * nmemb) / size;
 }
 
 int CAPEv2Tag::fseek_callback(void *fp, long int offset, int whence)
 {
-  CFile *file = (CFile *)fp;
+  CTagFileReader *file = (CTagFileReader *)fp;
   return (file->Seek(offset, whence) >= 0) ? 0 : -1;
 }
 
 long CAPEv2Tag::ftell_callback(void *fp)
 {
-  CFile *file = (CFile *)fp;
+  CTagFileReader *file = (CTagFileReader *)fp;
   int64_t pos = file->GetPosition();
   if(pos > LONG_MAX)
     return -1;
@@ -71,15 +69,22 @@ CAPEv2Tag::~CAPEv2Tag()
 
 bool CAPEv2Tag::ReadTag(const char* filename)
 {
-  if (!filename || !m_dll.Load())
+  if (!filename)
     return false;
 
-  // Read in our tag using our dll
-  apetag *tag = m_dll.apetag_init();
-
-  CFile file;
+  CTagFileReader file;
   if (!file.Open(filename))
     return false;
+  return ReadTag(file);
+}
+
+bool CAPEv2Tag::ReadTag(CTagFileReader& file)
+{
+  if (!m_dll.Load())
+    return false;
+
+  // Read in our tag using our dll
+  apetag *tag = m_dll.apetag_init();
 
   // Create our file reading class
   ape_file file_api;
@@ -89,7 +94,7 @@ bool CAPEv2Tag::ReadTag(const char* filename)
   file_api.tell_func = ftell_callback;
   file_api.data = &file;
 
-  m_dll.apetag_read_fp(tag, &file_api, (char *)filename, 0);
+  m_dll.apetag_read_fp(tag, &file_api, (char *)file.GetFileName().c_str(), 0);
   if (!tag)
     return false;
 
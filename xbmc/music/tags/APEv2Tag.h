@@ -30,12 +30,15 @@ namespace MUSIC_INFO
 
 #pragma once
 
+class CTagFileReader;
+
 class CAPEv2Tag
 {
 public:
   CAPEv2Tag(void);
   virtual ~CAPEv2Tag(void);
   bool ReadTag(const char* filename);
+  bool ReadTag(CTagFileReader& file);
   CStdString GetTitle() { return m_strTitle; }
   CStdString GetArtist() { return m_strArtist; }
   CStdString GetYear() { return m_strYear; }
@@ -28,6 +28,7 @@
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
 #include "ThumbnailCache.h"
+#include "TagFileReader.h"
 
 #include <set>
 
@@ -75,27 +76,103 @@ id3_ucs4_t* CID3Tag::StringCharsetToUcs4(const CStdString& str) const
 }
 
 bool CID3Tag::Read(const CStdString& strFile)
+{
+  CTagFileReader file;
+  if (!file.Open(strFile))
+    return false;
+  return Read(file);
+}
+
+bool CID3Tag::Read(CTagFileReader& file)
 {
   m_dll.Load();
 
-  CTag::Read(strFile);
+  CTag::Read(file.GetFileName());
 
-  id3_file* id3file = m_dll.id3_file_open(strFile.c_str(), ID3_FILE_MODE_READONLY);
-  if (!id3file)
+  // Collect the tags in the same order as id3_file_open() does: an ID3v1 tag, ID3v2 tags
+  // at the start of the file following any SEEK frames, and an ID3v2 tag appended before
+  // the ID3v1 tag. Both ends of the file are buffered, so this costs no further reads.
+  id3_tag* primary = m_dll.id3_tag_new();
+  if (!primary)
     return false;
 
-  m_tag = m_dll.id3_file_tag(id3file);
-  if (!m_tag)
-    return false;
+  vector<FileTag> tags;
+  int64_t length = file.GetLength();
+  bool hasID3v1 = length >= 128 && AddTag(file, length - 128, primary, tags) == 128;
+
+  int64_t location = 0;
+  long seek = -1;
+  long size = AddTag(file, location, primary, tags, &seek);
+  while (size > 0 && seek >= 0)
+  {
+    location += size + seek;
+    size = AddTag(file, location, primary, tags, &seek);
+  }
+
+  int64_t footer = length - (hasID3v1 ? 128 : 0) - 10;
+  if (footer > 0)
+  {
+    size = AddTag(file, footer, primary, tags);
+    if (size < 0)
+      AddTag(file, footer + size, primary, tags);
+  }
 
-  m_musicInfoTag.SetURL(strFile);
+  m_tag = primary;
+  m_musicInfoTag.SetURL(file.GetFileName());
 
   Parse();
 
-  m_dll.id3_file_close(id3file);
+  m_dll.id3_tag_delete(primary);
+  m_tag = NULL;
   return true;
 }
 
+// Read the tag at location, if there is one, into the primary tag. As with id3_file_open(),
+// a tag replaces the frames read so far unless it's marked as an update of them. Returns the
+// size of the tag, or for a footer minus the offset of its tag's header, 0 if there's no tag.
+long CID3Tag::AddTag(CTagFileReader& file, int64_t location, id3_tag* primary, vector<FileTag>& tags, long* seek)
+{
+  if (seek)
+    *seek = -1;
+
+  id3_byte_t query[ID3_TAG_QUERYSIZE];
+  if (file.Seek(location) != location || file.Read(query, ID3_TAG_QUERYSIZE) != ID3_TAG_QUERYSIZE)
+    return 0;
+  long size = m_dll.id3_tag_query(query, ID3_TAG_QUERYSIZE);
+  if (size <= 0)
+    return size;
+
+  // skip tags we have already read (eg by following a SEEK frame) and overlapping ones
+  for (vector<FileTag>::const_iterator i = tags.begin(); i != tags.end(); ++i)
+  {
+    if (location < i->location + i->length && location + size > i->location)
+      return 0;
+  }
+
+  vector<id3_byte_t> data(size);
+  if (file.Seek(location) != location || file.Read(&data[0], size) != (unsigned int)size)
+    return 0;
+  FileTag fileTag = { location, size };
+  tags.push_back(fileTag);
+
+  id3_tag* tag = m_dll.id3_tag_parse(&data[0], size);
+  if (!tag)
+    return size;
+
+  if (!(tag->extendedflags & ID3_TAG_EXTENDEDFLAG_TAGISANUPDATE))
+    m_dll.id3_tag_clearframes(primary);
+  id3_frame* frame;
+  for (unsigned int i = 0; (frame = m_dll.id3_tag_findframe(tag, NULL, i)); i++)
+    m_dll.id3_tag_attachframe(primary, frame);
+
+  if (seek && (frame = m_dll.id3_tag_findframe(tag, "SEEK", 0)))
+    *seek = m_dll.id3_field_getint(m_dll.id3_frame_field(frame, 0));
+
+  // the frames are reference counted, so they stay with the primary tag
+  m_dll.id3_tag_delete(tag);
+  return size;
+}
+
 bool CID3Tag::Parse()
 {
   ParseReplayGainInfo();
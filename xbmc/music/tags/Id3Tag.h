@@ -22,20 +22,31 @@
 #include "Tag.h"
 #include "DllLibid3tag.h"
 
+#include <vector>
+
 namespace MUSIC_INFO
 {
 
+class CTagFileReader;
+
 class CID3Tag : public CTag
 {
 public:
   CID3Tag(void);
   virtual ~CID3Tag(void);
   virtual bool Read(const CStdString& strFile);
+  bool Read(CTagFileReader& file);
   virtual bool Write(const CStdString& strFile);
 
   CStdString ParseMP3Genre(const CStdString& str) const;
 
 protected:
+  struct FileTag
+  {
+    int64_t location;
+    long length;
+  };
+  long AddTag(CTagFileReader& file, int64_t location, id3_tag* primary, std::vector<FileTag>& tags, long* seek = NULL);
   bool Parse();
   void ParseReplayGainInfo();
 
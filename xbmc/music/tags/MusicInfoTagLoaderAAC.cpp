@@ -20,7 +20,7 @@
  */
 
 #include "MusicInfoTagLoaderAAC.h"
-#include "filesystem/File.h"
+#include "TagFileReader.h"
 
 #define PACK_UINT32(a,b,c,d) \
   ((((uint32_t)a) << 24) | \
@@ -43,28 +43,23 @@ CMusicInfoTagLoaderAAC::CMusicInfoTagLoaderAAC(void)
 CMusicInfoTagLoaderAAC::~CMusicInfoTagLoaderAAC()
 {}
 
-int CMusicInfoTagLoaderAAC::ReadDuration(const CStdString& strFileName)
+int CMusicInfoTagLoaderAAC::ReadDuration(CTagFileReader& file)
 {
   int duration  = 0;
-  XFILE::CFile file;
-  if (file.Open(strFileName))
-  {
-    int tagOffset = ReadID3Length(file);
-
-    if ((duration = ReadMP4Duration(file, tagOffset, 0)))
-    {}
-    else if ((duration = ReadADTSDuration(file, tagOffset)))
-    {}
-    else if ((duration = ReadADIFDuration(file, tagOffset)))
-    {}
-    
-    file.Close();
-  }
+  file.Seek(0);
+  int tagOffset = ReadID3Length(file);
+
+  if ((duration = ReadMP4Duration(file, tagOffset, 0)))
+  {}
+  else if ((duration = ReadADTSDuration(file, tagOffset)))
+  {}
+  else if ((duration = ReadADIFDuration(file, tagOffset)))
+  {}
 
   return duration;
 }
 
-int CMusicInfoTagLoaderAAC::ReadID3Length(XFILE::CFile& file)
+int CMusicInfoTagLoaderAAC::ReadID3Length(CTagFileReader& file)
 {
   char  buf[10]   = {};
   int   tagLength = 0;
@@ -79,7 +74,7 @@ int CMusicInfoTagLoaderAAC::ReadID3Length(XFILE::CFile& file)
   return 0;
 }
 
-int CMusicInfoTagLoaderAAC::ReadADTSDuration(XFILE::CFile& file, int offset)
+int CMusicInfoTagLoaderAAC::ReadADTSDuration(CTagFileReader& file, int offset)
 {
   uint8_t buf[10]       = {};
   uint64_t totalLength  = 0;
@@ -107,7 +102,7 @@ int CMusicInfoTagLoaderAAC::ReadADTSDuration(XFILE::CFile& file, int offset)
   return ((int)framesPerSec) ? (int)((float)frames/framesPerSec) : 0;
 }
 
-int CMusicInfoTagLoaderAAC::ReadADIFDuration(XFILE::CFile& file, int offset)
+int CMusicInfoTagLoaderAAC::ReadADIFDuration(CTagFileReader& file, int offset)
 {
   uint8_t buf[17]   = {};
   int skip          = 0;
@@ -131,7 +126,7 @@ int CMusicInfoTagLoaderAAC::ReadADIFDuration(XFILE::CFile& file, int offset)
   return (bitrate) ? (int)(((float)fileLen*8.f)/(float)(bitrate)) : 0;
 }
 
-int CMusicInfoTagLoaderAAC::ReadMP4Duration(XFILE::CFile& file, int64_t position, int64_t endPosition)
+int CMusicInfoTagLoaderAAC::ReadMP4Duration(CTagFileReader& file, int64_t position, int64_t endPosition)
 {
   uint8_t buf[8] = {};
 
@@ -22,11 +22,6 @@
 
 #include "MusicInfoTagLoaderMP3.h"
 
-namespace XFILE
-{
-  class CFile;
-}
-
 namespace MUSIC_INFO
 {
 
@@ -36,10 +31,10 @@ public:
   CMusicInfoTagLoaderAAC(void);
   virtual ~CMusicInfoTagLoaderAAC();
 private:
-  virtual int ReadDuration(const CStdString& strFileName);
-  int ReadID3Length(XFILE::CFile& file);
-  int ReadADTSDuration(XFILE::CFile& file, int offset);
-  int ReadADIFDuration(XFILE::CFile& file, int offset);
-  int ReadMP4Duration(XFILE::CFile& file, int64_t position, int64_t endPosition);
+  virtual int ReadDuration(CTagFileReader& file);
+  int ReadID3Length(CTagFileReader& file);
+  int ReadADTSDuration(CTagFileReader& file, int offset);
+  int ReadADIFDuration(CTagFileReader& file, int offset);
+  int ReadMP4Duration(CTagFileReader& file, int64_t position, int64_t endPosition);
 };
 }
@@ -22,8 +22,8 @@
 #include "MusicInfoTagLoaderMP3.h"
 #include "APEv2Tag.h"
 #include "Id3Tag.h"
+#include "TagFileReader.h"
 #include "settings/AdvancedSettings.h"
-#include "filesystem/File.h"
 #include "utils/log.h"
 
 using namespace MUSIC_INFO;
@@ -63,7 +63,6 @@ using namespace MUSIC_INFO;
 #define EMPHASIS_MASK 3
 
 using namespace MUSIC_INFO;
-using namespace XFILE;
 
 CMusicInfoTagLoaderMP3::CMusicInfoTagLoaderMP3(void)
 {
@@ -78,10 +77,18 @@ bool CMusicInfoTagLoaderMP3::Load(const CStdString& strFileName, CMusicInfoTag&
 {
   try
   {
+    // the ID3 and APEv2 tags and the duration are all read from the one opened file
+    CTagFileReader file;
+    if (!file.Open(strFileName))
+    {
+      tag.SetLoaded(false);
+      return false;
+    }
+
     // retrieve the ID3 Tag info from strFileName
     // and put it in tag
     CID3Tag id3tag;
-    if (id3tag.Read(strFileName))
+    if (id3tag.Read(file))
     {
       id3tag.GetMusicInfoTag(tag);
       m_replayGainInfo=id3tag.GetReplayGain();
@@ -90,7 +97,7 @@ bool CMusicInfoTagLoaderMP3::Load(const CStdString& strFileName, CMusicInfoTag&
 #ifndef ARMEL_ // TODO this will probably be OK next time we sync to trunk
     // Check for an APEv2 tag
     CAPEv2Tag apeTag;
-    if (PrioritiseAPETags() && apeTag.ReadTag(strFileName.c_str()))
+    if (PrioritiseAPETags() && apeTag.ReadTag(file))
     { // found - let's copy over the additional info (if any)
       if (apeTag.GetArtist().size())
       {
@@ -137,7 +144,7 @@ bool CMusicInfoTagLoaderMP3::Load(const CStdString& strFileName, CMusicInfoTag&
         tag.SetRating(apeTag.GetRating());
     }
 #endif
-    tag.SetDuration(ReadDuration(strFileName));
+    tag.SetDuration(ReadDuration(file));
 
     return tag.Loaded();
   }
@@ -152,10 +159,14 @@ bool CMusicInfoTagLoaderMP3::Load(const CStdString& strFileName, CMusicInfoTag&
 
 bool CMusicInfoTagLoaderMP3::ReadSeekAndReplayGainInfo(const CStdString &strFileName)
 {
+  CTagFileReader file;
+  if (!file.Open(strFileName))
+    return false;
+
 #ifndef ARMEL_ // TODO this will probably be OK next time we sync to trunk
   // First check for an APEv2 tag
   CAPEv2Tag apeTag;
-  if (apeTag.ReadTag(strFileName.c_str()))
+  if (apeTag.ReadTag(file))
   { // found - let's copy over the additional info (if any)
     if (apeTag.GetReplayGain().iHasGainInfo)
       m_replayGainInfo = apeTag.GetReplayGain();
@@ -164,7 +175,7 @@ bool CMusicInfoTagLoaderMP3::ReadSeekAndReplayGainInfo(const CStdString &strFile
   if (!m_replayGainInfo.iHasGainInfo)
   { // Nothing found query id3 tag
     CID3Tag id3tag;
-    if (id3tag.Read(strFileName))
+    if (id3tag.Read(file))
     {
       if (id3tag.GetReplayGain().iHasGainInfo)
         m_replayGainInfo = id3tag.GetReplayGain();
@@ -172,7 +183,7 @@ bool CMusicInfoTagLoaderMP3::ReadSeekAndReplayGainInfo(const CStdString &strFile
   }
 
   // now read the duration
-  int duration = ReadDuration(strFileName);
+  int duration = ReadDuration(file);
 
   return duration>0 ? true : false;
 }
@@ -227,7 +238,7 @@ int CMusicInfoTagLoaderMP3::IsMp3FrameHeader(unsigned long head)
 //TODO: merge duplicate, but slitely different implemented) code and consts in IsMp3FrameHeader(above) and ReadDuration (below).
 
 // Inspired by http://rockbox.haxx.se/ and http://www.xs4all.nl/~rwvtveer/scilla
-int CMusicInfoTagLoaderMP3::ReadDuration(const CStdString& strFileName)
+int CMusicInfoTagLoaderMP3::ReadDuration(CTagFileReader& file)
 {
 #define SCANSIZE  8192
 #define CHECKNUMFRAMES 5
@@ -246,10 +257,6 @@ int CMusicInfoTagLoaderMP3::ReadDuration(const CStdString& strFileName)
     };
 
 
-  CFile file;
-  if (!file.Open(strFileName))
-    return 0;
-
   /* Check if the file has an ID3v1 tag */
   file.Seek(file.GetLength()-128, SEEK_SET);
   file.Read(buffer, 3);
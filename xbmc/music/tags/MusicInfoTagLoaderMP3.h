@@ -27,6 +27,8 @@
 namespace MUSIC_INFO
 {
 
+class CTagFileReader;
+
 class CVBRMP3SeekHelper
 {
 public:
@@ -119,7 +121,7 @@ public:
   bool ReadSeekAndReplayGainInfo(const CStdString &strFileName);
   static unsigned int IsID3v2Header(unsigned char* pBuf, size_t bufLen);
 protected:
-  virtual int ReadDuration(const CStdString& strFileName);
+  virtual int ReadDuration(CTagFileReader& file);
   bool ReadLAMETagInfo(unsigned char *p);
   int IsMp3FrameHeader(unsigned long head);
   virtual bool PrioritiseAPETags() const;
@@ -20,6 +20,7 @@
  */
 
 #include "MusicInfoTagLoaderWavPack.h"
+#include "TagFileReader.h"
 #include "cores/paplayer/DVDPlayerCodec.h"
 
 
@@ -31,10 +32,10 @@ CMusicInfoTagLoaderWAVPack::CMusicInfoTagLoaderWAVPack(void)
 CMusicInfoTagLoaderWAVPack::~CMusicInfoTagLoaderWAVPack()
 {}
 
-int CMusicInfoTagLoaderWAVPack::ReadDuration(const CStdString& strFileName)
+int CMusicInfoTagLoaderWAVPack::ReadDuration(CTagFileReader& file)
 {
   DVDPlayerCodec codec;
-  if (codec.Init(strFileName, 4096))
+  if (codec.Init(file.GetFileName(), 4096))
   {
     return (int)((codec.m_TotalTime + 500) / 1000);
   }
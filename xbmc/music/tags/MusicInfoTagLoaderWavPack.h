@@ -32,6 +32,6 @@ public:
   virtual ~CMusicInfoTagLoaderWAVPack();
 private:
   virtual bool PrioritiseAPETags() const;
-  virtual int ReadDuration(const CStdString& strFileName);
+  virtual int ReadDuration(CTagFileReader& file);
 };
 }
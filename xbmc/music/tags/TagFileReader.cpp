@@ -0,0 +1,181 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "TagFileReader.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace MUSIC_INFO;
+
+// Read from either end of a file on open. Big enough for an ID3v2 tag without
+// embedded pictures plus the first frames, or an APEv2 tag plus an ID3v1 tag.
+#define TAG_BLOCK_SIZE 65536
+
+CTagFileReader::CTagFileReader()
+{
+  m_length = 0;
+  m_position = 0;
+  m_requests = 0;
+  m_bytesRead = 0;
+}
+
+CTagFileReader::~CTagFileReader()
+{
+  Close();
+}
+
+bool CTagFileReader::Open(const CStdString &strFileName)
+{
+  Close();
+  m_strFileName = strFileName;
+  m_requests = 1;
+  if (!m_file.Open(strFileName))
+    return false;
+
+  m_length = m_file.GetLength();
+  if (m_length <= 0)
+    return true;
+
+  // small files are read whole, others a block from either end
+  unsigned int headSize = m_length <= 2 * TAG_BLOCK_SIZE ? (unsigned int)m_length : TAG_BLOCK_SIZE;
+  m_head.data.resize(headSize);
+  m_head.data.resize(Fill(&m_head.data[0], 0, headSize));
+
+  m_tail.start = m_length;
+  if (m_head.End() < m_length)
+  {
+    m_tail.start = m_length - TAG_BLOCK_SIZE;
+    m_tail.data.resize(TAG_BLOCK_SIZE);
+    unsigned int read = Fill(&m_tail.data[0], m_tail.start, TAG_BLOCK_SIZE);
+    if (read < TAG_BLOCK_SIZE)
+    {
+      m_tail.start = m_length;
+      m_tail.data.clear();
+    }
+  }
+  return true;
+}
+
+void CTagFileReader::Close()
+{
+  if (!m_strFileName.IsEmpty())
+    CLog::Log(LOGDEBUG, "%s - %s: %u requests, %"PRId64" bytes read", __FUNCTION__, m_strFileName.c_str(), m_requests, m_bytesRead);
+
+  m_file.Close();
+  m_strFileName.clear();
+  m_length = 0;
+  m_position = 0;
+  m_head = Block();
+  m_tail = Block();
+  m_requests = 0;
+  m_bytesRead = 0;
+}
+
+unsigned int CTagFileReader::Read(void *lpBuf, int64_t uiBufSize)
+{
+  if (uiBufSize <= 0 || m_position < 0 || m_position >= m_length)
+    return 0;
+
+  unsigned int size = (unsigned int)std::min(uiBufSize, m_length - m_position);
+  unsigned int read = ReadAt(m_position, (unsigned char *)lpBuf, size);
+  m_position += read;
+  return read;
+}
+
+int64_t CTagFileReader::Seek(int64_t iFilePosition, int iWhence)
+{
+  int64_t position;
+  switch (iWhence)
+  {
+  case SEEK_SET:
+    position = iFilePosition;
+    break;
+  case SEEK_CUR:
+    position = m_position + iFilePosition;
+    break;
+  case SEEK_END:
+    position = m_length + iFilePosition;
+    break;
+  default:
+    return -1;
+  }
+  if (position < 0)
+    return -1;
+  m_position = position;
+  return m_position;
+}
+
+unsigned int CTagFileReader::ReadAt(int64_t position, unsigned char *buffer, unsigned int size)
+{
+  if (!m_head.Contains(position, size) && !m_tail.Contains(position, size))
+  {
+    if (position <= m_head.End())
+    { // continues on from the head, eg past a large ID3v2 tag - grow the head
+      int64_t end = std::min(m_length, std::max(position + size, m_head.End() + TAG_BLOCK_SIZE));
+      size_t old = m_head.data.size();
+      m_head.data.resize((size_t)(end - m_head.start));
+      m_head.data.resize(old + Fill(&m_head.data[old], m_head.start + old, (unsigned int)(end - m_head.start - old)));
+    }
+    else if (position + size >= m_tail.start && !m_tail.data.empty())
+    { // runs into the tail, eg a large APEv2 tag - grow the tail
+      int64_t start = std::max(m_head.End(), std::min(position, m_tail.start - TAG_BLOCK_SIZE));
+      std::vector<unsigned char> data((size_t)(m_tail.start - start));
+      if (Fill(&data[0], start, data.size()) < data.size())
+        return 0;
+      m_tail.data.insert(m_tail.data.begin(), data.begin(), data.end());
+      m_tail.start = start;
+    }
+    else
+    { // somewhere in the middle, read it as is
+      return Fill(buffer, position, size);
+    }
+  }
+
+  // the blocks may overlap once grown, so prefer the one holding all of it
+  const Block *block = m_head.Contains(position, size) ? &m_head : &m_tail;
+  if (!block->Contains(position, size))
+    block = m_head.Contains(position, 1) ? &m_head : &m_tail; // the file ended early
+  if (!block->Contains(position, 1))
+    return 0;
+  unsigned int available = std::min(size, (unsigned int)(block->End() - position));
+  memcpy(buffer, &block->data[(size_t)(position - block->start)], available);
+  return available;
+}
+
+unsigned int CTagFileReader::Fill(unsigned char *buffer, int64_t position, unsigned int size)
+{
+  if (m_file.Seek(position, SEEK_SET) != position)
+    return 0;
+
+  unsigned int done = 0;
+  while (done < size)
+  {
+    m_requests++;
+    unsigned int read = m_file.Read(buffer + done, size - done);
+    if (read == 0)
+      break;
+    done += read;
+  }
+  m_bytesRead += done;
+  return done;
+}
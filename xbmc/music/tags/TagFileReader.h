@@ -0,0 +1,87 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+#include "filesystem/File.h"
+
+#include <vector>
+
+namespace MUSIC_INFO
+{
+
+/*!
+ \brief Read access to a music file for the tag parsers.
+
+ Tags live at the start of a file (ID3v2, the Xing/VBRI/LAME headers in the first
+ frames) and at its end (ID3v1, APEv2, appended ID3v2). Each parser opening the file
+ and seeking around in it costs a round trip per open and read on a network share,
+ so the file is opened once and a block is read from either end up front. Reads that
+ fall within, or continue on from, those blocks are answered from memory; anything
+ else is read from the still open file.
+
+ Reading mirrors CFile, so code written against CFile can use it unchanged.
+ */
+class CTagFileReader
+{
+public:
+  CTagFileReader();
+  ~CTagFileReader();
+
+  bool Open(const CStdString &strFileName);
+  void Close();
+
+  unsigned int Read(void *lpBuf, int64_t uiBufSize);
+  int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET);
+  int64_t GetPosition() const { return m_position; };
+  int64_t GetLength() const { return m_length; };
+  const CStdString &GetFileName() const { return m_strFileName; };
+
+  /*! \brief Number of opens and reads sent to the file so far. */
+  unsigned int GetRequests() const { return m_requests; };
+  /*! \brief Number of bytes read from the file so far. */
+  int64_t GetBytesRead() const { return m_bytesRead; };
+
+private:
+  struct Block
+  {
+    Block() : start(0) {};
+    int64_t End() const { return start + data.size(); };
+    bool Contains(int64_t position, unsigned int size) const { return position >= start && position + size <= End(); };
+
+    int64_t start;
+    std::vector<unsigned char> data;
+  };
+
+  unsigned int ReadAt(int64_t position, unsigned char *buffer, unsigned int size);
+  unsigned int Fill(unsigned char *buffer, int64_t position, unsigned int size);
+
+  XFILE::CFile m_file;
+  CStdString   m_strFileName;
+  int64_t      m_length;
+  int64_t      m_position;
+  Block        m_head;
+  Block        m_tail;
+
+  unsigned int m_requests;
+  int64_t      m_bytesRead;
+};
+}
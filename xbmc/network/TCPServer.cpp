@@ -10,7 +10,17 @@
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
+#include "utils/TimeUtils.h"
 #include "threads/SingleLock.h"
+#include <errno.h>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define HAS_EPOLL
+#endif
 
 static const char     bt_service_name[] = "XBMC JSON-RPC";
 static const char     bt_service_desc[] = "Interface for XBMC remote control over bluetooth";
@@ -33,7 +43,19 @@ using namespace JSONRPC;
 using namespace ANNOUNCEMENT;
 //using namespace std; On VS2010, bind conflicts with std::bind
 
-#define RECEIVEBUFFER 1024
+#define RECEIVEBUFFER 16384
+// events handled per epoll_wait()
+#define MAX_EVENTS 64
+
+// announcements are dropped for clients with more than this much output queued
+#define MAX_QUEUED_OUTPUT (512 * 1024)
+// clients whose queued output doesn't move for this long are disconnected
+#define STALLED_CLIENT_TIMEOUT 30000
+
+#ifdef _WIN32
+// winsock has no non-blocking sends, the socket is made non-blocking while queued output is flushed
+#define MSG_DONTWAIT 0
+#endif
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -69,86 +91,280 @@ CTCPServer::CTCPServer(int port, bool nonlocal)
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_epoll = -1;
+  m_wakeup[0] = m_wakeup[1] = -1;
+
+#ifdef HAS_EPOLL
+  m_epoll = epoll_create(MAX_EVENTS);
+  if (m_epoll < 0)
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to create epoll set, falling back to select");
+  else if (pipe(m_wakeup) == 0)
+  {
+    fcntl(m_wakeup[0], F_SETFL, O_NONBLOCK);
+    fcntl(m_wakeup[1], F_SETFL, O_NONBLOCK);
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = m_wakeup[0];
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup[0], &event);
+  }
+  else
+  {
+    // without the wakeup pipe the epoll loop can't be interrupted
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to create wakeup pipe, falling back to select");
+    close(m_epoll);
+    m_epoll = -1;
+    m_wakeup[0] = m_wakeup[1] = -1;
+  }
+#endif
+}
+
+CTCPServer::~CTCPServer()
+{
+#ifdef HAS_EPOLL
+  if (m_wakeup[0] >= 0)
+  {
+    close(m_wakeup[0]);
+    close(m_wakeup[1]);
+  }
+  if (m_epoll >= 0)
+    close(m_epoll);
+#endif
+}
+
+void CTCPServer::StopThread(bool bWait /* = true */)
+{
+  m_bStop = true;
+  Wake();
+  CThread::StopThread(bWait);
+}
+
+void CTCPServer::Wake()
+{
+#ifdef HAS_EPOLL
+  if (m_wakeup[1] >= 0)
+  {
+    char c = 0;
+    if (write(m_wakeup[1], &c, 1) < 0 && errno != EAGAIN)
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to wake the server thread");
+  }
+#endif
 }
 
 void CTCPServer::Process()
 {
   m_bStop = false;
 
+  std::vector<SocketEvent> events;
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
-
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
-    {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
-    }
-
-    for (unsigned int i = 0; i < m_connections.size(); i++)
-    {
-      FD_SET(m_connections[i].m_socket, &rfds);
-      if ((intptr_t)m_connections[i].m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i].m_socket;
-    }
-
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+    events.clear();
+    if (!WaitForEvents(events))
     {
       CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
       Sleep(1000);
       Initialize();
+      continue;
     }
-    else if (res > 0)
+
+    for (std::vector<SocketEvent>::iterator event = events.begin(); event != events.end(); ++event)
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
+      if (std::find(m_servers.begin(), m_servers.end(), event->socket) != m_servers.end())
+      {
+        if (event->readable)
+          AcceptConnection(event->socket);
+        continue;
+      }
+
+      // the client may have gone with an earlier event
+      Connections::iterator it = m_connections.find(event->socket);
+      if (it == m_connections.end())
+        continue;
+      CTCPClient *client = it->second;
+
+      if (event->writable)
       {
-        int socket = m_connections[i].m_socket;
-        if (FD_ISSET(socket, &rfds))
+        CSingleLock lock (client->m_critSection);
+        if (!client->FlushOutput(false))
         {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          if (nread > 0)
-          {
-            m_connections[i].PushBuffer(this, buffer, nread);
-          }
-          if (nread <= 0)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i].Disconnect();
-            m_connections.erase(m_connections.begin() + i);
-          }
+          CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+          lock.Leave();
+          RemoveConnection(it);
+          continue;
         }
+        lock.Leave();
+        client->UpdateWriteInterest(m_epoll);
       }
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+      if (event->readable)
       {
-        if (FD_ISSET(*it, &rfds))
+        char buffer[RECEIVEBUFFER];
+        int nread = recv(event->socket, buffer, RECEIVEBUFFER, 0);
+        if (nread > 0)
+        {
+          client->PushBuffer(this, buffer, nread);
+          client->UpdateWriteInterest(m_epoll);
+        }
+        else
         {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient newconnection;
-          newconnection.m_socket = accept(*it, (sockaddr*)&newconnection.m_cliaddr, &newconnection.m_addrlen);
-
-          if (newconnection.m_socket == INVALID_SOCKET)
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed");
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
+          CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+          RemoveConnection(it);
         }
       }
     }
+
+    unsigned int now = CTimeUtils::GetTimeMS();
+    for (Connections::iterator it = m_connections.begin(); it != m_connections.end(); )
+    {
+      Connections::iterator next = it;
+      ++next;
+      if (it->second->IsStalled(now))
+      {
+        CLog::Log(LOGWARNING, "JSONRPC Server: Disconnecting a client that stopped reading its announcements");
+        RemoveConnection(it);
+      }
+      it = next;
+    }
   }
 
   Deinitialize();
 }
 
+bool CTCPServer::WaitForEvents(std::vector<SocketEvent> &events)
+{
+#ifdef HAS_EPOLL
+  if (m_epoll >= 0)
+  {
+    // only wake up regularly while there's output queued, to notice stalled clients
+    int timeout = -1;
+    for (Connections::iterator it = m_connections.begin(); it != m_connections.end() && timeout < 0; ++it)
+    {
+      if (it->second->HasOutput())
+        timeout = 1000;
+    }
+
+    struct epoll_event ready[MAX_EVENTS];
+    int count = epoll_wait(m_epoll, ready, MAX_EVENTS, timeout);
+    if (count < 0)
+      return errno == EINTR;
+
+    for (int i = 0; i < count; i++)
+    {
+      if (ready[i].data.fd == m_wakeup[0])
+      {
+        char buffer[64];
+        while (read(m_wakeup[0], buffer, sizeof(buffer)) > 0);
+        continue;
+      }
+
+      SocketEvent event;
+      event.socket   = ready[i].data.fd;
+      event.readable = (ready[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+      event.writable = (ready[i].events & EPOLLOUT) != 0;
+      events.push_back(event);
+    }
+    return true;
+  }
+#endif
+
+  SOCKET          max_fd = 0;
+  fd_set          rfds, wfds;
+  struct timeval  to     = {1, 0};
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+  {
+    FD_SET(*it, &rfds);
+    if ((intptr_t)*it > (intptr_t)max_fd)
+      max_fd = *it;
+  }
+
+  for (Connections::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+  {
+    FD_SET(it->first, &rfds);
+    // wait for clients that couldn't take all their announcements yet
+    if (it->second->HasOutput())
+      FD_SET(it->first, &wfds);
+    if ((intptr_t)it->first > (intptr_t)max_fd)
+      max_fd = it->first;
+  }
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res < 0)
+    return false;
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end() && res > 0; it++)
+  {
+    if (FD_ISSET(*it, &rfds))
+    {
+      SocketEvent event = { *it, true, false };
+      events.push_back(event);
+    }
+  }
+
+  for (Connections::iterator it = m_connections.begin(); it != m_connections.end() && res > 0; ++it)
+  {
+    SocketEvent event = { it->first, FD_ISSET(it->first, &rfds) != 0, FD_ISSET(it->first, &wfds) != 0 };
+    if (event.readable || event.writable)
+      events.push_back(event);
+  }
+  return true;
+}
+
+void CTCPServer::AcceptConnection(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  CTCPClient *newconnection = new CTCPClient();
+  newconnection->m_socket = accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed");
+    delete newconnection;
+    return;
+  }
+
+#ifdef HAS_EPOLL
+  if (m_epoll >= 0)
+  {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = newconnection->m_socket;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, newconnection->m_socket, &event) < 0)
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch new connection");
+      newconnection->Disconnect();
+      delete newconnection;
+      return;
+    }
+  }
+#endif
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+  CSingleLock lock (m_connectionsSection);
+  m_connections[newconnection->m_socket] = newconnection;
+}
+
+void CTCPServer::RemoveConnection(Connections::iterator it)
+{
+  CTCPClient *client = it->second;
+  {
+    CSingleLock lock (m_connectionsSection);
+    m_connections.erase(it);
+  }
+
+#ifdef HAS_EPOLL
+  if (m_epoll >= 0)
+  {
+    struct epoll_event event = {};
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, client->m_socket, &event);
+  }
+#endif
+  client->Disconnect();
+  delete client;
+}
+
 bool CTCPServer::Download(const char *path, CVariant &result)
 {
   return false;
@@ -161,23 +377,34 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(EAnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = AnnouncementToJSON(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  // serialized once, all clients queue the same buffer
+  boost::shared_ptr<std::string> str(new std::string(AnnouncementToJSON(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact)));
 
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+  bool wake = false;
+  CSingleLock lock (m_connectionsSection);
+  for (Connections::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
   {
-    {
-      CSingleLock lock (m_connections[i].m_critSection);
-      if ((m_connections[i].GetAnnouncementFlags() & flag) == 0)
-        continue;
-    }
+    CTCPClient *client = it->second;
+    if ((client->GetAnnouncementFlags() & flag) == 0)
+      continue;
 
-    unsigned int sent = 0;
-    do
-    {
-      CSingleLock lock (m_connections[i].m_critSection);
-      sent += send(m_connections[i].m_socket, str.c_str(), str.size() - sent, sent);
-    } while (sent < str.size());
+    if (!client->QueueOutput(str))
+      continue;
+
+    // send what the socket takes right away, unless a response is being sent,
+    // the rest is sent by Process() once the client reads it
+    CSingleTryLock clientLock (client->m_critSection);
+    if (clientLock.IsOwner())
+      client->FlushOutput(false);
+    clientLock.Leave();
+
+    wake |= client->UpdateWriteInterest(m_epoll);
   }
+  lock.Leave();
+
+  // have Process() keep an eye on clients that didn't take everything
+  if (wake)
+    Wake();
 }
 
 bool CTCPServer::Initialize()
@@ -191,6 +418,15 @@ bool CTCPServer::Initialize()
 
   if(started)
   {
+#ifdef HAS_EPOLL
+    for (unsigned int i = 0; i < m_servers.size() && m_epoll >= 0; i++)
+    {
+      struct epoll_event event = {};
+      event.events = EPOLLIN;
+      event.data.fd = m_servers[i];
+      epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_servers[i], &event);
+    }
+#endif
     CAnnouncementManager::AddAnnouncer(this);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
@@ -420,13 +656,20 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
-    m_connections[i].Disconnect();
-
-  m_connections.clear();
+  while (!m_connections.empty())
+    RemoveConnection(m_connections.begin());
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
+  {
+#ifdef HAS_EPOLL
+    if (m_epoll >= 0)
+    {
+      struct epoll_event event = {};
+      epoll_ctl(m_epoll, EPOLL_CTL_DEL, m_servers[i], &event);
+    }
+#endif
     closesocket(m_servers[i]);
+  }
 
   m_servers.clear();
 
@@ -443,23 +686,17 @@ CTCPServer::CTCPClient::CTCPClient()
 {
   m_announcementflags = ANNOUNCE_ALL;
   m_socket = INVALID_SOCKET;
-  m_beginBrackets = 0;
-  m_endBrackets = 0;
-  m_beginChar = 0;
-  m_endChar = 0;
-
-  m_addrlen = sizeof(m_cliaddr);
-}
+  m_depth = 0;
+  m_inString = false;
+  m_escaped = false;
 
-CTCPServer::CTCPClient::CTCPClient(const CTCPClient& client)
-{
-  Copy(client);
-}
+  m_outputOffset = 0;
+  m_outputSize = 0;
+  m_outputProgress = 0;
+  m_dropped = 0;
+  m_writeInterest = false;
 
-CTCPServer::CTCPClient& CTCPServer::CTCPClient::operator=(const CTCPClient& client)
-{
-  Copy(client);
-  return *this;
+  m_addrlen = sizeof(m_cliaddr);
 }
 
 int CTCPServer::CTCPClient::GetPermissionFlags()
@@ -478,44 +715,98 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
   return true;
 }
 
-void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
+// Sends a response to a client while it is being written. The client is
+// locked from the first part of the response on, so that no announcement
+// can end up in the middle of it, but not while the method is executed.
+// Announcements queued before the response are sent first.
+class CTCPServer::CTCPClientOutput : public IJSONOutput
 {
-  for (int i = 0; i < length; i++)
+public:
+  CTCPClientOutput(CTCPClient &client) : m_client(client), m_locked(false) {}
+  ~CTCPClientOutput()
   {
-    char c = buffer[i];
+    if (m_locked)
+      m_client.m_critSection.unlock();
+  }
 
-    if (m_beginChar == 0 && c == '{')
+  virtual bool Write(const char *data, unsigned int length)
+  {
+    if (!m_locked)
     {
-      m_beginChar = '{';
-      m_endChar = '}';
+      m_client.m_critSection.lock();
+      m_locked = true;
+      if (!m_client.FlushOutput(true))
+        return false;
     }
-    else if (m_beginChar == 0 && c == '[')
+
+    unsigned int sent = 0;
+    while (sent < length)
     {
-      m_beginChar = '[';
-      m_endChar = ']';
+      int result = send(m_client.m_socket, data + sent, length - sent, 0);
+      if (result <= 0)
+        return false;
+      sent += result;
     }
+    return true;
+  }
+
+private:
+  CTCPClient &m_client;
+  bool m_locked;
+};
+
+void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
+{
+  // Requests are framed by following the nesting of the JSON text, skipping
+  // brackets in strings. Anything between requests is ignored. The state is
+  // kept across reads so each byte is only looked at once.
+  int start = m_depth > 0 ? 0 : -1;
+  for (int i = 0; i < length; i++)
+  {
+    char c = buffer[i];
 
-    if (m_beginChar != 0)
+    if (m_depth == 0)
     {
-      m_buffer.push_back(c);
-      if (c == m_beginChar)
-        m_beginBrackets++;
-      else if (c == m_endChar)
-        m_endBrackets++;
-      if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
+      if (c == '{' || c == '[')
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        CSingleLock lock (m_critSection);
-        send(m_socket, line.c_str(), line.size(), 0);
-        m_beginChar = m_beginBrackets = m_endBrackets = 0;
-        m_buffer.clear();
+        start = i;
+        m_depth = 1;
       }
     }
+    else if (m_inString)
+    {
+      if (m_escaped)
+        m_escaped = false;
+      else if (c == '\\')
+        m_escaped = true;
+      else if (c == '"')
+        m_inString = false;
+    }
+    else if (c == '"')
+      m_inString = true;
+    else if (c == '{' || c == '[')
+      m_depth++;
+    else if ((c == '}' || c == ']') && --m_depth == 0)
+    {
+      m_buffer.append(buffer + start, i + 1 - start);
+      start = -1;
+
+      CTCPClientOutput output(*this);
+      if (!CJSONRPC::MethodCall(m_buffer, host, this, output))
+        CLog::Log(LOGWARNING, "JSONRPC Server: Failed to send the response to a client");
+      m_buffer.clear();
+    }
   }
+
+  if (start >= 0)
+    m_buffer.append(buffer + start, length - start);
 }
 
 void CTCPServer::CTCPClient::Disconnect()
 {
+  if (m_dropped)
+    CLog::Log(LOGDEBUG, "JSONRPC Server: %u announcements were dropped for the client", m_dropped);
+
   if (m_socket > 0)
   {
     CSingleLock lock (m_critSection);
@@ -525,16 +816,109 @@ void CTCPServer::CTCPClient::Disconnect()
   }
 }
 
-void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
+bool CTCPServer::CTCPClient::QueueOutput(const boost::shared_ptr<std::string> &buffer)
+{
+  CSingleLock lock (m_outputSection);
+  if (m_outputSize + buffer->size() > MAX_QUEUED_OUTPUT)
+  {
+    if (m_dropped++ == 0)
+      CLog::Log(LOGWARNING, "JSONRPC Server: Client isn't reading its announcements, dropping them");
+    return false;
+  }
+
+  if (m_output.empty())
+    m_outputProgress = CTimeUtils::GetTimeMS();
+  m_output.push_back(buffer);
+  m_outputSize += buffer->size();
+  return true;
+}
+
+bool CTCPServer::CTCPClient::FlushOutput(bool block)
+{
+#ifdef _WIN32
+  unsigned long nonblocking = 1;
+  if (!block)
+    ioctlsocket(m_socket, FIONBIO, &nonblocking);
+#endif
+
+  bool result = true;
+  while (true)
+  {
+    boost::shared_ptr<std::string> buffer;
+    unsigned int offset;
+    {
+      CSingleLock lock (m_outputSection);
+      if (m_output.empty())
+        break;
+      buffer = m_output.front();
+      offset = m_outputOffset;
+    }
+
+    // send without holding the output lock, so announcements can be queued meanwhile.
+    // Only the holder of m_critSection sends, so the front buffer stays put.
+    int sent = send(m_socket, buffer->c_str() + offset, buffer->size() - offset, block ? 0 : MSG_DONTWAIT);
+    if (sent < 0 && WSAGetLastError() == WSAEINTR)
+      continue;
+    if (sent < 0 && !block && WSAGetLastError() == WSAEWOULDBLOCK)
+      break;
+    if (sent <= 0)
+    {
+      result = false;
+      break;
+    }
+
+    CSingleLock lock (m_outputSection);
+    m_outputProgress = CTimeUtils::GetTimeMS();
+    m_outputSize -= sent;
+    m_outputOffset += sent;
+    if (m_outputOffset == buffer->size())
+    {
+      m_output.pop_front();
+      m_outputOffset = 0;
+    }
+  }
+
+#ifdef _WIN32
+  nonblocking = 0;
+  if (!block)
+    ioctlsocket(m_socket, FIONBIO, &nonblocking);
+#endif
+  return result;
+}
+
+bool CTCPServer::CTCPClient::HasOutput()
+{
+  CSingleLock lock (m_outputSection);
+  return !m_output.empty();
+}
+
+bool CTCPServer::CTCPClient::IsStalled(unsigned int now)
 {
-  m_socket            = client.m_socket;
-  m_cliaddr           = client.m_cliaddr;
-  m_addrlen           = client.m_addrlen;
-  m_announcementflags = client.m_announcementflags;
-  m_beginBrackets     = client.m_beginBrackets;
-  m_endBrackets       = client.m_endBrackets;
-  m_beginChar         = client.m_beginChar;
-  m_endChar           = client.m_endChar;
-  m_buffer            = client.m_buffer;
+  CSingleLock lock (m_outputSection);
+  return !m_output.empty() && now - m_outputProgress > STALLED_CLIENT_TIMEOUT;
 }
 
+bool CTCPServer::CTCPClient::UpdateWriteInterest(int epoll)
+{
+#ifdef HAS_EPOLL
+  if (epoll < 0)
+    return false;
+
+  // decided under the output lock, so the last change to the queue wins
+  CSingleLock lock (m_outputSection);
+  bool interest = !m_output.empty();
+  if (interest == m_writeInterest)
+    return false;
+
+  struct epoll_event event = {};
+  event.events = (uint32_t)EPOLLIN | (interest ? (uint32_t)EPOLLOUT : 0);
+  event.data.fd = m_socket;
+  if (epoll_ctl(epoll, EPOLL_CTL_MOD, m_socket, &event) < 0)
+    return false;
+
+  m_writeInterest = interest;
+  return interest;
+#else
+  return false;
+#endif
+}
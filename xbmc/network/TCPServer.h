@@ -1,6 +1,10 @@
 #pragma once
+#include <deque>
+#include <map>
+#include <string>
 #include <vector>
 #include <sys/socket.h>
+#include <boost/shared_ptr.hpp>
 #include "interfaces/IAnnouncer.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/Thread.h"
@@ -19,43 +23,92 @@ namespace JSONRPC
     virtual int GetCapabilities();
 
     virtual void Announce(ANNOUNCEMENT::EAnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+    virtual void StopThread(bool bWait = true);
   protected:
     void Process();
   private:
     CTCPServer(int port, bool nonlocal);
+    virtual ~CTCPServer();
     bool Initialize();
     bool InitializeBlue();
     bool InitializeTCP();
     void Deinitialize();
 
+    struct SocketEvent
+    {
+      SOCKET socket;
+      bool   readable;
+      bool   writable;
+    };
+
+    /*! \brief Wait for sockets to become readable, or writable for clients with queued output.
+     \return false if waiting failed.
+     */
+    bool WaitForEvents(std::vector<SocketEvent> &events);
+    void AcceptConnection(SOCKET server);
+    /*! \brief Interrupt WaitForEvents(). */
+    void Wake();
+
     class CTCPClient : public IClient
     {
     public:
       CTCPClient();
-      //Copying a CCriticalSection is not allowed, so copy everything but that
-      //when adding a member variable, make sure to copy it in CTCPClient::Copy
-      CTCPClient(const CTCPClient& client);
-      CTCPClient& operator=(const CTCPClient& client);
       virtual int  GetPermissionFlags();
       virtual int  GetAnnouncementFlags();
       virtual bool SetAnnouncementFlags(int flags);
       void PushBuffer(CTCPServer *host, const char *buffer, int length);
       void Disconnect();
 
+      /*! \brief Queue an announcement to be sent, dropping it if too much is queued already.
+       The buffer is shared between all clients the announcement goes to.
+       */
+      bool QueueOutput(const boost::shared_ptr<std::string> &buffer);
+      /*! \brief Send queued output, without waiting for the socket unless block is set.
+       Must be called with m_critSection held so the output doesn't end up in the middle of a response.
+       \return false if the socket failed.
+       */
+      bool FlushOutput(bool block);
+      bool HasOutput();
+      /*! \brief Whether queued output hasn't made any progress for too long. */
+      bool IsStalled(unsigned int now);
+      /*! \brief Watch the socket for writability in the given epoll set if output is queued, stop watching otherwise.
+       \return true if the socket wasn't watched for writability before but is now.
+       */
+      bool UpdateWriteInterest(int epoll);
+
       SOCKET           m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t        m_addrlen;
-      CCriticalSection m_critSection;
+      CCriticalSection m_critSection;  ///< held while a response or queued output is sent
 
     private:
-      void Copy(const CTCPClient& client);
+      // copying a CCriticalSection is not allowed
+      CTCPClient(const CTCPClient& client);
+      CTCPClient& operator=(const CTCPClient& client);
+
       int m_announcementflags;
-      int m_beginBrackets, m_endBrackets;
-      char m_beginChar, m_endChar;
+      int m_depth;        ///< nesting depth of the request being received, 0 between requests
+      bool m_inString;    ///< whether the request being received is in a string
+      bool m_escaped;     ///< whether the previous character was an escaping backslash
       std::string m_buffer;
+
+      CCriticalSection m_outputSection;
+      std::deque< boost::shared_ptr<std::string> > m_output;
+      unsigned int m_outputOffset;   ///< bytes of the first buffer already sent
+      unsigned int m_outputSize;     ///< bytes queued and not sent yet
+      unsigned int m_outputProgress; ///< time output was last queued on an empty queue or sent
+      unsigned int m_dropped;        ///< announcements dropped because too much output was queued
+      bool m_writeInterest;          ///< whether the socket is watched for writability
     };
 
-    std::vector<CTCPClient> m_connections;
+    class CTCPClientOutput;
+    typedef std::map<SOCKET, CTCPClient*> Connections;
+    void RemoveConnection(Connections::iterator it);
+
+    Connections m_connections;
+    CCriticalSection m_connectionsSection; ///< held while m_connections is changed by Process() or walked by Announce()
+    int m_epoll;       ///< epoll set of the server and client sockets, -1 where select() is used
+    int m_wakeup[2];   ///< pipe registered with m_epoll to interrupt waiting
     std::vector<SOCKET> m_servers;
     int m_port;
     bool m_nonlocal;
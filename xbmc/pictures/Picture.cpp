@@ -28,13 +28,14 @@
 #include "DllImageLib.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "ThumbnailCache.h"
 
 using namespace XFILE;
 
 bool CPicture::CreateThumbnail(const CStdString& file, const CStdString& thumbFile, bool checkExistence /*= false*/)
 {
   // don't create the thumb if it already exists
-  if (checkExistence && CFile::Exists(thumbFile))
+  if (checkExistence && CThumbnailCache::GetThumbnailCache()->FileExists(thumbFile))
     return true;
 
   return CacheImage(file, thumbFile, g_advancedSettings.m_thumbSize, g_advancedSettings.m_thumbSize);
@@ -60,6 +61,7 @@ bool CPicture::CacheImage(const CStdString& sourceUrl, const CStdString& destFil
           CLog::Log(LOGERROR, "%s Unable to create new image %s from image %s", __FUNCTION__, destFile.c_str(), sourceUrl.c_str());
           return false;
         }
+        CThumbnailCache::GetThumbnailCache()->OnFileWritten(destFile);
         return true;
       }
       return false;
@@ -70,6 +72,7 @@ bool CPicture::CacheImage(const CStdString& sourceUrl, const CStdString& destFil
       CLog::Log(LOGERROR, "%s Unable to create new image %s from image %s", __FUNCTION__, destFile.c_str(), sourceUrl.c_str());
       return false;
     }
+    CThumbnailCache::GetThumbnailCache()->OnFileWritten(destFile);
     return true;
   }
   else
@@ -103,6 +106,7 @@ bool CPicture::CreateThumbnailFromMemory(const unsigned char* buffer, int bufSiz
     CLog::Log(LOGERROR, "%s: exception with fileType: %s", __FUNCTION__, extension.c_str());
     return false;
   }
+  CThumbnailCache::GetThumbnailCache()->OnFileWritten(thumbFile);
   return true;
 }
 
@@ -118,13 +122,18 @@ void CPicture::CreateFolderThumb(const CStdString *thumbs, const CStdString &fol
   {
     CLog::Log(LOGERROR, "%s failed for folder thumb %s", __FUNCTION__, folderThumb.c_str());
   }
+  else
+    CThumbnailCache::GetThumbnailCache()->OnFileWritten(folderThumb);
 }
 
 bool CPicture::CreateThumbnailFromSurface(const unsigned char *buffer, int width, int height, int stride, const CStdString &thumbFile)
 {
   DllImageLib dll;
   if (!buffer || !dll.Load()) return false;
-  return dll.CreateThumbnailFromSurface((BYTE *)buffer, width, height, stride, thumbFile.c_str());
+  if (!dll.CreateThumbnailFromSurface((BYTE *)buffer, width, height, stride, thumbFile.c_str()))
+    return false;
+  CThumbnailCache::GetThumbnailCache()->OnFileWritten(thumbFile);
+  return true;
 }
 
 int CPicture::ConvertFile(const CStdString &srcFile, const CStdString &destFile, float rotateDegrees, int width, int height, unsigned int quality, bool mirror)
@@ -137,6 +146,7 @@ int CPicture::ConvertFile(const CStdString &srcFile, const CStdString &destFile,
     CLog::Log(LOGERROR, "%s: Error %i converting image %s", __FUNCTION__, ret, srcFile.c_str());
     return ret;
   }
+  CThumbnailCache::GetThumbnailCache()->OnFileWritten(destFile);
   return ret;
 }
 
@@ -22,6 +22,7 @@
 #include "SlideShowPicture.h"
 #include "system.h"
 #include "guilib/Texture.h"
+#include "guilib/GUIQuadBatch.h"
 #include "utils/ssrc.h"         // for M_PI
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
@@ -716,6 +717,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
     g_Windowing.Get3DDevice()->DrawPrimitiveUP( D3DPT_LINESTRIP, 4, vertex, sizeof(VERTEX) );
 
 #elif defined(HAS_GL)
+  g_quadBatch.Flush();
   g_graphicsContext.BeginPaint();
   if (pTexture)
   {
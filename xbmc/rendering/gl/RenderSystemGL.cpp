@@ -25,6 +25,7 @@
 #ifdef HAS_GL
 
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITextureGL.h"
 #include "settings/AdvancedSettings.h"
 #include "RenderSystemGL.h"
 #include "utils/log.h"
@@ -207,11 +208,15 @@ bool CRenderSystemGL::ResetRenderSystem(int width, int height, bool fullScreen,
   glEnable(GL_BLEND);          // Turn Blending On
   glDisable(GL_DEPTH_TEST);
 
+  g_quadBatch.SetRenderer(CGUITextureGL::GetRenderer());
+
   return true;
 }
 
 bool CRenderSystemGL::DestroyRenderSystem()
 {
+  g_quadBatch.Flush();
+  g_quadBatch.SetRenderer(NULL);
   m_bRenderCreated = false;
 
   return true;
@@ -230,6 +235,8 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  g_quadBatch.Flush();
+
   return true;
 }
 
@@ -238,6 +245,8 @@ bool CRenderSystemGL::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  g_quadBatch.Flush();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -266,6 +275,8 @@ bool CRenderSystemGL::PresentRender()
   if (!m_bRenderCreated)
     return false;
 
+  g_quadBatch.Flush();
+
   if (m_iVSyncMode != 0 && m_iSwapRate != 0)
   {
     int64_t curr, diff, freq;
@@ -362,6 +373,8 @@ void CRenderSystemGL::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  g_quadBatch.Flush();
+
   glMatrixMode(GL_PROJECTION);
   glPushMatrix();
   glMatrixMode(GL_TEXTURE);
@@ -400,6 +413,7 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  g_quadBatch.Flush();
   g_graphicsContext.BeginPaint();
 
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
@@ -448,6 +462,7 @@ void CRenderSystemGL::ApplyHardwareTransform(const TransformMatrix &finalMatrix)
   if (!m_bRenderCreated)
     return;
 
+  g_quadBatch.Flush();
   glMatrixMode(GL_MODELVIEW);
   glPushMatrix();
   GLfloat matrix[4][4];
@@ -469,6 +484,7 @@ void CRenderSystemGL::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  g_quadBatch.Flush();
   glMatrixMode(GL_MODELVIEW);
   glPopMatrix();
 }
@@ -538,6 +554,7 @@ void CRenderSystemGL::SetViewPort(CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  g_quadBatch.Flush();
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
 }
@@ -546,6 +563,8 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  g_quadBatch.Flush();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -51,6 +51,7 @@ void CAdvancedSettings::Initialize()
   m_audioApplyDrc = true;
   m_dvdplayerIgnoreDTSinWAV = false;
   m_audioResample = 0;
+  m_audioResampleQuality = 2;
   m_audioForceDirectSound = false;
 
   m_karaokeSyncDelayCDG = 0.0f;
@@ -92,6 +93,7 @@ void CAdvancedSettings::Initialize()
   m_videoAllowLanczos3 = false;
   m_videoAutoScaleMaxFps = 30.0f;
   m_videoAllowMpeg4VDPAU = false;
+  m_videoDirectRendering = true;
   m_DXVACheckCompatibility = false;
   m_DXVACheckCompatibilityPresent = false;
 
@@ -175,6 +177,7 @@ void CAdvancedSettings::Initialize()
   m_thumbSize = DEFAULT_THUMB_SIZE;
   m_fanartHeight = DEFAULT_FANART_HEIGHT;
   m_useDDSFanart = false;
+  m_useThumbnailIndex = true;
 
   m_sambaclienttimeout = 10;
   m_sambadoscodepage = "";
@@ -239,6 +242,9 @@ void CAdvancedSettings::Initialize()
   m_fullScreen = m_startFullScreen = false;
   m_showExitButton = true;
   m_splashImage = true;
+  m_parallelStartup = true;
+  m_startupTrace = false;
+  m_pythonInterpreterPool = 2;
 
   m_playlistRetries = 100;
   m_playlistTimeout = 20; // 20 seconds timeout
@@ -277,6 +283,9 @@ void CAdvancedSettings::Initialize()
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
+  m_databasePoolSize = 4;
+  m_databasePoolIdleTimeout = 60;
+
   m_enableMultimediaKeys = false;
 
   m_canWindowed = true;
@@ -352,6 +361,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "percentseekbackwardbig", m_musicPercentSeekBackwardBig, -100, 0);
 
     XMLUtils::GetInt(pElement, "resample", m_audioResample, 0, 192000);
+    XMLUtils::GetInt(pElement, "resamplequality", m_audioResampleQuality, 0, 3);
     XMLUtils::GetString(pElement, "transcodeto", m_audioTranscodeTo);
 
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
@@ -445,6 +455,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement,"allowlanczos3",m_videoAllowLanczos3);
     XMLUtils::GetFloat(pElement,"autoscalemaxfps",m_videoAutoScaleMaxFps, 0.0f, 1000.0f);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vdpau",m_videoAllowMpeg4VDPAU);
+    XMLUtils::GetBoolean(pElement,"directrendering",m_videoDirectRendering);
 
     TiXmlElement* pAdjustRefreshrate = pElement->FirstChildElement("adjustrefreshrate");
     if (pAdjustRefreshrate)
@@ -652,6 +663,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetBoolean(pRootElement, "fullscreen", m_startFullScreen);
 #endif
   XMLUtils::GetBoolean(pRootElement, "splash", m_splashImage);
+  XMLUtils::GetBoolean(pRootElement, "parallelstartup", m_parallelStartup);
+  XMLUtils::GetBoolean(pRootElement, "startuptrace", m_startupTrace);
   XMLUtils::GetBoolean(pRootElement, "showexitbutton", m_showExitButton);
   XMLUtils::GetBoolean(pRootElement, "canwindowed", m_canWindowed);
 
@@ -659,6 +672,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetInt(pRootElement, "busydialogdelay", m_busyDialogDelay, 0, 5000);
   XMLUtils::GetInt(pRootElement, "playlistretries", m_playlistRetries, -1, 5000);
   XMLUtils::GetInt(pRootElement, "playlisttimeout", m_playlistTimeout, 0, 5000);
+  XMLUtils::GetInt(pRootElement, "pythoninterpreterpool", m_pythonInterpreterPool, 0, 16);
 
   XMLUtils::GetBoolean(pRootElement,"glrectanglehack", m_GLRectangleHack);
   XMLUtils::GetInt(pRootElement,"skiploopfilter", m_iSkipLoopFilter, -16, 48);
@@ -809,6 +823,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetInt(pRootElement, "thumbsize", m_thumbSize, 0, 1024);
   XMLUtils::GetInt(pRootElement, "fanartheight", m_fanartHeight, 0, 1080);
   XMLUtils::GetBoolean(pRootElement, "useddsfanart", m_useDDSFanart);
+  XMLUtils::GetBoolean(pRootElement, "usethumbnailindex", m_useThumbnailIndex);
 
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
@@ -880,6 +895,13 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pDatabase, "name", m_databaseVideo.name);
   }
 
+  pDatabase = pRootElement->FirstChildElement("databasepool");
+  if (pDatabase)
+  {
+    XMLUtils::GetInt(pDatabase, "size", m_databasePoolSize, 0, 32);
+    XMLUtils::GetUInt(pDatabase, "idletimeout", m_databasePoolIdleTimeout);
+  }
+
   pDatabase = pRootElement->FirstChildElement("musicdatabase");
   if (pDatabase)
   {
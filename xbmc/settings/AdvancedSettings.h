@@ -84,6 +84,7 @@ class CAdvancedSettings
     float m_audioPlayCountMinimumPercent;
     bool m_dvdplayerIgnoreDTSinWAV;
     int m_audioResample;
+    int m_audioResampleQuality;
     CStdString m_audioTranscodeTo;
 
     float m_videoSubsDelayRange;
@@ -123,6 +124,7 @@ class CAdvancedSettings
     bool  m_videoAllowLanczos3;
     float m_videoAutoScaleMaxFps;
     bool  m_videoAllowMpeg4VDPAU;
+    bool  m_videoDirectRendering;
     std::vector<RefreshOverride> m_videoAdjustRefreshOverrides;
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
@@ -182,6 +184,7 @@ class CAdvancedSettings
     int m_thumbSize;
     int m_fanartHeight;
     bool m_useDDSFanart;
+    bool m_useThumbnailIndex;
 
     int m_sambaclienttimeout;
     CStdString m_sambadoscodepage;
@@ -253,8 +256,11 @@ class CAdvancedSettings
 	bool m_showExitButton; /* Ideal for appliances to hide a 'useless' button */
     bool m_canWindowed;
     bool m_splashImage;
+    bool m_parallelStartup; /* overlap the independent steps of startup */
+    bool m_startupTrace;    /* write a timeline of startup to special://temp/startuptrace.json */
     bool m_alwaysOnTop;  /* makes xbmc to run always on top .. osx/win32 only .. */
     int m_playlistRetries;
+    int m_pythonInterpreterPool; /* idle python interpreters kept to run the next plugin, 0 to create one per run */
     int m_playlistTimeout;
     bool m_GLRectangleHack;
     int m_iSkipLoopFilter;
@@ -286,6 +292,8 @@ class CAdvancedSettings
 
     DatabaseSettings m_databaseMusic; // advanced music database setup
     DatabaseSettings m_databaseVideo; // advanced video database setup
+    int m_databasePoolSize;               // idle connections kept per database
+    unsigned int m_databasePoolIdleTimeout; // seconds before an idle connection is closed
 
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
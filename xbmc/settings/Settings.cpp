@@ -56,6 +56,7 @@
 #include "input/MouseStat.h"
 #include "filesystem/File.h"
 #include "addons/AddonManager.h"
+#include "ThumbnailCache.h"
 
 using namespace std;
 using namespace XFILE;
@@ -1829,6 +1830,7 @@ void CSettings::CreateProfileFolders()
     CDirectory::Create(URIUtils::AddFileToFolder(GetThumbnailsFolder(), strHex));
     CDirectory::Create(URIUtils::AddFileToFolder(generatedThumbsFolder, strHex));
   }
+  CThumbnailCache::GetThumbnailCache()->BuildIndex();
   CDirectory::Create("special://profile/addon_data");
   CDirectory::Create("special://profile/keymaps");
 }
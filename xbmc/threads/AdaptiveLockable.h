@@ -0,0 +1,97 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#if defined(_MSC_VER)
+#include <emmintrin.h>
+#endif
+
+namespace XbmcThreads
+{
+  /**
+   * Most spins an AdaptiveLockable makes before it blocks, 0 on a single
+   *  processor where the owner can't release the lock while we spin.
+   */
+  extern int g_adaptiveSpinLimit;
+
+  /**
+   * Tells the processor we are in a spin loop.
+   */
+  inline void CpuRelax()
+  {
+#if defined(_MSC_VER)
+    _mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__ ("pause");
+#endif
+  }
+
+  /**
+   * This template takes any implementation of the "Lockable" concept and
+   *  spins on try_lock() for a while before it blocks in lock(), like
+   *  PTHREAD_MUTEX_ADAPTIVE_NP does.
+   *
+   * Most locks are only held for the time it takes to push onto a list or
+   *  look up a map, so a thread finding the lock taken usually gets it after
+   *  a few hundred cycles of spinning, which is far cheaper than going to
+   *  sleep in the kernel and being woken again.
+   *
+   * The number of spins adapts to how long it took to get the lock the last
+   *  times round, so a lock that is held for long stops spinning early and
+   *  goes to sleep. The estimate is only updated while holding the lock.
+   */
+  template<class L> class AdaptiveLockable
+  {
+    L mutex;
+    int spins;
+
+  public:
+    inline AdaptiveLockable() : spins(0) {}
+
+    inline void lock()
+    {
+      if (mutex.try_lock())
+        return;
+
+      int limit = spins * 2 + 10;
+      if (limit > g_adaptiveSpinLimit)
+        limit = g_adaptiveSpinLimit;
+
+      int count = 0;
+      for (; count < limit; count++)
+      {
+        CpuRelax();
+        if (mutex.try_lock())
+        {
+          spins += (count - spins) / 8;
+          return;
+        }
+      }
+
+      mutex.lock();
+      spins += (count - spins) / 8;
+    }
+
+    inline bool try_lock() { return mutex.try_lock(); }
+    inline void unlock() { mutex.unlock(); }
+  };
+}
@@ -473,6 +473,48 @@ long AtomicSubtract(volatile long* pAddr, long amount)
 
 #endif
 
+///////////////////////////////////////////////////////////////////////////
+// Full memory barrier
+///////////////////////////////////////////////////////////////////////////
+#if defined(__ppc__) || defined(__powerpc__) // PowerPC
+
+void AtomicFence()
+{
+  __asm__ __volatile__ ("sync" : : : "memory");
+}
+
+#elif defined(WIN32)
+
+void AtomicFence()
+{
+  long barrier;
+  __asm
+  {
+    xchg barrier, eax;
+  }
+}
+
+#elif defined(__i386__) || defined(__x86_64__)
+
+void AtomicFence()
+{
+  // a locked instruction orders like mfence, and is cheaper on most processors
+#if defined(__x86_64__)
+  __asm__ __volatile__ ("lock/orq $0, (%%rsp)" : : : "memory", "cc");
+#else
+  __asm__ __volatile__ ("lock/orl $0, (%%esp)" : : : "memory", "cc");
+#endif
+}
+
+#else // ARM, MIPS (GCC)
+
+void AtomicFence()
+{
+  __sync_synchronize();
+}
+
+#endif
+
 ///////////////////////////////////////////////////////////////////////////
 // Fast spinlock implmentation. No backoff when busy
 ///////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,8 @@ long AtomicIncrement(volatile long* pAddr);
 long AtomicDecrement(volatile long* pAddr);
 long AtomicAdd(volatile long* pAddr, long amount);
 long AtomicSubtract(volatile long* pAddr, long amount);
+// full memory barrier, no load or store is moved across it
+void AtomicFence();
 
 class CAtomicSpinLock
 {
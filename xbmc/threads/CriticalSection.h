@@ -22,6 +22,10 @@
 #pragma once
 
 #include <boost/thread/recursive_mutex.hpp>
+#include "threads/AdaptiveLockable.h"
+#ifdef XBMC_LOCK_PROFILER
+#include "threads/LockProfiler.h"
+#endif
 
 namespace XbmcThreads
 {
@@ -96,10 +100,23 @@ namespace XbmcThreads
 
 /**
  * A CCriticalSection is a CountingLockable whose implementation is a boost
- *  recursive_mutex.
+ *  recursive_mutex, which spins for a while before it blocks when it is
+ *  taken (see AdaptiveLockable).
  *
  * This is not a typedef because of a number of "class CCriticalSection;" 
  *  forward declarations in the code that break when it's done that way.
  */
-class CCriticalSection : public XbmcThreads::CountingLockable<boost::recursive_mutex> {};
+#ifdef XBMC_LOCK_PROFILER
+/**
+ * In lock profiling builds the mutex is wrapped in a ProfiledLockable
+ *  that is registered under the code creating the CCriticalSection.
+ */
+class CCriticalSection : public XbmcThreads::CountingLockable<XbmcThreads::ProfiledLockable<XbmcThreads::AdaptiveLockable<boost::recursive_mutex> > >
+{
+public:
+  CCriticalSection();
+};
+#else
+class CCriticalSection : public XbmcThreads::CountingLockable<XbmcThreads::AdaptiveLockable<boost::recursive_mutex> > {};
+#endif
 
@@ -30,6 +30,8 @@ void CEvent::addGroup(XbmcThreads::CEventGroup* group)
     groups = new std::vector<XbmcThreads::CEventGroup*>();
 
   groups->push_back(group);
+  // the group checks 'signaled' once it waits, see Set()
+  AtomicFence();
 }
 
 void CEvent::removeGroup(XbmcThreads::CEventGroup* group)
@@ -58,16 +60,28 @@ void CEvent::removeGroup(XbmcThreads::CEventGroup* group)
 //  CEvent::groupListMutex -> CEventGroup::mutex -> CEvent::mutex
 void CEvent::Set()
 {
-  // no locking necessary
+  // publish whatever was done before the Set, then check for waiters. A waiter
+  //  counts itself in before it checks 'signaled' with the mutex held, so if we
+  //  see no waiter it sees the Event signaled, otherwise taking the mutex
+  //  makes sure it's waiting on the condition by the time we notify.
+  AtomicFence();
   signaled = true; 
-  condVar.notifyAll();
+  AtomicFence();
+  if (numWaits)
+  {
+    CSingleLock lock(mutex);
+    condVar.notifyAll();
+  }
 
-  CSingleLock l(groupListMutex);
   if (groups)
   {
-    for (std::vector<XbmcThreads::CEventGroup*>::iterator iter = groups->begin(); 
-         iter != groups->end(); iter++)
-      (*iter)->Set(this);
+    CSingleLock l(groupListMutex);
+    if (groups)
+    {
+      for (std::vector<XbmcThreads::CEventGroup*>::iterator iter = groups->begin(); 
+           iter != groups->end(); iter++)
+        (*iter)->Set(this);
+    }
   }
 }
 
@@ -23,6 +23,7 @@
 
 #include <vector>
 
+#include "threads/Atomics.h"
 #include "threads/Condition.h"
 
 // forward declare the CEventGroup
@@ -40,12 +41,17 @@ namespace XbmcThreads
  * in the code that uses this behavior).
  *
  * This class manages 'spurious returns' from the condition variable.
+ *
+ * Set() only takes the mutex when someone is waiting, and waiting on a
+ * manual reset Event that is already signaled doesn't take it at all. The
+ * memory fences in Set() and the waits make sure that a waiter either sees
+ * the Event signaled or is seen by Set().
  */
 class CEvent
 {
   bool manualReset;
   volatile bool signaled;
-  unsigned int numWaits;
+  volatile unsigned int numWaits;
 
   CCriticalSection groupListMutex; // lock for the groups list
   std::vector<XbmcThreads::CEventGroup*> * groups;
@@ -83,7 +89,17 @@ public:
    *  was triggered. Otherwise it will return false.
    */
   inline bool WaitMSec(unsigned int milliSeconds) 
-  { CSingleLock lock(mutex); numWaits++; condVar.wait(mutex,milliSeconds); numWaits--; return prepReturn(); }
+  {
+    if (manualReset && signaled)
+    {
+      AtomicFence();
+      return true;
+    }
+    CSingleLock lock(mutex);
+    if (!signaled)
+    { numWaits++; AtomicFence(); condVar.wait(mutex,milliSeconds); numWaits--; }
+    return prepReturn();
+  }
 
   /**
    * This will wait for the Event to be triggered. The method will return 
@@ -91,7 +107,17 @@ public:
    * it will return false. Otherwise it will return false.
    */
   inline bool Wait()
-  { CSingleLock lock(mutex); numWaits++; condVar.wait(mutex); numWaits--; return prepReturn(); }
+  {
+    if (manualReset && signaled)
+    {
+      AtomicFence();
+      return true;
+    }
+    CSingleLock lock(mutex);
+    if (!signaled)
+    { numWaits++; AtomicFence(); condVar.wait(mutex); numWaits--; }
+    return prepReturn();
+  }
 
 };
 
@@ -0,0 +1,217 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "LockProfiler.h"
+#include "threads/CriticalSection.h"
+#include "PlatformDefs.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <stdio.h>
+#ifdef _LINUX
+#include <execinfo.h>
+#include <stdlib.h>
+#define _ReturnAddress() __builtin_return_address(0)
+#else
+extern "C" void * _ReturnAddress(void);
+#pragma intrinsic(_ReturnAddress)
+#endif
+
+using namespace XbmcThreads;
+
+class CLockProfiler::Site
+{
+public:
+  Site(const void* site, const char* name)
+  {
+    m_site = site;
+    m_name = name ? name : "";
+    m_locks = 0;
+    Reset();
+  }
+
+  void Reset()
+  {
+    m_acquires = 0;
+    m_contended = 0;
+    m_waitTotal = 0;
+    m_waitMax = 0;
+    m_holdTotal = 0;
+    m_holdMax = 0;
+  }
+
+  boost::mutex m_mutex;
+  const void*  m_site;
+  std::string  m_name;
+  unsigned int m_locks;
+  uint64_t     m_acquires;
+  uint64_t     m_contended;
+  int64_t      m_waitTotal; // in host counter ticks
+  int64_t      m_waitMax;
+  int64_t      m_holdTotal;
+  int64_t      m_holdMax;
+};
+
+#ifdef XBMC_LOCK_PROFILER
+// out of line, so that the return address lies in the code creating the section
+CCriticalSection::CCriticalSection()
+{
+  mutex.setSite(_ReturnAddress());
+}
+#endif
+
+CLockProfiler& CLockProfiler::Get()
+{
+  // never destroyed, locks may still be in use during static destruction
+  static CLockProfiler* s_profiler = new CLockProfiler;
+  return *s_profiler;
+}
+
+CLockProfiler::Site* CLockProfiler::Register(const void* site, const char* name)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  std::map<const void*, Site*>::iterator it = m_sites.find(site);
+  if (it == m_sites.end())
+    it = m_sites.insert(std::make_pair(site, new Site(site, name))).first;
+  it->second->m_locks++;
+  return it->second;
+}
+
+int64_t CLockProfiler::Now()
+{
+  return CurrentHostCounter();
+}
+
+void CLockProfiler::Acquired(Site* site, int64_t wait, bool contended)
+{
+  if (!site)
+    return;
+
+  boost::mutex::scoped_lock lock(site->m_mutex);
+  site->m_acquires++;
+  if (contended)
+  {
+    site->m_contended++;
+    site->m_waitTotal += wait;
+    site->m_waitMax = std::max(site->m_waitMax, wait);
+  }
+}
+
+void CLockProfiler::Released(Site* site, int64_t hold)
+{
+  if (!site)
+    return;
+
+  boost::mutex::scoped_lock lock(site->m_mutex);
+  site->m_holdTotal += hold;
+  site->m_holdMax = std::max(site->m_holdMax, hold);
+}
+
+static bool SortByWait(const LockStats& left, const LockStats& right)
+{
+  if (left.waitTotal != right.waitTotal)
+    return left.waitTotal > right.waitTotal;
+  return left.holdTotal > right.holdTotal;
+}
+
+std::vector<LockStats> CLockProfiler::GetStats() const
+{
+  std::vector<LockStats> result;
+  double toMs = 1000.0 / CurrentHostFrequency();
+
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+    for (std::map<const void*, Site*>::const_iterator it = m_sites.begin(); it != m_sites.end(); ++it)
+    {
+      Site* site = it->second;
+      LockStats stats;
+      stats.site = site->m_site;
+      stats.name = site->m_name;
+      stats.locks = site->m_locks;
+
+      boost::mutex::scoped_lock siteLock(site->m_mutex);
+      stats.acquires  = site->m_acquires;
+      stats.contended = site->m_contended;
+      stats.waitTotal = site->m_waitTotal * toMs;
+      stats.waitMax   = site->m_waitMax * toMs;
+      stats.holdTotal = site->m_holdTotal * toMs;
+      stats.holdMax   = site->m_holdMax * toMs;
+      result.push_back(stats);
+    }
+  }
+
+  // name the sites after the function they are in
+#ifdef _LINUX
+  std::vector<void*> addresses;
+  for (std::vector<LockStats>::iterator it = result.begin(); it != result.end(); ++it)
+    addresses.push_back(const_cast<void*>(it->site));
+  char** symbols = addresses.empty() ? NULL : backtrace_symbols(&addresses[0], (int)addresses.size());
+#endif
+  for (unsigned int i = 0; i < result.size(); i++)
+  {
+    if (!result[i].name.empty())
+      continue;
+#ifdef _LINUX
+    if (symbols)
+    {
+      result[i].name = symbols[i];
+      continue;
+    }
+#endif
+    char address[32];
+    sprintf(address, "%p", result[i].site);
+    result[i].name = address;
+  }
+#ifdef _LINUX
+  free(symbols);
+#endif
+
+  std::sort(result.begin(), result.end(), SortByWait);
+  return result;
+}
+
+void CLockProfiler::Dump(unsigned int maxSites) const
+{
+  std::vector<LockStats> stats = GetStats();
+  CLog::Log(LOGNOTICE, "Lock profile of %u sites, by time waited:", (unsigned int)stats.size());
+  CLog::Log(LOGNOTICE, "  %8s %10s %10s %11s %9s %11s %9s  %s", "locks", "acquires", "contended", "wait ms", "max ms", "held ms", "max ms", "site");
+  unsigned int count = 0;
+  for (std::vector<LockStats>::iterator it = stats.begin(); it != stats.end() && count < maxSites; ++it)
+  {
+    const LockStats& site = *it;
+    if (!site.contended)
+      continue;
+    count++;
+    CLog::Log(LOGNOTICE, "  %8u %10"PRIu64" %10"PRIu64" %11.2f %9.2f %11.2f %9.2f  %s", site.locks, site.acquires, site.contended,
+              site.waitTotal, site.waitMax, site.holdTotal, site.holdMax, site.name.c_str());
+  }
+}
+
+void CLockProfiler::Reset()
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  for (std::map<const void*, Site*>::iterator it = m_sites.begin(); it != m_sites.end(); ++it)
+  {
+    boost::mutex::scoped_lock siteLock(it->second->m_mutex);
+    it->second->Reset();
+  }
+}
@@ -0,0 +1,138 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace XbmcThreads
+{
+  /**
+   * Contention figures of all the locks created at one place in the code.
+   *  Times are in milliseconds.
+   */
+  struct LockStats
+  {
+    const void*  site;
+    std::string  name;
+    unsigned int locks;      // number of locks created at the site
+    uint64_t     acquires;
+    uint64_t     contended;  // acquires that had to wait for another thread
+    double       waitTotal;
+    double       waitMax;
+    double       holdTotal;  // from the outermost lock() to the matching unlock()
+    double       holdMax;
+  };
+
+  /**
+   * Collects the figures of every ProfiledLockable. Locks are grouped by the
+   *  place they were created at, which is named after the function containing
+   *  it when the symbols can be looked up (link with -rdynamic) or else given
+   *  as an address.
+   *
+   * The profiler is only wired into CCriticalSection in builds configured with
+   *  --enable-lock-profiling, which define XBMC_LOCK_PROFILER. Other builds
+   *  don't pay anything for it.
+   */
+  class CLockProfiler
+  {
+  public:
+    class Site;
+
+    static CLockProfiler& Get();
+
+    Site* Register(const void* site, const char* name = NULL);
+
+    /**
+     * The figures of all sites, the ones waited on longest first.
+     */
+    std::vector<LockStats> GetStats() const;
+
+    /**
+     * Writes the figures of the sites that were waited on to the log.
+     */
+    void Dump(unsigned int maxSites = 50) const;
+    void Reset();
+
+    static int64_t Now();
+    static void Acquired(Site* site, int64_t wait, bool contended);
+    static void Released(Site* site, int64_t hold);
+
+  private:
+    CLockProfiler() {}
+
+    mutable boost::mutex m_mutex;
+    std::map<const void*, Site*> m_sites;
+  };
+
+  /**
+   * A Lockable that reports how it's used to the CLockProfiler. Like the
+   *  mutex it wraps, it can be used in a CountingLockable.
+   */
+  template<class L> class ProfiledLockable
+  {
+    L mutex;
+    unsigned int depth;
+    int64_t acquired;
+    CLockProfiler::Site* site;
+
+  public:
+    inline ProfiledLockable() : depth(0), acquired(0), site(NULL) {}
+
+    inline void setSite(const void* creator, const char* name = NULL) { site = CLockProfiler::Get().Register(creator, name); }
+
+    inline void lock()
+    {
+      if (mutex.try_lock())
+        CLockProfiler::Acquired(site, 0, false);
+      else
+      {
+        int64_t start = CLockProfiler::Now();
+        mutex.lock();
+        CLockProfiler::Acquired(site, CLockProfiler::Now() - start, true);
+      }
+      if (depth++ == 0)
+        acquired = CLockProfiler::Now();
+    }
+
+    inline bool try_lock()
+    {
+      if (!mutex.try_lock())
+        return false;
+      CLockProfiler::Acquired(site, 0, false);
+      if (depth++ == 0)
+        acquired = CLockProfiler::Now();
+      return true;
+    }
+
+    inline void unlock()
+    {
+      if (--depth == 0)
+        CLockProfiler::Released(site, CLockProfiler::Now() - acquired);
+      mutex.unlock();
+    }
+  };
+}
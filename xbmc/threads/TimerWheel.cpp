@@ -0,0 +1,320 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "TimerWheel.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+
+#define TIMER_TICK   10  // ms
+
+#define ROOT_BITS    8
+#define ROOT_SIZE    (1 << ROOT_BITS)
+#define ROOT_MASK    (ROOT_SIZE - 1)
+#define OUTER_BITS   6
+#define OUTER_SIZE   (1 << OUTER_BITS)
+#define OUTER_MASK   (OUTER_SIZE - 1)
+#define OUTER_COUNT  3
+
+// first tick past the range of wheel n, n = 0 being the root wheel
+#define WHEEL_RANGE(n) ((int64_t)1 << (ROOT_BITS + (n) * OUTER_BITS))
+// slot of outer wheel n a tick belongs to
+#define OUTER_INDEX(tick, n) (int)(((tick) >> (ROOT_BITS + (n) * OUTER_BITS)) & OUTER_MASK)
+
+CTimerWheel::CTimerWheel() : CThread("TimerWheel"), m_callbackDone(true)
+{
+  m_frequency = CurrentHostFrequency();
+  m_origin = CurrentHostCounter();
+  m_tick = 0;
+  m_wakeTick = -1;
+  m_nextID = 1;
+  m_running = 0;
+  m_runningCallback = NULL;
+  m_started = false;
+  m_stopped = false;
+  m_expired = 0;
+  m_wakeups = 0;
+}
+
+CTimerWheel::~CTimerWheel()
+{
+  Stop();
+}
+
+CTimerWheel &CTimerWheel::Get()
+{
+  static CTimerWheel s_timerWheel;
+  return s_timerWheel;
+}
+
+unsigned int CTimerWheel::Schedule(ITimerCallback *callback, unsigned int delay, unsigned int period, unsigned int slack)
+{
+  CSingleLock lock(m_section);
+  if (m_stopped || !callback)
+    return 0;
+
+  // round up so that a timer never expires early
+  int64_t now = GetTime();
+  int64_t expires = (now + delay + TIMER_TICK - 1) / TIMER_TICK;
+  if (slack >= TIMER_TICK)
+  {
+    int64_t granularity = 1;
+    while (granularity * 2 <= slack / TIMER_TICK)
+      granularity *= 2;
+    int64_t aligned = (now + delay + slack) / TIMER_TICK / granularity * granularity;
+    if (aligned > expires)
+      expires = aligned;
+  }
+
+  if (m_timers.empty() && m_tick < now / TIMER_TICK)
+    m_tick = now / TIMER_TICK; // nothing to catch up on
+
+  unsigned int timerID = m_nextID++;
+  if (m_nextID == 0)
+    m_nextID = 1;
+
+  Timer &timer = m_timers[timerID];
+  timer.callback = callback;
+  timer.expires  = expires;
+  timer.period   = period ? std::max(1u, period / TIMER_TICK) : 0;
+  Insert(timerID, expires);
+
+  if (!m_started)
+  {
+    m_started = true;
+    Create();
+  }
+  else if (m_wakeTick < 0 || expires < m_wakeTick)
+    m_wake.Set();
+
+  return timerID;
+}
+
+bool CTimerWheel::Cancel(unsigned int timerID, bool wait)
+{
+  CSingleLock lock(m_section);
+  bool pending = m_timers.erase(timerID) > 0;
+  // the slot still lists the timer, it's skipped once its time comes
+  if (wait)
+    WaitForCallback(lock, timerID, NULL);
+  return pending;
+}
+
+void CTimerWheel::CancelAll(ITimerCallback *callback, bool wait)
+{
+  CSingleLock lock(m_section);
+  for (std::map<unsigned int, Timer>::iterator it = m_timers.begin(); it != m_timers.end(); )
+  {
+    if (it->second.callback == callback)
+      m_timers.erase(it++);
+    else
+      ++it;
+  }
+  if (wait)
+    WaitForCallback(lock, 0, callback);
+}
+
+void CTimerWheel::Stop()
+{
+  {
+    CSingleLock lock(m_section);
+    if (m_stopped)
+      return;
+    m_stopped = true;
+    m_timers.clear();
+    if (!m_started)
+      return;
+  }
+  StopThread();
+}
+
+void CTimerWheel::Process()
+{
+  std::vector<Expiry> expired;
+  while (!m_bStop)
+  {
+    {
+      CSingleLock lock(m_section);
+      Advance(GetTime() / TIMER_TICK, expired);
+      if (!expired.empty())
+        m_wakeups++;
+    }
+
+    for (std::vector<Expiry>::iterator it = expired.begin(); it != expired.end() && !m_bStop; ++it)
+    {
+      {
+        // the timer may have been cancelled since it was collected, eg by an earlier callback
+        CSingleLock lock(m_section);
+        std::map<unsigned int, Timer>::iterator timer = m_timers.find(it->timerID);
+        if (timer == m_timers.end())
+          continue;
+        if (!it->periodic)
+          m_timers.erase(timer);
+        m_running = it->timerID;
+        m_runningCallback = it->callback;
+        m_callbackDone.Reset();
+      }
+
+      it->callback->OnTimer(it->timerID);
+
+      CSingleLock lock(m_section);
+      m_running = 0;
+      m_runningCallback = NULL;
+      m_expired++;
+      m_callbackDone.Set();
+    }
+    expired.clear();
+
+    int64_t wait;
+    {
+      CSingleLock lock(m_section);
+      m_wakeTick = GetNextExpiry();
+      wait = m_wakeTick < 0 ? -1 : std::max((int64_t)0, m_wakeTick * TIMER_TICK - GetTime());
+    }
+    if (wait < 0)
+      AbortableWait(m_wake);
+    else if (wait > 0)
+      AbortableWait(m_wake, (int)wait);
+  }
+}
+
+int64_t CTimerWheel::GetTime() const
+{
+  return (CurrentHostCounter() - m_origin) * 1000 / m_frequency;
+}
+
+void CTimerWheel::Insert(unsigned int timerID, int64_t expires)
+{
+  int64_t delta = expires - m_tick;
+  if (delta < 0)
+  { // overdue, expire on the next tick
+    m_root[m_tick & ROOT_MASK].push_back(timerID);
+    return;
+  }
+  if (delta < WHEEL_RANGE(0))
+  {
+    m_root[expires & ROOT_MASK].push_back(timerID);
+    return;
+  }
+  for (int n = 0; n < OUTER_COUNT - 1; n++)
+  {
+    if (delta < WHEEL_RANGE(n + 1))
+    {
+      m_outer[n][OUTER_INDEX(expires, n)].push_back(timerID);
+      return;
+    }
+  }
+  // beyond the outermost wheel, it's put back in again once the slot comes around
+  if (delta >= WHEEL_RANGE(OUTER_COUNT))
+    expires = m_tick + WHEEL_RANGE(OUTER_COUNT) - 1;
+  m_outer[OUTER_COUNT - 1][OUTER_INDEX(expires, OUTER_COUNT - 1)].push_back(timerID);
+}
+
+void CTimerWheel::Cascade(std::vector<unsigned int> &slot)
+{
+  std::vector<unsigned int> timers;
+  timers.swap(slot);
+  for (std::vector<unsigned int>::iterator it = timers.begin(); it != timers.end(); ++it)
+  {
+    std::map<unsigned int, Timer>::iterator timer = m_timers.find(*it);
+    if (timer != m_timers.end())
+      Insert(*it, timer->second.expires);
+  }
+}
+
+void CTimerWheel::Advance(int64_t tick, std::vector<Expiry> &expired)
+{
+  if (m_timers.empty())
+  {
+    if (m_tick <= tick)
+      m_tick = tick + 1;
+    return;
+  }
+
+  while (m_tick <= tick)
+  {
+    // each time a wheel comes round, sort the next slot of the wheel outside it into it
+    int index = (int)(m_tick & ROOT_MASK);
+    for (int n = 0; n < OUTER_COUNT && index == 0; n++)
+    {
+      index = OUTER_INDEX(m_tick, n);
+      Cascade(m_outer[n][index]);
+    }
+
+    std::vector<unsigned int> slot;
+    slot.swap(m_root[m_tick & ROOT_MASK]);
+    for (std::vector<unsigned int>::iterator it = slot.begin(); it != slot.end(); ++it)
+    {
+      std::map<unsigned int, Timer>::iterator timer = m_timers.find(*it);
+      if (timer == m_timers.end())
+        continue; // cancelled
+      if (timer->second.expires > m_tick)
+      { // was beyond the outermost wheel
+        Insert(*it, timer->second.expires);
+        continue;
+      }
+
+      Expiry expiry;
+      expiry.timerID  = *it;
+      expiry.callback = timer->second.callback;
+      expiry.periodic = timer->second.period > 0;
+      expired.push_back(expiry);
+
+      if (expiry.periodic)
+      { // periods missed while the thread was held up are skipped
+        timer->second.expires = std::max(timer->second.expires + timer->second.period, tick + 1);
+        Insert(*it, timer->second.expires);
+      }
+      // a one-shot timer stays pending until its callback is made, so it can still be cancelled
+    }
+    m_tick++;
+  }
+}
+
+int64_t CTimerWheel::GetNextExpiry() const
+{
+  if (m_timers.empty())
+    return -1;
+
+  // no further than the end of the root wheel, where the outer wheels move on
+  if ((m_tick & ROOT_MASK) == 0)
+    return m_tick;
+  int64_t end = (m_tick | ROOT_MASK) + 1;
+  for (int64_t tick = m_tick; tick < end; tick++)
+  {
+    if (!m_root[tick & ROOT_MASK].empty())
+      return tick;
+  }
+  return end;
+}
+
+void CTimerWheel::WaitForCallback(CSingleLock &lock, unsigned int timerID, ITimerCallback *callback)
+{
+  if (IsCurrentThread())
+    return; // cancelled from a callback
+
+  while (m_running && (m_running == timerID || m_runningCallback == callback))
+  {
+    lock.Leave();
+    m_callbackDone.Wait();
+    lock.Enter();
+  }
+}
@@ -0,0 +1,141 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+class ITimerCallback
+{
+public:
+  virtual ~ITimerCallback() {}
+
+  /*!
+   \brief Called on the timer thread when a timer expires.
+   Keep it short, all other timers wait for it to return.
+   \param timerID the id Schedule() returned for the timer.
+   */
+  virtual void OnTimer(unsigned int timerID) = 0;
+};
+
+/*!
+ \brief Runs all timers on a single thread.
+
+ Timers are kept in a hierarchical timing wheel with a 10ms tick: a wheel of 256
+ slots for the next 2.56 seconds and three wheels of 64 slots, each covering 64
+ times the range of the one below. Scheduling and cancelling a timer take constant
+ time, and the timers in a slot of an outer wheel are only sorted into the inner
+ wheels as their time comes closer. The thread sleeps until the next slot holding
+ a timer is due.
+
+ A timer given some slack may expire up to that much later than asked for, which
+ lets timers due close to each other expire on the same tick. Their expiry is
+ aligned to a multiple of the largest power of two ticks that fits within the slack.
+ */
+class CTimerWheel : private CThread
+{
+public:
+  CTimerWheel();
+  virtual ~CTimerWheel();
+
+  static CTimerWheel &Get();
+
+  /*!
+   \brief Schedules a timer, starting the timer thread if needed.
+   \param callback called when the timer expires, has to outlive the timer.
+   \param delay time in ms until the timer expires.
+   \param period time in ms between further expiries, 0 for a one-shot timer.
+   \param slack time in ms the timer may expire late by.
+   \return id of the timer, 0 once the timer thread was stopped.
+   */
+  unsigned int Schedule(ITimerCallback *callback, unsigned int delay, unsigned int period = 0, unsigned int slack = 0);
+
+  /*!
+   \brief Cancels a timer.
+   \param timerID the id Schedule() returned for the timer.
+   \param wait true to wait for the callback of the timer if it is running on the timer thread.
+   \return true if the timer was pending, false if it had already expired or been cancelled.
+   */
+  bool Cancel(unsigned int timerID, bool wait = false);
+
+  /*!
+   \brief Cancels all timers with the given callback, eg before destroying it.
+   */
+  void CancelAll(ITimerCallback *callback, bool wait = true);
+
+  /*!
+   \brief Cancels all timers and stops the timer thread for good.
+   */
+  void Stop();
+
+  /*! \brief Number of callbacks made so far. */
+  unsigned int GetExpired() const { return m_expired; };
+  /*! \brief Number of times the timer thread woke up to expire timers so far. */
+  unsigned int GetWakeups() const { return m_wakeups; };
+
+private:
+  struct Timer
+  {
+    ITimerCallback *callback;
+    int64_t         expires; // in ticks
+    unsigned int    period;  // in ticks
+  };
+
+  struct Expiry
+  {
+    unsigned int    timerID;
+    ITimerCallback *callback;
+    bool            periodic;
+  };
+
+  virtual void Process();
+
+  int64_t GetTime() const;
+  void Insert(unsigned int timerID, int64_t expires);
+  void Cascade(std::vector<unsigned int> &slot);
+  void Advance(int64_t tick, std::vector<Expiry> &expired);
+  int64_t GetNextExpiry() const;
+  void WaitForCallback(CSingleLock &lock, unsigned int timerID, ITimerCallback *callback);
+
+  CCriticalSection                m_section;
+  CEvent                          m_wake;
+  CEvent                          m_callbackDone;
+  std::map<unsigned int, Timer>   m_timers;
+  std::vector<unsigned int>       m_root[256];
+  std::vector<unsigned int>       m_outer[3][64];
+  int64_t                         m_origin;      // host counter at tick 0
+  int64_t                         m_frequency;
+  int64_t                         m_tick;        // next tick to expire
+  int64_t                         m_wakeTick;    // tick the thread sleeps until, -1 for no timers
+  unsigned int                    m_nextID;
+  unsigned int                    m_running;     // timer whose callback is running
+  ITimerCallback                 *m_runningCallback;
+  bool                            m_started;
+  bool                            m_stopped;
+  unsigned int                    m_expired;
+  unsigned int                    m_wakeups;
+};
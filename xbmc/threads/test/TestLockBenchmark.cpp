@@ -0,0 +1,173 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "threads/AdaptiveLockable.h"
+#include "threads/Event.h"
+#include "utils/test/TestUtils.h"
+
+#include <boost/thread/thread.hpp>
+#include <deque>
+
+using namespace XbmcThreads;
+
+// Not checks as such, these report how the lockables and CEvent perform.
+
+typedef CountingLockable<boost::recursive_mutex> BlockingSection;
+typedef CountingLockable<AdaptiveLockable<boost::recursive_mutex> > AdaptiveSection;
+
+// a short critical section like the ones in DVDMessageQueue
+template<class S> class queuer
+{
+  S& sec;
+  std::deque<int>& queue;
+  unsigned int iterations;
+  unsigned int outside;
+public:
+  volatile unsigned int spent;
+
+  queuer(S& s, std::deque<int>& q, unsigned int i, unsigned int o) : sec(s), queue(q), iterations(i), outside(o), spent(0) {}
+
+  void operator()()
+  {
+    for (unsigned int i = 0; i < iterations; i++)
+    {
+      {
+        boost::unique_lock<S> lock(sec);
+        queue.push_back(i);
+        if (queue.size() > 16)
+          queue.pop_front();
+      }
+      // some work between the locks, which is where light contention comes from
+      for (unsigned int j = 0; j < outside; j++)
+        spent = spent + j;
+    }
+  }
+};
+
+template<class S> static double Contend(unsigned int threads, unsigned int iterations, unsigned int outside)
+{
+  S sec;
+  std::deque<int> queue;
+  double start = NowMS();
+  boost::thread_group group;
+  for (unsigned int i = 0; i < threads; i++)
+    group.create_thread(queuer<S>(sec, queue, iterations, outside));
+  group.join_all();
+  double elapsed = NowMS() - start;
+  BOOST_CHECK(queue.size() <= 16);
+  return elapsed * 1000000.0 / (threads * iterations);
+}
+
+static void CompareLocks(const char* name, unsigned int threads, unsigned int outside)
+{
+  const unsigned int iterations = 200000;
+  double blocking = Contend<BlockingSection>(threads, iterations, outside);
+  double adaptive = Contend<AdaptiveSection>(threads, iterations, outside);
+  BOOST_TEST_MESSAGE(name << " (" << threads << " threads): blocking " << blocking << "ns, adaptive "
+                     << adaptive << "ns per lock and unlock");
+}
+
+BOOST_AUTO_TEST_CASE(TestLockBenchmarkUncontended)
+{
+  CompareLocks("uncontended", 1, 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestLockBenchmarkLightlyContended)
+{
+  CompareLocks("lightly contended", 2, 200);
+}
+
+BOOST_AUTO_TEST_CASE(TestLockBenchmarkHeavilyContended)
+{
+  CompareLocks("heavily contended", 8, 0);
+}
+
+class pinger
+{
+  CEvent& in;
+  CEvent& out;
+  unsigned int count;
+public:
+  pinger(CEvent& i, CEvent& o, unsigned int c) : in(i), out(o), count(c) {}
+  void operator()()
+  {
+    for (unsigned int i = 0; i < count; i++)
+    {
+      in.Wait();
+      out.Set();
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(TestLockBenchmarkEvent)
+{
+  const unsigned int count = 1000000;
+
+  CEvent unwaited;
+  double start = NowMS();
+  for (unsigned int i = 0; i < count; i++)
+    unwaited.Set();
+  double set = (NowMS() - start) * 1000000.0 / count;
+
+  unsigned int returned = 0;
+  CEvent unsignaled;
+  start = NowMS();
+  for (unsigned int i = 0; i < count; i++)
+    returned += unsignaled.WaitMSec(0);
+  double poll = (NowMS() - start) * 1000000.0 / count;
+  BOOST_CHECK_EQUAL(0u, returned);
+
+  CEvent manual(true, true);
+  start = NowMS();
+  for (unsigned int i = 0; i < count; i++)
+    returned += manual.Wait();
+  double signaled = (NowMS() - start) * 1000000.0 / count;
+  BOOST_CHECK_EQUAL(count, returned);
+
+  CEvent autoReset;
+  start = NowMS();
+  for (unsigned int i = 0; i < count; i++)
+  {
+    autoReset.Set();
+    returned += autoReset.WaitMSec(0);
+  }
+  double consume = (NowMS() - start) * 1000000.0 / count;
+  BOOST_CHECK_EQUAL(2 * count, returned);
+  BOOST_CHECK(!autoReset.WaitMSec(0));
+
+  const unsigned int rounds = 20000;
+  CEvent ping, pong;
+  start = NowMS();
+  boost::thread thread(pinger(ping, pong, rounds));
+  for (unsigned int i = 0; i < rounds; i++)
+  {
+    ping.Set();
+    pong.Wait();
+  }
+  thread.join();
+  double roundTrip = (NowMS() - start) * 1000000.0 / rounds;
+
+  BOOST_TEST_MESSAGE("CEvent: Set without waiters " << set << "ns, polling unsignaled " << poll
+                     << "ns, Wait on signaled manual reset " << signaled << "ns, Set and consume "
+                     << consume << "ns, round trip between two threads " << roundTrip << "ns");
+}
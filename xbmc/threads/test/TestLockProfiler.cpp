@@ -0,0 +1,125 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "threads/LockProfiler.h"
+#include "threads/SingleLock.h"
+#include "utils/test/TestUtils.h"
+
+#include <boost/thread/thread.hpp>
+
+using namespace XbmcThreads;
+
+static void SleepMS(unsigned int millis) { boost::thread::sleep(boost::get_system_time() + boost::posix_time::milliseconds(millis)); }
+
+// a profiled section that is there whether or not CCriticalSection is profiled
+class ProfiledSection : public CountingLockable<ProfiledLockable<boost::recursive_mutex> >
+{
+public:
+  ProfiledSection(const char* name) { mutex.setSite(this, name); }
+};
+
+static bool FindStats(const char* name, LockStats& result)
+{
+  std::vector<LockStats> stats = CLockProfiler::Get().GetStats();
+  for (std::vector<LockStats>::iterator it = stats.begin(); it != stats.end(); ++it)
+  {
+    if (it->name == name)
+    {
+      result = *it;
+      return true;
+    }
+  }
+  return false;
+}
+
+template<class S, class L> class hammer
+{
+  S& sec;
+  unsigned int iterations;
+  unsigned int sleepEvery;
+public:
+  hammer(S& s, unsigned int i, unsigned int every) : sec(s), iterations(i), sleepEvery(every) {}
+
+  void operator()()
+  {
+    for (unsigned int i = 1; i <= iterations; i++)
+    {
+      L lock(sec);
+      // recursion is counted as an acquire but doesn't add to the hold time
+      L inner(sec);
+      if (i % sleepEvery == 0)
+        SleepMS(1);
+    }
+  }
+};
+
+template<class S, class L> static void Stress(S& sec, const char* name)
+{
+  const unsigned int threads = 8, iterations = 20000, sleepEvery = 1000;
+
+  double start = NowMS();
+  boost::thread_group group;
+  for (unsigned int i = 0; i < threads; i++)
+    group.create_thread(hammer<S, L>(sec, iterations, sleepEvery));
+  group.join_all();
+  double elapsed = NowMS() - start;
+
+  LockStats stats;
+  BOOST_REQUIRE(FindStats(name, stats));
+  BOOST_CHECK_EQUAL(2ull * threads * iterations, stats.acquires);
+  BOOST_CHECK(stats.contended > 0);
+  BOOST_CHECK(stats.contended <= stats.acquires);
+  BOOST_CHECK(stats.waitMax <= stats.waitTotal);
+  BOOST_CHECK(stats.holdMax <= stats.holdTotal);
+  // every thread sleeps 20 times with the lock held
+  BOOST_CHECK(stats.holdMax >= 1.0);
+  BOOST_CHECK(stats.holdTotal >= threads * (iterations / sleepEvery) * 1.0);
+  // the lock is held by one thread at a time and waited on by the others at most
+  BOOST_CHECK(stats.holdTotal <= elapsed);
+  BOOST_CHECK(stats.waitTotal <= (threads - 1) * elapsed);
+  BOOST_TEST_MESSAGE(name << ": " << stats.acquires << " acquires, " << stats.contended << " contended, waited "
+                     << stats.waitTotal << "ms (" << stats.waitMax << "ms max), held " << stats.holdTotal
+                     << "ms (" << stats.holdMax << "ms max) in " << elapsed << "ms");
+}
+
+BOOST_AUTO_TEST_CASE(TestLockProfilerStress)
+{
+  ProfiledSection sec("TestLockProfilerStress");
+  Stress<ProfiledSection, boost::unique_lock<ProfiledSection> >(sec, "TestLockProfilerStress");
+
+  CLockProfiler::Get().Reset();
+  LockStats stats;
+  BOOST_REQUIRE(FindStats("TestLockProfilerStress", stats));
+  BOOST_CHECK_EQUAL(0ull, stats.acquires);
+  BOOST_CHECK_EQUAL(1u, stats.locks);
+}
+
+#ifdef XBMC_LOCK_PROFILER
+BOOST_AUTO_TEST_CASE(TestLockProfilerSingleLock)
+{
+  CCriticalSection sec;
+  // CCriticalSection registers under the code creating it, give this one a name to find it by
+  sec.getLockable().setSite(&sec, "TestLockProfilerSingleLock");
+  Stress<CCriticalSection, CSingleLock>(sec, "TestLockProfilerSingleLock");
+}
+#endif
@@ -0,0 +1,241 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "threads/TimerWheel.h"
+#include "threads/SingleLock.h"
+#include "utils/test/TestUtils.h"
+
+#include <boost/thread/thread.hpp>
+#include <map>
+#include <stdlib.h>
+
+static void SleepMS(unsigned int millis) { boost::thread::sleep(boost::get_system_time() + boost::posix_time::milliseconds(millis)); }
+
+// records when each timer expired
+class recorder : public ITimerCallback
+{
+public:
+  CCriticalSection section;
+  std::map<unsigned int, double> expired;
+  std::map<unsigned int, int> count;
+  unsigned int sleep;
+
+  recorder() : sleep(0) {}
+
+  virtual void OnTimer(unsigned int timerID)
+  {
+    {
+      CSingleLock lock(section);
+      expired[timerID] = NowMS();
+      count[timerID]++;
+    }
+    if (sleep)
+      SleepMS(sleep);
+  }
+
+  size_t size() { CSingleLock lock(section); return expired.size(); }
+};
+
+static void WaitFor(recorder &r, size_t count, unsigned int timeout)
+{
+  for (unsigned int waited = 0; r.size() < count && waited < timeout; waited += 10)
+    SleepMS(10);
+}
+
+BOOST_AUTO_TEST_CASE(TestTimerWheelExpiry)
+{
+  CTimerWheel wheel;
+  recorder r;
+
+  // covers the root wheel and the first outer one
+  const unsigned int delays[] = { 0, 5, 10, 50, 120, 500, 2550, 2600, 2700 };
+  const unsigned int count = sizeof(delays) / sizeof(delays[0]);
+  std::map<unsigned int, double> due;
+  double start = NowMS();
+  for (unsigned int i = 0; i < count; i++)
+    due[wheel.Schedule(&r, delays[i])] = start + delays[i];
+  unsigned int cancelled = wheel.Schedule(&r, 100);
+  BOOST_CHECK(wheel.Cancel(cancelled));
+  BOOST_CHECK(!wheel.Cancel(cancelled));
+
+  WaitFor(r, count, 5000);
+  SleepMS(50);
+
+  BOOST_CHECK_EQUAL((size_t)count, r.size());
+  BOOST_CHECK(r.expired.find(cancelled) == r.expired.end());
+  for (std::map<unsigned int, double>::iterator it = due.begin(); it != due.end(); ++it)
+  {
+    BOOST_CHECK(r.expired.find(it->first) != r.expired.end());
+    BOOST_CHECK(r.expired[it->first] >= it->second);
+    BOOST_CHECK(r.expired[it->first] < it->second + 200);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestTimerWheelPeriodic)
+{
+  CTimerWheel wheel;
+  recorder r;
+  r.sleep = 30;
+
+  unsigned int timer = wheel.Schedule(&r, 0, 20);
+  SleepMS(200);
+  // waits for the running callback, so none comes after
+  BOOST_CHECK(wheel.Cancel(timer, true));
+  int count = r.count[timer];
+  BOOST_CHECK(count >= 3);
+  SleepMS(100);
+  BOOST_CHECK_EQUAL(count, r.count[timer]);
+
+  // a stopped wheel takes no more timers
+  wheel.Stop();
+  BOOST_CHECK_EQUAL(0u, wheel.Schedule(&r, 10));
+}
+
+// cancels another timer from its callback
+class canceller : public ITimerCallback
+{
+public:
+  CTimerWheel &wheel;
+  unsigned int other;
+  bool cancelled;
+
+  canceller(CTimerWheel &w) : wheel(w), other(0), cancelled(false) {}
+
+  virtual void OnTimer(unsigned int timerID)
+  {
+    cancelled = wheel.Cancel(other);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(TestTimerWheelCancelExpired)
+{
+  CTimerWheel wheel;
+
+  // the slack lines both timers up on the same tick, so the second is already
+  // collected for expiry when the first callback cancels it
+  canceller c(wheel);
+  recorder r;
+  wheel.Schedule(&c, 20, 0, 100);
+  c.other = wheel.Schedule(&r, 20, 0, 100);
+  SleepMS(300);
+  BOOST_CHECK(c.cancelled);
+  BOOST_CHECK_EQUAL((size_t)0, r.size());
+
+  // same when cancelled from another thread while an earlier callback runs
+  recorder slow, later;
+  slow.sleep = 100;
+  wheel.Schedule(&slow, 20, 0, 100);
+  unsigned int timer = wheel.Schedule(&later, 20, 0, 100);
+  WaitFor(slow, 1, 1000);
+  BOOST_CHECK(wheel.Cancel(timer));
+  SleepMS(200);
+  BOOST_CHECK_EQUAL((size_t)0, later.size());
+}
+
+BOOST_AUTO_TEST_CASE(TestTimerWheelCoalescing)
+{
+  CTimerWheel exact, coalesced;
+  recorder r1, r2;
+
+  // 50 timers spread over 500ms, with and without 320ms of slack
+  double start = NowMS();
+  for (unsigned int i = 0; i < 50; i++)
+  {
+    exact.Schedule(&r1, 10 * i);
+    coalesced.Schedule(&r2, 10 * i, 0, 320);
+  }
+  WaitFor(r1, 50, 2000);
+  WaitFor(r2, 50, 2000);
+
+  BOOST_CHECK_EQUAL(50u, r2.size());
+  BOOST_CHECK(coalesced.GetWakeups() < exact.GetWakeups());
+  for (std::map<unsigned int, double>::iterator it = r2.expired.begin(); it != r2.expired.end(); ++it)
+    BOOST_CHECK(it->second >= start + 10 * (it->first - 1));
+  BOOST_TEST_MESSAGE("50 timers: " << exact.GetWakeups() << " wakeups exact, " << coalesced.GetWakeups() << " with slack");
+}
+
+// A timer the way CDelayedMessage used to do it, a thread sleeping until it's due.
+class sleeper : public CThread
+{
+public:
+  sleeper(recorder &r, unsigned int id, unsigned int delay) : m_recorder(r), m_id(id), m_delay(delay) {}
+  virtual void Process()
+  {
+    Sleep(m_delay);
+    m_recorder.OnTimer(m_id);
+  }
+private:
+  recorder &m_recorder;
+  unsigned int m_id;
+  unsigned int m_delay;
+};
+
+// Not a check as such, reports the cost of 10000 timers on the wheel against a thread per timer.
+BOOST_AUTO_TEST_CASE(TestTimerWheelBenchmark)
+{
+  const unsigned int count = 10000;
+  std::vector<unsigned int> delays;
+  srand(1);
+  for (unsigned int i = 0; i < count; i++)
+    delays.push_back(rand() % 1000);
+
+  recorder wheelRecorder;
+  std::map<unsigned int, double> due;
+  double start = NowMS();
+  {
+    CTimerWheel wheel;
+    for (unsigned int i = 0; i < count; i++)
+      due[wheel.Schedule(&wheelRecorder, delays[i])] = NowMS() + delays[i];
+    double scheduled = NowMS() - start;
+    WaitFor(wheelRecorder, count, 10000);
+    double done = NowMS() - start;
+
+    double late = 0, latest = 0;
+    for (std::map<unsigned int, double>::iterator it = wheelRecorder.expired.begin(); it != wheelRecorder.expired.end(); ++it)
+    {
+      late += it->second - due[it->first];
+      latest = std::max(latest, it->second - due[it->first]);
+    }
+    BOOST_CHECK_EQUAL((size_t)count, wheelRecorder.size());
+    BOOST_TEST_MESSAGE("timer wheel: scheduled " << count << " timers in " << scheduled << "ms, done after " << done
+                       << "ms on 1 thread with " << wheel.GetWakeups() << " wakeups, " << late / count << "ms late on average, "
+                       << latest << "ms at most");
+  }
+
+  recorder threadRecorder;
+  std::vector<sleeper*> sleepers;
+  start = NowMS();
+  for (unsigned int i = 0; i < count; i++)
+  {
+    sleeper *thread = new sleeper(threadRecorder, i, delays[i]);
+    thread->Create();
+    sleepers.push_back(thread);
+  }
+  double scheduled = NowMS() - start;
+  WaitFor(threadRecorder, count, 10000);
+  double done = NowMS() - start;
+  for (std::vector<sleeper*>::iterator it = sleepers.begin(); it != sleepers.end(); ++it)
+    delete *it;
+  BOOST_TEST_MESSAGE("thread per timer: scheduled " << count << " timers in " << scheduled << "ms, done after " << done
+                     << "ms on " << count << " threads, " << threadRecorder.size() << " expired");
+}
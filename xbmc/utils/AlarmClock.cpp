@@ -45,12 +45,7 @@ void CAlarmClock::Start(const CStdString& strName, float n_secs, const CStdStrin
   SAlarmClockEvent event;
   event.m_fSecs = n_secs;
   event.m_strCommand = strCommand;
-  if (!m_bIsRunning)
-  {
-    StopThread();
-    Create();
-    m_bIsRunning = true;
-  }
+  m_bIsRunning = true;
 
   CStdString strAlarmClock;
   CStdString strStarted;
@@ -74,6 +69,8 @@ void CAlarmClock::Start(const CStdString& strName, float n_secs, const CStdStrin
 
   event.watch.StartZero();
   CSingleLock lock(m_events);
+  // alarms are checked to within 100ms, which lets their timers share wakeups
+  event.m_timer = CTimerWheel::Get().Schedule(this, static_cast<unsigned int>(n_secs * 1000), 0, 100);
   m_event.insert(make_pair(lowerName,event));
   CLog::Log(LOGDEBUG,"started alarm with name: %s",lowerName.c_str());
 }
@@ -89,7 +86,13 @@ void CAlarmClock::Stop(const CStdString& strName, bool bSilent /* false */)
   if (iter == m_event.end())
     return;
 
+  Stop(iter, bSilent, iter->second.watch.GetElapsedSeconds() > iter->second.m_fSecs);
+}
+
+void CAlarmClock::Stop(map<CStdString,SAlarmClockEvent>::iterator iter, bool bSilent, bool bElapsed)
+{
   SAlarmClockEvent& event = iter->second;
+  CTimerWheel::Get().Cancel(event.m_timer);
 
   CStdString strAlarmClock;
   if (event.m_strCommand.Equals("xbmc.shutdown") || event.m_strCommand.Equals("xbmc.shutdown()"))
@@ -98,7 +101,7 @@ void CAlarmClock::Stop(const CStdString& strName, bool bSilent /* false */)
     strAlarmClock = g_localizeStrings.Get(13208);
 
   CStdString strMessage;
-  if( iter->second.watch.GetElapsedSeconds() > iter->second.m_fSecs )
+  if (bElapsed)
     strMessage = g_localizeStrings.Get(13211);
   else
   {
@@ -106,7 +109,7 @@ void CAlarmClock::Stop(const CStdString& strName, bool bSilent /* false */)
     CStdString strStarted = g_localizeStrings.Get(13212);
     strMessage.Format(strStarted.c_str(),static_cast<int>(remaining)/60,static_cast<int>(remaining)%60);
   }
-  if (iter->second.m_strCommand.IsEmpty() || iter->second.m_fSecs > iter->second.watch.GetElapsedSeconds())
+  if (iter->second.m_strCommand.IsEmpty() || !bElapsed)
   {
     if(!bSilent)
       CGUIDialogKaiToast::QueueNotification(CGUIDialogKaiToast::Info, strAlarmClock, strMessage);
@@ -118,24 +121,15 @@ void CAlarmClock::Stop(const CStdString& strName, bool bSilent /* false */)
   m_event.erase(iter);
 }
 
-void CAlarmClock::Process()
+void CAlarmClock::OnTimer(unsigned int timerID)
 {
-  while( !m_bStop)
+  CSingleLock lock(m_events);
+  for (map<CStdString,SAlarmClockEvent>::iterator iter=m_event.begin();iter != m_event.end(); ++iter)
   {
-    CStdString strLast = "";
+    if (iter->second.m_timer == timerID)
     {
-      CSingleLock lock(m_events);
-      for (map<CStdString,SAlarmClockEvent>::iterator iter=m_event.begin();iter != m_event.end(); ++iter)
-        if (iter->second.watch.GetElapsedSeconds() >= iter->second.m_fSecs)
-        {
-          Stop(iter->first);
-          if ((iter = m_event.find(strLast)) == m_event.end())
-            break;
-        }
-        else
-          strLast = iter->first;
+      Stop(iter, false, true);
+      break;
     }
-    Sleep(100);
   }
 }
-
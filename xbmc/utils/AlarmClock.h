@@ -24,7 +24,7 @@
 #include "StdString.h"
 #include "Stopwatch.h"
 #include "threads/CriticalSection.h"
-#include "threads/Thread.h"
+#include "threads/TimerWheel.h"
 
 #include <map>
 
@@ -33,9 +33,10 @@ struct SAlarmClockEvent
   CStopWatch watch;
   double m_fSecs;
   CStdString m_strCommand;
+  unsigned int m_timer;
 };
 
-class CAlarmClock : public CThread
+class CAlarmClock : public ITimerCallback
 {
 public:
   CAlarmClock();
@@ -67,8 +68,10 @@ public:
   }
 
   void Stop(const CStdString& strName, bool bSilent = false);
-  virtual void Process();
+  virtual void OnTimer(unsigned int timerID);
 private:
+  void Stop(std::map<CStdString,SAlarmClockEvent>::iterator iter, bool bSilent, bool bElapsed);
+
   std::map<CStdString,SAlarmClockEvent> m_event;
   CCriticalSection m_events;
 
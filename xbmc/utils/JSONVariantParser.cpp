@@ -75,7 +75,9 @@ CVariant CJSONVariantParser::Parse(const unsigned char *json, unsigned int lengt
 
   parser.push_buffer(json, length);
 
-  return callback.GetOutput();
+  CVariant result;
+  result.swap(callback.GetOutput());
+  return result;
 }
 
 int CJSONVariantParser::ParseNull(void * ctx)
@@ -23,6 +23,9 @@
 
 using namespace std;
 
+// hand the generated text to the output once this much has piled up
+#define STREAM_FLUSH_SIZE 16384
+
 string CJSONVariantWriter::Write(const CVariant &value, bool compact)
 {
   string output;
@@ -124,3 +127,100 @@ bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
 
   return success;
 }
+
+CJSONStreamWriter::CJSONStreamWriter(IJSONOutput &output, bool compact)
+  : m_output(output)
+{
+#if YAJL_MAJOR == 2
+  m_gen = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_gen, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_gen, yajl_gen_indent_string, "\t");
+#else
+  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
+  m_gen = yajl_gen_alloc(&conf, NULL);
+#endif
+  m_failed = false;
+  m_written = 0;
+}
+
+CJSONStreamWriter::~CJSONStreamWriter()
+{
+  yajl_gen_free(m_gen);
+}
+
+bool CJSONStreamWriter::OpenObject()
+{
+  return Check(yajl_gen_status_ok == yajl_gen_map_open(m_gen));
+}
+
+bool CJSONStreamWriter::CloseObject()
+{
+  return Check(yajl_gen_status_ok == yajl_gen_map_close(m_gen));
+}
+
+bool CJSONStreamWriter::OpenArray()
+{
+  return Check(yajl_gen_status_ok == yajl_gen_array_open(m_gen));
+}
+
+bool CJSONStreamWriter::CloseArray()
+{
+  return Check(yajl_gen_status_ok == yajl_gen_array_close(m_gen));
+}
+
+bool CJSONStreamWriter::Key(const string &key)
+{
+#if YAJL_MAJOR == 2
+  return Check(yajl_gen_status_ok == yajl_gen_string(m_gen, (const unsigned char*)key.c_str(), (size_t)key.length()));
+#else
+  return Check(yajl_gen_status_ok == yajl_gen_string(m_gen, (const unsigned char*)key.c_str(), key.length()));
+#endif
+}
+
+bool CJSONStreamWriter::Write(const CVariant &value)
+{
+  return Check(CJSONVariantWriter::InternalWrite(m_gen, value));
+}
+
+bool CJSONStreamWriter::Flush()
+{
+  if (m_failed)
+    return false;
+
+  const unsigned char * buffer;
+  unsigned int length = GetBuffer(&buffer);
+  if (length == 0)
+    return true;
+
+  if (!m_output.Write((const char *)buffer, length))
+    m_failed = true;
+  m_written += length;
+  yajl_gen_clear(m_gen);
+
+  return !m_failed;
+}
+
+bool CJSONStreamWriter::Check(bool success)
+{
+  if (!success)
+    m_failed = true;
+  if (m_failed)
+    return false;
+
+  const unsigned char * buffer;
+  if (GetBuffer(&buffer) >= STREAM_FLUSH_SIZE)
+    return Flush();
+
+  return true;
+}
+
+unsigned int CJSONStreamWriter::GetBuffer(const unsigned char **buffer)
+{
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(m_gen, buffer, &length);
+  return (unsigned int)length;
+}
@@ -32,5 +32,67 @@ class CJSONVariantWriter
 public:
   static std::string Write(const CVariant &value, bool compact);
 private:
+  friend class CJSONStreamWriter;
   static bool InternalWrite(yajl_gen g, const CVariant &value);
 };
+
+/*!
+ \brief Receives the text of a JSON document while it is being generated.
+ */
+class IJSONOutput
+{
+public:
+  virtual ~IJSONOutput() {}
+  virtual bool Write(const char *data, unsigned int length) = 0;
+};
+
+/*!
+ \brief Collects the text of a JSON document into a string.
+ */
+class CJSONStringOutput : public IJSONOutput
+{
+public:
+  virtual bool Write(const char *data, unsigned int length) { m_string.append(data, length); return true; }
+  const std::string &GetString() const { return m_string; }
+private:
+  std::string m_string;
+};
+
+/*!
+ \brief Generates a JSON document piece by piece.
+
+ The generated text is handed to the output whenever a few kB of it have piled
+ up, so a large document doesn't need to be held in memory as a whole, neither
+ as a CVariant tree nor as text. Values are written with Write(), objects and
+ arrays that are too large to build as a CVariant can be written member by
+ member with OpenObject()/Key()/CloseObject() and OpenArray()/CloseArray().
+ */
+class CJSONStreamWriter
+{
+public:
+  CJSONStreamWriter(IJSONOutput &output, bool compact);
+  ~CJSONStreamWriter();
+
+  bool OpenObject();
+  bool CloseObject();
+  bool OpenArray();
+  bool CloseArray();
+  bool Key(const std::string &key);
+  bool Write(const CVariant &value);
+
+  /*!
+   \brief Hands all the text generated so far to the output.
+   \return false if generating or writing any of the text failed
+   */
+  bool Flush();
+
+  unsigned int GetBytesWritten() const { return m_written; }
+private:
+  bool Check(bool success);
+  unsigned int GetBuffer(const unsigned char **buffer);
+
+  yajl_gen     m_gen;
+  IJSONOutput &m_output;
+  bool         m_failed;
+  unsigned int m_written;
+};
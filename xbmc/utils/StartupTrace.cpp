@@ -0,0 +1,122 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "StartupTrace.h"
+#include "threads/SingleLock.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+CStartupTrace &CStartupTrace::Get()
+{
+  static CStartupTrace s_trace;
+  return s_trace;
+}
+
+CStartupTrace::CStartupTrace()
+{
+  m_finished = false;
+  m_origin = CurrentHostCounter();
+  // whoever traces first is the main thread
+  m_threads[CThread::GetCurrentThreadId()] = 1;
+}
+
+CStartupTrace::Scope::Scope(const char *name)
+{
+  CStartupTrace::Get();
+  m_name = name;
+  m_start = CurrentHostCounter();
+}
+
+CStartupTrace::Scope::~Scope()
+{
+  CStartupTrace::Get().Add(m_name, m_start, CurrentHostCounter());
+}
+
+void CStartupTrace::Add(const char *name, int64_t start, int64_t end)
+{
+  CSingleLock lock(m_section);
+  if (m_finished)
+    return;
+
+  ThreadIdentifier thread = CThread::GetCurrentThreadId();
+  std::map<ThreadIdentifier, int>::iterator it = m_threads.find(thread);
+  if (it == m_threads.end())
+    it = m_threads.insert(std::make_pair(thread, (int)m_threads.size() + 1)).first;
+
+  // phases may have started before the first one was traced
+  if (start < m_origin)
+    m_origin = start;
+
+  Event event;
+  event.name   = name;
+  event.thread = it->second;
+  event.start  = start;
+  event.end    = end;
+  m_events.push_back(event);
+}
+
+void CStartupTrace::Finish()
+{
+  CSingleLock lock(m_section);
+  if (m_finished)
+    return;
+  m_finished = true;
+
+  int64_t elapsed = CurrentHostCounter() - m_origin;
+  CLog::Log(LOGNOTICE, "%s - startup took %.2fms, %u phases traced on %u threads", __FUNCTION__,
+            1000.f * elapsed / CurrentHostFrequency(), (unsigned int)m_events.size(), (unsigned int)m_threads.size());
+
+  if (g_advancedSettings.m_startupTrace)
+  {
+    CStdString path("special://temp/startuptrace.json");
+    if (Write(path))
+      CLog::Log(LOGNOTICE, "%s - wrote startup trace to %s", __FUNCTION__, CSpecialProtocol::TranslatePath(path).c_str());
+    else
+      CLog::Log(LOGERROR, "%s - unable to write startup trace to %s", __FUNCTION__, path.c_str());
+  }
+  m_events.clear();
+}
+
+bool CStartupTrace::Write(const CStdString &path) const
+{
+  // complete ("X") events with timestamps in microseconds, see the Trace Event Format
+  int64_t frequency = CurrentHostFrequency();
+  CStdString json = "{\"traceEvents\":[\n";
+  json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}}";
+  for (std::vector<Event>::const_iterator it = m_events.begin(); it != m_events.end(); ++it)
+  {
+    CStdString event;
+    event.Format(",\n{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"X\",\"ts\":%"PRId64",\"dur\":%"PRId64",\"pid\":1,\"tid\":%d}",
+                 it->name, (it->start - m_origin) * 1000000 / frequency, (it->end - it->start) * 1000000 / frequency, it->thread);
+    json += event;
+  }
+  json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true))
+    return false;
+  bool written = file.Write(json.c_str(), json.size()) == (int)json.size();
+  file.Close();
+  return written;
+}
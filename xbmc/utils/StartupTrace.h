@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+#include "utils/StdString.h"
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#define TRACE_STARTUP_PHASE(name) CStartupTrace::Scope startupTraceScope(name);
+
+/*!
+ \brief Timeline of the phases of startup.
+
+ Phases are recorded from any thread with the thread they ran on and when they
+ started and ended, until Finish() is called once startup is done. Finish() logs
+ how long startup took and, with <startuptrace> set in advancedsettings.xml, writes
+ the timeline to special://temp/startuptrace.json in the Chrome trace event format,
+ ready to be loaded into chrome://tracing.
+ */
+class CStartupTrace
+{
+public:
+  static CStartupTrace &Get();
+
+  /*!
+   \brief Records the lifetime of the object as a phase.
+   \param name name of the phase, which must outlive the trace (eg a literal).
+   */
+  class Scope
+  {
+  public:
+    Scope(const char *name);
+    ~Scope();
+  private:
+    const char *m_name;
+    int64_t     m_start;
+  };
+
+  void Add(const char *name, int64_t start, int64_t end);
+  void Finish();
+
+private:
+  CStartupTrace();
+  bool Write(const CStdString &path) const;
+
+  struct Event
+  {
+    const char *name;
+    int         thread;
+    int64_t     start;
+    int64_t     end;
+  };
+
+  CCriticalSection                m_section;
+  bool                            m_finished;
+  int64_t                         m_origin;
+  std::vector<Event>              m_events;
+  std::map<ThreadIdentifier, int> m_threads;
+};
@@ -0,0 +1,195 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "TaskGraph.h"
+#include "JobManager.h"
+#include "StartupTrace.h"
+#include "StringUtils.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <string.h>
+
+// Runs the job of a task, tracing it under the name of the task
+class CTaskJob : public CJob
+{
+public:
+  CTaskJob(const char *name, CJob *job) : m_name(name), m_job(job) {}
+  virtual ~CTaskJob() { delete m_job; }
+  virtual const char *GetType() const { return m_job->GetType(); }
+  virtual bool DoWork()
+  {
+    CStartupTrace::Scope scope(m_name);
+    return m_job->DoWork();
+  }
+private:
+  const char *m_name;
+  CJob       *m_job;
+};
+
+CTaskGraph::CTaskGraph(bool parallel) : m_completed(true)
+{
+  m_parallel = parallel;
+  m_started = false;
+}
+
+CTaskGraph::~CTaskGraph()
+{
+  WaitAll();
+}
+
+void CTaskGraph::Add(const char *name, CJob *job, const CStdString &after)
+{
+  Task task;
+  task.name    = name;
+  task.job     = new CTaskJob(name, job);
+  task.state   = STATE_PENDING;
+  task.success = false;
+
+  // dependencies have to be added first, which also keeps the graph free of cycles
+  CStdStringArray names;
+  StringUtils::SplitString(after, ",", names);
+  for (unsigned int i = 0; i < names.size(); i++)
+  {
+    names[i].Trim();
+    if (names[i].IsEmpty())
+      continue;
+    int index = Find(names[i].c_str());
+    if (index < 0)
+      CLog::Log(LOGERROR, "%s - task %s depends on unknown task %s", __FUNCTION__, name, names[i].c_str());
+    else
+      task.after.push_back(index);
+  }
+
+  CSingleLock lock(m_section);
+  m_tasks.push_back(task);
+}
+
+void CTaskGraph::Start()
+{
+  m_started = true;
+  if (m_parallel)
+  {
+    StartReady();
+    return;
+  }
+
+  // tasks only depend on those added before them, so a single pass will do
+  for (unsigned int i = 0; i < m_tasks.size(); i++)
+  {
+    Task &task = m_tasks[i];
+    task.success = task.job->DoWork();
+    task.state   = STATE_DONE;
+    delete task.job;
+    task.job = NULL;
+  }
+}
+
+bool CTaskGraph::Wait(const char *name)
+{
+  TRACE_STARTUP_PHASE("wait")
+  while (true)
+  {
+    {
+      CSingleLock lock(m_section);
+      int index = Find(name);
+      if (index < 0)
+        return false;
+      if (m_tasks[index].state == STATE_DONE || !m_started)
+        return m_tasks[index].success;
+      m_completed.Reset();
+    }
+    m_completed.Wait();
+  }
+}
+
+bool CTaskGraph::WaitAll()
+{
+  if (!m_started)
+  { // nothing ran, drop the jobs
+    for (std::vector<Task>::iterator it = m_tasks.begin(); it != m_tasks.end(); ++it)
+    {
+      delete it->job;
+      it->job = NULL;
+      it->state = STATE_DONE;
+    }
+  }
+
+  bool success = true;
+  for (unsigned int i = 0; i < m_tasks.size(); i++)
+  {
+    if (!Wait(m_tasks[i].name))
+      success = false;
+  }
+  return success;
+}
+
+void CTaskGraph::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  for (std::vector<Task>::iterator it = m_tasks.begin(); it != m_tasks.end(); ++it)
+  {
+    if (it->job == job)
+    {
+      it->job     = NULL; // deleted by the job manager once we return
+      it->state   = STATE_DONE;
+      it->success = success;
+      if (!success)
+        CLog::Log(LOGERROR, "%s - task %s failed", __FUNCTION__, it->name);
+      break;
+    }
+  }
+  StartReady();
+  m_completed.Set();
+}
+
+int CTaskGraph::Find(const char *name) const
+{
+  for (unsigned int i = 0; i < m_tasks.size(); i++)
+  {
+    if (strcmp(m_tasks[i].name, name) == 0)
+      return i;
+  }
+  return -1;
+}
+
+bool CTaskGraph::IsReady(const Task &task) const
+{
+  for (std::vector<unsigned int>::const_iterator it = task.after.begin(); it != task.after.end(); ++it)
+  {
+    if (m_tasks[*it].state != STATE_DONE)
+      return false;
+  }
+  return true;
+}
+
+void CTaskGraph::StartReady()
+{
+  CSingleLock lock(m_section);
+  for (std::vector<Task>::iterator it = m_tasks.begin(); it != m_tasks.end(); ++it)
+  {
+    if (it->state == STATE_PENDING && IsReady(*it))
+    {
+      it->state = STATE_RUNNING;
+      CJobManager::GetInstance().AddJob(it->job, this, CJob::PRIORITY_HIGH);
+    }
+  }
+}
@@ -0,0 +1,100 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/StdString.h"
+#include "Job.h"
+
+#include <vector>
+
+/*!
+ \brief Runs a set of jobs on the job manager, each once the jobs it depends on are done.
+
+ Used to overlap the independent steps of startup. Tasks are added up front, then
+ Start() hands every task without outstanding dependencies to the job manager and
+ each completion releases the tasks waiting on it. The caller carries on with its
+ own work meanwhile and calls Wait() for a task once it needs its result.
+
+ A dependency only orders the tasks: a task still runs if one it depends on failed.
+ Each task is traced as a startup phase under its name.
+ */
+class CTaskGraph : public IJobCallback
+{
+public:
+  /*!
+   \param parallel false to run the tasks one after the other on the thread calling Start().
+   */
+  CTaskGraph(bool parallel = true);
+  virtual ~CTaskGraph();
+
+  /*!
+   \brief Adds a task to the graph, which takes ownership of the job.
+   \param name name of the task, which must outlive the graph (eg a literal).
+   \param job the work of the task.
+   \param after comma separated names of the tasks that have to finish before this one starts.
+   */
+  void Add(const char *name, CJob *job, const CStdString &after = "");
+
+  void Start();
+
+  /*!
+   \brief Waits for a task to finish.
+   \return the result of the task, false if there is no task of that name.
+   */
+  bool Wait(const char *name);
+
+  /*!
+   \brief Waits for all tasks to finish.
+   \return true if all of them succeeded.
+   */
+  bool WaitAll();
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  enum State
+  {
+    STATE_PENDING = 0,
+    STATE_RUNNING,
+    STATE_DONE
+  };
+
+  struct Task
+  {
+    const char *name;
+    CJob       *job;
+    std::vector<unsigned int> after;
+    State       state;
+    bool        success;
+  };
+
+  int Find(const char *name) const;
+  bool IsReady(const Task &task) const;
+  void StartReady();
+
+  CCriticalSection  m_section;
+  CEvent            m_completed;
+  std::vector<Task> m_tasks;
+  bool              m_parallel;
+  bool              m_started;
+};
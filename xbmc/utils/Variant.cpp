@@ -20,14 +20,97 @@
  */
 #include "Variant.h"
 #include <string.h>
+#include <algorithm>
 
 using namespace std;
 
 CVariant CVariant::ConstNullVariant = CVariant::VariantTypeConstNull;
 
+CVariant::VariantMap::VariantMap(const VariantMap &rhs)
+{
+  m_members.reserve(rhs.m_members.size());
+  for (Members::const_iterator it = rhs.m_members.begin(); it != rhs.m_members.end(); ++it)
+    m_members.push_back(new value_type(**it));
+}
+
+CVariant::VariantMap::~VariantMap()
+{
+  clear();
+}
+
+CVariant::VariantMap::Members::const_iterator CVariant::VariantMap::lower_bound(const string &key) const
+{
+  // members are often added in key order, so check the end first
+  if (m_members.empty() || m_members.back()->first < key)
+    return m_members.end();
+
+  Members::const_iterator first = m_members.begin();
+  size_t count = m_members.size();
+  while (count > 0)
+  {
+    size_t half = count / 2;
+    Members::const_iterator middle = first + half;
+    if ((*middle)->first < key)
+    {
+      first = middle + 1;
+      count -= half + 1;
+    }
+    else
+      count = half;
+  }
+  return first;
+}
+
+const CVariant *CVariant::VariantMap::find(const string &key) const
+{
+  Members::const_iterator it = lower_bound(key);
+  if (it != m_members.end() && (*it)->first == key)
+    return &(*it)->second;
+  return NULL;
+}
+
+CVariant &CVariant::VariantMap::operator[](const string &key)
+{
+  Members::iterator it = m_members.begin() + (lower_bound(key) - m_members.begin());
+  if (it == m_members.end() || (*it)->first != key)
+    it = m_members.insert(it, new value_type(key, CVariant()));
+  return (*it)->second;
+}
+
+void CVariant::VariantMap::erase(const string &key)
+{
+  Members::iterator it = m_members.begin() + (lower_bound(key) - m_members.begin());
+  if (it != m_members.end() && (*it)->first == key)
+  {
+    delete *it;
+    m_members.erase(it);
+  }
+}
+
+void CVariant::VariantMap::clear()
+{
+  for (Members::iterator it = m_members.begin(); it != m_members.end(); ++it)
+    delete *it;
+  m_members.clear();
+}
+
+bool CVariant::VariantMap::operator==(const VariantMap &rhs) const
+{
+  if (m_members.size() != rhs.m_members.size())
+    return false;
+
+  for (Members::const_iterator it = m_members.begin(), it2 = rhs.m_members.begin(); it != m_members.end(); ++it, ++it2)
+  {
+    if ((*it)->first != (*it2)->first || !((*it)->second == (*it2)->second))
+      return false;
+  }
+  return true;
+}
+
 CVariant::CVariant(VariantType type)
 {
   m_type = type;
+  m_smallLength = 0;
 
   switch (type)
   {
@@ -41,7 +124,7 @@ CVariant::CVariant(VariantType type)
       m_data.boolean = false;
       break;
     case VariantTypeString:
-      m_data.string = NULL;
+      setString("", 0);
       break;
     case VariantTypeDouble:
       m_data.dvalue = 0.0;
@@ -61,85 +144,143 @@ CVariant::CVariant(VariantType type)
 CVariant::CVariant(int integer)
 {
   m_type = VariantTypeInteger;
+  m_smallLength = 0;
   m_data.integer = integer;
 }
 
 CVariant::CVariant(int64_t integer)
 {
   m_type = VariantTypeInteger;
+  m_smallLength = 0;
   m_data.integer = integer;
 }
 
 CVariant::CVariant(unsigned int unsignedinteger)
 {
   m_type = VariantTypeUnsignedInteger;
+  m_smallLength = 0;
   m_data.unsignedinteger = unsignedinteger;
 }
 
 CVariant::CVariant(uint64_t unsignedinteger)
 {
   m_type = VariantTypeUnsignedInteger;
+  m_smallLength = 0;
   m_data.unsignedinteger = unsignedinteger;
 }
 
 CVariant::CVariant(double value)
 {
   m_type = VariantTypeDouble;
+  m_smallLength = 0;
   m_data.dvalue = value;
 }
 
 CVariant::CVariant(float value)
 {
   m_type = VariantTypeDouble;
+  m_smallLength = 0;
   m_data.dvalue = (double)value;
 }
 
 CVariant::CVariant(bool boolean)
 {
   m_type = VariantTypeBoolean;
+  m_smallLength = 0;
   m_data.boolean = boolean;
 }
 
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str);
+  setString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str, length);
+  setString(str, length);
 }
 
 CVariant::CVariant(const string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new string(str);
+  setString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(const CVariant &variant)
 {
-  m_type = variant.m_type;
-  *this = variant;
+  copy(variant);
 }
 
-CVariant::~CVariant()
+#ifdef VARIANT_HAS_RVALUE_REFERENCES
+CVariant::CVariant(CVariant &&variant)
 {
-  if (m_type == VariantTypeString && m_data.string)
+  // never take the data of the shared const null variant
+  if (variant.m_type == VariantTypeConstNull)
   {
-    delete m_data.string;
-    m_data.string = NULL;
+    copy(variant);
+    return;
   }
-  else if (m_type == VariantTypeArray && m_data.array)
+
+  m_type = VariantTypeNull;
+  m_smallLength = 0;
+  swap(variant);
+}
+#endif
+
+CVariant::~CVariant()
+{
+  cleanup();
+}
+
+void CVariant::copy(const CVariant &rhs)
+{
+  m_type = rhs.m_type;
+  m_smallLength = rhs.m_smallLength;
+
+  switch (m_type)
   {
+  case VariantTypeString:
+    if (m_smallLength)
+      m_data = rhs.m_data;
+    else
+      m_data.string = new string(*rhs.m_data.string);
+    break;
+  case VariantTypeArray:
+    m_data.array = new VariantArray(*rhs.m_data.array);
+    break;
+  case VariantTypeObject:
+    m_data.map = new VariantMap(*rhs.m_data.map);
+    break;
+  default:
+    m_data = rhs.m_data;
+    break;
+  }
+}
+
+void CVariant::cleanup()
+{
+  if (m_type == VariantTypeString && !m_smallLength)
+    delete m_data.string;
+  else if (m_type == VariantTypeArray)
     delete m_data.array;
-    m_data.array = NULL;
+  else if (m_type == VariantTypeObject)
+    delete m_data.map;
+}
+
+void CVariant::setString(const char *str, unsigned int length)
+{
+  if (length < SmallStringSize)
+  {
+    memcpy(m_data.smallstring, str, length);
+    m_data.smallstring[length] = '\0';
+    m_smallLength = length + 1;
   }
-  else if (m_type == VariantTypeObject && m_data.map)
+  else
   {
-    delete m_data.map;
-    m_data.map = NULL;
+    m_data.string = new string(str, length);
+    m_smallLength = 0;
   }
 }
 
@@ -231,12 +372,12 @@ bool CVariant::asBoolean(bool fallback) const
 const char *CVariant::asString(const char *fallback) const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return c_str();
   else
     return fallback;
 }
 
-CVariant &CVariant::operator[](string key)
+CVariant &CVariant::operator[](const string &key)
 {
   if (m_type == VariantTypeNull)
   {
@@ -250,12 +391,14 @@ CVariant &CVariant::operator[](string key)
     return ConstNullVariant;
 }
 
-const CVariant &CVariant::operator[](std::string key) const
+const CVariant &CVariant::operator[](const string &key) const
 {
+  // looking up a missing member of a const object doesn't add it
+  const CVariant *member = NULL;
   if (m_type == VariantTypeObject)
-    return (*m_data.map)[key];
-  else
-    return ConstNullVariant;
+    member = m_data.map->find(key);
+
+  return member ? *member : ConstNullVariant;
 }
 
 CVariant &CVariant::operator[](unsigned int position)
@@ -276,40 +419,32 @@ const CVariant &CVariant::operator[](unsigned int position) const
 
 CVariant &CVariant::operator=(const CVariant &rhs)
 {
-  if (m_type == VariantTypeConstNull)
+  if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
 
-  m_type = rhs.m_type;
+  // copy before releasing our data, rhs may be part of it
+  CVariant temp(rhs);
+  swap(temp);
 
-  switch (m_type)
-  {
-  case VariantTypeInteger:
-    m_data.integer = rhs.m_data.integer;
-    break;
-  case VariantTypeUnsignedInteger:
-    m_data.integer = rhs.m_data.unsignedinteger;
-    break;
-  case VariantTypeBoolean:
-    m_data.boolean = rhs.m_data.boolean;
-    break;
-  case VariantTypeDouble:
-    m_data.dvalue = rhs.m_data.dvalue;
-    break;
-  case VariantTypeString:
-    m_data.string = new string(rhs.m_data.string->c_str());
-    break;
-  case VariantTypeArray:
-    m_data.array = new VariantArray(rhs.m_data.array->begin(), rhs.m_data.array->end());
-    break;
-  case VariantTypeObject:
-    m_data.map = new VariantMap(rhs.m_data.map->begin(), rhs.m_data.map->end());
-    break;
-  default:
-    break;
-  }
+  return *this;
+}
+
+#ifdef VARIANT_HAS_RVALUE_REFERENCES
+CVariant &CVariant::operator=(CVariant &&rhs)
+{
+  if (m_type == VariantTypeConstNull || this == &rhs)
+    return *this;
+
+  if (rhs.m_type == VariantTypeConstNull)
+    return *this = static_cast<const CVariant &>(rhs);
+
+  CVariant temp(VariantTypeNull);
+  temp.swap(rhs);
+  swap(temp);
 
   return *this;
 }
+#endif
 
 bool CVariant::operator==(const CVariant &rhs) const
 {
@@ -330,7 +465,7 @@ bool CVariant::operator==(const CVariant &rhs) const
       return m_data.dvalue == rhs.m_data.dvalue;
       break;
     case VariantTypeString:
-      return (*m_data.string) == (*rhs.m_data.string);
+      return size() == rhs.size() && memcmp(c_str(), rhs.c_str(), size()) == 0;
       break;
     case VariantTypeArray:
       return (*m_data.array) == (*rhs.m_data.array);
@@ -355,31 +490,51 @@ void CVariant::push_back(CVariant variant)
   }
 
   if (m_type == VariantTypeArray)
-    m_data.array->push_back(variant);
+  {
+    VariantArray &array = *m_data.array;
+    if (array.size() == array.capacity())
+    {
+      // grow by swapping the elements into the new storage, letting the
+      // vector do it would deep copy every one of them
+      VariantArray grown;
+      grown.reserve(array.empty() ? 4 : 2 * array.size());
+      grown.resize(array.size());
+      for (unsigned int i = 0; i < array.size(); i++)
+        grown[i].swap(array[i]);
+      array.swap(grown);
+    }
+    array.push_back(CVariant());
+    array.back().swap(variant);
+  }
 }
 
 void CVariant::append(CVariant variant)
 {
-  push_back(variant);
+  push_back(CVariant());
+  if (m_type == VariantTypeArray)
+    m_data.array->back().swap(variant);
 }
 
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return m_smallLength ? m_data.smallstring : m_data.string->c_str();
   else
     return NULL;
 }
 
 void CVariant::swap(CVariant &rhs)
 {
-  VariantType  temp_type = m_type;
-  VariantUnion temp_data = m_data;
+  VariantType   temp_type   = m_type;
+  unsigned char temp_length = m_smallLength;
+  VariantUnion  temp_data   = m_data;
 
   m_type = rhs.m_type;
+  m_smallLength = rhs.m_smallLength;
   m_data = rhs.m_data;
 
   rhs.m_type = temp_type;
+  rhs.m_smallLength = temp_length;
   rhs.m_data = temp_data;
 }
 
@@ -454,7 +609,7 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return m_smallLength ? m_smallLength - 1 : m_data.string->size();
   else
     return 0;
 }
@@ -477,7 +632,7 @@ void CVariant::clear()
     m_data.array->clear();
 }
 
-void CVariant::erase(std::string key)
+void CVariant::erase(const string &key)
 {
   if (m_type == VariantTypeNull)
   {
@@ -497,13 +652,19 @@ void CVariant::erase(unsigned int position)
   }
 
   if (m_type == VariantTypeArray && position < size())
-    m_data.array->erase(m_data.array->begin() + position);
+  {
+    // shift the following elements down by swapping rather than copying them
+    VariantArray &array = *m_data.array;
+    for (unsigned int i = position; i + 1 < array.size(); i++)
+      array[i].swap(array[i + 1]);
+    array.pop_back();
+  }
 }
 
-bool CVariant::isMember(string key) const
+bool CVariant::isMember(const string &key) const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->find(key) != m_data.map->end();
+    return m_data.map->find(key) != NULL;
 
   return false;
 }
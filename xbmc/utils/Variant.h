@@ -22,8 +22,14 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <iterator>
+#include <stddef.h>
 #include <stdint.h>
 
+#if defined(__GXX_EXPERIMENTAL_CXX0X__) || __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1600)
+#define VARIANT_HAS_RVALUE_REFERENCES
+#endif
+
 class CVariant
 {
 public:
@@ -52,6 +58,9 @@ public:
   CVariant(const char *str, unsigned int length);
   CVariant(const std::string &str);
   CVariant(const CVariant &variant);
+#ifdef VARIANT_HAS_RVALUE_REFERENCES
+  CVariant(CVariant &&variant);
+#endif
 
   ~CVariant();
 
@@ -73,14 +82,20 @@ public:
   double asDouble(double fallback = 0.0) const;
   float asFloat(float fallback = 0.0f) const;
 
-  CVariant &operator[](std::string key);
-  const CVariant &operator[](std::string key) const;
+  CVariant &operator[](const std::string &key);
+  const CVariant &operator[](const std::string &key) const;
   CVariant &operator[](unsigned int position);
   const CVariant &operator[](unsigned int position) const;
 
   CVariant &operator=(const CVariant &rhs);
+#ifdef VARIANT_HAS_RVALUE_REFERENCES
+  CVariant &operator=(CVariant &&rhs);
+#endif
   bool operator==(const CVariant &rhs) const;
 
+  /*! \brief Append a value to the array.
+   The value is swapped into place, so passing a temporary doesn't copy it at all.
+   */
   void push_back(CVariant variant);
   void append(CVariant variant);
 
@@ -90,7 +105,82 @@ public:
 
 private:
   typedef std::vector<CVariant> VariantArray;
-  typedef std::map<std::string, CVariant> VariantMap;
+
+  /*!
+   \brief Object members, kept in a vector sorted by key.
+
+   Objects rarely have more than a few dozen members, so a binary search over a
+   contiguous array of member pointers beats walking the nodes of a tree. Members
+   are allocated individually so references to them stay valid while other
+   members are added or removed, as they did with std::map.
+   */
+  class VariantMap
+  {
+  public:
+    typedef std::pair<const std::string, CVariant> value_type;
+
+  private:
+    typedef std::vector<value_type*> Members;
+
+  public:
+    template<typename T, typename Base>
+    class member_iterator
+    {
+    public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef T                               value_type;
+      typedef ptrdiff_t                       difference_type;
+      typedef T*                              pointer;
+      typedef T&                              reference;
+
+      member_iterator() {}
+      member_iterator(const Base &it) : m_it(it) {}
+      template<typename T2, typename Base2>
+      member_iterator(const member_iterator<T2, Base2> &rhs) : m_it(rhs.base()) {}
+
+      T &operator*() const  { return **m_it; }
+      T *operator->() const { return *m_it; }
+      member_iterator &operator++()   { ++m_it; return *this; }
+      member_iterator operator++(int) { member_iterator it(*this); ++m_it; return it; }
+      member_iterator &operator--()   { --m_it; return *this; }
+      member_iterator operator--(int) { member_iterator it(*this); --m_it; return it; }
+      bool operator==(const member_iterator &rhs) const { return m_it == rhs.m_it; }
+      bool operator!=(const member_iterator &rhs) const { return m_it != rhs.m_it; }
+
+      const Base &base() const { return m_it; }
+
+    private:
+      Base m_it;
+    };
+
+    typedef member_iterator<value_type, Members::iterator>             iterator;
+    typedef member_iterator<const value_type, Members::const_iterator> const_iterator;
+
+    VariantMap() {}
+    VariantMap(const VariantMap &rhs);
+    ~VariantMap();
+
+    iterator begin()             { return m_members.begin(); }
+    const_iterator begin() const { return m_members.begin(); }
+    iterator end()               { return m_members.end(); }
+    const_iterator end() const   { return m_members.end(); }
+
+    const CVariant *find(const std::string &key) const;
+    CVariant &operator[](const std::string &key);
+    void erase(const std::string &key);
+
+    unsigned int size() const { return m_members.size(); }
+    bool empty() const        { return m_members.empty(); }
+    void clear();
+
+    bool operator==(const VariantMap &rhs) const;
+
+  private:
+    VariantMap &operator=(const VariantMap &rhs);
+    Members::const_iterator lower_bound(const std::string &key) const;
+
+    Members m_members;
+  };
 
 public:
   typedef VariantArray::iterator        iterator_array;
@@ -112,12 +202,19 @@ public:
   unsigned int size() const;
   bool empty() const;
   void clear();
-  void erase(std::string key);
+  void erase(const std::string &key);
   void erase(unsigned int position);
 
-  bool isMember(std::string key) const;
+  bool isMember(const std::string &key) const;
 
 private:
+  void copy(const CVariant &rhs);
+  void cleanup();
+  void setString(const char *str, unsigned int length);
+
+  // strings shorter than this are stored inline rather than on the heap
+  static const unsigned int SmallStringSize = 16;
+
   union VariantUnion
   {
     int64_t integer;
@@ -125,11 +222,13 @@ private:
     bool boolean;
     double dvalue;
     std::string *string;
+    char smallstring[SmallStringSize];
     VariantArray *array;
     VariantMap *map;
   };
 
   VariantType m_type;
+  unsigned char m_smallLength; ///< length + 1 of an inline string, 0 if the string is on the heap
   VariantUnion m_data;
 
   static CVariant ConstNullVariant;
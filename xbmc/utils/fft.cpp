@@ -26,8 +26,18 @@
 
 
 #include <math.h>
+#include <string.h>
+#include <map>
 
 #include "fft.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 
 #ifndef M_PI
 #define M_PI  3.1415926535897932384626433832795
@@ -37,68 +47,220 @@
 #define M_SQRT2 1.4142135623730950488016887242097
 #endif
 
+static void MakeHannWindow(std::vector<float>& window, unsigned int size)
+{
+  window.resize(size);
+  for (unsigned int i = 0; i < size; i++)
+    window[i] = (float)(0.5 * (1 - cos(2 * M_PI * i / size)));
+}
 
+// plans for the functions that are given the size on each call
+class CFFTPlans
+{
+public:
+  ~CFFTPlans()
+  {
+    for (std::map<std::pair<unsigned int, int>, CFFT*>::iterator it = m_ffts.begin(); it != m_ffts.end(); it++)
+      delete it->second;
+  }
 
+  const CFFT& GetFFT(unsigned int size, int isign)
+  {
+    CSingleLock lock(m_section);
+    CFFT*& plan = m_ffts[std::make_pair(size, isign)];
+    if (!plan)
+      plan = new CFFT(size, isign);
+    return *plan;
+  }
 
-void fft( float data[], int nn, int isign )
-{
-  int n = nn << 1;
-  int i, j, m;
+  const std::vector<float>& GetWindow(unsigned int size)
+  {
+    CSingleLock lock(m_section);
+    std::vector<float>& window = m_windows[size];
+    if (window.size() != size)
+      MakeHannWindow(window, size);
+    return window;
+  }
+
+private:
+  CCriticalSection m_section;
+  std::map<std::pair<unsigned int, int>, CFFT*> m_ffts;
+  std::map<unsigned int, std::vector<float> > m_windows;
+};
 
-  /* bit reversal section */
+static CFFTPlans g_fftPlans;
 
-  j = 1;
-  for ( i = 1; i < n; i += 2 )
+CFFT::CFFT(unsigned int size, int isign) : m_size(size)
+{
+  // bit reversal section, as the pairs to swap
+
+  unsigned int i, j, m;
+  for (i = 0, j = 0; i < size; i++)
   {
-    if ( j > i )
+    if (j > i)
     {
-      swap( data[j], data[i] );
-      swap( data[j + 1], data[i + 1] );
+      m_swaps.push_back(i);
+      m_swaps.push_back(j);
     }
-    m = nn;
-    while ( m >= 2 && j > m )
+    m = size >> 1;
+    while (m >= 1 && (j & m))
     {
-      j -= m;
+      j ^= m;
       m >>= 1;
     }
-    j += m;
+    j |= m;
   }
 
-  /* Daniel-Lanczos section */
+  // Daniel-Lanczos section, the factors of each pass after the first.
+  // They are stored twice over, so the butterflies need no shuffling of them.
 
-  long double theta, wr, wpr, wpi, wi, wtemp;
-  float tempr, tempi;
-  int mmax = 2;
-  while (n > mmax)
+  for (unsigned int half = 2; half < size; half <<= 1)
   {
-    int istep = mmax << 1;
-    theta = isign * ( 2.0 * M_PI / mmax );
-    wtemp = sin(0.5 * theta);
-    wpr = -2.0 * wtemp * wtemp;
-    wpi = sin( theta );
-    wr = 1.0;
-    wi = 0.0;
-    for ( m = 1; m < mmax; m += 2 )
+    m_stages.push_back(m_twiddleRe.size());
+    for (unsigned int k = 0; k < half; k++)
     {
-      for ( i = m; i <= n; i += istep )
-      {
-        j = i + mmax;
-        if (j >= n || i >= n)
-          break;
-        tempr = (float) (wr * data[j] - wi * data[j + 1]);
-        tempi = (float) (wr * data[j + 1] + wi * data[j]);
-        data[j] = data[i] - tempr;
-        data[j + 1] = data[i + 1] - tempi;
-        data[i] += tempr;
-        data[i + 1] += tempi;
-      }
-      wr = (wtemp = wr) * wpr - wi * wpi + wr;
-      wi = wi * wpr + wtemp * wpi + wi;
+      double theta = isign * M_PI * k / half;
+      float wr = (float)cos(theta);
+      float wi = (float)sin(theta);
+      m_twiddleRe.push_back(wr);
+      m_twiddleRe.push_back(wr);
+      m_twiddleIm.push_back(-wi);
+      m_twiddleIm.push_back(wi);
     }
-    mmax = istep;
   }
 }
 
+// the butterflies of one block of a pass, a[k] with b[k] for count complex values
+static inline void Butterflies(float* a, float* b, const float* wr, const float* wi, unsigned int count)
+{
+  unsigned int n = count << 1;
+#if defined(__SSE__)
+  for (unsigned int k = 0; k < n; k += 4)
+  {
+    __m128 x = _mm_loadu_ps(a + k);
+    __m128 y = _mm_loadu_ps(b + k);
+    __m128 t = _mm_add_ps(_mm_mul_ps(y, _mm_loadu_ps(wr + k)),
+                          _mm_mul_ps(_mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 3, 0, 1)), _mm_loadu_ps(wi + k)));
+    _mm_storeu_ps(b + k, _mm_sub_ps(x, t));
+    _mm_storeu_ps(a + k, _mm_add_ps(x, t));
+  }
+#elif defined(__ARM_NEON__)
+  for (unsigned int k = 0; k < n; k += 4)
+  {
+    float32x4_t x = vld1q_f32(a + k);
+    float32x4_t y = vld1q_f32(b + k);
+    float32x4_t t = vmlaq_f32(vmulq_f32(y, vld1q_f32(wr + k)), vrev64q_f32(y), vld1q_f32(wi + k));
+    vst1q_f32(b + k, vsubq_f32(x, t));
+    vst1q_f32(a + k, vaddq_f32(x, t));
+  }
+#else
+  for (unsigned int k = 0; k < n; k += 2)
+  {
+    float tempr = b[k] * wr[k] + b[k + 1] * wi[k];
+    float tempi = b[k + 1] * wr[k + 1] + b[k] * wi[k + 1];
+    b[k] = a[k] - tempr;
+    b[k + 1] = a[k + 1] - tempi;
+    a[k] += tempr;
+    a[k + 1] += tempi;
+  }
+#endif
+}
+
+void CFFT::Transform(float data[]) const
+{
+  if (m_size < 2)
+    return;
+
+  for (unsigned int i = 0; i < m_swaps.size(); i += 2)
+  {
+    float* a = data + 2 * m_swaps[i];
+    float* b = data + 2 * m_swaps[i + 1];
+    swap(a[0], b[0]);
+    swap(a[1], b[1]);
+  }
+
+  // the first pass has no factors to apply
+  unsigned int n = m_size << 1;
+  for (unsigned int i = 0; i < n; i += 4)
+  {
+    float tempr = data[i + 2];
+    float tempi = data[i + 3];
+    data[i + 2] = data[i] - tempr;
+    data[i + 3] = data[i + 1] - tempi;
+    data[i] += tempr;
+    data[i + 1] += tempi;
+  }
+
+  unsigned int stage = 0;
+  for (unsigned int half = 2; half < m_size; half <<= 1, stage++)
+  {
+    const float* wr = &m_twiddleRe[m_stages[stage]];
+    const float* wi = &m_twiddleIm[m_stages[stage]];
+    for (unsigned int block = 0; block < m_size; block += half << 1)
+      Butterflies(data + 2 * block, data + 2 * (block + half), wr, wi, half);
+  }
+}
+
+CRealFFT::CRealFFT(unsigned int size, bool window, int isign) : m_size(size), m_fft(size / 2, isign)
+{
+  if (window)
+    MakeHannWindow(m_window, size);
+
+  unsigned int half = size / 2;
+  for (unsigned int k = 0; k <= half / 2; k++)
+  {
+    double theta = isign * 2 * M_PI * k / size;
+    m_twiddle.push_back((float)cos(theta));
+    m_twiddle.push_back((float)sin(theta));
+  }
+}
+
+void CRealFFT::Transform(const float in[], float out[]) const
+{
+  unsigned int half = m_size / 2;
+  if (m_window.empty())
+    memcpy(out, in, m_size * sizeof(float));
+  else
+  {
+    for (unsigned int i = 0; i < m_size; i++)
+      out[i] = in[i] * m_window[i];
+  }
+
+  // the even samples go in as the real parts and the odd ones as the imaginary parts
+  m_fft.Transform(out);
+
+  // and are taken apart again, from each value and its mirror
+  float re = out[0];
+  float im = out[1];
+  out[0] = re + im;
+  out[1] = 0;
+  out[2 * half] = re - im;
+  out[2 * half + 1] = 0;
+
+  for (unsigned int k = 1; k <= half / 2; k++)
+  {
+    float* zk = out + 2 * k;
+    float* zmk = out + 2 * (half - k);
+    float evenr = 0.5f * (zk[0] + zmk[0]);
+    float eveni = 0.5f * (zk[1] - zmk[1]);
+    float oddr  = 0.5f * (zk[1] + zmk[1]);
+    float oddi  = 0.5f * (zmk[0] - zk[0]);
+    float wr = m_twiddle[2 * k];
+    float wi = m_twiddle[2 * k + 1];
+    float tempr = wr * oddr - wi * oddi;
+    float tempi = wr * oddi + wi * oddr;
+    zk[0] = evenr + tempr;
+    zk[1] = eveni + tempi;
+    zmk[0] = evenr - tempr;
+    zmk[1] = tempi - eveni;
+  }
+}
+
+void fft( float data[], int nn, int isign )
+{
+  g_fftPlans.GetFFT(nn, isign).Transform(data + 1);
+}
+
 // By JM - packed 2 channel real fft - returns the amplitudes of the fft array
 // data[] is a 2n size array, with interleaved channels, and the fft is returned in data[]
 // interleaving is preserved.
@@ -108,7 +270,7 @@ void twochannelrfft(float data[], int n)
   int nn = n + n;
   int nn1 = nn + 1;
   // data is already packed - do the transform
-  fft( data - 1, n , + 1 );
+  g_fftPlans.GetFFT(n, 1).Transform(data);
 
   // now repack the array as needed
   data[0] = data[0] * data[0]; // only need the amplitude squared
@@ -144,15 +306,14 @@ void twochanwithwindow(float data[], int n)
   int nn = n + n;
   int nn1 = nn + 1;
   // window the data
-  float wn;
+  const std::vector<float>& window = g_fftPlans.GetWindow(n);
   for (int i = 0; i < nn; i += 2)
   {
-    wn = (float)(0.5 * (1 - cos(M_PI * i / n)));
-    data[i] *= wn;
-    data[i + 1] *= wn;
+    data[i] *= window[i >> 1];
+    data[i + 1] *= window[i >> 1];
   }
   // data is already packed - do the transform
-  fft( data - 1, n , + 1 );
+  g_fftPlans.GetFFT(n, 1).Transform(data);
 
   // now repack the array as needed
   data[0] = data[0] * data[0]; // only need the amplitude squared
@@ -25,6 +25,8 @@
  *  Arvin Schnell, Am Heidberg 8, 28865 Lilienthal, Germany
  *
  */
+#include <vector>
+
 static __inline long double sqr( long double arg )
 {
   return arg * arg;
@@ -48,5 +50,54 @@ void fft( float data[], int nn, int isign );
 void twochannelrfft(float data[], int n);
 void twochanwithwindow(float data[], int n); // test
 
+// The functions above keep a CFFT for each size they are called with, so
+// its tables are worked out on the first call only.
+
+// Complex fft of a fixed size, a power of 2, with the bit reversal and
+// twiddle factors worked out once. The butterflies use SSE or NEON when
+// built for them.
+// A plan is not changed by Transform(), so threads may share one.
+
+class CFFT
+{
+public:
+  // isign as for fft(), +1 for fft and -1 for inverse fft
+  CFFT(unsigned int size, int isign = 1);
+
+  // data[0..2*size-1] is replaced by its fft, the same as
+  // fft(data - 1, size, isign) gives
+  void Transform(float data[]) const;
+
+  unsigned int GetSize() const { return m_size; }
+
+private:
+  unsigned int m_size;
+  std::vector<unsigned int> m_swaps;  // pairs of complex indices the bit reversal swaps
+  std::vector<unsigned int> m_stages; // where the twiddle factors of each pass start
+  std::vector<float> m_twiddleRe;     // wr, wr for each factor
+  std::vector<float> m_twiddleIm;     // -wi, wi for each factor
+};
+
+// Fft of real input of a fixed size, a power of 2, done as a complex fft
+// of half the size. An optional Hann window is kept as a table.
+
+class CRealFFT
+{
+public:
+  CRealFFT(unsigned int size, bool window = false, int isign = 1);
+
+  // in[0..size-1] are the samples, out[0..size+1] gets the size/2+1
+  // complex values of the fft that are not mirrors of the others
+  void Transform(const float in[], float out[]) const;
+
+  unsigned int GetSize() const { return m_size; }
+
+private:
+  unsigned int m_size;
+  CFFT m_fft;
+  std::vector<float> m_window;
+  std::vector<float> m_twiddle; // wr, wi to recombine each pair of values
+};
+
 
 #endif
@@ -0,0 +1,276 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+#include "utils/fft.h"
+#include "utils/test/TestUtils.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI  3.1415926535897932384626433832795
+#endif
+
+// fft() and twochanwithwindow() as they were before the plans, to check against
+
+static void OldFFT( float data[], int nn, int isign )
+{
+  int n = nn << 1;
+  int i, j, m;
+
+  j = 1;
+  for ( i = 1; i < n; i += 2 )
+  {
+    if ( j > i )
+    {
+      swap( data[j], data[i] );
+      swap( data[j + 1], data[i + 1] );
+    }
+    m = nn;
+    while ( m >= 2 && j > m )
+    {
+      j -= m;
+      m >>= 1;
+    }
+    j += m;
+  }
+
+  long double theta, wr, wpr, wpi, wi, wtemp;
+  float tempr, tempi;
+  int mmax = 2;
+  while (n > mmax)
+  {
+    int istep = mmax << 1;
+    theta = isign * ( 2.0 * M_PI / mmax );
+    wtemp = sin(0.5 * theta);
+    wpr = -2.0 * wtemp * wtemp;
+    wpi = sin( theta );
+    wr = 1.0;
+    wi = 0.0;
+    for ( m = 1; m < mmax; m += 2 )
+    {
+      for ( i = m; i <= n; i += istep )
+      {
+        j = i + mmax;
+        if (j >= n || i >= n)
+          break;
+        tempr = (float) (wr * data[j] - wi * data[j + 1]);
+        tempi = (float) (wr * data[j + 1] + wi * data[j]);
+        data[j] = data[i] - tempr;
+        data[j + 1] = data[i + 1] - tempi;
+        data[i] += tempr;
+        data[i + 1] += tempi;
+      }
+      wr = (wtemp = wr) * wpr - wi * wpi + wr;
+      wi = wi * wpr + wtemp * wpi + wi;
+    }
+    mmax = istep;
+  }
+}
+
+static void OldTwoChanWithWindow(float data[], int n)
+{
+  float rep, rem, aip, aim;
+  int nn = n + n;
+  int nn1 = nn + 1;
+  float wn;
+  for (int i = 0; i < nn; i += 2)
+  {
+    wn = (float)(0.5 * (1 - cos(M_PI * i / n)));
+    data[i] *= wn;
+    data[i + 1] *= wn;
+  }
+  OldFFT( data - 1, n , + 1 );
+
+  data[0] = data[0] * data[0];
+  data[1] = data[1] * data[1];
+  data[n] = data[n] * data[n];
+  data[n + 1] = data[n + 1] * data[n + 1];
+
+  for (int j = 2; j < n; j += 2)
+  {
+    rep = data[j] + data[nn - j];
+    rem = data[j] - data[nn - j];
+    aip = data[j + 1] + data[nn1 - j];
+    aim = data[j + 1] - data[nn1 - j];
+    data[j] = (float)(0.5 * (sqr(rep) + sqr(aim)));
+    data[j + 1] = (float)(0.5 * (sqr(rem) + sqr(aip)));
+  }
+}
+
+static void Noise(std::vector<float>& data)
+{
+  for (unsigned int i = 0; i < data.size(); i++)
+    data[i] = (float)rand() / RAND_MAX * 2 - 1;
+}
+
+// the largest difference, relative to the largest value expected
+static double Error(const float* values, const float* expected, unsigned int size)
+{
+  double largest = 0, error = 0;
+  for (unsigned int i = 0; i < size; i++)
+  {
+    largest = std::max(largest, (double)fabs(expected[i]));
+    error = std::max(error, (double)fabs(values[i] - expected[i]));
+  }
+  return largest > 0 ? error / largest : error;
+}
+
+// the transform worked out sum by sum, in double
+static std::vector<float> DFT(const std::vector<float>& data, int isign)
+{
+  unsigned int size = data.size() / 2;
+  std::vector<float> result(data.size());
+  for (unsigned int k = 0; k < size; k++)
+  {
+    double re = 0, im = 0;
+    for (unsigned int j = 0; j < size; j++)
+    {
+      double theta = isign * 2 * M_PI * (double)((j * k) % size) / size;
+      re += data[2 * j] * cos(theta) - data[2 * j + 1] * sin(theta);
+      im += data[2 * j] * sin(theta) + data[2 * j + 1] * cos(theta);
+    }
+    result[2 * k] = (float)re;
+    result[2 * k + 1] = (float)im;
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(TestFFTAgainstDFT)
+{
+  srand(1);
+  for (unsigned int size = 1; size <= 1024; size <<= 1)
+  {
+    for (int isign = -1; isign <= 1; isign += 2)
+    {
+      std::vector<float> data(2 * size);
+      Noise(data);
+      std::vector<float> expected = DFT(data, isign);
+      CFFT fft(size, isign);
+      fft.Transform(&data[0]);
+      BOOST_CHECK_MESSAGE(Error(&data[0], &expected[0], data.size()) < 1e-5, "size " << size << ", isign " << isign);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestFFTAgainstOld)
+{
+  srand(2);
+  for (int size = 512; size <= 8192; size <<= 1)
+  {
+    std::vector<float> data(2 * size);
+    Noise(data);
+    std::vector<float> old(data);
+    std::vector<float> windowed(data);
+    std::vector<float> oldWindowed(data);
+
+    fft(&data[0] - 1, size, 1);
+    OldFFT(&old[0] - 1, size, 1);
+    BOOST_CHECK_MESSAGE(Error(&data[0], &old[0], data.size()) < 1e-5, "fft, size " << size);
+
+    // the callers only use the amplitudes up to half the size
+    twochanwithwindow(&windowed[0], size);
+    OldTwoChanWithWindow(&oldWindowed[0], size);
+    BOOST_CHECK_MESSAGE(Error(&windowed[0], &oldWindowed[0], size + 2) < 1e-5, "twochanwithwindow, size " << size);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestRealFFT)
+{
+  srand(3);
+  for (unsigned int size = 2; size <= 1024; size <<= 1)
+  {
+    for (int window = 0; window <= 1; window++)
+    {
+      std::vector<float> samples(size);
+      Noise(samples);
+
+      std::vector<float> complex(2 * size, 0.0f);
+      for (unsigned int i = 0; i < size; i++)
+        complex[2 * i] = samples[i] * (window ? (float)(0.5 * (1 - cos(2 * M_PI * i / size))) : 1.0f);
+      std::vector<float> expected = DFT(complex, 1);
+
+      CRealFFT fft(size, window != 0);
+      std::vector<float> out(size + 2);
+      fft.Transform(&samples[0], &out[0]);
+      BOOST_CHECK_MESSAGE(Error(&out[0], &expected[0], size + 2) < 1e-5, "size " << size << ", window " << window);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestFFTBenchmark)
+{
+  srand(4);
+  for (unsigned int size = 512; size <= 8192; size <<= 1)
+  {
+    const unsigned int runs = 4 * 1024 * 1024 / size;
+    std::vector<float> input(2 * size);
+    Noise(input);
+    std::vector<float> data(2 * size);
+    std::vector<float> out(size + 2);
+
+    double start = NowMS();
+    for (unsigned int i = 0; i < runs; i++)
+    {
+      data = input;
+      OldFFT(&data[0] - 1, size, 1);
+    }
+    double oldFFT = (NowMS() - start) * 1000 / runs;
+
+    CFFT plan(size);
+    start = NowMS();
+    for (unsigned int i = 0; i < runs; i++)
+    {
+      data = input;
+      plan.Transform(&data[0]);
+    }
+    double newFFT = (NowMS() - start) * 1000 / runs;
+
+    start = NowMS();
+    for (unsigned int i = 0; i < runs; i++)
+    {
+      data = input;
+      OldTwoChanWithWindow(&data[0], size);
+    }
+    double oldTwoChan = (NowMS() - start) * 1000 / runs;
+
+    start = NowMS();
+    for (unsigned int i = 0; i < runs; i++)
+    {
+      data = input;
+      twochanwithwindow(&data[0], size);
+    }
+    double newTwoChan = (NowMS() - start) * 1000 / runs;
+
+    CRealFFT real(size, true);
+    start = NowMS();
+    for (unsigned int i = 0; i < runs; i++)
+      real.Transform(&input[0], &out[0]);
+    double realFFT = (NowMS() - start) * 1000 / runs;
+
+    BOOST_TEST_MESSAGE(size << " points: fft " << oldFFT << "us before, " << newFFT << "us planned; twochanwithwindow "
+                       << oldTwoChan << "us before, " << newTwoChan << "us planned; real fft with window " << realFFT << "us");
+  }
+}
@@ -0,0 +1,201 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/Variant.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/JSONVariantWriter.h"
+
+#include <boost/test/unit_test.hpp>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+BOOST_AUTO_TEST_CASE(TestVariantStrings)
+{
+  CVariant small("label");
+  CVariant large("smb://server/share/Movies/Some Movie (2010)/Some Movie (2010).mkv");
+  CVariant embedded("a\0b", 3);
+
+  BOOST_CHECK_EQUAL(5u, small.size());
+  BOOST_CHECK_EQUAL(std::string("label"), small.asString());
+  BOOST_CHECK_EQUAL(65u, large.size());
+  BOOST_CHECK_EQUAL(3u, embedded.size());
+  BOOST_CHECK_EQUAL(0, memcmp("a\0b", embedded.c_str(), 4));
+  BOOST_CHECK_EQUAL(std::string(""), CVariant(CVariant::VariantTypeString).asString());
+
+  // copies of either representation compare equal and stay independent
+  CVariant smallCopy(small), largeCopy(large);
+  BOOST_CHECK(smallCopy == small);
+  BOOST_CHECK(largeCopy == large);
+  smallCopy = large;
+  largeCopy = "short";
+  BOOST_CHECK(smallCopy == large);
+  BOOST_CHECK_EQUAL(std::string("short"), largeCopy.asString());
+  BOOST_CHECK_EQUAL(std::string("label"), small.asString());
+  BOOST_CHECK(!(CVariant("a\0b", 3) == CVariant("a\0c", 3)));
+}
+
+BOOST_AUTO_TEST_CASE(TestVariantObjects)
+{
+  CVariant object;
+  object["year"] = 2010;
+  object["title"] = "Title";
+  object["file"] = "file.mkv";
+  object["genre"] = "Drama";
+
+  // members are kept in key order
+  const char *keys[] = { "file", "genre", "title", "year" };
+  unsigned int i = 0;
+  for (CVariant::const_iterator_map it = object.begin_map(); it != object.end_map(); it++, i++)
+    BOOST_CHECK_EQUAL(std::string(keys[i]), it->first);
+  BOOST_CHECK_EQUAL(4u, i);
+
+  // references to members survive adding others
+  CVariant &year = object["year"];
+  for (char c = 'a'; c <= 'z'; c++)
+    object[std::string(1, c)] = c;
+  year = 2011;
+  BOOST_CHECK_EQUAL(2011, object["year"].asInteger());
+  BOOST_CHECK_EQUAL(30u, object.size());
+
+  // looking up a missing member of a const object doesn't add it
+  const CVariant &constObject = object;
+  BOOST_CHECK(constObject["missing"].isNull());
+  BOOST_CHECK(!object.isMember("missing"));
+  BOOST_CHECK_EQUAL(30u, object.size());
+
+  object.erase("genre");
+  BOOST_CHECK(!object.isMember("genre"));
+  BOOST_CHECK(object.isMember("file"));
+
+  CVariant copy(object);
+  BOOST_CHECK(copy == object);
+  copy["file"] = "other.mkv";
+  BOOST_CHECK(!(copy == object));
+}
+
+BOOST_AUTO_TEST_CASE(TestVariantArrays)
+{
+  CVariant array(CVariant::VariantTypeArray);
+  for (int i = 0; i < 100; i++)
+  {
+    CVariant item;
+    item["label"] = "item";
+    item["id"] = i;
+    array.push_back(item);
+    BOOST_CHECK(item.isObject());
+  }
+  BOOST_CHECK_EQUAL(100u, array.size());
+  BOOST_CHECK_EQUAL(99, array[99]["id"].asInteger());
+
+  array.erase(0u);
+  BOOST_CHECK_EQUAL(99u, array.size());
+  BOOST_CHECK_EQUAL(1, array[0u]["id"].asInteger());
+  BOOST_CHECK_EQUAL(99, array[98]["id"].asInteger());
+
+  // assigning part of a variant to itself
+  array = array[0u];
+  BOOST_CHECK(array.isObject());
+  BOOST_CHECK_EQUAL(1, array["id"].asInteger());
+}
+
+// A library listing as VideoLibrary.GetMovies returns it with most fields requested.
+static CVariant BuildMovies(int count)
+{
+  CVariant result;
+  CVariant &movies = result["movies"];
+  for (int i = 0; i < count; i++)
+  {
+    char title[64];
+    sprintf(title, "Movie number %d", i);
+
+    CVariant movie;
+    movie["movieid"] = i;
+    movie["label"] = title;
+    movie["title"] = title;
+    movie["file"] = std::string("smb://server/share/Movies/") + title + ".mkv";
+    movie["thumbnail"] = "special://masterprofile/Thumbnails/Video/a/a1b2c3d4.tbn";
+    movie["fanart"] = "special://masterprofile/Thumbnails/Video/Fanart/a1b2c3d4.tbn";
+    movie["year"] = 1950 + i % 60;
+    movie["rating"] = 6.5;
+    movie["runtime"] = "120";
+    movie["genre"] = "Drama / Thriller";
+    movie["director"] = "Some Director";
+    movie["plot"] = "A plot long enough to be stored on the heap rather than inline in the variant.";
+    movie["playcount"] = i % 2;
+    for (int j = 0; j < 5; j++)
+    {
+      CVariant actor;
+      actor["name"] = "Actor Name";
+      actor["role"] = "Role";
+      movie["cast"].push_back(actor);
+    }
+    movies.push_back(movie);
+  }
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = count;
+  result["limits"]["total"] = count;
+  return result;
+}
+
+static double Elapsed(clock_t start)
+{
+  return 1000.0 * (clock() - start) / CLOCKS_PER_SEC;
+}
+
+BOOST_AUTO_TEST_CASE(TestVariantJSONRoundTrip)
+{
+  CVariant movies = BuildMovies(10);
+  std::string json = CJSONVariantWriter::Write(movies, true);
+  CVariant parsed = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+
+  BOOST_CHECK_EQUAL(10u, parsed["movies"].size());
+  BOOST_CHECK_EQUAL(std::string("Movie number 9"), parsed["movies"][9]["title"].asString());
+  BOOST_CHECK_EQUAL(json, CJSONVariantWriter::Write(parsed, true));
+}
+
+// Not a check as such, reports how long building, copying, serializing and
+// parsing a large listing takes so changes to CVariant can be compared.
+BOOST_AUTO_TEST_CASE(TestVariantBenchmark)
+{
+  const int count = 5000;
+
+  clock_t start = clock();
+  CVariant movies = BuildMovies(count);
+  double build = Elapsed(start);
+
+  start = clock();
+  CVariant copy(movies);
+  double copied = Elapsed(start);
+
+  start = clock();
+  std::string json = CJSONVariantWriter::Write(movies, true);
+  double serialize = Elapsed(start);
+
+  start = clock();
+  CVariant parsed = CJSONVariantParser::Parse((const unsigned char *)json.c_str(), json.size());
+  double parse = Elapsed(start);
+
+  BOOST_CHECK(copy == movies);
+  BOOST_CHECK_EQUAL((unsigned int)count, parsed["movies"].size());
+  BOOST_TEST_MESSAGE(count << " movies (" << json.size() << " bytes): build " << build << "ms, copy " << copied
+                     << "ms, serialize " << serialize << "ms, parse " << parse << "ms");
+}
@@ -5014,9 +5014,9 @@ void CVideoDatabase::Stack(CFileItemList& items, VIDEODB_CONTENT_TYPE type, bool
   }
 }
 
-bool CVideoDatabase::GetEpisodesNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idYear, int idActor, int idDirector, int idShow, int idSeason)
+CStdString CVideoDatabase::GetEpisodesNavWhere(int idGenre, int idYear, int idActor, int idDirector, int idShow, int idSeason, CStdString &strIn)
 {
-  CStdString where, strIn;
+  CStdString where;
   if (idShow != -1)
   {
     strIn = PrepareSQL("= %i", idShow);
@@ -5044,6 +5044,22 @@ bool CVideoDatabase::GetEpisodesNav(const CStdString& strBaseDir, CFileItemList&
   else if (idYear !=-1)
     where=PrepareSQL("where premiered like '%%%i%%'", idYear);
 
+  return where;
+}
+
+int CVideoDatabase::GetEpisodesNavCount(int idGenre, int idYear, int idActor, int idDirector, int idShow, int idSeason)
+{
+  CStdString strIn;
+  return GetRowCount("episodeview", GetEpisodesNavWhere(idGenre, idYear, idActor, idDirector, idShow, idSeason, strIn));
+}
+
+bool CVideoDatabase::GetEpisodesNav(const CStdString& strBaseDir, CFileItemList& items, int idGenre, int idYear, int idActor, int idDirector, int idShow, int idSeason, const CStdString &order /* = "" */)
+{
+  CStdString strIn;
+  CStdString where = GetEpisodesNavWhere(idGenre, idYear, idActor, idDirector, idShow, idSeason, strIn);
+  if (!order.IsEmpty())
+    where += " " + order;
+
   // we always append show, season + episode in GetEpisodesByWhere
   CStdString parent, grandParent;
   URIUtils::GetParentPath(strBaseDir,parent);
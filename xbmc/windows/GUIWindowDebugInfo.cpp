@@ -33,6 +33,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
 #include "GUIInfoManager.h"
+#include "interfaces/AnnouncementManager.h"
 
 CGUIWindowDebugInfo::CGUIWindowDebugInfo(void)
     : CGUIDialog(98, "")
@@ -108,6 +109,15 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info.Format("LOG: %sxbmc.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_settings.m_logFolder.c_str(),
                 stat.dwAvailPhys/1024, stat.dwTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+
+    unsigned int depth, maxDepth, averageLatency, maxLatency;
+    ANNOUNCEMENT::CAnnouncementManager::GetQueueStats(depth, maxDepth, averageLatency, maxLatency);
+    info.AppendFormat("\nANNOUNCE: %u queued (max %u) - latency %u ms (max %u ms)", depth, maxDepth, averageLatency, maxLatency);
+
+    unsigned int hits, misses, frameLayouts;
+    float frameTime;
+    CGUITextLayout::GetCacheStats(hits, misses, frameLayouts, frameTime);
+    info.AppendFormat("\nTEXT: %u cached/%u laid out - %u layouts in %.2f ms last frame", hits, misses, frameLayouts, frameTime);
   }
 
   // render the skin debug info